@@ -2,7 +2,9 @@
 #include "alpaca_format.hpp"
 #include <spdlog/spdlog.h>
 #include <drogon/drogon.h>
+#include <algorithm>
 #include <cmath>
+#include <sstream>
 
 using json = nlohmann::json;
 
@@ -71,13 +73,91 @@ bool shortable_by_locate_proxy(const std::shared_ptr<SessionManager>& session_mg
            ratio <= cfg.execution.short_locate_max_prior_short_volume_ratio;
 }
 
+/**
+ * Fill an Order from an Alpaca order request body. Returns an error message on
+ * invalid input; json exceptions propagate for missing/mistyped fields.
+ */
+std::optional<std::string> parse_order_request(const json& body, Order& order) {
+    order.symbol = body.at("symbol").get<std::string>();
+    order.client_order_id = body.value("client_order_id", utils::generate_id());
+
+    // Side
+    std::string side = body.value("side", "buy");
+    order.side = side == "buy" ? OrderSide::BUY : OrderSide::SELL;
+
+    // Type
+    std::string type = body.value("type", "market");
+    if (type == "limit") order.type = OrderType::LIMIT;
+    else if (type == "stop") order.type = OrderType::STOP;
+    else if (type == "stop_limit") order.type = OrderType::STOP_LIMIT;
+    else if (type == "trailing_stop") order.type = OrderType::TRAILING_STOP;
+    else order.type = OrderType::MARKET;
+
+    // Time in force
+    std::string tif = body.value("time_in_force", "day");
+    if (tif == "gtc") order.tif = TimeInForce::GTC;
+    else if (tif == "ioc") order.tif = TimeInForce::IOC;
+    else if (tif == "fok") order.tif = TimeInForce::FOK;
+    else if (tif == "opg") order.tif = TimeInForce::OPG;
+    else if (tif == "cls") order.tif = TimeInForce::CLS;
+    else order.tif = TimeInForce::DAY;
+
+    // Quantity (can be qty or notional)
+    if (body.contains("qty")) {
+        order.qty = body["qty"].get<double>();
+    } else if (body.contains("notional")) {
+        // Notional orders need to be converted to qty based on current price
+        // For now, we'll return an error - needs price data
+        return std::string("notional orders not yet supported");
+    }
+
+    // Prices
+    if (body.contains("limit_price")) {
+        order.limit_price = body["limit_price"].get<double>();
+    }
+    if (body.contains("stop_price")) {
+        order.stop_price = body["stop_price"].get<double>();
+    }
+    if (body.contains("trail_price")) {
+        order.trail_price = body["trail_price"].get<double>();
+    }
+    if (body.contains("trail_percent")) {
+        order.trail_percent = body["trail_percent"].get<double>();
+    }
+
+    if (body.contains("decision_time") && !body["decision_time"].is_null()) {
+        if (body["decision_time"].is_string()) {
+            auto parsed = utils::parse_ts_any(body["decision_time"].get<std::string>());
+            if (!parsed) {
+                return std::string("invalid decision_time");
+            }
+            order.decision_time_ns = utils::ts_to_ns(*parsed);
+        } else if (body["decision_time"].is_number_integer()) {
+            order.decision_time_ns = body["decision_time"].get<int64_t>();
+        } else {
+            return std::string("invalid decision_time");
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<std::string> split_symbols(const std::string& raw) {
+    std::vector<std::string> out;
+    std::stringstream ss(raw);
+    std::string token;
+    while (std::getline(ss, token, ',')) {
+        if (!token.empty()) out.push_back(token);
+    }
+    return out;
+}
+
 } // namespace
 
 AlpacaController::AlpacaController(std::shared_ptr<SessionManager> session_mgr, const Config& cfg)
     : session_mgr_(std::move(session_mgr)), cfg_(cfg) {
-    // Register event callback to cache last trades/quotes
-    session_mgr_->add_event_callback([this](const std::string& session_id, const Event& ev) {
-        std::lock_guard<std::mutex> lock(cache_mutex_);
+    // Cache last trades/quotes; order events never reach this callback
+    session_mgr_->add_market_data_callback([this](const std::string& session_id, const Event& ev) {
+        std::lock_guard<InstrumentedMutex> lock(cache_mutex_);
         int64_t ts = utils::ts_to_ns(ev.timestamp);
         if (ev.event_type == EventType::TRADE) {
             const auto& t = std::get<TradeData>(ev.data);
@@ -250,10 +330,9 @@ void AlpacaController::closePosition(const drogon::HttpRequestPtr& req,
     }
 
     // Get the created order
-    auto orders = session_mgr_->get_orders(session->id);
-    auto order_it = orders.find(order_id);
-    if (order_it != orders.end()) {
-        cb(json_resp(format_order(order_it->second)));
+    auto created = session_mgr_->get_order(session->id, order_id);
+    if (created) {
+        cb(json_resp(format_order(*created)));
     } else {
         cb(json_resp({{"id", order_id}, {"status", "accepted"}}));
     }
@@ -269,13 +348,8 @@ void AlpacaController::closeAllPositions(const drogon::HttpRequestPtr& req,
 
     // Cancel all open orders first if requested
     if (cancel_orders) {
-        auto orders = session_mgr_->get_orders(session->id);
-        for (const auto& [id, order] : orders) {
-            if (order.status == OrderStatus::NEW ||
-                order.status == OrderStatus::ACCEPTED ||
-                order.status == OrderStatus::PARTIALLY_FILLED) {
-                session_mgr_->cancel_order(session->id, id);
-            }
+        for (const auto& id : session->orders.open_order_ids()) {
+            session_mgr_->cancel_order(session->id, id);
         }
     }
 
@@ -323,37 +397,32 @@ void AlpacaController::orders(const drogon::HttpRequestPtr& req,
     if (!session) { cb(error_resp("session not found", 404)); return; }
 
     // Parse query parameters
+    OrderQuery query;
     std::string status_filter = req->getParameter("status");
+    if (status_filter == "open") query.status = OrderStatusFilter::OPEN;
+    else if (status_filter == "closed") query.status = OrderStatusFilter::CLOSED;
+    else query.status = OrderStatusFilter::ALL;
+
     int limit = 50;
     auto limit_param = req->getParameter("limit");
     if (!limit_param.empty()) {
         limit = std::stoi(limit_param);
     }
+    query.limit = static_cast<size_t>(std::clamp(limit, 1, 500));
+    query.newest_first = req->getParameter("direction") != "asc";
+    query.symbols = split_symbols(req->getParameter("symbols"));
+    if (auto after = utils::parse_ts_any(req->getParameter("after"))) {
+        query.after_ns = utils::ts_to_ns(*after);
+    }
+    if (auto until = utils::parse_ts_any(req->getParameter("until"))) {
+        query.until_ns = utils::ts_to_ns(*until);
+    }
 
-    auto orders = session_mgr_->get_orders(session->id);
     json arr = json::array();
-
-    for (const auto& [id, order] : orders) {
-        // Apply status filter
-        if (!status_filter.empty() && status_filter != "all") {
-            bool include = false;
-            if (status_filter == "open") {
-                include = order.status == OrderStatus::NEW ||
-                         order.status == OrderStatus::ACCEPTED ||
-                         order.status == OrderStatus::PENDING_NEW ||
-                         order.status == OrderStatus::PARTIALLY_FILLED;
-            } else if (status_filter == "closed") {
-                include = order.status == OrderStatus::FILLED ||
-                         order.status == OrderStatus::CANCELED ||
-                         order.status == OrderStatus::EXPIRED ||
-                         order.status == OrderStatus::REJECTED;
-            }
-            if (!include) continue;
-        }
-
+    session->orders.visit(query, [&](const Order& order) {
         arr.push_back(format_order(order));
-        if (static_cast<int>(arr.size()) >= limit) break;
-    }
+        return true;
+    });
 
     cb(json_resp(arr));
 }
@@ -365,14 +434,13 @@ void AlpacaController::getOrder(const drogon::HttpRequestPtr& req,
     auto session = get_session(req);
     if (!session) { cb(error_resp("session not found", 404)); return; }
 
-    auto orders = session_mgr_->get_orders(session->id);
-    auto it = orders.find(order_id);
-    if (it == orders.end()) {
+    auto order = session->orders.get(order_id);
+    if (!order) {
         cb(error_resp("order not found", 404));
         return;
     }
 
-    cb(json_resp(format_order(it->second)));
+    cb(json_resp(format_order(*order)));
 }
 
 void AlpacaController::getOrderByClientId(const drogon::HttpRequestPtr& req,
@@ -387,15 +455,13 @@ void AlpacaController::getOrderByClientId(const drogon::HttpRequestPtr& req,
         return;
     }
 
-    auto orders = session_mgr_->get_orders(session->id);
-    for (const auto& [id, order] : orders) {
-        if (order.client_order_id == client_order_id) {
-            cb(json_resp(format_order(order)));
-            return;
-        }
+    auto order = session->orders.get_by_client_id(client_order_id);
+    if (!order) {
+        cb(error_resp("order not found", 404));
+        return;
     }
 
-    cb(error_resp("order not found", 404));
+    cb(json_resp(format_order(*order)));
 }
 
 void AlpacaController::submitOrder(const drogon::HttpRequestPtr& req,
@@ -408,70 +474,11 @@ void AlpacaController::submitOrder(const drogon::HttpRequestPtr& req,
         auto body = json::parse(req->getBody());
 
         Order order;
-        order.symbol = body.at("symbol").get<std::string>();
-        order.client_order_id = body.value("client_order_id", utils::generate_id());
-
-        // Side
-        std::string side = body.value("side", "buy");
-        order.side = side == "buy" ? OrderSide::BUY : OrderSide::SELL;
-
-        // Type
-        std::string type = body.value("type", "market");
-        if (type == "limit") order.type = OrderType::LIMIT;
-        else if (type == "stop") order.type = OrderType::STOP;
-        else if (type == "stop_limit") order.type = OrderType::STOP_LIMIT;
-        else if (type == "trailing_stop") order.type = OrderType::TRAILING_STOP;
-        else order.type = OrderType::MARKET;
-
-        // Time in force
-        std::string tif = body.value("time_in_force", "day");
-        if (tif == "gtc") order.tif = TimeInForce::GTC;
-        else if (tif == "ioc") order.tif = TimeInForce::IOC;
-        else if (tif == "fok") order.tif = TimeInForce::FOK;
-        else if (tif == "opg") order.tif = TimeInForce::OPG;
-        else if (tif == "cls") order.tif = TimeInForce::CLS;
-        else order.tif = TimeInForce::DAY;
-
-        // Quantity (can be qty or notional)
-        if (body.contains("qty")) {
-            order.qty = body["qty"].get<double>();
-        } else if (body.contains("notional")) {
-            // Notional orders need to be converted to qty based on current price
-            // For now, we'll return an error - needs price data
-            cb(error_resp("notional orders not yet supported", 400));
+        if (auto err = parse_order_request(body, order)) {
+            cb(error_resp(*err, 400));
             return;
         }
 
-        // Prices
-        if (body.contains("limit_price")) {
-            order.limit_price = body["limit_price"].get<double>();
-        }
-        if (body.contains("stop_price")) {
-            order.stop_price = body["stop_price"].get<double>();
-        }
-        if (body.contains("trail_price")) {
-            order.trail_price = body["trail_price"].get<double>();
-        }
-        if (body.contains("trail_percent")) {
-            order.trail_percent = body["trail_percent"].get<double>();
-        }
-
-        if (body.contains("decision_time") && !body["decision_time"].is_null()) {
-            if (body["decision_time"].is_string()) {
-                auto parsed = utils::parse_ts_any(body["decision_time"].get<std::string>());
-                if (!parsed) {
-                    cb(error_resp("invalid decision_time", 400));
-                    return;
-                }
-                order.decision_time_ns = utils::ts_to_ns(*parsed);
-            } else if (body["decision_time"].is_number_integer()) {
-                order.decision_time_ns = body["decision_time"].get<int64_t>();
-            } else {
-                cb(error_resp("invalid decision_time", 400));
-                return;
-            }
-        }
-
         // Extended hours not supported in simulation
 
         // Submit order
@@ -481,10 +488,9 @@ void AlpacaController::submitOrder(const drogon::HttpRequestPtr& req,
             return;
         }
         // Return the created order
-        auto orders = session_mgr_->get_orders(session->id);
-        auto it = orders.find(order_id);
-        if (it != orders.end()) {
-            cb(json_resp(format_order(it->second), 200));
+        auto created = session->orders.get(order_id);
+        if (created) {
+            cb(json_resp(format_order(*created), 200));
         } else {
             order.id = order_id;
             cb(json_resp(format_order(order), 200));
@@ -504,20 +510,19 @@ void AlpacaController::replaceOrder(const drogon::HttpRequestPtr& req,
     auto session = get_session(req);
     if (!session) { cb(error_resp("session not found", 404)); return; }
 
-    auto orders = session_mgr_->get_orders(session->id);
-    auto it = orders.find(order_id);
-    if (it == orders.end()) {
+    auto existing = session->orders.get(order_id);
+    if (!existing) {
         cb(error_resp("order not found", 404));
         return;
     }
 
     // Can only replace open orders
-    if (it->second.status == OrderStatus::ACCEPTED) {
+    if (existing->status == OrderStatus::ACCEPTED) {
         cb(error_resp("cannot replace order in accepted status", 422));
         return;
     }
-    if (it->second.status != OrderStatus::NEW &&
-        it->second.status != OrderStatus::PARTIALLY_FILLED) {
+    if (existing->status != OrderStatus::NEW &&
+        existing->status != OrderStatus::PARTIALLY_FILLED) {
         cb(error_resp("order cannot be replaced", 422));
         return;
     }
@@ -529,7 +534,7 @@ void AlpacaController::replaceOrder(const drogon::HttpRequestPtr& req,
         session_mgr_->cancel_order(session->id, order_id);
 
         // Create a new order with updated values
-        Order new_order = it->second;
+        Order new_order = *existing;
         new_order.id.clear();  // Will get new ID
         new_order.client_order_id = body.value("client_order_id", new_order.client_order_id + "_replaced");
 
@@ -564,10 +569,9 @@ void AlpacaController::replaceOrder(const drogon::HttpRequestPtr& req,
             return;
         }
 
-        auto new_orders = session_mgr_->get_orders(session->id);
-        auto new_it = new_orders.find(new_order_id);
-        if (new_it != new_orders.end()) {
-            cb(json_resp(format_order(new_it->second)));
+        auto replaced = session->orders.get(new_order_id);
+        if (replaced) {
+            cb(json_resp(format_order(*replaced)));
         } else {
             new_order.id = new_order_id;
             cb(json_resp(format_order(new_order)));
@@ -603,19 +607,13 @@ void AlpacaController::cancelAllOrders(const drogon::HttpRequestPtr& req,
     auto session = get_session(req);
     if (!session) { cb(error_resp("session not found", 404)); return; }
 
-    auto orders = session_mgr_->get_orders(session->id);
     json results = json::array();
 
-    for (const auto& [id, order] : orders) {
-        // Only cancel open orders
-        if (order.status != OrderStatus::NEW &&
-            order.status != OrderStatus::ACCEPTED &&
-            order.status != OrderStatus::PARTIALLY_FILLED) {
-            continue;
-        }
-
-        bool ok = session_mgr_->cancel_order(session->id, id);
-        if (ok) {
+    auto ids = session->orders.open_order_ids();
+    auto canceled = session_mgr_->cancel_orders(session->id, ids);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        const auto& id = ids[i];
+        if (canceled[i]) {
             results.push_back({
                 {"id", id},
                 {"status", 200}
@@ -632,6 +630,105 @@ void AlpacaController::cancelAllOrders(const drogon::HttpRequestPtr& req,
     cb(json_resp(results));
 }
 
+void AlpacaController::submitOrders(const drogon::HttpRequestPtr& req,
+                                    std::function<void(const drogon::HttpResponsePtr&)>&& cb) {
+    if (!authorize(req)) { cb(unauthorized()); return; }
+    auto session = get_session(req);
+    if (!session) { cb(error_resp("session not found", 404)); return; }
+
+    json body;
+    try {
+        body = json::parse(req->getBody());
+    } catch (const json::exception& e) {
+        cb(error_resp(std::string("invalid request: ") + e.what(), 400));
+        return;
+    }
+    const json& items = body.is_object() ? body.value("orders", json::array()) : body;
+    if (!items.is_array()) {
+        cb(error_resp("expected an array of orders", 400));
+        return;
+    }
+
+    // Validate everything first, then submit the valid orders in one pass.
+    json results = json::array();
+    std::vector<Order> batch;
+    std::vector<size_t> batch_index;
+    batch.reserve(items.size());
+    batch_index.reserve(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        Order order;
+        std::optional<std::string> err;
+        try {
+            err = parse_order_request(items[i], order);
+        } catch (const json::exception& e) {
+            err = std::string("invalid request: ") + e.what();
+        }
+        if (err) {
+            results.push_back({{"index", i}, {"status", 400}, {"body", {{"message", *err}}}});
+        } else {
+            results.push_back(nullptr);
+            batch.push_back(std::move(order));
+            batch_index.push_back(i);
+        }
+    }
+
+    std::vector<std::string> ids;
+    try {
+        ids = session_mgr_->submit_orders(session->id, batch);
+    } catch (const std::exception& e) {
+        cb(error_resp(e.what(), 500));
+        return;
+    }
+    for (size_t k = 0; k < batch_index.size(); ++k) {
+        const size_t i = batch_index[k];
+        if (ids[k].empty()) {
+            results[i] = {{"index", i}, {"status", 422}, {"body", {{"message", "order submission failed"}}}};
+            continue;
+        }
+        auto created = session->orders.get(ids[k]);
+        if (!created) {
+            batch[k].id = ids[k];
+            created = batch[k];
+        }
+        results[i] = {{"index", i}, {"status", 200}, {"body", format_order(*created)}};
+    }
+
+    cb(json_resp(results));
+}
+
+void AlpacaController::cancelOrders(const drogon::HttpRequestPtr& req,
+                                    std::function<void(const drogon::HttpResponsePtr&)>&& cb) {
+    if (!authorize(req)) { cb(unauthorized()); return; }
+    auto session = get_session(req);
+    if (!session) { cb(error_resp("session not found", 404)); return; }
+
+    std::vector<std::string> ids;
+    try {
+        auto body = json::parse(req->getBody());
+        const json& items = body.is_object() ? body.at("order_ids") : body;
+        ids = items.get<std::vector<std::string>>();
+    } catch (const json::exception& e) {
+        cb(error_resp(std::string("invalid request: ") + e.what(), 400));
+        return;
+    }
+
+    auto canceled = session_mgr_->cancel_orders(session->id, ids);
+    json results = json::array();
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (canceled[i]) {
+            results.push_back({{"id", ids[i]}, {"status", 200}});
+        } else {
+            results.push_back({
+                {"id", ids[i]},
+                {"status", 422},
+                {"body", {{"message", "failed to cancel"}}}
+            });
+        }
+    }
+
+    cb(json_resp(results));
+}
+
 // ============================================================================
 // Market Data Endpoints
 // ============================================================================
@@ -701,7 +798,7 @@ void AlpacaController::getLatestTrade(const drogon::HttpRequestPtr& req,
                                       std::string symbol) {
     if (!authorize(req)) { cb(unauthorized()); return; }
 
-    std::lock_guard<std::mutex> lock(cache_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(cache_mutex_);
     auto it = last_trades_.find(symbol);
     if (it == last_trades_.end()) {
         cb(error_resp("no trade data available", 404));
@@ -725,7 +822,7 @@ void AlpacaController::getLatestQuote(const drogon::HttpRequestPtr& req,
                                       std::string symbol) {
     if (!authorize(req)) { cb(unauthorized()); return; }
 
-    std::lock_guard<std::mutex> lock(cache_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(cache_mutex_);
     auto it = last_quotes_.find(symbol);
     if (it == last_quotes_.end()) {
         cb(error_resp("no quote data available", 404));
@@ -758,7 +855,7 @@ void AlpacaController::getSnapshot(const drogon::HttpRequestPtr& req,
 
     // Add latest trade
     {
-        std::lock_guard<std::mutex> lock(cache_mutex_);
+        std::lock_guard<InstrumentedMutex> lock(cache_mutex_);
         auto t_it = last_trades_.find(symbol);
         if (t_it != last_trades_.end()) {
             snapshot["latestTrade"] = {
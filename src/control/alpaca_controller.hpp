@@ -44,6 +44,10 @@ public:
     // Order by client order ID
     ADD_METHOD_TO(AlpacaController::getOrderByClientId, "/v2/orders:by_client_order_id", drogon::Get);
 
+    // Batch order submission / cancellation (simulator extension)
+    ADD_METHOD_TO(AlpacaController::submitOrders, "/v2/orders:batch", drogon::Post);
+    ADD_METHOD_TO(AlpacaController::cancelOrders, "/v2/orders:batch_cancel", drogon::Post);
+
     // Market Data - Historical
     ADD_METHOD_TO(AlpacaController::getTrades, "/v2/stocks/{1}/trades", drogon::Get);
     ADD_METHOD_TO(AlpacaController::getQuotes, "/v2/stocks/{1}/quotes", drogon::Get);
@@ -97,6 +101,10 @@ public:
                      std::string order_id);
     void cancelAllOrders(const drogon::HttpRequestPtr& req,
                          std::function<void(const drogon::HttpResponsePtr&)>&& cb);
+    void submitOrders(const drogon::HttpRequestPtr& req,
+                      std::function<void(const drogon::HttpResponsePtr&)>&& cb);
+    void cancelOrders(const drogon::HttpRequestPtr& req,
+                      std::function<void(const drogon::HttpResponsePtr&)>&& cb);
 
     // Market Data
     void getTrades(const drogon::HttpRequestPtr& req,
@@ -147,7 +155,7 @@ private:
     Config cfg_;
 
     // Cache for last trades/quotes by symbol
-    std::mutex cache_mutex_;
+    InstrumentedMutex cache_mutex_{"alpaca.cache"};
     std::unordered_map<std::string, std::pair<double, int64_t>> last_trades_;  // symbol -> (price, timestamp)
     std::unordered_map<std::string, std::tuple<double, double, int64_t>> last_quotes_;  // symbol -> (bid, ask, timestamp)
 };
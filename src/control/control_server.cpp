@@ -1,5 +1,7 @@
 #include "control_server.hpp"
 #include "../core/utils.hpp"
+#include "../core/metrics.hpp"
+#include "../core/cpu_profiler.hpp"
 #include <spdlog/spdlog.h>
 #include <drogon/drogon.h>
 #include <sstream>
@@ -7,11 +9,91 @@
 #include <algorithm>
 #include <fstream>
 #include <cctype>
+#include <charconv>
+#include <limits>
+#include <thread>
 
 using json = nlohmann::json;
 
 namespace broker_sim {
 
+namespace {
+
+Order parse_order(const json& body) {
+    Order order;
+    order.symbol = body.at("symbol").get<std::string>();
+    order.side = body.value("side", "buy") == "buy" ? OrderSide::BUY : OrderSide::SELL;
+    std::string type = body.value("type", "market");
+    if (type == "limit") order.type = OrderType::LIMIT;
+    else if (type == "stop") order.type = OrderType::STOP;
+    else if (type == "stop_limit") order.type = OrderType::STOP_LIMIT;
+    else order.type = OrderType::MARKET;
+    std::string tif = body.value("tif", "day");
+    if (tif == "ioc") order.tif = TimeInForce::IOC;
+    else if (tif == "fok") order.tif = TimeInForce::FOK;
+    else order.tif = TimeInForce::DAY;
+    if (body.contains("qty")) order.qty = body["qty"].get<double>();
+    if (body.contains("limit_price")) order.limit_price = body["limit_price"].get<double>();
+    if (body.contains("stop_price")) order.stop_price = body["stop_price"].get<double>();
+    return order;
+}
+
+// Non-negative decimal query parameter; nullopt on signs, junk or overflow.
+std::optional<size_t> parse_count(const std::string& value) {
+    size_t out = 0;
+    const char* end = value.data() + value.size();
+    auto [ptr, ec] = std::from_chars(value.data(), end, out);
+    if (ec != std::errc{} || ptr != end) return std::nullopt;
+    return out;
+}
+
+Timestamp parse_iso_time(const std::string& value) {
+    std::tm tm{};
+    std::istringstream ss(value);
+    ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
+    return std::chrono::system_clock::from_time_t(timegm(&tm));
+}
+
+// Session fields shared by POST /sessions and POST /sweeps.
+void parse_session_config(SessionConfig& cfg, const json& j, const Config& app_cfg) {
+    cfg.symbols = j.value("symbols", std::vector<std::string>{});
+    cfg.initial_capital = j.value("initial_capital", app_cfg.defaults.initial_capital);
+    cfg.speed_factor = j.value("speed_factor", app_cfg.defaults.speed_factor);
+    cfg.live_bar_aggr_source = j.value("live_bar_aggr_source", std::string{"trades"});
+    cfg.live_aggr_bar_stream_freq_ms = j.value("live_aggr_bar_stream_freq", app_cfg.defaults.live_aggr_bar_stream_freq_ms);
+    cfg.batch_mode = j.value("batch_mode", false);
+    cfg.batch_checkpoint_events = j.value("batch_checkpoint_events", uint64_t{0});
+    if (j.contains("strategy") && j["strategy"].is_object()) {
+        const auto& strat = j["strategy"];
+        cfg.strategy_library = strat.at("library").get<std::string>();
+        cfg.strategy_params = strat.value("params", json::object()).dump();
+    }
+    std::string start = j.value("start_time", "");
+    std::string end = j.value("end_time", "");
+    auto now = std::chrono::system_clock::now();
+    cfg.start_time = start.empty() ? now : parse_iso_time(start);
+    cfg.end_time = end.empty() ? now : parse_iso_time(end);
+}
+
+json command_json(const ControlCommand& cmd) {
+    auto status = cmd.status.load(std::memory_order_acquire);
+    json out{
+        {"command_id", cmd.id},
+        {"session_id", cmd.session_id},
+        {"command", cmd.type},
+        {"status", command_status_name(status)},
+        {"submitted_at", utils::ts_to_iso(cmd.submitted_at)}
+    };
+    if (status == CommandStatus::DONE || status == CommandStatus::FAILED) {
+        out["completed_at"] = utils::ts_to_iso(*cmd.completed_at);
+        if (status == CommandStatus::DONE) out["result"] = cmd.result;
+        else out["error"] = cmd.error;
+    }
+    return out;
+}
+
+} // namespace
+
 ControlServer::ControlServer(std::shared_ptr<SessionManager> session_mgr,
                              const Config& cfg)
     : session_mgr_(std::move(session_mgr))
@@ -68,31 +150,10 @@ void ControlServer::createSession(const drogon::HttpRequestPtr& req,
         std::optional<std::string> requested_id;
         if (!body.empty()) {
             auto j = json::parse(body);
-            cfg.symbols = j.value("symbols", std::vector<std::string>{});
-            cfg.initial_capital = j.value("initial_capital", cfg_.defaults.initial_capital);
-            cfg.speed_factor = j.value("speed_factor", cfg_.defaults.speed_factor);
-            cfg.live_bar_aggr_source = j.value("live_bar_aggr_source", std::string{"trades"});
-            cfg.live_aggr_bar_stream_freq_ms = j.value("live_aggr_bar_stream_freq", cfg_.defaults.live_aggr_bar_stream_freq_ms);
+            parse_session_config(cfg, j, cfg_);
             if (j.contains("session_id") && !j["session_id"].is_null()) {
                 requested_id = j["session_id"].get<std::string>();
             }
-            std::string start = j.value("start_time", "");
-            std::string end = j.value("end_time", "");
-            auto now = std::chrono::system_clock::now();
-            cfg.start_time = now;
-            cfg.end_time = now;
-            if (!start.empty()) {
-                std::tm tm{};
-                std::istringstream ss(start);
-                ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
-                cfg.start_time = std::chrono::system_clock::from_time_t(timegm(&tm));
-            }
-            if (!end.empty()) {
-                std::tm tm{};
-                std::istringstream ss(end);
-                ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
-                cfg.end_time = std::chrono::system_clock::from_time_t(timegm(&tm));
-            }
         }
         auto start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(cfg.start_time.time_since_epoch()).count();
         spdlog::info("createSession: parsed start_time_ns={}, live_bar_aggr_source={}, live_aggr_bar_stream_freq_ms={}", start_ns, cfg.live_bar_aggr_source, cfg.live_aggr_bar_stream_freq_ms);
@@ -150,6 +211,7 @@ void ControlServer::getSession(const drogon::HttpRequestPtr& req,
         {"current_time", utils::ts_to_iso(session->time_engine->current_time())},
         {"symbols", session->config.symbols}
     };
+    if (!session->forked_from.empty()) out["forked_from"] = session->forked_from;
     callback(json_resp(out));
 }
 
@@ -163,6 +225,121 @@ void ControlServer::deleteSession(const drogon::HttpRequestPtr& req,
     callback(json_resp(json{{"status","deleted"},{"session_id",session_id}}));
 }
 
+void ControlServer::forkSession(const drogon::HttpRequestPtr& req,
+                                std::function<void (const drogon::HttpResponsePtr &)> &&callback,
+                                std::string session_id) {
+    if (!authorize(req)) { callback(unauthorized()); return; }
+    if (!session_mgr_->get_session(session_id)) { callback(json_resp(json{{"error","session not found"}},404)); return; }
+    try {
+        std::optional<std::string> requested_id;
+        auto body = req->getBody();
+        if (!body.empty()) {
+            auto j = json::parse(body);
+            if (j.contains("session_id") && !j["session_id"].is_null()) {
+                requested_id = j["session_id"].get<std::string>();
+            }
+        }
+        auto child = session_mgr_->fork_session(session_id, requested_id);
+        callback(json_resp(json{
+            {"session_id", child->id},
+            {"forked_from", child->forked_from},
+            {"status", static_cast<int>(child->status)},
+            {"current_time", utils::ts_to_iso(child->time_engine->current_time())}
+        }, 201));
+    } catch (const std::exception& e) {
+        callback(json_resp(json{{"error", e.what()}}, 409));
+    }
+}
+
+void ControlServer::metrics(const drogon::HttpRequestPtr& req,
+                            std::function<void (const drogon::HttpResponsePtr &)> &&callback) {
+    if (!authorize(req)) { callback(unauthorized()); return; }
+    // Queue depth is sampled at scrape time rather than tracked per push/pop.
+    auto& registry = MetricsRegistry::instance();
+    for (const auto& session : session_mgr_->list_sessions()) {
+        const MetricLabels labels{{"session", session->id}};
+        registry.gauge("broker_session_queue_size", "Events waiting in the session queue", labels)
+            ->set(static_cast<int64_t>(session->event_queue ? session->event_queue->size() : 0));
+        registry.gauge("broker_session_events_processed", "Market events applied by the session", labels)
+            ->set(static_cast<int64_t>(session->events_processed.load(std::memory_order_relaxed)));
+    }
+    auto resp = drogon::HttpResponse::newHttpResponse();
+    resp->setContentTypeString("text/plain; version=0.0.4; charset=utf-8");
+    resp->setBody(registry.render_prometheus());
+    callback(resp);
+}
+
+void ControlServer::cpuProfile(const drogon::HttpRequestPtr& req,
+                               std::function<void (const drogon::HttpResponsePtr &)> &&callback) {
+    if (!authorize(req)) { callback(unauthorized()); return; }
+    double seconds = 10.0;
+    int hz = 99;  // off the 100Hz grid so periodic work is not sampled in lockstep
+    try {
+        if (auto v = req->getParameter("seconds"); !v.empty()) seconds = std::stod(v);
+        if (auto v = req->getParameter("hz"); !v.empty()) hz = std::stoi(v);
+    } catch (const std::exception&) {
+        callback(json_resp(json{{"error", "seconds and hz must be numeric"}}, 400));
+        return;
+    }
+    if (!(seconds > 0.0 && seconds <= 60.0) || hz < 1 || hz > 1000) {
+        callback(json_resp(json{{"error", "seconds must be in (0, 60] and hz in [1, 1000]"}}, 400));
+        return;
+    }
+
+    // ITIMER_PROF ticks on process CPU time, so a busy process can take up
+    // to one sample per tick per core.
+    const size_t cores = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 16);
+    const auto max_samples = static_cast<size_t>(seconds * hz) * cores + 64;
+    auto& profiler = CpuProfiler::instance();
+    if (!profiler.start(hz, max_samples)) {
+        const bool busy = profiler.running();
+        callback(json_resp(json{{"error", busy ? "a CPU profile is already being captured"
+                                               : "failed to start CPU profiler"}},
+                           busy ? 409 : 500));
+        return;
+    }
+    spdlog::info("CPU profile started: {}s at {}Hz", seconds, hz);
+
+    // Reply from the event loop once the window closes; the handler thread is
+    // not held while sampling.
+    drogon::app().getLoop()->runAfter(seconds, [callback = std::move(callback)]() {
+        auto result = CpuProfiler::instance().stop();
+        spdlog::info("CPU profile finished: {} samples, {} dropped", result.samples, result.dropped);
+        auto resp = drogon::HttpResponse::newHttpResponse();
+        resp->setContentTypeString("text/plain; charset=utf-8");
+        resp->addHeader("Content-Disposition", "attachment; filename=\"cpu.collapsed\"");
+        resp->addHeader("X-Profile-Samples", std::to_string(result.samples));
+        resp->addHeader("X-Profile-Dropped", std::to_string(result.dropped));
+        resp->addHeader("X-Profile-Hz", std::to_string(result.hz));
+        resp->setBody(std::move(result.collapsed));
+        callback(resp);
+    });
+}
+
+void ControlServer::install_request_metrics() {
+    static const std::string kStartKey = "metrics_start_ns";
+    drogon::app().registerPreHandlingAdvice([](const drogon::HttpRequestPtr& req) {
+        req->attributes()->insert(kStartKey, std::chrono::steady_clock::now());
+    });
+    drogon::app().registerPostHandlingAdvice([](const drogon::HttpRequestPtr& req,
+                                                const drogon::HttpResponsePtr&) {
+        if (!req->attributes()->find(kStartKey)) return;
+        const auto started = req->attributes()->get<std::chrono::steady_clock::time_point>(kStartKey);
+        // Matched patterns ("/v2/orders/{1}") keep route cardinality bounded.
+        std::string key = std::string(req->methodString()) + " " + std::string(req->getMatchedPathPattern());
+        thread_local std::unordered_map<std::string, std::shared_ptr<Histogram>> cache;
+        auto it = cache.find(key);
+        if (it == cache.end()) {
+            auto hist = MetricsRegistry::instance().histogram(
+                "broker_http_request_duration_seconds", "HTTP handler latency by route",
+                {{"method", std::string(req->methodString())},
+                 {"route", std::string(req->getMatchedPathPattern())}});
+            it = cache.emplace(std::move(key), std::move(hist)).first;
+        }
+        it->second->record_since(started);
+    });
+}
+
 void ControlServer::stats(const drogon::HttpRequestPtr& req,
                           std::function<void (const drogon::HttpResponsePtr &)> &&callback,
                           std::string session_id) {
@@ -178,7 +355,11 @@ void ControlServer::stats(const drogon::HttpRequestPtr& req,
         {"queue_dropped", qdrop},
         {"last_event_ns", session->last_event_ns.load(std::memory_order_acquire)},
         {"events_enqueued", session->events_enqueued.load(std::memory_order_acquire)},
-        {"events_dropped", session->events_dropped.load(std::memory_order_acquire)}
+        {"events_dropped", session->events_dropped.load(std::memory_order_acquire)},
+        {"event_latency_p50_ns", session->event_latency->quantile(0.50)},
+        {"event_latency_p99_ns", session->event_latency->quantile(0.99)},
+        {"queue_wait_p99_ns", session->queue_wait->quantile(0.99)},
+        {"pace", session_mgr_->pace_report(*session).to_json()}
     };
     callback(json_resp(out));
 }
@@ -189,21 +370,7 @@ void ControlServer::submitOrder(const drogon::HttpRequestPtr& req,
     if (!authorize(req)) { callback(unauthorized()); return; }
     try {
         auto body = json::parse(req->getBody());
-        Order order;
-        order.symbol = body.at("symbol").get<std::string>();
-        order.side = body.value("side", "buy") == "buy" ? OrderSide::BUY : OrderSide::SELL;
-        std::string type = body.value("type", "market");
-        if (type == "limit") order.type = OrderType::LIMIT;
-        else if (type == "stop") order.type = OrderType::STOP;
-        else if (type == "stop_limit") order.type = OrderType::STOP_LIMIT;
-        else order.type = OrderType::MARKET;
-        std::string tif = body.value("tif", "day");
-        if (tif == "ioc") order.tif = TimeInForce::IOC;
-        else if (tif == "fok") order.tif = TimeInForce::FOK;
-        else order.tif = TimeInForce::DAY;
-        if (body.contains("qty")) order.qty = body["qty"].get<double>();
-        if (body.contains("limit_price")) order.limit_price = body["limit_price"].get<double>();
-        if (body.contains("stop_price")) order.stop_price = body["stop_price"].get<double>();
+        Order order = parse_order(body);
         auto id = session_mgr_->submit_order(session_id, order);
         if (id.empty()) {
             callback(json_resp(json{{"error", "session not found"}}, 404));
@@ -215,14 +382,110 @@ void ControlServer::submitOrder(const drogon::HttpRequestPtr& req,
     }
 }
 
+void ControlServer::submitOrders(const drogon::HttpRequestPtr& req,
+                                 std::function<void (const drogon::HttpResponsePtr &)> &&callback,
+                                 std::string session_id) {
+    if (!authorize(req)) { callback(unauthorized()); return; }
+    if (!session_mgr_->get_session(session_id)) {
+        callback(json_resp(json{{"error","session not found"}},404));
+        return;
+    }
+    json body;
+    try {
+        body = json::parse(req->getBody());
+    } catch (const std::exception& e) {
+        callback(json_resp(json{{"error", e.what()}}, 400));
+        return;
+    }
+    const json& items = body.is_object() ? body.value("orders", json::array()) : body;
+    if (!items.is_array()) {
+        callback(json_resp(json{{"error", "expected an array of orders"}}, 400));
+        return;
+    }
+    json results = json::array();
+    std::vector<Order> batch;
+    std::vector<size_t> batch_index;
+    batch.reserve(items.size());
+    batch_index.reserve(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        try {
+            batch.push_back(parse_order(items[i]));
+            batch_index.push_back(i);
+            results.push_back(nullptr);
+        } catch (const std::exception& e) {
+            results.push_back(json{{"index", i}, {"error", e.what()}});
+        }
+    }
+    std::vector<std::string> ids;
+    try {
+        ids = session_mgr_->submit_orders(session_id, std::move(batch));
+    } catch (const std::exception& e) {
+        callback(json_resp(json{{"error", e.what()}}, 500));
+        return;
+    }
+    for (size_t k = 0; k < batch_index.size(); ++k) {
+        const size_t i = batch_index[k];
+        if (ids[k].empty()) {
+            results[i] = json{{"index", i}, {"error", "order rejected"}};
+        } else {
+            results[i] = json{{"index", i}, {"order_id", ids[k]}};
+        }
+    }
+    callback(json_resp(json{{"results", results}}));
+}
+
+void ControlServer::cancelOrders(const drogon::HttpRequestPtr& req,
+                                 std::function<void (const drogon::HttpResponsePtr &)> &&callback,
+                                 std::string session_id) {
+    if (!authorize(req)) { callback(unauthorized()); return; }
+    if (!session_mgr_->get_session(session_id)) {
+        callback(json_resp(json{{"error","session not found"}},404));
+        return;
+    }
+    std::vector<std::string> ids;
+    try {
+        auto body = json::parse(req->getBody());
+        const json& items = body.is_object() ? body.at("order_ids") : body;
+        ids = items.get<std::vector<std::string>>();
+    } catch (const std::exception& e) {
+        callback(json_resp(json{{"error", e.what()}}, 400));
+        return;
+    }
+    auto canceled = session_mgr_->cancel_orders(session_id, ids);
+    json results = json::array();
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (canceled[i]) {
+            results.push_back(json{{"order_id", ids[i]}, {"status", "canceled"}});
+        } else {
+            results.push_back(json{{"order_id", ids[i]}, {"error", "not found"}});
+        }
+    }
+    callback(json_resp(json{{"results", results}}));
+}
+
 void ControlServer::listOrders(const drogon::HttpRequestPtr& req,
                                std::function<void (const drogon::HttpResponsePtr &)> &&callback,
                                std::string session_id) {
     if (!authorize(req)) { callback(unauthorized()); return; }
-    auto orders = session_mgr_->get_orders(session_id);
+    auto session = session_mgr_->get_session(session_id);
+    if (!session) { callback(json_resp(json{{"error","session not found"}},404)); return; }
+    OrderQuery query;
+    auto status = req->getParameter("status");
+    if (status == "open") query.status = OrderStatusFilter::OPEN;
+    else if (status == "closed") query.status = OrderStatusFilter::CLOSED;
+    auto lim = req->getParameter("limit");
+    if (!lim.empty()) {
+        auto parsed = parse_count(lim);
+        if (!parsed) {
+            callback(json_resp(json{{"error", "limit must be a non-negative integer"}}, 400));
+            return;
+        }
+        query.limit = *parsed;
+    }
+    auto sym = req->getParameter("symbol");
+    if (!sym.empty()) query.symbols.push_back(sym);
     json arr = json::array();
-    for (auto& kv : orders) {
-        const auto& o = kv.second;
+    session->orders.visit(query, [&](const Order& o) {
         arr.push_back({
             {"id", o.id},
             {"symbol", o.symbol},
@@ -234,7 +497,8 @@ void ControlServer::listOrders(const drogon::HttpRequestPtr& req,
             {"limit_price", o.limit_price.value_or(0.0)},
             {"stop_price", o.stop_price.value_or(0.0)}
         });
-    }
+        return true;
+    });
     callback(json_resp(arr));
 }
 
@@ -299,7 +563,14 @@ void ControlServer::events(const drogon::HttpRequestPtr& req,
     if (!authorize(req)) { callback(unauthorized()); return; }
     size_t limit = 100;
     auto lim = req->getParameter("limit");
-    if (!lim.empty()) limit = std::stoul(lim);
+    if (!lim.empty()) {
+        auto parsed = parse_count(lim);
+        if (!parsed) {
+            callback(json_resp(json{{"error", "limit must be a non-negative integer"}}, 400));
+            return;
+        }
+        limit = *parsed;
+    }
     json arr = json::array();
     {
         std::lock_guard<std::mutex> lock(events_mutex_);
@@ -321,7 +592,14 @@ void ControlServer::performance(const drogon::HttpRequestPtr& req,
     if (!session || !session->perf) { callback(json_resp(json{{"error","session not found"}},404)); return; }
     size_t limit = 200;
     auto lim = req->getParameter("limit");
-    if (!lim.empty()) limit = static_cast<size_t>(std::stoul(lim));
+    if (!lim.empty()) {
+        auto parsed = parse_count(lim);
+        if (!parsed) {
+            callback(json_resp(json{{"error", "limit must be a non-negative integer"}}, 400));
+            return;
+        }
+        limit = *parsed;
+    }
     auto points = session->perf->points(limit);
     auto metrics = session->perf->metrics();
     json series = json::array();
@@ -340,6 +618,120 @@ void ControlServer::performance(const drogon::HttpRequestPtr& req,
     callback(json_resp(out));
 }
 
+void ControlServer::results(const drogon::HttpRequestPtr& req,
+                            std::function<void (const drogon::HttpResponsePtr &)> &&callback,
+                            std::string session_id) {
+    if (!authorize(req)) { callback(unauthorized()); return; }
+    auto session = session_mgr_->get_session(session_id);
+    if (!session || !session->perf) { callback(json_resp(json{{"error","session not found"}},404)); return; }
+    auto state = session->account_manager->state();
+    auto metrics = session->perf->metrics();
+    uint64_t processed = session->events_processed.load(std::memory_order_acquire);
+    int64_t wall_ns = session->run_wall_ns.load(std::memory_order_relaxed);
+    double events_per_sec = wall_ns > 0 ? processed * 1e9 / static_cast<double>(wall_ns) : 0.0;
+    size_t open_orders = session->orders.open_order_ids().size();
+    json out{
+        {"session_id", session->id},
+        {"status", static_cast<int>(session->status)},
+        {"completed", session->status == SessionStatus::COMPLETED},
+        {"batch_mode", session->config.batch_mode},
+        {"current_time", utils::ts_to_iso(session->time_engine->current_time())},
+        {"events_processed", processed},
+        {"wall_time_ms", wall_ns / 1'000'000},
+        {"events_per_sec", events_per_sec},
+        {"open_orders", open_orders},
+        {"account", {
+            {"cash", state.cash},
+            {"equity", state.equity},
+            {"long_market_value", state.long_market_value},
+            {"short_market_value", state.short_market_value},
+            {"accrued_fees", state.accrued_fees}
+        }},
+        {"metrics", {
+            {"total_return", metrics.total_return},
+            {"max_drawdown", metrics.max_drawdown},
+            {"sharpe", metrics.sharpe}
+        }}
+    };
+    callback(json_resp(out));
+}
+
+void ControlServer::createSweep(const drogon::HttpRequestPtr& req,
+                                std::function<void (const drogon::HttpResponsePtr &)> &&callback) {
+    if (!authorize(req)) { callback(unauthorized()); return; }
+    try {
+        auto j = json::parse(req->getBody());
+        SessionConfig base;
+        base.queue_capacity = cfg_.defaults.session_queue_capacity;
+        base.overflow_policy = "block";
+        parse_session_config(base, j, cfg_);
+        if (!j.contains("variants") || !j["variants"].is_array() || j["variants"].empty()) {
+            callback(json_resp(json{{"error", "variants must be a non-empty array"}}, 400));
+            return;
+        }
+        std::vector<SweepVariant> variants;
+        for (const auto& v : j["variants"]) {
+            SweepVariant variant;
+            variant.label = v.value("label", "");
+            if (v.contains("execution") && v["execution"].is_object()) {
+                ExecutionConfig exec = cfg_.execution;
+                apply_execution_config(exec, v["execution"]);
+                variant.execution = exec;
+            }
+            if (v.contains("fees") && v["fees"].is_object()) {
+                FeeConfig fees = cfg_.fees;
+                apply_fee_config(fees, v["fees"]);
+                variant.fees = fees;
+            }
+            if (v.contains("strategy_params")) {
+                variant.strategy_params = v["strategy_params"].dump();
+            }
+            variants.push_back(std::move(variant));
+        }
+        auto group = session_mgr_->create_sweep(base, variants);
+        json ids = json::array();
+        for (const auto& session : group->sessions) ids.push_back(session->id);
+        callback(json_resp(json{{"sweep_id", group->id}, {"session_ids", ids}}, 201));
+    } catch (const std::exception& e) {
+        spdlog::error("create_sweep failed: {}", e.what());
+        callback(json_resp(json{{"error", e.what()}}, 400));
+    }
+}
+
+void ControlServer::getSweep(const drogon::HttpRequestPtr& req,
+                             std::function<void (const drogon::HttpResponsePtr &)> &&callback,
+                             std::string sweep_id) {
+    if (!authorize(req)) { callback(unauthorized()); return; }
+    auto group = session_mgr_->get_sweep(sweep_id);
+    if (!group) { callback(json_resp(json{{"error","sweep not found"}},404)); return; }
+    json members = json::array();
+    for (size_t i = 0; i < group->sessions.size(); ++i) {
+        const auto& session = group->sessions[i];
+        auto state = session->account_manager->state();
+        json row{
+            {"label", group->labels[i]},
+            {"session_id", session->id},
+            {"status", static_cast<int>(session->status)},
+            {"events_processed", session->events_processed.load(std::memory_order_acquire)},
+            {"equity", state.equity},
+            {"accrued_fees", state.accrued_fees}
+        };
+        if (session->perf) {
+            auto metrics = session->perf->metrics();
+            row["total_return"] = metrics.total_return;
+            row["max_drawdown"] = metrics.max_drawdown;
+            row["sharpe"] = metrics.sharpe;
+        }
+        members.push_back(std::move(row));
+    }
+    callback(json_resp(json{
+        {"sweep_id", group->id},
+        {"done", group->done.load()},
+        {"events_read", group->events_read.load(std::memory_order_relaxed)},
+        {"sessions", members}
+    }));
+}
+
 void ControlServer::sessionTime(const drogon::HttpRequestPtr& req,
                                 std::function<void (const drogon::HttpResponsePtr &)> &&callback,
                                 std::string session_id) {
@@ -518,6 +910,50 @@ static json parse_conditions(const std::string& raw) {
     return arr;
 }
 
+void ControlServer::trace(const drogon::HttpRequestPtr& req,
+                          std::function<void (const drogon::HttpResponsePtr &)> &&callback,
+                          std::string session_id) {
+    if (!authorize(req)) { callback(unauthorized()); return; }
+    auto session = session_mgr_->get_session(session_id);
+    if (!session) { callback(json_resp(json{{"error","session not found"}},404)); return; }
+    Timestamp start, end;
+    resolve_time_range(req, *session, start, end);
+    callback(json_resp(session->tracer.chrome_trace(session->id, ts_to_ns(start), ts_to_ns(end))));
+}
+
+void ControlServer::traceStages(const drogon::HttpRequestPtr& req,
+                                std::function<void (const drogon::HttpResponsePtr &)> &&callback,
+                                std::string session_id) {
+    if (!authorize(req)) { callback(unauthorized()); return; }
+    auto session = session_mgr_->get_session(session_id);
+    if (!session) { callback(json_resp(json{{"error","session not found"}},404)); return; }
+    callback(json_resp(json{
+        {"sample_every", session->tracer.sample_every()},
+        {"spans_recorded", session->tracer.recorded()},
+        {"stages", session->tracer.stage_summary()}
+    }));
+}
+
+void ControlServer::setTraceSampling(const drogon::HttpRequestPtr& req,
+                                     std::function<void (const drogon::HttpResponsePtr &)> &&callback,
+                                     std::string session_id) {
+    if (!authorize(req)) { callback(unauthorized()); return; }
+    auto session = session_mgr_->get_session(session_id);
+    if (!session) { callback(json_resp(json{{"error","session not found"}},404)); return; }
+    try {
+        auto body = json::parse(req->getBody());
+        int64_t every = body.value("sample_every", int64_t{0});
+        if (every < 0 || every > std::numeric_limits<uint32_t>::max()) {
+            callback(json_resp(json{{"error", "sample_every must be between 0 and 4294967295"}}, 400));
+            return;
+        }
+        session->tracer.set_sample_every(static_cast<uint32_t>(every));
+        callback(json_resp(json{{"sample_every", every}}));
+    } catch (const std::exception& e) {
+        callback(json_resp(json{{"error", e.what()}}, 400));
+    }
+}
+
 void ControlServer::jumpTo(const drogon::HttpRequestPtr& req,
                            std::function<void (const drogon::HttpResponsePtr &)> &&callback,
                            std::string session_id) {
@@ -527,8 +963,42 @@ void ControlServer::jumpTo(const drogon::HttpRequestPtr& req,
         std::string ts = body.value("timestamp", "");
         auto parsed = parse_ts_iso(ts);
         if (!parsed) { callback(json_resp(json{{"error","invalid timestamp"}},400)); return; }
-        session_mgr_->jump_to(session_id, *parsed);
-        callback(json_resp(json{{"timestamp", ts}}));
+        auto* mgr = session_mgr_.get();
+        auto cmd = mgr->post_command(session_id, "jump", [mgr, session_id, when = *parsed, ts]() {
+            if (!mgr->get_session(session_id)) throw std::runtime_error("session not found");
+            mgr->jump_to(session_id, when);
+            return json{{"timestamp", ts}};
+        });
+        if (!cmd) { callback(json_resp(json{{"error","session not found"}},404)); return; }
+        callback(json_resp(command_json(*cmd), 202));
+    } catch (const std::exception& e) {
+        callback(json_resp(json{{"error", e.what()}}, 400));
+    }
+}
+
+void ControlServer::seek(const drogon::HttpRequestPtr& req,
+                         std::function<void (const drogon::HttpResponsePtr &)> &&callback,
+                         std::string session_id) {
+    if (!authorize(req)) { callback(unauthorized()); return; }
+    try {
+        auto body = json::parse(req->getBody());
+        std::string ts = body.value("timestamp", "");
+        auto parsed = parse_ts_iso(ts);
+        if (!parsed) { callback(json_resp(json{{"error","invalid timestamp"}},400)); return; }
+        auto* mgr = session_mgr_.get();
+        auto cmd = mgr->post_command(session_id, "seek", [mgr, session_id, when = *parsed, ts]() {
+            auto result = mgr->seek_to(session_id, when);
+            if (!result) throw std::runtime_error("session not found");
+            auto session = mgr->get_session(session_id);
+            return json{
+                {"timestamp", ts},
+                {"snapshot_time", utils::ts_to_iso(result->snapshot_time)},
+                {"replayed_events", result->replayed_events},
+                {"status", session ? static_cast<int>(session->status) : -1}
+            };
+        });
+        if (!cmd) { callback(json_resp(json{{"error","session not found"}},404)); return; }
+        callback(json_resp(command_json(*cmd), 202));
     } catch (const std::exception& e) {
         callback(json_resp(json{{"error", e.what()}}, 400));
     }
@@ -543,8 +1013,14 @@ void ControlServer::fastForward(const drogon::HttpRequestPtr& req,
         std::string ts = body.value("timestamp", "");
         auto parsed = parse_ts_iso(ts);
         if (!parsed) { callback(json_resp(json{{"error","invalid timestamp"}},400)); return; }
-        session_mgr_->fast_forward(session_id, *parsed);
-        callback(json_resp(json{{"timestamp", ts}}));
+        auto* mgr = session_mgr_.get();
+        auto cmd = mgr->post_command(session_id, "fast_forward", [mgr, session_id, when = *parsed, ts]() {
+            if (!mgr->get_session(session_id)) throw std::runtime_error("session not found");
+            mgr->fast_forward(session_id, when);
+            return json{{"timestamp", ts}};
+        });
+        if (!cmd) { callback(json_resp(json{{"error","session not found"}},404)); return; }
+        callback(json_resp(command_json(*cmd), 202));
     } catch (const std::exception& e) {
         callback(json_resp(json{{"error", e.what()}}, 400));
     }
@@ -563,8 +1039,26 @@ void ControlServer::stop(const drogon::HttpRequestPtr& req,
                          std::function<void (const drogon::HttpResponsePtr &)> &&callback,
                          std::string session_id) {
     if (!authorize(req)) { callback(unauthorized()); return; }
-    session_mgr_->stop_session(session_id);
-    callback(json_resp(json::object()));
+    auto* mgr = session_mgr_.get();
+    auto cmd = mgr->post_command(session_id, "stop", [mgr, session_id]() {
+        mgr->stop_session(session_id);
+        return json::object();
+    });
+    if (!cmd) { callback(json_resp(json{{"error","session not found"}},404)); return; }
+    callback(json_resp(command_json(*cmd), 202));
+}
+
+void ControlServer::getCommand(const drogon::HttpRequestPtr& req,
+                               std::function<void (const drogon::HttpResponsePtr &)> &&callback,
+                               std::string session_id,
+                               std::string command_id) {
+    if (!authorize(req)) { callback(unauthorized()); return; }
+    auto cmd = session_mgr_->get_command(command_id);
+    if (!cmd || cmd->session_id != session_id) {
+        callback(json_resp(json{{"error","command not found"}},404));
+        return;
+    }
+    callback(json_resp(command_json(*cmd)));
 }
 
 void ControlServer::cancel(const drogon::HttpRequestPtr& req,
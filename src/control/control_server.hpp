@@ -26,13 +26,20 @@ public:
     ADD_METHOD_TO(ControlServer::listSessions, "/sessions", drogon::Get);
     ADD_METHOD_TO(ControlServer::getSession, "/sessions/{1}", drogon::Get);
     ADD_METHOD_TO(ControlServer::deleteSession, "/sessions/{1}", drogon::Delete);
+    ADD_METHOD_TO(ControlServer::forkSession, "/sessions/{1}/fork", drogon::Post);
     ADD_METHOD_TO(ControlServer::submitOrder, "/sessions/{1}/orders", drogon::Post);
     ADD_METHOD_TO(ControlServer::listOrders, "/sessions/{1}/orders", drogon::Get);
+    ADD_METHOD_TO(ControlServer::submitOrders, "/sessions/{1}/orders/batch", drogon::Post);
+    ADD_METHOD_TO(ControlServer::cancelOrders, "/sessions/{1}/orders/batch_cancel", drogon::Post);
     ADD_METHOD_TO(ControlServer::account, "/sessions/{1}/account", drogon::Get);
     ADD_METHOD_TO(ControlServer::stats, "/sessions/{1}/stats", drogon::Get);
+    ADD_METHOD_TO(ControlServer::trace, "/sessions/{1}/trace", drogon::Get);
+    ADD_METHOD_TO(ControlServer::setTraceSampling, "/sessions/{1}/trace", drogon::Post);
+    ADD_METHOD_TO(ControlServer::traceStages, "/sessions/{1}/trace/stages", drogon::Get);
     ADD_METHOD_TO(ControlServer::eventLog, "/sessions/{1}/events/log", drogon::Get);
     ADD_METHOD_TO(ControlServer::events, "/sessions/{1}/events", drogon::Get);
     ADD_METHOD_TO(ControlServer::performance, "/sessions/{1}/performance", drogon::Get);
+    ADD_METHOD_TO(ControlServer::results, "/sessions/{1}/results", drogon::Get);
     ADD_METHOD_TO(ControlServer::sessionTime, "/sessions/{1}/time", drogon::Get);
     ADD_METHOD_TO(ControlServer::start, "/sessions/{1}/start", drogon::Post);
     ADD_METHOD_TO(ControlServer::pause, "/sessions/{1}/pause", drogon::Post);
@@ -40,11 +47,17 @@ public:
     ADD_METHOD_TO(ControlServer::stop, "/sessions/{1}/stop", drogon::Post);
     ADD_METHOD_TO(ControlServer::setSpeed, "/sessions/{1}/speed", drogon::Post);
     ADD_METHOD_TO(ControlServer::jumpTo, "/sessions/{1}/jump", drogon::Post);
+    ADD_METHOD_TO(ControlServer::seek, "/sessions/{1}/seek", drogon::Post);
     ADD_METHOD_TO(ControlServer::fastForward, "/sessions/{1}/fast_forward", drogon::Post);
+    ADD_METHOD_TO(ControlServer::getCommand, "/sessions/{1}/commands/{2}", drogon::Get);
     ADD_METHOD_TO(ControlServer::watermark, "/sessions/{1}/watermark", drogon::Get);
     ADD_METHOD_TO(ControlServer::cancel, "/sessions/{1}/orders/{2}/cancel", drogon::Post);
     ADD_METHOD_TO(ControlServer::applyDividend, "/sessions/{1}/corporate_actions/dividend", drogon::Post);
     ADD_METHOD_TO(ControlServer::applySplit, "/sessions/{1}/corporate_actions/split", drogon::Post);
+    ADD_METHOD_TO(ControlServer::createSweep, "/sweeps", drogon::Post);
+    ADD_METHOD_TO(ControlServer::getSweep, "/sweeps/{1}", drogon::Get);
+    ADD_METHOD_TO(ControlServer::metrics, "/metrics", drogon::Get);
+    ADD_METHOD_TO(ControlServer::cpuProfile, "/profile/cpu", drogon::Get);
     METHOD_LIST_END
 
     ControlServer(std::shared_ptr<SessionManager> session_mgr, const Config& cfg);
@@ -54,12 +67,19 @@ public:
     void listSessions(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback);
     void getSession(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
     void deleteSession(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
+    void forkSession(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
     void submitOrder(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
+    void submitOrders(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
+    void cancelOrders(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
     void listOrders(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
     void account(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
     void stats(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
+    void trace(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
+    void traceStages(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
+    void setTraceSampling(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
     void eventLog(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
     void events(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
+    void results(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
     void performance(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
     void sessionTime(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
     void start(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
@@ -67,12 +87,24 @@ public:
     void resume(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
     void setSpeed(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
     void jumpTo(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
+    void seek(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
     void fastForward(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
     void watermark(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
     void stop(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
+    void getCommand(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id, std::string command_id);
     void cancel(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id, std::string order_id);
     void applyDividend(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
     void applySplit(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string session_id);
+    void createSweep(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback);
+    void getSweep(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback, std::string sweep_id);
+    void metrics(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback);
+    void cpuProfile(const drogon::HttpRequestPtr& req, std::function<void (const drogon::HttpResponsePtr &)> &&callback);
+
+    /**
+     * Time every HTTP request (all controllers) into
+     * broker_http_request_duration_seconds{method,route}. Call once before app().run().
+     */
+    static void install_request_metrics();
 
     // event propagation
     void on_event(const std::string& session_id, const Event& ev);
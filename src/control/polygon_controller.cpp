@@ -252,9 +252,9 @@ json build_top_mover_ticker(const TopMoversSnapshotRecord& snapshot, size_t inde
 
 PolygonController::PolygonController(std::shared_ptr<SessionManager> session_mgr, const Config& cfg)
     : session_mgr_(std::move(session_mgr)), cfg_(cfg) {
-    // Register event callback to cache quotes and trades
-    session_mgr_->add_event_callback([this](const std::string& session_id, const Event& ev) {
-        std::lock_guard<std::mutex> lock(cache_mutex_);
+    // Cache quotes and trades; order events never reach this callback
+    session_mgr_->add_market_data_callback([this](const std::string& session_id, const Event& ev) {
+        std::lock_guard<InstrumentedMutex> lock(cache_mutex_);
         int64_t ts = utils::ts_to_ns(ev.timestamp);
 
         if (ev.event_type == EventType::QUOTE) {
@@ -631,7 +631,7 @@ void PolygonController::lastTrade(const drogon::HttpRequestPtr& req,
     auto session = get_session(req);
     if (!session) { cb(error_resp("session not found", 404)); return; }
 
-    std::lock_guard<std::mutex> lock(cache_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(cache_mutex_);
     auto it = trades_cache_[session->id].find(symbol);
 
     if (it == trades_cache_[session->id].end()) {
@@ -804,7 +804,7 @@ void PolygonController::lastQuote(const drogon::HttpRequestPtr& req,
     }
 
     // Fall back to cached quote
-    std::lock_guard<std::mutex> lock(cache_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(cache_mutex_);
     auto it = quotes_cache_[session->id].find(symbol);
     if (it == quotes_cache_[session->id].end()) {
         cb(error_resp("No quote data available", 404));
@@ -2632,7 +2632,7 @@ void PolygonController::snapshotAll(const drogon::HttpRequestPtr& req,
 
     if (tickers.empty()) {
         // Fallback to cached data when no precomputed movers snapshot is available yet.
-        std::lock_guard<std::mutex> lock(cache_mutex_);
+        std::lock_guard<InstrumentedMutex> lock(cache_mutex_);
         if (session) {
             for (const auto& [sym, q] : quotes_cache_[session->id]) {
                 json ticker_data = {
@@ -2723,7 +2723,7 @@ void PolygonController::snapshotTicker(const drogon::HttpRequestPtr& req,
     ticker_data["prevDay"] = {{"o", 0}, {"h", 0}, {"l", 0}, {"c", 0}, {"v", 0}, {"vw", 0}};
 
     // Get cached trade
-    std::lock_guard<std::mutex> lock(cache_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(cache_mutex_);
     auto trade_it = trades_cache_[session->id].find(symbol);
     if (trade_it != trades_cache_[session->id].end()) {
         ticker_data["lastTrade"] = {
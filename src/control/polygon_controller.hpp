@@ -191,7 +191,7 @@ private:
 
     std::shared_ptr<SessionManager> session_mgr_;
     Config cfg_;
-    std::mutex cache_mutex_;
+    InstrumentedMutex cache_mutex_{"polygon.cache"};
     std::unordered_map<std::string, std::unordered_map<std::string, QuoteCache>> quotes_cache_;
     std::unordered_map<std::string, std::unordered_map<std::string, TradeCache>> trades_cache_;
 };
@@ -10,7 +10,7 @@ AccountManager::AccountManager(double initial_cash) {
 
 Position AccountManager::apply_fill(const std::string& symbol, const Fill& fill, OrderSide side, double fees) {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto& pos = positions_[symbol];
+    auto& pos = positions_.mut()[symbol];
     pos.symbol = symbol;
     double qty_change = side == OrderSide::BUY ? fill.fill_qty : -fill.fill_qty;
 
@@ -56,7 +56,7 @@ void AccountManager::mark_to_market(const std::string& symbol, double last_price
 void AccountManager::recompute_equity() {
     state_.long_market_value = 0.0;
     state_.short_market_value = 0.0;
-    for (auto& kv : positions_) {
+    for (const auto& kv : *positions_) {
         if (kv.second.qty >= 0)
             state_.long_market_value += kv.second.market_value;
         else
@@ -93,12 +93,13 @@ AccountState AccountManager::state() const {
 
 std::unordered_map<std::string, Position> AccountManager::positions() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return positions_;
+    return *positions_;
 }
 
 void AccountManager::mark_to_market_locked(const std::string& symbol, double last_price) {
-    auto it = positions_.find(symbol);
-    if (it == positions_.end()) return;
+    if (positions_->find(symbol) == positions_->end()) return;
+    auto& positions = positions_.mut();
+    auto it = positions.find(symbol);
     auto& pos = it->second;
     pos.market_value = pos.qty * last_price;
     pos.cost_basis = pos.qty * pos.avg_entry_price;
@@ -107,8 +108,8 @@ void AccountManager::mark_to_market_locked(const std::string& symbol, double las
 
 void AccountManager::apply_dividend(const std::string& symbol, double amount_per_share) {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = positions_.find(symbol);
-    if (it == positions_.end()) return;
+    auto it = positions_->find(symbol);
+    if (it == positions_->end()) return;
     double cash_delta = it->second.qty * amount_per_share;
     state_.cash += cash_delta;
     recompute_equity();
@@ -117,9 +118,8 @@ void AccountManager::apply_dividend(const std::string& symbol, double amount_per
 void AccountManager::apply_split(const std::string& symbol, double split_ratio) {
     if (split_ratio <= 0.0) return;
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = positions_.find(symbol);
-    if (it == positions_.end()) return;
-    auto& pos = it->second;
+    if (positions_->find(symbol) == positions_->end()) return;
+    auto& pos = positions_.mut()[symbol];
     pos.qty *= split_ratio;
     pos.avg_entry_price /= split_ratio;
     pos.market_value = pos.qty * pos.avg_entry_price;
@@ -135,7 +135,7 @@ void AccountManager::restore_state(const AccountState& state) {
 
 void AccountManager::restore_positions(const std::unordered_map<std::string, Position>& positions) {
     std::lock_guard<std::mutex> lock(mutex_);
-    positions_ = positions;
+    positions_ = Cow<std::unordered_map<std::string, Position>>(positions);
     recompute_equity();
 }
 
@@ -144,7 +144,18 @@ AccountState& AccountManager::state_mutable() {
 }
 
 std::unordered_map<std::string, Position>& AccountManager::positions_mutable() {
-    return positions_;
+    return positions_.mut();
+}
+
+std::shared_ptr<AccountManager> AccountManager::fork() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto copy = std::make_shared<AccountManager>(0.0);
+    copy->state_ = state_;
+    copy->positions_ = positions_;
+    copy->initial_margin_rate_ = initial_margin_rate_;
+    copy->maintenance_margin_rate_ = maintenance_margin_rate_;
+    copy->pdt_threshold_ = pdt_threshold_;
+    return copy;
 }
 
 } // namespace broker_sim
@@ -3,7 +3,9 @@
 #include <string>
 #include <unordered_map>
 #include <mutex>
+#include <memory>
 #include "matching_engine.hpp"
+#include "cow.hpp"
 
 namespace broker_sim {
 
@@ -49,6 +51,11 @@ public:
     void apply_dividend(const std::string& symbol, double amount_per_share);
     void apply_split(const std::string& symbol, double split_ratio);
 
+    /**
+     * Copy for a session fork; positions are shared copy-on-write.
+     */
+    std::shared_ptr<AccountManager> fork() const;
+
     /**
      * Restore state from checkpoint (for crash recovery).
      */
@@ -67,7 +74,7 @@ private:
     void mark_to_market_locked(const std::string& symbol, double last_price);
 
     AccountState state_;
-    std::unordered_map<std::string, Position> positions_;
+    Cow<std::unordered_map<std::string, Position>> positions_;
     double initial_margin_rate_{0.5};     // 50% initial
     double maintenance_margin_rate_{0.25}; // 25% maintenance
     double pdt_threshold_{25000.0};
@@ -0,0 +1,159 @@
+#include "alloc_tracking.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace broker_sim {
+
+namespace {
+
+struct StageTotals {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> frees{0};
+};
+
+// Constant-initialized so allocations made during static init are counted safely.
+constinit std::array<StageTotals, static_cast<size_t>(AllocStage::COUNT)> g_stage_totals{};
+constinit thread_local AllocCounts t_counts{};
+constinit thread_local AllocStage t_stage = AllocStage::OTHER;
+
+} // namespace
+
+const char* alloc_stage_name(AllocStage stage) {
+    switch (stage) {
+        case AllocStage::OTHER: return "other";
+        case AllocStage::ENQUEUE: return "enqueue";
+        case AllocStage::DEQUEUE: return "dequeue";
+        case AllocStage::EVENT_LOG: return "event_log";
+        case AllocStage::WAL: return "wal";
+        case AllocStage::MATCH: return "match";
+        case AllocStage::CALLBACKS: return "callbacks";
+        case AllocStage::STRATEGY: return "strategy";
+        case AllocStage::CHECKPOINT: return "checkpoint";
+        default: return "unknown";
+    }
+}
+
+namespace alloc_tracking {
+
+AllocCounts thread_counts() {
+    return t_counts;
+}
+
+AllocCounts stage_counts(AllocStage stage) {
+    const auto& totals = g_stage_totals[static_cast<size_t>(stage)];
+    return {totals.allocations.load(std::memory_order_relaxed),
+            totals.bytes.load(std::memory_order_relaxed),
+            totals.frees.load(std::memory_order_relaxed)};
+}
+
+void reset_stages() {
+    for (auto& totals : g_stage_totals) {
+        totals.allocations.store(0, std::memory_order_relaxed);
+        totals.bytes.store(0, std::memory_order_relaxed);
+        totals.frees.store(0, std::memory_order_relaxed);
+    }
+}
+
+AllocStage exchange_stage(AllocStage stage) {
+    AllocStage previous = t_stage;
+    t_stage = stage;
+    return previous;
+}
+
+} // namespace alloc_tracking
+
+#ifdef BROKER_ALLOC_TRACKING
+
+namespace {
+
+void note_alloc(std::size_t size) {
+    t_counts.allocations++;
+    t_counts.bytes += size;
+    auto& totals = g_stage_totals[static_cast<size_t>(t_stage)];
+    totals.allocations.fetch_add(1, std::memory_order_relaxed);
+    totals.bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void note_free() {
+    t_counts.frees++;
+    g_stage_totals[static_cast<size_t>(t_stage)].frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+void* counted_alloc(std::size_t size) {
+    note_alloc(size);
+    if (size == 0) size = 1;
+    for (;;) {
+        if (void* p = std::malloc(size)) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* counted_aligned_alloc(std::size_t size, std::align_val_t align) {
+    note_alloc(size);
+    const std::size_t alignment = static_cast<std::size_t>(align);
+    // aligned_alloc wants a non-zero multiple of the alignment.
+    size = size == 0 ? alignment : (size + alignment - 1) / alignment * alignment;
+    for (;;) {
+        if (void* p = std::aligned_alloc(alignment, size)) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void counted_free(void* p) noexcept {
+    if (!p) return;
+    note_free();
+    std::free(p);
+}
+
+} // namespace
+
+#endif // BROKER_ALLOC_TRACKING
+
+} // namespace broker_sim
+
+#ifdef BROKER_ALLOC_TRACKING
+
+using broker_sim::counted_alloc;
+using broker_sim::counted_aligned_alloc;
+using broker_sim::counted_free;
+
+void* operator new(std::size_t size) { return counted_alloc(size); }
+void* operator new[](std::size_t size) { return counted_alloc(size); }
+void* operator new(std::size_t size, std::align_val_t align) { return counted_aligned_alloc(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return counted_aligned_alloc(size, align); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return counted_alloc(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return counted_alloc(size); } catch (...) { return nullptr; }
+}
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    try { return counted_aligned_alloc(size, align); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    try { return counted_aligned_alloc(size, align); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { counted_free(p); }
+void operator delete[](void* p) noexcept { counted_free(p); }
+void operator delete(void* p, std::size_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::size_t) noexcept { counted_free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { counted_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { counted_free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { counted_free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { counted_free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { counted_free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { counted_free(p); }
+
+#endif // BROKER_ALLOC_TRACKING
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace broker_sim {
+
+/**
+ * Heap allocation accounting for hot-path allocation budgets.
+ *
+ * Built with -DENABLE_ALLOC_TRACKING=ON (which defines BROKER_ALLOC_TRACKING)
+ * the process replaces global operator new/delete with counting versions.
+ * Every allocation is charged to the calling thread and to the thread's
+ * current AllocStage, which the session pipeline sets with AllocStageScope.
+ * In normal builds nothing is replaced, the scopes compile to nothing and all
+ * counters read zero.
+ */
+enum class AllocStage : uint8_t {
+    OTHER,       // anything outside an instrumented stage
+    ENQUEUE,     // feeder: decode into Event and push onto the session queue
+    DEQUEUE,     // session loop outside process_event: pop, pacing, snapshots
+    EVENT_LOG,   // process_event: event log line
+    WAL,         // process_event: market event WAL record
+    MATCH,       // process_event: matching, fills, accounting, equity
+    CALLBACKS,   // process_event: event callbacks (WebSocket fan-out)
+    STRATEGY,    // process_event: in-process strategy dispatch
+    CHECKPOINT,  // process_event: periodic checkpoint
+    COUNT
+};
+
+const char* alloc_stage_name(AllocStage stage);
+
+struct AllocCounts {
+    uint64_t allocations{0};
+    uint64_t bytes{0};
+    uint64_t frees{0};
+
+    AllocCounts operator-(const AllocCounts& other) const {
+        return {allocations - other.allocations, bytes - other.bytes, frees - other.frees};
+    }
+};
+
+namespace alloc_tracking {
+
+constexpr bool enabled() {
+#ifdef BROKER_ALLOC_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+/** Allocations made by the calling thread since it started. */
+AllocCounts thread_counts();
+
+/** Allocations charged to a stage, summed over all threads. */
+AllocCounts stage_counts(AllocStage stage);
+
+/** Zero the per-stage totals (thread totals are left alone). */
+void reset_stages();
+
+/** Make `stage` the calling thread's current stage and return the previous one. */
+AllocStage exchange_stage(AllocStage stage);
+
+} // namespace alloc_tracking
+
+/**
+ * Charges the calling thread's allocations to a stage until set() moves it
+ * to another or the scope ends, which restores the enclosing stage.
+ */
+class AllocStageScope {
+public:
+#ifdef BROKER_ALLOC_TRACKING
+    explicit AllocStageScope(AllocStage stage) : previous_(alloc_tracking::exchange_stage(stage)) {}
+    ~AllocStageScope() { alloc_tracking::exchange_stage(previous_); }
+    void set(AllocStage stage) { alloc_tracking::exchange_stage(stage); }
+#else
+    explicit AllocStageScope(AllocStage) {}
+    void set(AllocStage) {}
+#endif
+    AllocStageScope(const AllocStageScope&) = delete;
+    AllocStageScope& operator=(const AllocStageScope&) = delete;
+
+private:
+#ifdef BROKER_ALLOC_TRACKING
+    AllocStage previous_;
+#endif
+};
+
+} // namespace broker_sim
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace broker_sim {
+
+/**
+ * Append-only list of callbacks that can be dispatched without locking or
+ * allocating.
+ *
+ * add() copies the current list, appends, and publishes the copy with a
+ * release store; dispatch() reads the published pointer once and walks it.
+ * Superseded copies are kept until the list is destroyed because a dispatcher
+ * may still be walking one. Registration happens a handful of times per
+ * process or session, so the retained copies stay small, and there is no
+ * reference count for dispatchers on different threads to contend on.
+ */
+template <typename Callback>
+class CallbackList {
+public:
+    CallbackList() = default;
+    CallbackList(const CallbackList&) = delete;
+    CallbackList& operator=(const CallbackList&) = delete;
+
+    void add(Callback cb) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        const auto* current = current_.load(std::memory_order_relaxed);
+        auto next = current ? std::make_unique<std::vector<Callback>>(*current)
+                            : std::make_unique<std::vector<Callback>>();
+        next->push_back(std::move(cb));
+        current_.store(next.get(), std::memory_order_release);
+        versions_.push_back(std::move(next));
+    }
+
+    /** Invoke every callback registered before the call; callbacks added meanwhile run next time. */
+    template <typename... Args>
+    void dispatch(Args&&... args) const {
+        const auto* callbacks = current_.load(std::memory_order_acquire);
+        if (!callbacks) return;
+        for (const auto& cb : *callbacks) {
+            if (cb) cb(args...);
+        }
+    }
+
+    bool empty() const { return current_.load(std::memory_order_acquire) == nullptr; }
+
+    size_t size() const {
+        const auto* callbacks = current_.load(std::memory_order_acquire);
+        return callbacks ? callbacks->size() : 0;
+    }
+
+private:
+    std::mutex write_mutex_;
+    std::vector<std::unique_ptr<const std::vector<Callback>>> versions_;
+    std::atomic<const std::vector<Callback>*> current_{nullptr};
+};
+
+} // namespace broker_sim
@@ -8,6 +8,7 @@
 #include <spdlog/spdlog.h>
 #include "matching_engine.hpp"
 #include "account_manager.hpp"
+#include "order_archive.hpp"
 
 namespace broker_sim {
 
@@ -30,6 +31,10 @@ inline std::string wal_path(const std::string& dir, const std::string& session_i
     return dir + "/session_" + session_id + ".wal.jsonl";
 }
 
+inline std::string order_archive_path(const std::string& dir, const std::string& session_id) {
+    return dir + "/session_" + session_id + ".orders.jsonl";
+}
+
 inline void save_checkpoint(const Checkpoint& ckpt, const std::string& dir = "logs") {
     std::filesystem::create_directories(dir);
     nlohmann::json j;
@@ -68,30 +73,7 @@ inline void save_checkpoint(const Checkpoint& ckpt, const std::string& dir = "lo
 
     nlohmann::json ord = nlohmann::json::array();
     for (const auto& kv : ckpt.orders) {
-        const auto& o = kv.second;
-        ord.push_back({
-            {"id", o.id},
-            {"client_order_id", o.client_order_id},
-            {"symbol", o.symbol},
-            {"side", o.side == OrderSide::BUY ? "BUY" : "SELL"},
-            {"type", static_cast<int>(o.type)},
-            {"tif", static_cast<int>(o.tif)},
-            {"status", static_cast<int>(o.status)},
-            {"qty", o.qty.value_or(0.0)},
-            {"filled_qty", o.filled_qty},
-            {"limit_price", o.limit_price.value_or(0.0)},
-            {"stop_price", o.stop_price.value_or(0.0)},
-            {"trail_price", o.trail_price.value_or(0.0)},
-            {"trail_percent", o.trail_percent.value_or(0.0)},
-            {"stop_triggered", o.stop_triggered},
-            {"is_maker", o.is_maker},
-            {"created_at_ns", o.created_at_ns},
-            {"submitted_at_ns", o.submitted_at_ns},
-            {"updated_at_ns", o.updated_at_ns},
-            {"filled_at_ns", o.filled_at_ns},
-            {"last_fill_fee", o.last_fill_fee},
-            {"cumulative_fees", o.cumulative_fees}
-        });
+        ord.push_back(order_to_json(kv.second));
     }
     j["orders"] = ord;
 
@@ -172,32 +154,7 @@ inline std::optional<Checkpoint> load_checkpoint(const std::string& session_id,
 
     if (j.contains("orders")) {
         for (const auto& o : j["orders"]) {
-            Order ord;
-            ord.id = o.value("id", "");
-            ord.client_order_id = o.value("client_order_id", "");
-            ord.symbol = o.value("symbol", "");
-            ord.side = o.value("side", "BUY") == "BUY" ? OrderSide::BUY : OrderSide::SELL;
-            ord.type = static_cast<OrderType>(o.value("type", 0));
-            ord.tif = static_cast<TimeInForce>(o.value("tif", 0));
-            ord.status = static_cast<OrderStatus>(o.value("status", 0));
-            ord.qty = o.value("qty", 0.0);
-            ord.filled_qty = o.value("filled_qty", 0.0);
-            double lp = o.value("limit_price", 0.0);
-            if (lp > 0.0) ord.limit_price = lp;
-            double sp = o.value("stop_price", 0.0);
-            if (sp > 0.0) ord.stop_price = sp;
-            double tp = o.value("trail_price", 0.0);
-            if (tp > 0.0) ord.trail_price = tp;
-            double tpct = o.value("trail_percent", 0.0);
-            if (tpct > 0.0) ord.trail_percent = tpct;
-            ord.stop_triggered = o.value("stop_triggered", false);
-            ord.is_maker = o.value("is_maker", false);
-            ord.created_at_ns = o.value("created_at_ns", int64_t{0});
-            ord.submitted_at_ns = o.value("submitted_at_ns", int64_t{0});
-            ord.updated_at_ns = o.value("updated_at_ns", int64_t{0});
-            ord.filled_at_ns = o.value("filled_at_ns", int64_t{0});
-            ord.last_fill_fee = o.value("last_fill_fee", 0.0);
-            ord.cumulative_fees = o.value("cumulative_fees", 0.0);
+            Order ord = order_from_json(o);
             if (!ord.id.empty()) {
                 ck.orders[ord.id] = ord;
             }
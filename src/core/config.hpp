@@ -89,6 +89,16 @@ struct ExecutionConfig {
     // Polling fallback
     int poll_interval_seconds{0};          // >0 enables polling fallback per window
 
+    // Batch session scheduler (work-stealing pool shared by batch_mode sessions)
+    int scheduler_threads{0};              // 0 = hardware concurrency
+    int scheduler_slice_events{1024};      // Events per cooperative slice before yielding
+    int control_threads{2};                // Workers running session control commands
+    int trace_sample_every{0};             // Trace every Nth event's pipeline stages (0 = off)
+
+    // Seek snapshots (in-memory, copy-on-write) so seek_to replays only the gap
+    int seek_snapshot_interval_seconds{300}; // Simulated seconds between snapshots (0 = disabled)
+    int seek_snapshot_limit{256};          // Max snapshots per session; thinned by half when exceeded
+
     // Checkpoint/WAL settings
     int checkpoint_interval_events{10000}; // Save checkpoint every N events (0 = disabled)
     bool enable_wal{true};                 // Enable write-ahead logging
@@ -132,6 +142,7 @@ struct ExecutionConfig {
     bool enable_circuit_breakers{true};
     double luld_tier1_pct{5.0};   // Tier 1 (S&P 500, Russell 1000): 5% band
     double luld_tier2_pct{10.0};  // Tier 2 (other NMS stocks): 10% band
+    std::vector<std::string> luld_tier1_symbols{};  // Tier 1 symbols; all others are Tier 2
     int luld_halt_duration_sec{300};  // 5-minute halt duration
 
     // Corporate actions
@@ -269,6 +280,31 @@ struct ExecutionConfig {
         return raw_window_end;
     }
 
+    /**
+     * Eastern Time calendar date of a timestamp, as 00:00 UTC on that date
+     * (how daily bars are stamped).
+     */
+    static std::chrono::system_clock::time_point et_date(std::chrono::system_clock::time_point ts) {
+        std::tm tm_et = to_et_tm(ts);
+        std::tm date{};
+        date.tm_year = tm_et.tm_year;
+        date.tm_mon = tm_et.tm_mon;
+        date.tm_mday = tm_et.tm_mday;
+        return std::chrono::system_clock::from_time_t(timegm(&date));
+    }
+
+    /**
+     * First Eastern Time midnight after a timestamp.
+     */
+    static std::chrono::system_clock::time_point next_et_midnight(std::chrono::system_clock::time_point ts) {
+        std::tm tm_et = to_et_tm(ts);
+        int year = tm_et.tm_year + 1900;
+        int month = tm_et.tm_mon + 1;
+        int day = tm_et.tm_mday;
+        add_days(year, month, day, 1);
+        return et_local_to_utc(year, month, day, 0, 0);
+    }
+
     /**
      * Check if we're in extended hours (pre-market or after-hours).
      */
@@ -374,7 +410,8 @@ private:
         tm.tm_mon = month - 1;
         tm.tm_mday = day + delta;
         auto tt = timegm(&tm);
-        std::tm tm_out = *std::gmtime(&tt);
+        std::tm tm_out{};
+        gmtime_r(&tt, &tm_out);
         year = tm_out.tm_year + 1900;
         month = tm_out.tm_mon + 1;
         day = tm_out.tm_mday;
@@ -426,7 +463,8 @@ private:
 
     static bool is_us_dst_utc(std::chrono::system_clock::time_point ts) {
         auto tt = std::chrono::system_clock::to_time_t(ts);
-        std::tm tm_utc = *std::gmtime(&tt);
+        std::tm tm_utc{};
+        gmtime_r(&tt, &tm_utc);
         int year = tm_utc.tm_year + 1900;
         int dst_start_day = nth_weekday_of_month(year, 3, 0, 2);
         int dst_end_day = nth_weekday_of_month(year, 11, 0, 1);
@@ -444,7 +482,10 @@ private:
         int offset_min = et_offset_minutes(ts);
         auto adjusted = ts + std::chrono::minutes(offset_min);
         auto tt = std::chrono::system_clock::to_time_t(adjusted);
-        return *std::gmtime(&tt);
+        // gmtime's shared buffer would race between pooled session loops.
+        std::tm tm{};
+        gmtime_r(&tt, &tm);
+        return tm;
     }
 
     static std::chrono::system_clock::time_point et_local_to_utc(int year, int month, int day,
@@ -629,6 +670,108 @@ struct Config {
     AuthConfig auth;
 };
 
+/**
+ * Apply an "execution" JSON object onto an ExecutionConfig; absent keys keep
+ * their current values. Shared by load_config and per-session overrides.
+ */
+inline void apply_execution_config(ExecutionConfig& exec, const json& e) {
+    exec.enable_latency = e.value("enable_latency", exec.enable_latency);
+    exec.fixed_latency_us = e.value("fixed_latency_us", exec.fixed_latency_us);
+    exec.enable_slippage = e.value("enable_slippage", exec.enable_slippage);
+    exec.fixed_slippage_bps = e.value("fixed_slippage_bps", exec.fixed_slippage_bps);
+    exec.poll_interval_seconds = e.value("poll_interval_seconds", exec.poll_interval_seconds);
+    exec.scheduler_threads = e.value("scheduler_threads", exec.scheduler_threads);
+    exec.scheduler_slice_events = e.value("scheduler_slice_events",
+                                          exec.scheduler_slice_events);
+    exec.control_threads = e.value("control_threads", exec.control_threads);
+    exec.trace_sample_every = e.value("trace_sample_every", exec.trace_sample_every);
+    exec.seek_snapshot_interval_seconds = e.value("seek_snapshot_interval_seconds",
+                                                  exec.seek_snapshot_interval_seconds);
+    exec.seek_snapshot_limit = e.value("seek_snapshot_limit", exec.seek_snapshot_limit);
+    exec.enable_margin_call_checks = e.value("enable_margin_call_checks",
+                                             exec.enable_margin_call_checks);
+    exec.enable_forced_liquidation = e.value("enable_forced_liquidation",
+                                             exec.enable_forced_liquidation);
+    exec.enable_shared_feed = e.value("enable_shared_feed",
+                                      exec.enable_shared_feed);
+    exec.enable_market_impact = e.value("enable_market_impact",
+                                        exec.enable_market_impact);
+    exec.market_impact_bps = e.value("market_impact_bps",
+                                     exec.market_impact_bps);
+    // Extended hours settings
+    exec.enable_extended_hours = e.value("enable_extended_hours",
+                                         exec.enable_extended_hours);
+    exec.enforce_market_hours = e.value("enforce_market_hours",
+                                        exec.enforce_market_hours);
+    exec.premarket_start_minutes = e.value("premarket_start_minutes",
+                                           exec.premarket_start_minutes);
+    exec.regular_start_minutes = e.value("regular_start_minutes",
+                                         exec.regular_start_minutes);
+    exec.regular_end_minutes = e.value("regular_end_minutes",
+                                       exec.regular_end_minutes);
+    exec.afterhours_end_minutes = e.value("afterhours_end_minutes",
+                                          exec.afterhours_end_minutes);
+    exec.extended_hours_slippage_mult = e.value("extended_hours_slippage_mult",
+                                                exec.extended_hours_slippage_mult);
+    exec.extended_hours_liquidity_pct = e.value("extended_hours_liquidity_pct",
+                                                exec.extended_hours_liquidity_pct);
+    exec.allow_shorting = e.value("allow_shorting", exec.allow_shorting);
+    exec.enable_short_sale_restrictions = e.value("enable_short_sale_restrictions",
+                                                  exec.enable_short_sale_restrictions);
+    exec.ssr_threshold_pct = e.value("ssr_threshold_pct", exec.ssr_threshold_pct);
+    exec.enable_short_locate_checks = e.value("enable_short_locate_checks",
+                                              exec.enable_short_locate_checks);
+    exec.short_locate_reject_missing = e.value("short_locate_reject_missing",
+                                               exec.short_locate_reject_missing);
+    exec.short_locate_min_prior_total_volume = e.value(
+        "short_locate_min_prior_total_volume",
+        exec.short_locate_min_prior_total_volume);
+    exec.short_locate_min_prior_short_volume = e.value(
+        "short_locate_min_prior_short_volume",
+        exec.short_locate_min_prior_short_volume);
+    exec.short_locate_min_prior_short_volume_ratio = e.value(
+        "short_locate_min_prior_short_volume_ratio",
+        exec.short_locate_min_prior_short_volume_ratio);
+    exec.short_locate_max_prior_short_volume_ratio = e.value(
+        "short_locate_max_prior_short_volume_ratio",
+        exec.short_locate_max_prior_short_volume_ratio);
+    exec.short_locate_max_age_days = e.value("short_locate_max_age_days",
+                                             exec.short_locate_max_age_days);
+    exec.enable_circuit_breakers = e.value("enable_circuit_breakers", exec.enable_circuit_breakers);
+    exec.luld_tier1_pct = e.value("luld_tier1_pct", exec.luld_tier1_pct);
+    exec.luld_tier2_pct = e.value("luld_tier2_pct", exec.luld_tier2_pct);
+    exec.luld_halt_duration_sec = e.value("luld_halt_duration_sec", exec.luld_halt_duration_sec);
+    if (e.contains("luld_tier1_symbols") && e["luld_tier1_symbols"].is_array()) {
+        exec.luld_tier1_symbols.clear();
+        for (const auto& symbol : e["luld_tier1_symbols"]) {
+            if (symbol.is_string()) {
+                exec.luld_tier1_symbols.push_back(symbol.get<std::string>());
+            }
+        }
+    }
+    if (e.contains("market_holidays") && e["market_holidays"].is_array()) {
+        exec.market_holidays.clear();
+        for (const auto& holiday : e["market_holidays"]) {
+            if (holiday.is_string()) {
+                exec.market_holidays.push_back(holiday.get<std::string>());
+            }
+        }
+    }
+}
+
+/**
+ * Apply a "fees" JSON object onto a FeeConfig; absent keys keep their values.
+ */
+inline void apply_fee_config(FeeConfig& fees, const json& f) {
+    fees.per_share_commission = f.value("per_share_commission", fees.per_share_commission);
+    fees.per_order_commission = f.value("per_order_commission", fees.per_order_commission);
+    fees.sec_fee_per_million = f.value("sec_fee_per_million", fees.sec_fee_per_million);
+    fees.taf_fee_per_share = f.value("taf_fee_per_share", fees.taf_fee_per_share);
+    fees.finra_taf_cap = f.value("finra_taf_cap", fees.finra_taf_cap);
+    fees.maker_rebate_per_share = f.value("maker_rebate_per_share", fees.maker_rebate_per_share);
+    fees.taker_fee_per_share = f.value("taker_fee_per_share", fees.taker_fee_per_share);
+}
+
 inline void load_config(Config& cfg, const std::string& path) {
     std::ifstream f(path);
     if (!f.is_open()) {
@@ -680,79 +823,10 @@ inline void load_config(Config& cfg, const std::string& path) {
         cfg.defaults.live_aggr_bar_stream_freq_ms = d.value("live_aggr_bar_stream_freq", cfg.defaults.live_aggr_bar_stream_freq_ms);
     }
     if (j.contains("execution")) {
-        auto& e = j["execution"];
-        cfg.execution.enable_latency = e.value("enable_latency", cfg.execution.enable_latency);
-        cfg.execution.fixed_latency_us = e.value("fixed_latency_us", cfg.execution.fixed_latency_us);
-        cfg.execution.enable_slippage = e.value("enable_slippage", cfg.execution.enable_slippage);
-        cfg.execution.fixed_slippage_bps = e.value("fixed_slippage_bps", cfg.execution.fixed_slippage_bps);
-        cfg.execution.poll_interval_seconds = e.value("poll_interval_seconds", cfg.execution.poll_interval_seconds);
-        cfg.execution.enable_margin_call_checks = e.value("enable_margin_call_checks",
-                                                         cfg.execution.enable_margin_call_checks);
-        cfg.execution.enable_forced_liquidation = e.value("enable_forced_liquidation",
-                                                         cfg.execution.enable_forced_liquidation);
-        cfg.execution.enable_shared_feed = e.value("enable_shared_feed",
-                                                   cfg.execution.enable_shared_feed);
-        cfg.execution.enable_market_impact = e.value("enable_market_impact",
-                                                    cfg.execution.enable_market_impact);
-        cfg.execution.market_impact_bps = e.value("market_impact_bps",
-                                                 cfg.execution.market_impact_bps);
-        // Extended hours settings
-        cfg.execution.enable_extended_hours = e.value("enable_extended_hours",
-                                                      cfg.execution.enable_extended_hours);
-        cfg.execution.enforce_market_hours = e.value("enforce_market_hours",
-                                                     cfg.execution.enforce_market_hours);
-        cfg.execution.premarket_start_minutes = e.value("premarket_start_minutes",
-                                                        cfg.execution.premarket_start_minutes);
-        cfg.execution.regular_start_minutes = e.value("regular_start_minutes",
-                                                      cfg.execution.regular_start_minutes);
-        cfg.execution.regular_end_minutes = e.value("regular_end_minutes",
-                                                    cfg.execution.regular_end_minutes);
-        cfg.execution.afterhours_end_minutes = e.value("afterhours_end_minutes",
-                                                       cfg.execution.afterhours_end_minutes);
-        cfg.execution.extended_hours_slippage_mult = e.value("extended_hours_slippage_mult",
-                                                             cfg.execution.extended_hours_slippage_mult);
-        cfg.execution.extended_hours_liquidity_pct = e.value("extended_hours_liquidity_pct",
-                                                             cfg.execution.extended_hours_liquidity_pct);
-        cfg.execution.allow_shorting = e.value("allow_shorting", cfg.execution.allow_shorting);
-        cfg.execution.enable_short_sale_restrictions = e.value("enable_short_sale_restrictions",
-                                                               cfg.execution.enable_short_sale_restrictions);
-        cfg.execution.ssr_threshold_pct = e.value("ssr_threshold_pct", cfg.execution.ssr_threshold_pct);
-        cfg.execution.enable_short_locate_checks = e.value("enable_short_locate_checks",
-                                                           cfg.execution.enable_short_locate_checks);
-        cfg.execution.short_locate_reject_missing = e.value("short_locate_reject_missing",
-                                                            cfg.execution.short_locate_reject_missing);
-        cfg.execution.short_locate_min_prior_total_volume = e.value(
-            "short_locate_min_prior_total_volume",
-            cfg.execution.short_locate_min_prior_total_volume);
-        cfg.execution.short_locate_min_prior_short_volume = e.value(
-            "short_locate_min_prior_short_volume",
-            cfg.execution.short_locate_min_prior_short_volume);
-        cfg.execution.short_locate_min_prior_short_volume_ratio = e.value(
-            "short_locate_min_prior_short_volume_ratio",
-            cfg.execution.short_locate_min_prior_short_volume_ratio);
-        cfg.execution.short_locate_max_prior_short_volume_ratio = e.value(
-            "short_locate_max_prior_short_volume_ratio",
-            cfg.execution.short_locate_max_prior_short_volume_ratio);
-        cfg.execution.short_locate_max_age_days = e.value("short_locate_max_age_days",
-                                                          cfg.execution.short_locate_max_age_days);
-        if (e.contains("market_holidays") && e["market_holidays"].is_array()) {
-            cfg.execution.market_holidays.clear();
-            for (const auto& holiday : e["market_holidays"]) {
-                if (holiday.is_string()) {
-                    cfg.execution.market_holidays.push_back(holiday.get<std::string>());
-                }
-            }
-        }
+        apply_execution_config(cfg.execution, j["execution"]);
     }
     if (j.contains("fees")) {
-        auto& f = j["fees"];
-        cfg.fees.per_share_commission = f.value("per_share_commission", cfg.fees.per_share_commission);
-        cfg.fees.per_order_commission = f.value("per_order_commission", cfg.fees.per_order_commission);
-        cfg.fees.sec_fee_per_million = f.value("sec_fee_per_million", cfg.fees.sec_fee_per_million);
-        cfg.fees.taf_fee_per_share = f.value("taf_fee_per_share", cfg.fees.taf_fee_per_share);
-        cfg.fees.finra_taf_cap = f.value("finra_taf_cap", cfg.fees.finra_taf_cap);
-        cfg.fees.maker_rebate_per_share = f.value("maker_rebate_per_share", cfg.fees.maker_rebate_per_share);
-        cfg.fees.taker_fee_per_share = f.value("taker_fee_per_share", cfg.fees.taker_fee_per_share);
+        apply_fee_config(cfg.fees, j["fees"]);
     }
     if (j.contains("websocket")) {
         auto& w = j["websocket"];
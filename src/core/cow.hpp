@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace broker_sim {
+
+/**
+ * Copy-on-write value holder used for state that session forks share.
+ *
+ * Copying a Cow shares the underlying value; the first mutable access through
+ * a shared instance clones it. A fork therefore costs O(1) per container and
+ * each side pays once for the containers it later changes. Like the plain
+ * member it replaces, a Cow is guarded by its owner's mutex; only the sharing
+ * between owners is handled here.
+ */
+template <typename T>
+class Cow {
+public:
+    Cow() : ptr_(std::make_shared<T>()) {}
+    explicit Cow(T value) : ptr_(std::make_shared<T>(std::move(value))) {}
+
+    const T& operator*() const { return *ptr_; }
+    const T* operator->() const { return ptr_.get(); }
+
+    T& mut() {
+        if (ptr_.use_count() > 1) {
+            ptr_ = std::make_shared<T>(*ptr_);
+        } else {
+            // Pairs with the release in the other owner's shared_ptr reset so
+            // its last read of the value happens-before our in-place write.
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *ptr_;
+    }
+
+    bool shared() const { return ptr_.use_count() > 1; }
+
+private:
+    std::shared_ptr<T> ptr_;
+};
+
+} // namespace broker_sim
@@ -0,0 +1,226 @@
+#include "cpu_profiler.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#include <fmt/format.h>
+
+namespace broker_sim {
+
+struct CpuSampleBuffer {
+    explicit CpuSampleBuffer(size_t capacity)
+        : capacity(capacity),
+          frames(capacity * CpuProfiler::kMaxFrames),
+          depth(capacity, 0),
+          skip(capacity, 0) {}
+
+    const size_t capacity;
+    std::vector<void*> frames;    // capacity rows of kMaxFrames, leaf first
+    std::vector<uint8_t> depth;
+    std::vector<uint8_t> skip;    // leading frames belonging to the handler itself
+    std::atomic<size_t> next{0};
+    std::atomic<uint64_t> dropped{0};
+};
+
+namespace {
+
+std::atomic<CpuSampleBuffer*> g_buffer{nullptr};
+std::atomic<int> g_in_handler{0};
+bool g_handler_installed = false;
+
+void* interrupted_pc(void* ucontext) {
+    auto* uc = static_cast<ucontext_t*>(ucontext);
+#if defined(__x86_64__)
+    return reinterpret_cast<void*>(uc->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__aarch64__)
+    return reinterpret_cast<void*>(uc->uc_mcontext.pc);
+#else
+    (void)uc;
+    return nullptr;
+#endif
+}
+
+// Async-signal context: only touches preallocated memory and atomics.
+// backtrace() is safe here once libgcc has been loaded (see start()).
+void on_sigprof(int, siginfo_t*, void* ucontext) {
+    const int saved_errno = errno;
+    g_in_handler.fetch_add(1);
+    if (CpuSampleBuffer* buf = g_buffer.load()) {
+        const size_t slot = buf->next.fetch_add(1, std::memory_order_relaxed);
+        if (slot < buf->capacity) {
+            void** row = &buf->frames[slot * CpuProfiler::kMaxFrames];
+            const int n = backtrace(row, CpuProfiler::kMaxFrames);
+            // Frames above the interrupted instruction are this handler and
+            // the signal trampoline; the PC from the ucontext marks the cut.
+            const void* pc = interrupted_pc(ucontext);
+            int skip = std::min(n, 2);
+            for (int i = 0; i < std::min(n, 4); ++i) {
+                if (row[i] == pc) {
+                    skip = i;
+                    break;
+                }
+            }
+            buf->depth[slot] = static_cast<uint8_t>(n);
+            buf->skip[slot] = static_cast<uint8_t>(skip);
+        } else {
+            buf->dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    g_in_handler.fetch_sub(1);
+    errno = saved_errno;
+}
+
+std::string symbolize(void* addr, bool is_return_address) {
+    // A return address points after the call; step back into the call
+    // instruction so inlined/tail positions resolve to the caller.
+    void* lookup = is_return_address ? static_cast<char*>(addr) - 1 : addr;
+    Dl_info info{};
+    if (dladdr(lookup, &info) == 0) {
+        return fmt::format("[unknown+{:#x}]", reinterpret_cast<uintptr_t>(addr));
+    }
+    std::string name;
+    if (info.dli_sname) {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        name = (status == 0 && demangled) ? demangled : info.dli_sname;
+        std::free(demangled);
+    } else {
+        const char* module = info.dli_fname ? info.dli_fname : "?";
+        if (const char* slash = std::strrchr(module, '/')) module = slash + 1;
+        name = fmt::format("{}+{:#x}", module,
+                           reinterpret_cast<uintptr_t>(addr) - reinterpret_cast<uintptr_t>(info.dli_fbase));
+    }
+    // ';' separates frames in the collapsed format.
+    std::replace(name.begin(), name.end(), ';', ':');
+    return name;
+}
+
+} // namespace
+
+CpuProfiler::CpuProfiler() = default;
+CpuProfiler::~CpuProfiler() = default;
+
+CpuProfiler& CpuProfiler::instance() {
+    static CpuProfiler profiler;
+    return profiler;
+}
+
+bool CpuProfiler::start(int hz, size_t max_samples) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    if (running_.load() || hz <= 0 || max_samples == 0) {
+        return false;
+    }
+
+    if (!g_handler_installed) {
+        // The first backtrace() call dlopens libgcc, which must not happen
+        // inside a signal handler.
+        void* warmup[2];
+        backtrace(warmup, 2);
+
+        // The handler stays installed for the life of the process: a SIGPROF
+        // still in flight after stop() must never reach the default action,
+        // which terminates the process. With no buffer armed it does nothing.
+        struct sigaction sa {};
+        sa.sa_sigaction = on_sigprof;
+        sa.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&sa.sa_mask);
+        if (sigaction(SIGPROF, &sa, nullptr) != 0) {
+            return false;
+        }
+        g_handler_installed = true;
+    }
+
+    buffer_ = std::make_unique<CpuSampleBuffer>(max_samples);
+    hz_ = hz;
+    g_buffer.store(buffer_.get());
+
+    const long interval_us = std::max(1L, 1'000'000L / hz);
+    itimerval timer{};
+    timer.it_interval.tv_sec = interval_us / 1'000'000;
+    timer.it_interval.tv_usec = interval_us % 1'000'000;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        g_buffer.store(nullptr);
+        buffer_.reset();
+        return false;
+    }
+    running_.store(true, std::memory_order_release);
+    return true;
+}
+
+CpuProfiler::Result CpuProfiler::stop() {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    Result result;
+    if (!running_.load()) {
+        return result;
+    }
+
+    itimerval off{};
+    setitimer(ITIMER_PROF, &off, nullptr);
+    g_buffer.store(nullptr);
+    while (g_in_handler.load() != 0) {
+        std::this_thread::yield();
+    }
+    running_.store(false, std::memory_order_release);
+
+    std::unique_ptr<CpuSampleBuffer> buf = std::move(buffer_);
+    const size_t taken = std::min(buf->next.load(), buf->capacity);
+    result.samples = taken;
+    result.dropped = buf->dropped.load();
+    result.hz = hz_;
+
+    // Symbolize each distinct address once, then merge stacks by name so
+    // different PCs within the same function collapse into one line.
+    std::unordered_map<void*, std::string> leaf_names;
+    std::unordered_map<void*, std::string> caller_names;
+    std::map<std::string, uint64_t> stacks;
+    std::string line;
+    for (size_t slot = 0; slot < taken; ++slot) {
+        const int depth = buf->depth[slot];
+        const int skip = buf->skip[slot];
+        if (depth <= skip) continue;
+        void** row = &buf->frames[slot * kMaxFrames];
+
+        line.clear();
+        for (int i = depth - 1; i >= skip; --i) {
+            const bool is_leaf = i == skip;
+            auto& cache = is_leaf ? leaf_names : caller_names;
+            auto it = cache.find(row[i]);
+            if (it == cache.end()) {
+                it = cache.emplace(row[i], symbolize(row[i], !is_leaf)).first;
+            }
+            if (!line.empty()) line += ';';
+            line += it->second;
+        }
+        stacks[line]++;
+    }
+
+    std::vector<std::pair<const std::string*, uint64_t>> ordered;
+    ordered.reserve(stacks.size());
+    for (const auto& [stack, count] : stacks) {
+        ordered.emplace_back(&stack, count);
+    }
+    std::stable_sort(ordered.begin(), ordered.end(),
+                     [](const auto& a, const auto& b) { return a.second > b.second; });
+    for (const auto& [stack, count] : ordered) {
+        result.collapsed += *stack;
+        result.collapsed += ' ';
+        result.collapsed += std::to_string(count);
+        result.collapsed += '\n';
+    }
+    return result;
+}
+
+} // namespace broker_sim
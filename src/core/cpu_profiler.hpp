@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace broker_sim {
+
+struct CpuSampleBuffer;
+
+/**
+ * Process-wide sampling CPU profiler.
+ *
+ * start() arms ITIMER_PROF so the kernel sends SIGPROF to whichever thread
+ * is burning CPU, `hz` times per CPU-second. The handler does nothing but
+ * store a backtrace into a preallocated buffer. stop() disarms the timer,
+ * waits for in-flight handlers and symbolizes the stacks with dladdr and the
+ * C++ demangler. The result is in collapsed-stack format ("root;...;leaf
+ * count" per line), which flamegraph.pl, speedscope and inferno can read.
+ *
+ * Frames in the main executable only resolve to names when it is linked
+ * with -rdynamic (ENABLE_EXPORTS); otherwise they show as module+offset.
+ * Only one capture can run at a time.
+ */
+class CpuProfiler {
+public:
+    static constexpr int kMaxFrames = 48;
+
+    struct Result {
+        uint64_t samples{0};
+        uint64_t dropped{0};   // signals that arrived after the buffer filled
+        int hz{0};
+        std::string collapsed;
+    };
+
+    static CpuProfiler& instance();
+
+    /** Begin sampling; false if a capture is already running or the timer cannot be armed. */
+    bool start(int hz, size_t max_samples);
+
+    /** End the current capture and return its stacks; empty if none was running. */
+    Result stop();
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+
+private:
+    CpuProfiler();
+    ~CpuProfiler();
+
+    std::mutex control_mutex_;
+    std::atomic<bool> running_{false};
+    std::unique_ptr<CpuSampleBuffer> buffer_;
+    int hz_{0};
+};
+
+} // namespace broker_sim
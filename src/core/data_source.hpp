@@ -688,7 +688,8 @@ public:
                                     Timestamp end_time,
                                     const std::function<void(const BarRecord&)>& cb) = 0;
 
-    // Stream aggregate bars without also replaying trades/quotes.
+    // Stream aggregate bars without also replaying trades/quotes. Daily bars
+    // ("day") are stamped with their trading date at 00:00 UTC.
     virtual void stream_aggregate_bars(const std::vector<std::string>& symbols,
                                        Timestamp start_time,
                                        Timestamp end_time,
@@ -7,9 +7,31 @@
 #include <limits>
 #include <cstdint>
 #include <nlohmann/json.hpp>
+#include "metrics.hpp"
 
 namespace {
 
+// Runs a SELECT, recording its wall time (including the row callbacks) and
+// row count under `op`.
+template <typename OnBlock>
+void select_timed(clickhouse::Client& client, const char* op, const std::string& query, OnBlock&& on_block) {
+    auto& metrics = broker_sim::MetricsRegistry::instance();
+    const broker_sim::MetricLabels labels{{"op", op}};
+    auto duration = metrics.histogram("broker_clickhouse_query_seconds", "ClickHouse SELECT wall time", labels);
+    auto rows = metrics.counter("broker_clickhouse_rows_total", "Rows returned by ClickHouse", labels);
+    const auto started = std::chrono::steady_clock::now();
+    try {
+        client.Select(query, [&](const clickhouse::Block& block) {
+            rows->add(block.GetRowCount());
+            on_block(block);
+        });
+    } catch (...) {
+        metrics.counter("broker_clickhouse_query_errors_total", "Failed ClickHouse SELECTs", labels)->add();
+        throw;
+    }
+    duration->record_since(started);
+}
+
 std::tm gmtime_utc(std::time_t tt) {
     std::tm tm{};
     gmtime_r(&tt, &tm);
@@ -131,7 +153,7 @@ void ClickHouseDataSource::stream_trades(const std::vector<std::string>& symbols
                                          Timestamp start_time,
                                          Timestamp end_time,
                                          const std::function<void(const TradeRecord&)>& cb) {
-    std::lock_guard<std::mutex> lock(client_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(client_mutex_);
     if (!client_) return;
     std::string sym_list = build_symbol_list(symbols);
     auto start_str = format_timestamp(start_time);
@@ -147,7 +169,7 @@ void ClickHouseDataSource::stream_trades(const std::vector<std::string>& symbols
         ORDER BY timestamp ASC
     )", sym_list, start_str, end_str, realtime_trade_sql_filter());
 
-    client_->Select(query, [&cb](const clickhouse::Block& block) {
+    select_timed(*client_, "stream_trades", query, [&cb](const clickhouse::Block& block) {
         for (size_t row = 0; row < block.GetRowCount(); ++row) {
             TradeRecord tr;
             tr.timestamp = extract_ts(block[0], row);
@@ -169,7 +191,7 @@ void ClickHouseDataSource::stream_quotes(const std::vector<std::string>& symbols
                                          Timestamp start_time,
                                          Timestamp end_time,
                                          const std::function<void(const QuoteRecord&)>& cb) {
-    std::lock_guard<std::mutex> lock(client_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(client_mutex_);
     if (!client_) return;
     std::string sym_list = build_symbol_list(symbols);
     auto start_str = format_timestamp(start_time);
@@ -183,7 +205,7 @@ void ClickHouseDataSource::stream_quotes(const std::vector<std::string>& symbols
         ORDER BY sip_timestamp ASC
     )", sym_list, start_str, end_str);
 
-    client_->Select(query, [&cb](const clickhouse::Block& block) {
+    select_timed(*client_, "stream_quotes", query, [&cb](const clickhouse::Block& block) {
         for (size_t row = 0; row < block.GetRowCount(); ++row) {
             QuoteRecord q;
             q.timestamp = extract_ts(block[0], row);
@@ -205,7 +227,7 @@ void ClickHouseDataSource::stream_events(const std::vector<std::string>& symbols
                                          Timestamp end_time,
                                          const std::function<void(const MarketEvent&)>& cb) {
     // Serialize shared client access; libclickhouse-cpp client is not thread-safe.
-    std::lock_guard<std::mutex> lock(client_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(client_mutex_);
     // Reconnect if client is null or stale
     if (!client_) {
         spdlog::info("ClickHouse client not connected, reconnecting...");
@@ -275,7 +297,7 @@ void ClickHouseDataSource::stream_events(const std::vector<std::string>& symbols
 
     // Execute query with auto-reconnect on network errors
     auto execute_query = [&]() {
-        client_->Select(query, [&](const clickhouse::Block& block) {
+        select_timed(*client_, "stream_events", query, [&](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 MarketEvent ev;
                 ev.timestamp = extract_ts(block[0], row);
@@ -337,7 +359,7 @@ void ClickHouseDataSource::stream_second_bars(const std::vector<std::string>& sy
                                               Timestamp end_time,
                                               const std::function<void(const BarRecord&)>& cb) {
     // Serialize shared client access; libclickhouse-cpp client is not thread-safe.
-    std::lock_guard<std::mutex> lock(client_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(client_mutex_);
     if (!client_) {
         spdlog::info("ClickHouse client not connected, reconnecting...");
         connect();
@@ -371,7 +393,7 @@ void ClickHouseDataSource::stream_second_bars(const std::vector<std::string>& sy
     size_t total_bars = 0;
 
     auto execute_query = [&]() {
-        client_->Select(query, [&](const clickhouse::Block& block) {
+        select_timed(*client_, "stream_second_bars", query, [&](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 BarRecord bar;
                 bar.timestamp = extract_ts(block[0], row);
@@ -408,7 +430,7 @@ void ClickHouseDataSource::stream_aggregate_bars(const std::vector<std::string>&
                                                  int multiplier,
                                                  const std::string& timespan,
                                                  const std::function<void(const BarRecord&)>& cb) {
-    std::lock_guard<std::mutex> lock(client_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(client_mutex_);
     if (!client_) {
         spdlog::info("ClickHouse client not connected, reconnecting...");
         connect();
@@ -420,6 +442,7 @@ void ClickHouseDataSource::stream_aggregate_bars(const std::vector<std::string>&
     });
     if (normalized_span == "sec" || normalized_span == "s") normalized_span = "second";
     if (normalized_span == "min" || normalized_span == "m") normalized_span = "minute";
+    if (normalized_span == "d") normalized_span = "day";
 
     auto resolve_bar_table = [&](const std::string& span, int mult) -> std::string {
         if (span == "second") {
@@ -435,6 +458,8 @@ void ClickHouseDataSource::stream_aggregate_bars(const std::vector<std::string>&
             if (mult == 10) return "stock_10m_bars";
             if (mult == 15) return "stock_15m_bars";
             if (mult == 30) return "stock_30m_bars";
+        } else if (span == "day") {
+            if (mult == 1) return "stock_daily_bars";
         }
         return "";
     };
@@ -447,12 +472,13 @@ void ClickHouseDataSource::stream_aggregate_bars(const std::vector<std::string>&
     }
 
     const auto trade_count_column = trade_count_column_for_table(table);
+    const auto time_expr = bar_time_expr_for_table(table);
     const std::string sym_list = build_symbol_list(symbols);
     const auto start_str = format_timestamp_precise(start_time);
     const auto end_str = format_timestamp_precise(end_time);
     const std::string query = fmt::format(R"(
         SELECT
-            toDateTime64(timestamp, 9) AS ts,
+            {} AS ts,
             CAST(symbol AS String) AS symbol,
             toFloat64(open) AS open,
             toFloat64(high) AS high,
@@ -463,10 +489,11 @@ void ClickHouseDataSource::stream_aggregate_bars(const std::vector<std::string>&
             toUInt64({}) AS trade_count
         FROM {}.{}
         WHERE symbol IN ({})
-          AND timestamp >= '{}'
-          AND timestamp < '{}'
-        ORDER BY timestamp ASC, symbol ASC
-    )", trade_count_column, cfg_.database, table, sym_list, start_str, end_str);
+          AND {} >= toDateTime64('{}', 9)
+          AND {} < toDateTime64('{}', 9)
+        ORDER BY ts ASC, symbol ASC
+    )", time_expr, trade_count_column, cfg_.database, table, sym_list,
+       time_expr, start_str, time_expr, end_str);
 
     spdlog::info("Starting ClickHouse aggregate bar stream for {} symbols, {} {} bars, {} to {}",
                  symbols.size(), mult, normalized_span, start_str, end_str);
@@ -474,7 +501,7 @@ void ClickHouseDataSource::stream_aggregate_bars(const std::vector<std::string>&
     size_t total_bars = 0;
 
     auto execute_query = [&]() {
-        client_->Select(query, [&](const clickhouse::Block& block) {
+        select_timed(*client_, "stream_aggregate_bars", query, [&](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 BarRecord bar;
                 bar.timestamp = extract_ts_any(block[0], row);
@@ -510,7 +537,7 @@ void ClickHouseDataSource::stream_events_with_bars(const std::vector<std::string
                                                    Timestamp end_time,
                                                    const std::function<void(const UnifiedMarketEvent&)>& cb) {
     // Serialize shared client access; libclickhouse-cpp client is not thread-safe.
-    std::lock_guard<std::mutex> lock(client_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(client_mutex_);
     if (!client_) {
         spdlog::info("ClickHouse client not connected, reconnecting...");
         connect();
@@ -629,7 +656,7 @@ void ClickHouseDataSource::stream_events_with_bars(const std::vector<std::string
     size_t total_events = 0;
 
     auto execute_query = [&]() {
-        client_->Select(query, [&](const clickhouse::Block& block) {
+        select_timed(*client_, "stream_events_with_bars", query, [&](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 UnifiedMarketEvent ev;
                 ev.timestamp = extract_ts(block[0], row);
@@ -739,7 +766,7 @@ std::vector<TradeRecord> ClickHouseDataSource::get_trades(const std::string& sym
             {}
         )", symbol, start_str, end_str, realtime_trade_sql_filter(), limit_clause);
 
-        client.Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(client, "get_trades", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 TradeRecord tr;
                 tr.timestamp = extract_ts_any(block[0], row);
@@ -790,7 +817,7 @@ std::vector<QuoteRecord> ClickHouseDataSource::get_quotes(const std::string& sym
             {}
         )", symbol, start_str, end_str, limit_clause);
 
-        client.Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(client, "get_quotes", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 QuoteRecord q;
                 q.timestamp = extract_ts(block[0], row);
@@ -939,7 +966,7 @@ std::vector<BarRecord> ClickHouseDataSource::get_bars(const std::string& symbol,
                limit_clause);
         }
 
-        client.Select(query, [&out, &symbol](const clickhouse::Block& block) {
+        select_timed(client, "get_bars", query, [&out, &symbol](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 BarRecord b;
                 b.open = 0.0;
@@ -986,7 +1013,7 @@ std::vector<CompanyNewsRecord> ClickHouseDataSource::get_company_news(const std:
         {}
     )", symbol, start_str, end_str, limit_clause(limit));
     auto run_select = [&]() {
-        client_->Select(query, [&out, &symbol](const clickhouse::Block& block) {
+        select_timed(*client_, "get_company_news", query, [&out, &symbol](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 CompanyNewsRecord n;
                 n.symbol = symbol;
@@ -1021,7 +1048,7 @@ std::vector<CompanyNewsRecord> ClickHouseDataSource::get_company_news(const std:
 }
 
 std::optional<CompanyProfileRecord> ClickHouseDataSource::get_company_profile(const std::string& symbol) {
-    std::lock_guard<std::mutex> lock(client_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(client_mutex_);
     if (!client_) return std::nullopt;
     // LowCardinality(String) columns need CAST(... AS String) for clickhouse-cpp
     std::string query = fmt::format(R"(
@@ -1037,7 +1064,7 @@ std::optional<CompanyProfileRecord> ClickHouseDataSource::get_company_profile(co
     )", symbol);
     std::optional<CompanyProfileRecord> out;
     auto run_select = [&]() {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_company_profile", query, [&out](const clickhouse::Block& block) {
             if (block.GetRowCount() == 0) return;
             CompanyProfileRecord p;
             p.symbol = block[0]->As<clickhouse::ColumnString>()->At(0);
@@ -1086,7 +1113,7 @@ std::vector<std::string> ClickHouseDataSource::get_company_peers(const std::stri
         {}
     )", symbol, limit_clause(limit));
     try {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_company_peers", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 auto sv = block[0]->As<clickhouse::ColumnString>()->At(row);
                 out.emplace_back(sv.data(), sv.size());
@@ -1113,7 +1140,7 @@ std::optional<NewsSentimentRecord> ClickHouseDataSource::get_news_sentiment(cons
     )", symbol);
     std::optional<NewsSentimentRecord> out;
     try {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_news_sentiment", query, [&out](const clickhouse::Block& block) {
             if (block.GetRowCount() == 0) return;
             NewsSentimentRecord s;
             s.symbol = block[0]->As<clickhouse::ColumnString>()->At(0);
@@ -1175,7 +1202,7 @@ std::optional<BasicFinancialsRecord> ClickHouseDataSource::get_basic_financials(
         )", escaped_symbol, as_of_date);
         std::optional<BasicFinancialsRecord> out;
         try {
-            client.Select(query, [&out](const clickhouse::Block& block) {
+            select_timed(client, "get_basic_financials", query, [&out](const clickhouse::Block& block) {
                 if (block.GetRowCount() == 0) return;
                 BasicFinancialsRecord b;
                 b.symbol = block[0]->As<clickhouse::ColumnString>()->At(0);
@@ -1213,7 +1240,7 @@ std::optional<BasicFinancialsRecord> ClickHouseDataSource::get_basic_financials(
     )", escaped_symbol);
     std::optional<BasicFinancialsRecord> out;
     try {
-        client.Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(client, "get_basic_financials", query, [&out](const clickhouse::Block& block) {
             if (block.GetRowCount() == 0) return;
             BasicFinancialsRecord b;
             b.symbol = block[0]->As<clickhouse::ColumnString>()->At(0);
@@ -1265,7 +1292,7 @@ std::vector<DividendRecord> ClickHouseDataSource::get_dividends(const std::strin
         {}
     )", symbol, start_str, end_str, limit_clause(limit));
     try {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_dividends", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 DividendRecord d;
                 d.symbol = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -1400,7 +1427,7 @@ std::vector<DividendRecord> ClickHouseDataSource::get_stock_dividends(const Stoc
             {}
         )", where_clause, sort_col, order, limit_clause);
 
-        client.Select(sql, [&out](const clickhouse::Block& block) {
+        select_timed(client, "get_stock_dividends", sql, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 DividendRecord d;
                 d.id = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -1497,7 +1524,7 @@ std::vector<StockSplitRecord> ClickHouseDataSource::get_stock_splits(const Stock
             {}
         )", where_clause, sort_col, order, limit_clause);
 
-        client.Select(sql, [&out](const clickhouse::Block& block) {
+        select_timed(client, "get_stock_splits", sql, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 StockSplitRecord s;
                 s.id = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -1670,7 +1697,7 @@ std::vector<StockNewsRecord> ClickHouseDataSource::get_stock_news(const StockNew
             return out;
         };
 
-        client.Select(sql, [&out, &read_array](const clickhouse::Block& block) {
+        select_timed(client, "get_stock_news", sql, [&out, &read_array](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 StockNewsRecord n;
                 n.id = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -1736,7 +1763,7 @@ std::vector<StockNewsInsightRecord> ClickHouseDataSource::get_stock_news_insight
             ORDER BY published_utc DESC
         )", id_list);
 
-        client.Select(sql, [&out](const clickhouse::Block& block) {
+        select_timed(client, "get_stock_news_insights", sql, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 StockNewsInsightRecord ins;
                 ins.article_id = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -1819,7 +1846,7 @@ std::vector<StockTickerEventRecord> ClickHouseDataSource::get_stock_ticker_event
             LIMIT {}
         )", where_clause, sort_col, order, limit);
 
-        client.Select(sql, [&out](const clickhouse::Block& block) {
+        select_timed(client, "get_stock_ticker_events", sql, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 StockTickerEventRecord r;
                 r.entity_name = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -1963,7 +1990,7 @@ std::vector<TickerBasicRecord> ClickHouseDataSource::get_tickers(const broker_si
             limit,
             query.offset);
 
-        client.Select(sql, [&out](const clickhouse::Block& block) {
+        select_timed(client, "get_tickers", sql, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 TickerBasicRecord rec;
                 rec.ticker = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -2128,7 +2155,7 @@ std::vector<StockIpoRecord> ClickHouseDataSource::get_stock_ipos(const StockIpos
             {}
         )", where_clause, sort_col, order, limit_clause);
 
-        client.Select(sql, [&out](const clickhouse::Block& block) {
+        select_timed(client, "get_stock_ipos", sql, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 StockIpoRecord r;
                 r.ticker = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -2218,7 +2245,7 @@ std::vector<StockShortInterestRecord> ClickHouseDataSource::get_stock_short_inte
             {}
         )", where_clause, sort_col, order, limit_clause);
 
-        client.Select(sql, [&out](const clickhouse::Block& block) {
+        select_timed(client, "get_stock_short_interest", sql, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 StockShortInterestRecord r;
                 r.ticker = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -2301,7 +2328,7 @@ std::vector<StockShortVolumeRecord> ClickHouseDataSource::get_stock_short_volume
             {}
         )", where_clause, sort_col, order, limit_clause);
 
-        client.Select(sql, [&out](const clickhouse::Block& block) {
+        select_timed(client, "get_stock_short_volume", sql, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 StockShortVolumeRecord r;
                 r.ticker = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -2420,7 +2447,7 @@ std::optional<TopMoversSnapshotRecord> ClickHouseDataSource::get_top_gainers_sna
             LIMIT 1
         )", ts, ts);
 
-        client.Select(sql, [&](const clickhouse::Block& block) {
+        select_timed(client, "get_top_gainers_snapshot", sql, [&](const clickhouse::Block& block) {
             if (snapshot || block.GetRowCount() == 0) {
                 return;
             }
@@ -2562,7 +2589,7 @@ std::optional<TopMoversSnapshotRecord> ClickHouseDataSource::get_top_losers_snap
             LIMIT 1
         )", ts, ts);
 
-        client.Select(sql, [&](const clickhouse::Block& block) {
+        select_timed(client, "get_top_losers_snapshot", sql, [&](const clickhouse::Block& block) {
             if (snapshot || block.GetRowCount() == 0) {
                 return;
             }
@@ -2775,7 +2802,7 @@ std::vector<FinancialsRecord> ClickHouseDataSource::get_stock_financials(const F
             return std::nullopt;
         };
 
-        client.Select(sql, [&out, &set_val, &parse_json, &json_number](const clickhouse::Block& block) {
+        select_timed(client, "get_stock_financials", sql, [&out, &set_val, &parse_json, &json_number](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 FinancialsRecord r;
                 r.ticker = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -3004,7 +3031,7 @@ std::vector<SplitRecord> ClickHouseDataSource::get_splits(const std::string& sym
         {}
     )", symbol, start_str, end_str, limit_clause(limit));
     try {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_splits", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 SplitRecord s;
                 s.symbol = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -3025,7 +3052,7 @@ std::vector<EarningsCalendarRecord> ClickHouseDataSource::get_earnings_calendar(
                                                                                 Timestamp start_time,
                                                                                 Timestamp end_time,
                                                                                 size_t limit) {
-    std::lock_guard<std::mutex> lock(client_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(client_mutex_);
     std::vector<EarningsCalendarRecord> out;
     if (!client_) return out;
     auto start_str = format_timestamp(start_time);
@@ -3051,7 +3078,7 @@ std::vector<EarningsCalendarRecord> ClickHouseDataSource::get_earnings_calendar(
         {}
     )", start_str, end_str, where_symbol, limit_clause(limit));
     auto run_select = [&]() {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_earnings_calendar", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 EarningsCalendarRecord e;
                 e.symbol = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -3090,7 +3117,7 @@ std::vector<RecommendationRecord> ClickHouseDataSource::get_recommendation_trend
                                                                                   Timestamp start_time,
                                                                                   Timestamp end_time,
                                                                                   size_t limit) {
-    std::lock_guard<std::mutex> lock(client_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(client_mutex_);
     std::vector<RecommendationRecord> out;
     if (!client_) return out;
     auto start_str = format_timestamp(start_time);
@@ -3106,7 +3133,7 @@ std::vector<RecommendationRecord> ClickHouseDataSource::get_recommendation_trend
         {}
     )", symbol, start_str, end_str, limit_clause(limit));
     auto run_select = [&]() {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_recommendation_trends", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 RecommendationRecord r;
                 r.symbol = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -3150,7 +3177,7 @@ std::optional<PriceTargetRecord> ClickHouseDataSource::get_price_targets(const s
     )", symbol);
     std::optional<PriceTargetRecord> out;
     try {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_price_targets", query, [&out](const clickhouse::Block& block) {
             if (block.GetRowCount() == 0) return;
             PriceTargetRecord p;
             p.symbol = block[0]->As<clickhouse::ColumnString>()->At(0);
@@ -3172,7 +3199,7 @@ std::vector<UpgradeDowngradeRecord> ClickHouseDataSource::get_upgrades_downgrade
                                                                                  Timestamp start_time,
                                                                                  Timestamp end_time,
                                                                                  size_t limit) {
-    std::lock_guard<std::mutex> lock(client_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(client_mutex_);
     std::vector<UpgradeDowngradeRecord> out;
     if (!client_) return out;
     auto start_str = format_timestamp(start_time);
@@ -3193,7 +3220,7 @@ std::vector<UpgradeDowngradeRecord> ClickHouseDataSource::get_upgrades_downgrade
         {}
     )", start_str, end_str, where_symbol, limit_clause(limit));
     auto run_select = [&]() {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_upgrades_downgrades", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 UpgradeDowngradeRecord u;
                 u.symbol = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -3239,7 +3266,7 @@ std::vector<FinnhubIpoRecord> ClickHouseDataSource::get_finnhub_ipo_calendar(Tim
         {}
     )", start_str, end_str, limit_clause(limit));
     try {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_finnhub_ipo_calendar", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 FinnhubIpoRecord r;
                 r.symbol = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -3277,7 +3304,7 @@ std::vector<CompanyNewsRecord> ClickHouseDataSource::get_finnhub_market_news(Tim
         {}
     )", start_str, end_str, limit_clause(limit));
     auto run_select = [&]() {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_finnhub_market_news", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 CompanyNewsRecord n;
                 n.symbol.clear();
@@ -3315,7 +3342,7 @@ void ClickHouseDataSource::stream_company_news(const std::vector<std::string>& s
                                                Timestamp start_time,
                                                Timestamp end_time,
                                                const std::function<void(const CompanyNewsRecord&)>& cb) {
-    std::lock_guard<std::mutex> lock(client_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(client_mutex_);
     if (symbols.empty()) {
         spdlog::info("ClickHouse stream_company_news skipped: empty symbol list");
         return;
@@ -3341,7 +3368,7 @@ void ClickHouseDataSource::stream_company_news(const std::vector<std::string>& s
 
     size_t emitted_rows = 0;
     auto run_select = [&]() {
-        client_->Select(query, [&cb, &emitted_rows](const clickhouse::Block& block) {
+        select_timed(*client_, "stream_company_news", query, [&cb, &emitted_rows](const clickhouse::Block& block) {
             emitted_rows += block.GetRowCount();
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 CompanyNewsRecord n;
@@ -3386,7 +3413,7 @@ void ClickHouseDataSource::stream_company_news(const std::vector<std::string>& s
 void ClickHouseDataSource::stream_finnhub_market_news(Timestamp start_time,
                                                       Timestamp end_time,
                                                       const std::function<void(const CompanyNewsRecord&)>& cb) {
-    std::lock_guard<std::mutex> lock(client_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(client_mutex_);
     if (!client_) {
         spdlog::info("ClickHouse client not connected for stream_finnhub_market_news, reconnecting...");
         connect();
@@ -3405,7 +3432,7 @@ void ClickHouseDataSource::stream_finnhub_market_news(Timestamp start_time,
 
     size_t emitted_rows = 0;
     auto run_select = [&]() {
-        client_->Select(query, [&cb, &emitted_rows](const clickhouse::Block& block) {
+        select_timed(*client_, "stream_finnhub_market_news", query, [&cb, &emitted_rows](const clickhouse::Block& block) {
             emitted_rows += block.GetRowCount();
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 CompanyNewsRecord n;
@@ -3452,7 +3479,7 @@ std::vector<FinnhubInsiderTransactionRecord> ClickHouseDataSource::get_finnhub_i
     Timestamp start_time,
     Timestamp end_time,
     size_t limit) {
-    std::lock_guard<std::mutex> lock(client_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(client_mutex_);
     std::vector<FinnhubInsiderTransactionRecord> out;
     if (!client_) return out;
     auto start_str = format_timestamp(start_time);
@@ -3473,7 +3500,7 @@ std::vector<FinnhubInsiderTransactionRecord> ClickHouseDataSource::get_finnhub_i
         {}
     )", start_str, end_str, where_symbol, limit_clause(limit));
     try {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_finnhub_insider_transactions", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 FinnhubInsiderTransactionRecord r;
                 r.symbol = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -3499,7 +3526,7 @@ std::vector<FinnhubSecFilingRecord> ClickHouseDataSource::get_finnhub_sec_filing
                                                                                   Timestamp start_time,
                                                                                   Timestamp end_time,
                                                                                   size_t limit) {
-    std::lock_guard<std::mutex> lock(client_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(client_mutex_);
     std::vector<FinnhubSecFilingRecord> out;
     if (!client_) return out;
     auto start_str = format_timestamp(start_time);
@@ -3519,7 +3546,7 @@ std::vector<FinnhubSecFilingRecord> ClickHouseDataSource::get_finnhub_sec_filing
         {}
     )", start_str, end_str, where_symbol, limit_clause(limit));
     auto run_select = [&]() {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_finnhub_sec_filings", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 FinnhubSecFilingRecord r;
                 r.symbol = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -3574,7 +3601,7 @@ std::vector<FinnhubCongressionalTradingRecord> ClickHouseDataSource::get_finnhub
         {}
     )", start_str, end_str, where_symbol, limit_clause(limit));
     try {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_finnhub_congressional_trading", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 FinnhubCongressionalTradingRecord r;
                 r.symbol = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -3621,7 +3648,7 @@ std::vector<FinnhubInsiderSentimentRecord> ClickHouseDataSource::get_finnhub_ins
         {}
     )", start_str, end_str, where_symbol, limit_clause(limit));
     try {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_finnhub_insider_sentiment", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 FinnhubInsiderSentimentRecord r;
                 r.symbol = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -3673,7 +3700,7 @@ std::vector<FinnhubEpsEstimateRecord> ClickHouseDataSource::get_finnhub_eps_esti
         {}
     )", start_str, end_str, where_symbol, where_freq, limit_clause(limit));
     try {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_finnhub_eps_estimates", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 FinnhubEpsEstimateRecord r;
                 r.symbol = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -3730,7 +3757,7 @@ std::vector<FinnhubRevenueEstimateRecord> ClickHouseDataSource::get_finnhub_reve
         {}
     )", start_str, end_str, where_symbol, where_freq, limit_clause(limit));
     try {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_finnhub_revenue_estimates", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 FinnhubRevenueEstimateRecord r;
                 r.symbol = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -3776,7 +3803,7 @@ std::vector<FinnhubEarningsHistoryRecord> ClickHouseDataSource::get_finnhub_earn
         {}
     )", start_str, end_str, where_symbol, limit_clause(limit));
     try {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_finnhub_earnings_history", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 FinnhubEarningsHistoryRecord r;
                 r.symbol = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -3821,7 +3848,7 @@ std::vector<FinnhubSocialSentimentRecord> ClickHouseDataSource::get_finnhub_soci
         {}
     )", start_str, end_str, where_symbol, limit_clause(limit));
     try {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_finnhub_social_sentiment", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 FinnhubSocialSentimentRecord r;
                 r.symbol = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -3868,7 +3895,7 @@ std::vector<FinnhubOwnershipRecord> ClickHouseDataSource::get_finnhub_ownership(
         {}
     )", date_expr, start_str, end_str, where_symbol, limit_clause(limit));
     try {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_finnhub_ownership", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 FinnhubOwnershipRecord r;
                 r.symbol = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -3924,7 +3951,7 @@ std::vector<FinnhubFinancialsStandardizedRecord> ClickHouseDataSource::get_finnh
         {}
     )", start_str, end_str, where_symbol, where_statement, where_freq, limit_clause(limit));
     try {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_finnhub_financials_standardized", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 FinnhubFinancialsStandardizedRecord r;
                 r.symbol = block[0]->As<clickhouse::ColumnString>()->At(row);
@@ -3973,7 +4000,7 @@ std::vector<FinnhubFinancialsReportedRecord> ClickHouseDataSource::get_finnhub_f
         {}
     )", start_str, end_str, where_symbol, where_freq, limit_clause(limit));
     try {
-        client_->Select(query, [&out](const clickhouse::Block& block) {
+        select_timed(*client_, "get_finnhub_financials_reported", query, [&out](const clickhouse::Block& block) {
             for (size_t row = 0; row < block.GetRowCount(); ++row) {
                 FinnhubFinancialsReportedRecord r;
                 r.symbol = block[0]->As<clickhouse::ColumnString>()->At(row);
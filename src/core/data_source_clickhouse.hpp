@@ -1,6 +1,7 @@
 #pragma once
 
 #include "data_source.hpp"
+#include "instrumented_mutex.hpp"
 #include <clickhouse/client.h>
 #include <spdlog/spdlog.h>
 #include <spdlog/fmt/fmt.h>
@@ -228,7 +229,7 @@ private:
 
     ClickHouseConfig cfg_;
     std::unique_ptr<clickhouse::Client> client_;
-    mutable std::mutex client_mutex_;  // Protects client_ from concurrent access
+    mutable InstrumentedMutex client_mutex_{"clickhouse.client"};  // Protects client_ from concurrent access
 };
 
 } // namespace broker_sim
@@ -4,11 +4,13 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <optional>
 #include <queue>
 #include <string>
 #include <thread>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -110,6 +112,8 @@ struct Event {
     EventType event_type;
     std::string symbol;
     EventPayload data;
+    int64_t enqueued_ns{0};  // steady_clock at EventQueue::push, for queue wait metrics
+    int64_t decoded_ns{0};   // steady_clock at decode when sampled for tracing, else 0
 
     bool operator>(const Event& other) const {
         if (timestamp != other.timestamp) {
@@ -125,21 +129,66 @@ public:
         : max_size_(max_size), overflow_policy_(std::move(overflow_policy)), sequence_(0) {}
 
     // Returns true if enqueued, false if dropped.
-    bool push(Timestamp ts, EventType type, const std::string& symbol, EventPayload data) {
-        if (stopped_.load(std::memory_order_acquire)) return false;
-        Event ev{ts, sequence_.fetch_add(1, std::memory_order_relaxed), type, symbol, std::move(data)};
-        std::lock_guard<std::mutex> lock(mutex_);
+    bool push(Timestamp ts, EventType type, const std::string& symbol, EventPayload data,
+              int64_t decoded_ns = 0) {
         if (stopped_.load(std::memory_order_acquire)) return false;
-        if (max_size_ > 0 && heap_.size() >= max_size_) {
-            if (overflow_policy_ == "drop_oldest") {
-                if (!heap_.empty()) heap_.pop();
-            } else {
-                dropped_count_.fetch_add(1, std::memory_order_relaxed);
-                return false;
+        Event ev{ts, sequence_.fetch_add(1, std::memory_order_relaxed), type, symbol, std::move(data),
+                 std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now().time_since_epoch()).count(),
+                 decoded_ns};
+        std::function<void()> wake;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopped_.load(std::memory_order_acquire)) return false;
+            if (max_size_ > 0 && heap_.size() >= max_size_) {
+                if (overflow_policy_ == "drop_oldest") {
+                    if (!heap_.empty()) heap_.pop();
+                } else {
+                    dropped_count_.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
             }
+            heap_.push(std::move(ev));
+            cv_.notify_one();
+            wake = std::exchange(wakeup_, nullptr);
         }
-        heap_.push(std::move(ev));
-        cv_.notify_one();
+        if (wake) wake();
+        return true;
+    }
+
+    // Like push(), but a full bounded queue makes the caller wait for the
+    // consumer to pop instead of applying the overflow policy. Only for
+    // producers on their own thread; returns false once the queue is stopped.
+    bool push_wait(Timestamp ts, EventType type, const std::string& symbol, EventPayload data,
+                   int64_t decoded_ns = 0) {
+        if (stopped_.load(std::memory_order_acquire)) return false;
+        Event ev{ts, sequence_.fetch_add(1, std::memory_order_relaxed), type, symbol, std::move(data),
+                 std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now().time_since_epoch()).count(),
+                 decoded_ns};
+        std::function<void()> wake;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            space_cv_.wait(lock, [&] {
+                return stopped_.load(std::memory_order_acquire) || max_size_ == 0 || heap_.size() < max_size_;
+            });
+            if (stopped_.load(std::memory_order_acquire)) return false;
+            heap_.push(std::move(ev));
+            cv_.notify_one();
+            wake = std::exchange(wakeup_, nullptr);
+        }
+        if (wake) wake();
+        return true;
+    }
+
+    // Arms a one-shot callback for the next push() or stop(), run on the
+    // caller's thread after the queue lock is released. Returns false without
+    // arming when an event is already queued or the queue is stopped, so the
+    // consumer should keep popping rather than wait.
+    bool notify_when_ready(std::function<void()> wakeup) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!heap_.empty() || stopped_.load(std::memory_order_acquire)) return false;
+        wakeup_ = std::move(wakeup);
         return true;
     }
 
@@ -148,6 +197,7 @@ public:
         if (heap_.empty()) return std::nullopt;
         Event ev = heap_.top();  // Copy, not move - pop() needs valid top element
         heap_.pop();
+        if (max_size_ > 0) space_cv_.notify_one();
         return ev;
     }
 
@@ -157,6 +207,7 @@ public:
         if (stopped_.load(std::memory_order_acquire) && heap_.empty()) return std::nullopt;
         Event ev = heap_.top();  // Copy, not move - pop() needs valid top element
         heap_.pop();
+        if (max_size_ > 0) space_cv_.notify_one();
         return ev;
     }
 
@@ -184,13 +235,25 @@ public:
         std::lock_guard<std::mutex> lock(mutex_);
         while (!heap_.empty()) heap_.pop();
         sequence_.store(0, std::memory_order_relaxed);
+        space_cv_.notify_all();
     }
 
     void stop() {
-        stopped_.store(true, std::memory_order_release);
+        std::function<void()> wake;
+        {
+            // Under the lock so a producer between its predicate check and
+            // the wait cannot miss the wakeup.
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_.store(true, std::memory_order_release);
+            wake = std::exchange(wakeup_, nullptr);
+        }
         cv_.notify_all();
+        space_cv_.notify_all();
+        if (wake) wake();
     }
 
+    bool stopped() const { return stopped_.load(std::memory_order_acquire); }
+
     void reset() {
         stopped_.store(false, std::memory_order_release);
     }
@@ -204,6 +267,8 @@ private:
     std::atomic<bool> stopped_{false};
     mutable std::mutex mutex_;
     std::condition_variable cv_;
+    std::condition_variable space_cv_;  // push_wait() waiters; signalled on pop
+    std::function<void()> wakeup_;      // armed by notify_when_ready()
 };
 
 /**
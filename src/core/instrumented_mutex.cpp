@@ -0,0 +1,15 @@
+#include "instrumented_mutex.hpp"
+
+namespace broker_sim {
+
+InstrumentedMutex::InstrumentedMutex(const std::string& name) : name_(name) {
+    auto& registry = MetricsRegistry::instance();
+    const MetricLabels labels{{"lock", name}};
+    wait_ = registry.histogram("broker_lock_wait_seconds",
+                               "Time spent waiting to acquire a lock (0 when uncontended)", labels);
+    hold_ = registry.histogram("broker_lock_hold_seconds", "Time a lock was held per acquisition", labels);
+    contended_ = registry.counter("broker_lock_contended_total",
+                                  "Acquisitions that had to block on another holder", labels);
+}
+
+} // namespace broker_sim
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "metrics.hpp"
+
+namespace broker_sim {
+
+/**
+ * std::mutex that reports how long callers wait for it and how long it is
+ * held, as broker_lock_wait_seconds{lock} and broker_lock_hold_seconds{lock}.
+ *
+ * Meets Lockable, so std::lock_guard / std::unique_lock work unchanged (it is
+ * not usable with std::condition_variable). An uncontended lock() is a
+ * try_lock plus one clock read; the wait is recorded as 0 so the wait
+ * histogram's count is the acquisition count. Instances constructed with the
+ * same name share one set of series.
+ */
+class InstrumentedMutex {
+public:
+    explicit InstrumentedMutex(const std::string& name);
+    InstrumentedMutex(const InstrumentedMutex&) = delete;
+    InstrumentedMutex& operator=(const InstrumentedMutex&) = delete;
+
+    void lock() {
+        if (mutex_.try_lock()) {
+            acquired_ns_ = now_ns();
+            wait_->record(0);
+            return;
+        }
+        const int64_t start = now_ns();
+        mutex_.lock();
+        acquired_ns_ = now_ns();
+        wait_->record(static_cast<uint64_t>(acquired_ns_ - start));
+        contended_->add();
+    }
+
+    bool try_lock() {
+        if (!mutex_.try_lock()) return false;
+        acquired_ns_ = now_ns();
+        wait_->record(0);
+        return true;
+    }
+
+    void unlock() {
+        const int64_t held = now_ns() - acquired_ns_;
+        mutex_.unlock();
+        hold_->record(static_cast<uint64_t>(held > 0 ? held : 0));
+    }
+
+    const std::string& name() const { return name_; }
+    const Histogram& wait_histogram() const { return *wait_; }
+    const Histogram& hold_histogram() const { return *hold_; }
+    uint64_t contended() const { return contended_->value(); }
+
+private:
+    static int64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    std::mutex mutex_;
+    int64_t acquired_ns_{0};  // written by the owner only, read in unlock()
+    std::string name_;
+    std::shared_ptr<Histogram> wait_;
+    std::shared_ptr<Histogram> hold_;
+    std::shared_ptr<Counter> contended_;
+};
+
+} // namespace broker_sim
@@ -0,0 +1,149 @@
+#include "luld_bands.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace broker_sim {
+
+struct LuldBandEngine::Window {
+    struct Bucket {
+        double sum{0.0};
+        uint32_t count{0};
+    };
+
+    std::array<Bucket, kWindowSeconds> buckets{};
+    int64_t newest_second{-1};
+    double sum{0.0};
+    uint64_t count{0};
+    double tier_pct{0.0};
+    Bands bands;
+    int64_t limit_since_ns{0};   // 0 = not in a limit state
+    int64_t paused_until_ns{0};  // 0 = not paused
+
+    void clear() {
+        buckets.fill(Bucket{});
+        newest_second = -1;
+        sum = 0.0;
+        count = 0;
+    }
+
+    // Slide the window forward so it covers (second - kWindowSeconds, second].
+    void advance(int64_t second) {
+        if (newest_second < 0 || second <= newest_second) {
+            newest_second = std::max(newest_second, second);
+            return;
+        }
+        if (second - newest_second >= kWindowSeconds) {
+            clear();
+        } else {
+            for (int64_t s = newest_second + 1; s <= second; ++s) {
+                Bucket& b = buckets[static_cast<size_t>(s % kWindowSeconds)];
+                sum -= b.sum;
+                count -= b.count;
+                b = Bucket{};
+            }
+            // Sums of many adds and subtracts drift; an empty window is exact.
+            if (count == 0) sum = 0.0;
+        }
+        newest_second = second;
+    }
+
+    // A late print counts towards the newest second rather than reopening an
+    // older bucket that may already have been recycled.
+    void add(int64_t second, double price) {
+        advance(second);
+        second = std::max(second, newest_second);
+        Bucket& b = buckets[static_cast<size_t>(second % kWindowSeconds)];
+        b.sum += price;
+        b.count++;
+        sum += price;
+        count++;
+    }
+};
+
+LuldBandEngine::LuldBandEngine(Params params) : params_(std::move(params)) {
+    std::sort(params_.tier1.begin(), params_.tier1.end());
+}
+
+LuldBandEngine::~LuldBandEngine() = default;
+
+LuldBandEngine::Bands LuldBandEngine::bands_for(double reference, double tier_pct) {
+    Bands b;
+    b.reference = reference;
+    if (reference <= 0.0) return b;
+    double width;
+    if (reference > 3.0) {
+        width = reference * tier_pct / 100.0;
+    } else if (reference >= 0.75) {
+        width = reference * 0.20;
+    } else {
+        width = std::min(0.15, reference * 0.75);
+    }
+    b.upper = reference + width;
+    b.lower = std::max(0.0, reference - width);
+    return b;
+}
+
+LuldBandEngine::Window* LuldBandEngine::window_for(SymbolId id) {
+    if (id == kInvalidSymbolId) return nullptr;
+    if (id >= windows_.size()) windows_.resize(static_cast<size_t>(id) + 1);
+    auto& slot = windows_[id];
+    if (!slot) {
+        slot = std::make_unique<Window>();
+        slot->tier_pct = std::binary_search(params_.tier1.begin(), params_.tier1.end(), id)
+            ? params_.tier1_pct
+            : params_.tier2_pct;
+        tracked_++;
+    }
+    return slot.get();
+}
+
+LuldBandEngine::Result LuldBandEngine::on_trade(SymbolId id, int64_t ts_ns, double price) {
+    Result result;
+    if (price <= 0.0 || ts_ns < 0) return result;
+    Window* w = window_for(id);
+    if (!w) return result;
+
+    if (w->paused_until_ns != 0) {
+        if (ts_ns < w->paused_until_ns) return result;
+        // Reopen: the first print after the pause is the new reference.
+        w->paused_until_ns = 0;
+        w->limit_since_ns = 0;
+        w->clear();
+        w->add(ts_ns / 1'000'000'000, price);
+        w->bands = bands_for(price, w->tier_pct);
+        result.action = Action::RESUME;
+        result.bands_changed = true;
+        result.bands = w->bands;
+        return result;
+    }
+
+    const int64_t second = ts_ns / 1'000'000'000;
+    w->advance(second);
+    const bool was_empty = w->count == 0;
+    w->add(second, price);
+
+    const double mean = w->sum / static_cast<double>(w->count);
+    const double ref = w->bands.reference;
+    if (was_empty || ref <= 0.0 ||
+        std::abs(mean - ref) / ref * 100.0 >= kReferenceMovePct) {
+        w->bands = bands_for(was_empty ? price : mean, w->tier_pct);
+        result.bands_changed = true;
+    }
+    result.bands = w->bands;
+
+    const bool at_band = price >= w->bands.upper || price <= w->bands.lower;
+    if (!at_band) {
+        w->limit_since_ns = 0;
+    } else if (w->limit_since_ns == 0) {
+        w->limit_since_ns = ts_ns;
+    } else if (ts_ns - w->limit_since_ns >= kLimitStateNs) {
+        w->limit_since_ns = 0;
+        w->paused_until_ns = ts_ns + params_.pause_ns;
+        result.action = Action::HALT;
+    }
+    return result;
+}
+
+} // namespace broker_sim
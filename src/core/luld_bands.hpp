@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "symbol_table.hpp"
+
+namespace broker_sim {
+
+/**
+ * Limit Up-Limit Down price bands derived from a session's trade prints.
+ *
+ * Each symbol keeps the mean trade price of the last five minutes in a ring
+ * of one-second buckets, so a trade costs one bucket update plus evicting the
+ * seconds that left the window. As in the LULD plan the reference price only
+ * follows that mean once it moves 1% or more, and the first trade into an
+ * empty window (the open, or after a quiet spell) sets it outright. Bands are
+ * reference +/- the symbol's tier percentage, widened for sub-$3 stocks.
+ *
+ * A print at or through a band puts the symbol in a limit state; a print
+ * inside the bands ends it. A limit state still in force 15 seconds later
+ * calls a trading pause, and the first print after the pause reopens the
+ * symbol and reseeds the reference at that price. Quotes are not consulted.
+ *
+ * Owned and called only by the session worker.
+ */
+class LuldBandEngine {
+public:
+    static constexpr int kWindowSeconds = 300;
+    static constexpr int64_t kLimitStateNs = 15'000'000'000;
+    static constexpr double kReferenceMovePct = 1.0;
+
+    struct Params {
+        double tier1_pct{5.0};
+        double tier2_pct{10.0};
+        int64_t pause_ns{300'000'000'000};
+        std::vector<SymbolId> tier1;   // sorted; every other symbol is Tier 2
+    };
+
+    struct Bands {
+        double reference{0.0};
+        double upper{0.0};
+        double lower{0.0};
+    };
+
+    enum class Action : uint8_t { NONE, HALT, RESUME };
+
+    struct Result {
+        Action action{Action::NONE};
+        bool bands_changed{false};
+        Bands bands;
+    };
+
+    explicit LuldBandEngine(Params params);
+    ~LuldBandEngine();
+    LuldBandEngine(const LuldBandEngine&) = delete;
+    LuldBandEngine& operator=(const LuldBandEngine&) = delete;
+
+    /** Bands around a reference price for a Tier 1/2 percentage. */
+    static Bands bands_for(double reference, double tier_pct);
+
+    /** Feed one trade; prints must arrive in timestamp order per symbol. */
+    Result on_trade(SymbolId id, int64_t ts_ns, double price);
+
+    size_t tracked_symbols() const { return tracked_; }
+
+private:
+    struct Window;
+
+    Window* window_for(SymbolId id);
+
+    Params params_;
+    std::vector<std::unique_ptr<Window>> windows_;   // indexed by SymbolId
+    size_t tracked_{0};
+};
+
+} // namespace broker_sim
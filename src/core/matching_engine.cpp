@@ -1,4 +1,5 @@
 #include "matching_engine.hpp"
+#include <algorithm>
 
 namespace broker_sim {
 
@@ -7,18 +8,29 @@ void MatchingEngine::set_config(const ExecutionConfig& config) {
     config_ = config;
 }
 
+std::shared_ptr<MatchingEngine> MatchingEngine::fork() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto copy = std::make_shared<MatchingEngine>(config_);
+    copy->current_nbbo_ = current_nbbo_;
+    copy->pending_orders_ = pending_orders_;
+    copy->rng_ = rng_;
+    return copy;
+}
+
 void MatchingEngine::reset() {
     std::lock_guard<std::mutex> lock(mutex_);
-    current_nbbo_.clear();
-    pending_orders_.clear();
+    current_nbbo_ = {};
+    pending_orders_ = {};
 }
 
 MatchingEngine::MatchResult MatchingEngine::update_nbbo(const NBBO& nbbo) {
     std::lock_guard<std::mutex> lock(mutex_);
-    current_nbbo_[nbbo.symbol] = nbbo;
+    current_nbbo_.mut()[nbbo.symbol] = nbbo;
     MatchResult result;
+    if (pending_orders_->empty()) return result;
 
-    for (auto it = pending_orders_.begin(); it != pending_orders_.end(); ) {
+    auto& pending = pending_orders_.mut();
+    for (auto it = pending.begin(); it != pending.end(); ) {
         if (it->second.symbol != nbbo.symbol) {
             ++it;
             continue;
@@ -31,7 +43,7 @@ MatchingEngine::MatchResult MatchingEngine::update_nbbo(const NBBO& nbbo) {
                 it->second.status = OrderStatus::EXPIRED;
                 it->second.expired_at_ns = nbbo.timestamp;
                 result.expired.push_back(it->second);
-                it = pending_orders_.erase(it);
+                it = pending.erase(it);
                 continue;
             }
         }
@@ -40,7 +52,7 @@ MatchingEngine::MatchResult MatchingEngine::update_nbbo(const NBBO& nbbo) {
         if (fill) {
             result.fills.push_back(*fill);
             if (!fill->is_partial) {
-                it = pending_orders_.erase(it);
+                it = pending.erase(it);
                 continue;
             }
         }
@@ -58,11 +70,11 @@ std::optional<Fill> MatchingEngine::submit_order(Order& order) {
         return std::nullopt;
     }
 
-    auto it = current_nbbo_.find(order.symbol);
-    if (it == current_nbbo_.end()) {
+    auto it = current_nbbo_->find(order.symbol);
+    if (it == current_nbbo_->end()) {
         // No NBBO available, queue the order
         order.status = OrderStatus::ACCEPTED;
-        pending_orders_[order.id] = order;
+        pending_orders_.mut()[order.id] = order;
         return std::nullopt;
     }
 
@@ -79,13 +91,9 @@ std::optional<Fill> MatchingEngine::submit_order_with_latency(Order& order, int6
 
 bool MatchingEngine::cancel_order(const std::string& order_id) {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = pending_orders_.find(order_id);
-    if (it != pending_orders_.end()) {
-        it->second.status = OrderStatus::CANCELED;
-        pending_orders_.erase(it);
-        return true;
-    }
-    return false;
+    if (pending_orders_->find(order_id) == pending_orders_->end()) return false;
+    pending_orders_.mut().erase(order_id);
+    return true;
 }
 
 std::vector<Order> MatchingEngine::expire_pending_orders_at(Timestamp timestamp) {
@@ -94,7 +102,12 @@ std::vector<Order> MatchingEngine::expire_pending_orders_at(Timestamp timestamp)
     const int64_t timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
         timestamp.time_since_epoch()).count();
 
-    for (auto it = pending_orders_.begin(); it != pending_orders_.end(); ) {
+    const bool any_expiring = std::any_of(pending_orders_->begin(), pending_orders_->end(),
+        [&](const auto& kv) { return kv.second.expire_at && timestamp >= *kv.second.expire_at; });
+    if (!any_expiring) return expired;
+
+    auto& pending = pending_orders_.mut();
+    for (auto it = pending.begin(); it != pending.end(); ) {
         if (!it->second.expire_at || timestamp < *it->second.expire_at) {
             ++it;
             continue;
@@ -104,7 +117,7 @@ std::vector<Order> MatchingEngine::expire_pending_orders_at(Timestamp timestamp)
         it->second.expired_at_ns = timestamp_ns;
         it->second.updated_at_ns = timestamp_ns;
         expired.push_back(it->second);
-        it = pending_orders_.erase(it);
+        it = pending.erase(it);
     }
 
     return expired;
@@ -112,16 +125,16 @@ std::vector<Order> MatchingEngine::expire_pending_orders_at(Timestamp timestamp)
 
 std::optional<NBBO> MatchingEngine::get_nbbo(const std::string& symbol) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = current_nbbo_.find(symbol);
-    if (it != current_nbbo_.end()) return it->second;
+    auto it = current_nbbo_->find(symbol);
+    if (it != current_nbbo_->end()) return it->second;
     return std::nullopt;
 }
 
 std::vector<Order> MatchingEngine::get_pending_orders() const {
     std::lock_guard<std::mutex> lock(mutex_);
     std::vector<Order> out;
-    out.reserve(pending_orders_.size());
-    for (const auto& kv : pending_orders_) {
+    out.reserve(pending_orders_->size());
+    for (const auto& kv : *pending_orders_) {
         out.push_back(kv.second);
     }
     return out;
@@ -129,8 +142,8 @@ std::vector<Order> MatchingEngine::get_pending_orders() const {
 
 std::optional<Order> MatchingEngine::get_order(const std::string& order_id) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = pending_orders_.find(order_id);
-    if (it != pending_orders_.end()) {
+    auto it = pending_orders_->find(order_id);
+    if (it != pending_orders_->end()) {
         return it->second;
     }
     return std::nullopt;
@@ -201,7 +214,7 @@ std::optional<Fill> MatchingEngine::try_fill(Order& order, const NBBO& nbbo) {
     if (order.min_exec_timestamp > 0 && nbbo.timestamp < order.min_exec_timestamp) {
         if (tif_allows_enqueue(order)) {
             order.status = OrderStatus::ACCEPTED;
-            pending_orders_[order.id] = order;
+            pending_orders_.mut()[order.id] = order;
         }
         return std::nullopt;
     }
@@ -210,7 +223,7 @@ std::optional<Fill> MatchingEngine::try_fill(Order& order, const NBBO& nbbo) {
     if (nbbo.bid_price > 0.0 && nbbo.ask_price > 0.0 && nbbo.bid_price >= nbbo.ask_price) {
         if (tif_allows_enqueue(order)) {
             order.status = OrderStatus::ACCEPTED;
-            pending_orders_[order.id] = order;
+            pending_orders_.mut()[order.id] = order;
         }
         return std::nullopt;
     }
@@ -219,7 +232,7 @@ std::optional<Fill> MatchingEngine::try_fill(Order& order, const NBBO& nbbo) {
     if (!should_fill()) {
         if (tif_allows_enqueue(order)) {
             order.status = OrderStatus::ACCEPTED;
-            pending_orders_[order.id] = order;
+            pending_orders_.mut()[order.id] = order;
         }
         return std::nullopt;
     }
@@ -264,7 +277,7 @@ std::optional<Fill> MatchingEngine::try_fill(Order& order, const NBBO& nbbo) {
         return std::nullopt;
     }
     order.status = OrderStatus::ACCEPTED;
-    pending_orders_[order.id] = order;
+    pending_orders_.mut()[order.id] = order;
     return std::nullopt;
 }
 
@@ -4,10 +4,12 @@
 #include <unordered_map>
 #include <vector>
 #include <optional>
+#include <memory>
 #include <mutex>
 #include <random>
 #include "event_queue.hpp"
 #include "config.hpp"
+#include "cow.hpp"
 
 namespace broker_sim {
 
@@ -137,6 +139,13 @@ public:
      */
     std::optional<Order> get_order(const std::string& order_id) const;
 
+    /**
+     * Copy for a session fork. NBBO cache and pending orders are shared
+     * copy-on-write; the RNG state is copied so both branches draw the same
+     * latency/slippage sequence.
+     */
+    std::shared_ptr<MatchingEngine> fork() const;
+
     /**
      * Clear all pending orders and NBBO data.
      */
@@ -181,8 +190,8 @@ private:
     int64_t apply_extended_hours_liquidity(int64_t available_size, Timestamp current_time) const;
 
     ExecutionConfig config_;
-    std::unordered_map<std::string, NBBO> current_nbbo_;
-    std::unordered_map<std::string, Order> pending_orders_;
+    Cow<std::unordered_map<std::string, NBBO>> current_nbbo_;
+    Cow<std::unordered_map<std::string, Order>> pending_orders_;
     mutable std::mutex mutex_;
     mutable std::mt19937_64 rng_;
 };
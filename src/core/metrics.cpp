@@ -0,0 +1,178 @@
+#include "metrics.hpp"
+
+#include <bit>
+#include <cstdio>
+
+namespace broker_sim {
+
+namespace {
+
+// Prometheus bucket bounds: 2^8 ns .. 2^36 ns.
+constexpr unsigned kFirstExposedPow2 = 8;
+constexpr unsigned kLastExposedPow2 = 36;
+
+std::string escape_label_value(const std::string& v) {
+    std::string out;
+    out.reserve(v.size());
+    for (char c : v) {
+        if (c == '\\' || c == '"') {
+            out += '\\';
+            out += c;
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+std::string render_labels(const MetricLabels& labels) {
+    if (labels.empty()) return "";
+    std::string out = "{";
+    for (size_t i = 0; i < labels.size(); ++i) {
+        if (i > 0) out += ',';
+        out += labels[i].first;
+        out += "=\"";
+        out += escape_label_value(labels[i].second);
+        out += '"';
+    }
+    out += '}';
+    return out;
+}
+
+// Splices one more label into an already rendered label set.
+std::string with_label(const std::string& rendered, const std::string& name, const std::string& value) {
+    std::string extra = name + "=\"" + value + "\"";
+    if (rendered.empty()) return "{" + extra + "}";
+    return rendered.substr(0, rendered.size() - 1) + "," + extra + "}";
+}
+
+std::string format_seconds(uint64_t ns) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.9g", static_cast<double>(ns) / 1e9);
+    return buf;
+}
+
+} // namespace
+
+// Buckets run (lower, upper] rather than [lower, upper): shifting every value
+// down by one before bucketing puts each power of two at the top of a bucket,
+// so a Prometheus "le" bound of 2^k ns counts a value of exactly 2^k.
+size_t Histogram::bucket_index(uint64_t v) {
+    if (v == 0) return 0;
+    --v;
+    if (v < kSubBuckets) return static_cast<size_t>(v) + 1;
+    const unsigned msb = 63u - static_cast<unsigned>(std::countl_zero(v));
+    const unsigned shift = msb - kSubBucketBits;
+    const size_t sub = static_cast<size_t>(v >> shift) - kSubBuckets;
+    return 1 + kSubBuckets + shift * kSubBuckets + sub;
+}
+
+uint64_t Histogram::bucket_upper(size_t index) {
+    if (index == 0) return 0;
+    --index;
+    if (index < kSubBuckets) return index + 1;
+    const size_t shift = (index - kSubBuckets) / kSubBuckets;
+    const uint64_t sub = (index - kSubBuckets) % kSubBuckets;
+    const uint64_t lower = (kSubBuckets + sub) << shift;
+    const uint64_t last = lower + ((uint64_t{1} << shift) - 1);
+    return last == ~uint64_t{0} ? last : last + 1;
+}
+
+uint64_t Histogram::quantile(double p) const {
+    const uint64_t total = count();
+    if (total == 0) return 0;
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(p * static_cast<double>(total) + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) return bucket_upper(i);
+    }
+    return bucket_upper(kBuckets - 1);
+}
+
+uint64_t Histogram::count_at_or_below(uint64_t le_ns) const {
+    uint64_t total = 0;
+    for (size_t i = 0; i < kBuckets && bucket_upper(i) <= le_ns; ++i) {
+        total += buckets_[i].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+template <typename T>
+std::shared_ptr<T> MetricsRegistry::get_or_create(const std::string& name, const std::string& help,
+                                                  const char* type, const MetricLabels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& family = families_[name];
+    if (family.type.empty()) {
+        family.help = help;
+        family.type = type;
+    }
+    auto& slot = family.series[render_labels(labels)];
+    if (auto* existing = std::get_if<std::shared_ptr<T>>(&slot); existing && *existing) {
+        return *existing;
+    }
+    auto metric = std::make_shared<T>();
+    slot = metric;
+    return metric;
+}
+
+std::shared_ptr<Counter> MetricsRegistry::counter(const std::string& name, const std::string& help,
+                                                  const MetricLabels& labels) {
+    return get_or_create<Counter>(name, help, "counter", labels);
+}
+
+std::shared_ptr<Gauge> MetricsRegistry::gauge(const std::string& name, const std::string& help,
+                                              const MetricLabels& labels) {
+    return get_or_create<Gauge>(name, help, "gauge", labels);
+}
+
+std::shared_ptr<Histogram> MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                                      const MetricLabels& labels) {
+    return get_or_create<Histogram>(name, help, "histogram", labels);
+}
+
+void MetricsRegistry::remove(const std::string& name, const MetricLabels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = families_.find(name);
+    if (it == families_.end()) return;
+    it->second.series.erase(render_labels(labels));
+}
+
+std::string MetricsRegistry::render_prometheus() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string out;
+    for (const auto& [name, family] : families_) {
+        if (family.series.empty()) continue;
+        out += "# HELP " + name + " " + family.help + "\n";
+        out += "# TYPE " + name + " " + family.type + "\n";
+        for (const auto& [labels, metric] : family.series) {
+            if (auto* c = std::get_if<std::shared_ptr<Counter>>(&metric)) {
+                out += name + labels + " " + std::to_string((*c)->value()) + "\n";
+            } else if (auto* g = std::get_if<std::shared_ptr<Gauge>>(&metric)) {
+                out += name + labels + " " + std::to_string((*g)->value()) + "\n";
+            } else if (auto* h = std::get_if<std::shared_ptr<Histogram>>(&metric)) {
+                const Histogram& hist = **h;
+                // Read count first so no bucket can exceed it on a live histogram.
+                const uint64_t count = hist.count();
+                for (unsigned pow2 = kFirstExposedPow2; pow2 <= kLastExposedPow2; ++pow2) {
+                    const uint64_t le = uint64_t{1} << pow2;
+                    out += name + "_bucket" + with_label(labels, "le", format_seconds(le)) + " " +
+                           std::to_string(std::min(count, hist.count_at_or_below(le))) + "\n";
+                }
+                out += name + "_bucket" + with_label(labels, "le", "+Inf") + " " + std::to_string(count) + "\n";
+                out += name + "_sum" + labels + " " + format_seconds(hist.sum()) + "\n";
+                out += name + "_count" + labels + " " + std::to_string(count) + "\n";
+            }
+        }
+    }
+    return out;
+}
+
+} // namespace broker_sim
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace broker_sim {
+
+/** Monotonic counter; add() is a single relaxed atomic increment. */
+class Counter {
+public:
+    void add(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+/** Point-in-time value that can move both ways. */
+class Gauge {
+public:
+    void set(int64_t v) { value_.store(v, std::memory_order_relaxed); }
+    void add(int64_t n) { value_.fetch_add(n, std::memory_order_relaxed); }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+/**
+ * Lock-free log-linear (HDR-style) histogram of nanosecond durations.
+ *
+ * Each power of two is split into kSubBuckets linear buckets, so a recorded
+ * value lands in a bucket at most 25% wider than itself across the full
+ * uint64 range. record() is two relaxed increments and an add; quantiles and
+ * exposition read the buckets without stopping writers.
+ */
+class Histogram {
+public:
+    static constexpr unsigned kSubBucketBits = 2;
+    static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+    static constexpr size_t kBuckets = 1 + kSubBuckets + (64 - kSubBucketBits) * kSubBuckets;
+
+    void record(uint64_t ns) {
+        buckets_[bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(ns, std::memory_order_relaxed);
+    }
+
+    void record_since(std::chrono::steady_clock::time_point start) {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        record(static_cast<uint64_t>(std::max<int64_t>(0,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count())));
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+
+    /** Upper bound (ns) of the bucket holding the p-th quantile, 0 when empty. */
+    uint64_t quantile(double p) const;
+
+    /** Number of recorded values <= le_ns, rounded to bucket granularity. */
+    uint64_t count_at_or_below(uint64_t le_ns) const;
+
+    static size_t bucket_index(uint64_t v);
+    static uint64_t bucket_upper(size_t index);
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+};
+
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+/**
+ * Process-wide registry of named metrics, rendered in Prometheus text format.
+ *
+ * Registration and rendering take a mutex; the returned metric objects are
+ * updated lock-free, so hot paths look a metric up once and keep the pointer.
+ * Registering the same name and labels again returns the existing metric.
+ */
+class MetricsRegistry {
+public:
+    static MetricsRegistry& instance();
+
+    std::shared_ptr<Counter> counter(const std::string& name, const std::string& help,
+                                     const MetricLabels& labels = {});
+    std::shared_ptr<Gauge> gauge(const std::string& name, const std::string& help,
+                                 const MetricLabels& labels = {});
+    std::shared_ptr<Histogram> histogram(const std::string& name, const std::string& help,
+                                         const MetricLabels& labels = {});
+
+    /** Drops one labelled series, e.g. when the session it describes is deleted. */
+    void remove(const std::string& name, const MetricLabels& labels);
+
+    /**
+     * Histograms are exposed in seconds with buckets at powers of two from
+     * 256ns to ~69s; the registry keeps full resolution for quantile().
+     */
+    std::string render_prometheus() const;
+
+private:
+    using Metric = std::variant<std::shared_ptr<Counter>, std::shared_ptr<Gauge>, std::shared_ptr<Histogram>>;
+    struct Family {
+        std::string help;
+        std::string type;
+        std::map<std::string, Metric> series;  // keyed by rendered label set
+    };
+
+    template <typename T>
+    std::shared_ptr<T> get_or_create(const std::string& name, const std::string& help,
+                                     const char* type, const MetricLabels& labels);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Family> families_;
+};
+
+} // namespace broker_sim
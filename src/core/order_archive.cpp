@@ -0,0 +1,431 @@
+#include "order_archive.hpp"
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <random>
+#include <unordered_set>
+#include <spdlog/spdlog.h>
+
+namespace broker_sim {
+
+namespace {
+
+// About two keys (id, client id) per record at 16 bits each keeps a page's
+// false-positive rate near 0.05%; symbols repeat and barely add to the load.
+constexpr size_t kPageFilterBits = size_t{OrderArchive::kPageRecords} * 2 * 16;
+constexpr size_t kSegmentFilterBits = kPageFilterBits * OrderArchive::kSegmentPages;
+constexpr int kProbes = 8;
+
+enum : uint64_t { kIdTag = 1, kClientIdTag = 2, kSymbolTag = 3 };
+
+uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t key_hash(uint64_t tag, const std::string& value) {
+    return mix(std::hash<std::string>{}(value) ^ (tag << 56));
+}
+
+} // namespace
+
+void OrderArchive::Bloom::add(uint64_t h) {
+    const uint64_t mask = words.size() * 64 - 1;
+    const uint64_t step = mix(h) | 1;
+    for (int i = 0; i < kProbes; ++i, h += step) {
+        words[(h & mask) >> 6] |= uint64_t{1} << (h & 63);
+    }
+}
+
+bool OrderArchive::Bloom::may_contain(uint64_t h) const {
+    const uint64_t mask = words.size() * 64 - 1;
+    const uint64_t step = mix(h) | 1;
+    for (int i = 0; i < kProbes; ++i, h += step) {
+        if (!(words[(h & mask) >> 6] & (uint64_t{1} << (h & 63)))) return false;
+    }
+    return true;
+}
+
+OrderArchive::~OrderArchive() {
+    drop_temp_file();
+}
+
+bool OrderArchive::attach_file(const std::string& path, bool load_existing) {
+    drop_temp_file();
+    if (file_.is_open()) file_.close();
+    path_.clear();
+    clear();
+    path_ = path;
+    if (load_existing && std::filesystem::exists(path_)) {
+        open_for_append(std::ios::app);
+        std::ifstream in(path_, std::ios::binary);
+        std::string line;
+        uint64_t offset = 0;
+        // Only needed while loading, to spot seqs that were written more than once.
+        std::unordered_set<uint64_t> seen;
+        while (std::getline(in, line)) {
+            uint64_t length = line.size() + 1;
+            try {
+                auto j = nlohmann::json::parse(line);
+                auto order = order_from_json(j);
+                uint64_t seq = j.value("seq", uint64_t{0});
+                if (!order.id.empty()) {
+                    uint64_t ordinal = index_record(order, seq, offset, line.size());
+                    if (!seen.insert(seq).second) moved_[seq] = ordinal;
+                }
+            } catch (const std::exception& e) {
+                spdlog::warn("[OrderArchive] skipping bad record at offset {} in {}: {}", offset, path_, e.what());
+            }
+            offset += length;
+        }
+        end_offset_ = offset;
+        live_ = seen.size();
+    } else {
+        open_for_append(std::ios::trunc);
+    }
+    if (!file_.is_open()) {
+        spdlog::warn("[OrderArchive] cannot open {}, keeping archive in memory", path_);
+        path_.clear();
+        return false;
+    }
+    return true;
+}
+
+void OrderArchive::append(const Order& order, uint64_t seq) {
+    auto j = order_to_json(order);
+    j["seq"] = seq;
+    std::string line = j.dump();
+
+    auto moved = moved_.find(seq);
+    bool was_live = false;
+    if (moved != moved_.end()) {
+        was_live = moved->second != kRemoved;
+    } else if (auto prior = key_of(order.id)) {
+        if (prior->second == seq) {
+            was_live = true;
+        } else {
+            moved_[prior->second] = kRemoved;
+            --live_;
+        }
+        moved = moved_.find(seq);
+    }
+
+    uint64_t offset = end_offset_;
+    if (!path_.empty()) {
+        file_.clear();
+        file_.seekp(0, std::ios::end);
+        file_ << line << '\n';
+        dirty_ = true;
+    } else {
+        segment_.append(line);
+        segment_.push_back('\n');
+    }
+    end_offset_ += line.size() + 1;
+    if (path_.empty() && segment_.size() >= kSpillBytes && !spill_failed_) spill_to_temp_file();
+    uint64_t ordinal = index_record(order, seq, offset, line.size());
+
+    if (moved != moved_.end()) {
+        moved->second = ordinal;
+    } else if (was_live) {
+        moved_[seq] = ordinal;
+    }
+    if (!was_live) ++live_;
+}
+
+bool OrderArchive::remove(const std::string& order_id) {
+    auto hit = find_latest(key_hash(kIdTag, order_id), false, order_id);
+    if (!hit) return false;
+    moved_[hit->rec->key.second] = kRemoved;
+    --live_;
+    return true;
+}
+
+std::optional<Order> OrderArchive::get(const std::string& order_id) const {
+    auto hit = find_latest(key_hash(kIdTag, order_id), false, order_id);
+    if (!hit) return std::nullopt;
+    return hit->rec->order;
+}
+
+std::optional<Order> OrderArchive::get_by_client_id(const std::string& client_order_id) const {
+    if (client_order_id.empty()) return std::nullopt;
+    auto hit = find_latest(key_hash(kClientIdTag, client_order_id), true, client_order_id);
+    if (!hit) return std::nullopt;
+    return hit->rec->order;
+}
+
+std::optional<OrderArchive::Key> OrderArchive::key_of(const std::string& order_id) const {
+    auto hit = find_latest(key_hash(kIdTag, order_id), false, order_id);
+    if (!hit) return std::nullopt;
+    return hit->rec->key;
+}
+
+OrderArchive::Scan OrderArchive::scan(const KeyRange& range, const std::vector<std::string>& symbols,
+                                      bool newest_first) const {
+    return Scan(*this, range, symbols, newest_first);
+}
+
+OrderArchive::Mark OrderArchive::mark() const {
+    return Mark{next_ordinal_, end_offset_, max_seq_, live_, moved_};
+}
+
+void OrderArchive::truncate(const Mark& mark) {
+    if (mark.ordinal > next_ordinal_ || mark.end_offset > end_offset_) return;
+    while (!pages_.empty() && pages_.back().first_ordinal >= mark.ordinal) pages_.pop_back();
+    if (!pages_.empty()) {
+        // Key span and filters may still cover dropped records; both only
+        // widen what a lookup opens, never what it returns.
+        Page& tail = pages_.back();
+        tail.count = static_cast<uint32_t>(mark.ordinal - tail.first_ordinal);
+        tail.bytes = mark.end_offset - tail.offset;
+    }
+    segments_.resize((pages_.size() + kSegmentPages - 1) / kSegmentPages);
+    moved_ = mark.moved;
+    live_ = mark.live;
+    max_seq_ = mark.max_seq;
+    next_ordinal_ = mark.ordinal;
+    end_offset_ = mark.end_offset;
+    cache_.clear();
+    if (path_.empty()) {
+        segment_.resize(end_offset_);
+        return;
+    }
+    file_.close();
+    std::error_code ec;
+    std::filesystem::resize_file(path_, end_offset_, ec);
+    if (ec) spdlog::warn("[OrderArchive] cannot truncate {} to {} bytes: {}", path_, end_offset_, ec.message());
+    open_for_append(std::ios::app);
+}
+
+void OrderArchive::clear() {
+    drop_temp_file();
+    spill_failed_ = false;
+    pages_.clear();
+    segments_.clear();
+    moved_.clear();
+    cache_.clear();
+    live_ = 0;
+    next_ordinal_ = 0;
+    segment_.clear();
+    segment_.shrink_to_fit();
+    end_offset_ = 0;
+    max_seq_ = 0;
+    if (!path_.empty()) {
+        open_for_append(std::ios::trunc);
+    }
+}
+
+bool OrderArchive::live(const Record& r) const {
+    auto it = moved_.find(r.key.second);
+    return it == moved_.end() || it->second == r.ordinal;
+}
+
+std::optional<OrderArchive::Hit> OrderArchive::find_latest(uint64_t hash, bool by_client_id,
+                                                           const std::string& value) const {
+    for (size_t s = segments_.size(); s-- > 0;) {
+        if (!segments_[s].may_contain(hash)) continue;
+        uint32_t first = static_cast<uint32_t>(s * kSegmentPages);
+        uint32_t last = std::min<uint32_t>(static_cast<uint32_t>(pages_.size()), first + kSegmentPages);
+        for (uint32_t p = last; p-- > first;) {
+            if (!pages_[p].filter.may_contain(hash)) continue;
+            auto data = load_page(p);
+            for (auto it = data->rbegin(); it != data->rend(); ++it) {
+                const std::string& v = by_client_id ? it->order.client_order_id : it->order.id;
+                if (v == value && live(*it)) return Hit{data, &*it};
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+uint64_t OrderArchive::index_record(const Order& order, uint64_t seq, uint64_t offset, uint64_t length) {
+    if (pages_.empty() || pages_.back().count == kPageRecords) {
+        if (pages_.size() % kSegmentPages == 0) segments_.emplace_back(kSegmentFilterBits);
+        Page page;
+        page.offset = offset;
+        page.first_ordinal = next_ordinal_;
+        page.filter = Bloom(kPageFilterBits);
+        pages_.push_back(std::move(page));
+    }
+    Page& page = pages_.back();
+    Bloom& segment = segments_.back();
+    Key key{order.submitted_at_ns, seq};
+    page.min_key = std::min(page.min_key, key);
+    page.max_key = std::max(page.max_key, key);
+    page.bytes = offset + length + 1 - page.offset;
+    page.count++;
+
+    uint64_t hashes[3] = {key_hash(kIdTag, order.id), key_hash(kSymbolTag, order.symbol), 0};
+    size_t n = 2;
+    if (!order.client_order_id.empty()) hashes[n++] = key_hash(kClientIdTag, order.client_order_id);
+    for (size_t i = 0; i < n; ++i) {
+        page.filter.add(hashes[i]);
+        segment.add(hashes[i]);
+    }
+    if (seq > max_seq_) max_seq_ = seq;
+
+    // A cached decode of the tail page no longer covers it.
+    uint32_t tail = static_cast<uint32_t>(pages_.size() - 1);
+    cache_.erase(std::remove_if(cache_.begin(), cache_.end(),
+                                [tail](const auto& e) { return e.first == tail; }),
+                 cache_.end());
+    return next_ordinal_++;
+}
+
+std::shared_ptr<const OrderArchive::PageData> OrderArchive::load_page(uint32_t page) const {
+    for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+        if (it->first != page) continue;
+        std::rotate(cache_.begin(), it, it + 1);
+        return cache_.front().second;
+    }
+
+    const Page& summary = pages_[page];
+    auto data = std::make_shared<PageData>();
+    auto raw = read_range(summary.offset, summary.bytes);
+    if (!raw) {
+        spdlog::warn("[OrderArchive] cannot read page {} ({} bytes at {})", page, summary.bytes, summary.offset);
+        return data;
+    }
+    data->reserve(summary.count);
+    uint64_t ordinal = summary.first_ordinal;
+    size_t pos = 0;
+    while (pos < raw->size()) {
+        size_t end = raw->find('\n', pos);
+        if (end == std::string::npos) end = raw->size();
+        // Records that failed to parse when indexed were never given an ordinal.
+        try {
+            auto j = nlohmann::json::parse(raw->begin() + static_cast<std::ptrdiff_t>(pos),
+                                           raw->begin() + static_cast<std::ptrdiff_t>(end));
+            auto order = order_from_json(j);
+            if (!order.id.empty()) {
+                Key key{order.submitted_at_ns, j.value("seq", uint64_t{0})};
+                data->push_back(Record{key, ordinal++, std::move(order)});
+            }
+        } catch (const std::exception&) {
+        }
+        pos = end + 1;
+    }
+
+    cache_.insert(cache_.begin(), {page, data});
+    if (cache_.size() > kCachedPages) cache_.pop_back();
+    return data;
+}
+
+std::optional<std::string> OrderArchive::read_range(uint64_t offset, uint64_t length) const {
+    if (path_.empty()) {
+        if (offset + length > segment_.size()) return std::nullopt;
+        return segment_.substr(offset, length);
+    }
+    if (dirty_) {
+        file_.flush();
+        dirty_ = false;
+    }
+    std::string out(length, '\0');
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(offset));
+    if (!file_.read(out.data(), static_cast<std::streamsize>(length))) {
+        file_.clear();
+        return std::nullopt;
+    }
+    return out;
+}
+
+void OrderArchive::spill_to_temp_file() {
+    static std::atomic<uint64_t> counter{0};
+    std::error_code ec;
+    auto dir = std::filesystem::temp_directory_path(ec);
+    if (!ec) {
+        path_ = (dir / ("broker_order_archive." + std::to_string(std::random_device{}()) + "." +
+                        std::to_string(counter.fetch_add(1)) + ".jsonl")).string();
+        open_for_append(std::ios::trunc);
+        if (file_.is_open()) {
+            file_.write(segment_.data(), static_cast<std::streamsize>(segment_.size()));
+            file_.flush();
+        }
+    }
+    if (ec || !file_.good()) {
+        spdlog::warn("[OrderArchive] cannot spill to a temporary file, keeping archive in memory");
+        if (file_.is_open()) file_.close();
+        if (!path_.empty()) std::filesystem::remove(path_, ec);
+        path_.clear();
+        spill_failed_ = true;
+        return;
+    }
+    temp_file_ = true;
+    segment_.clear();
+    segment_.shrink_to_fit();
+}
+
+void OrderArchive::drop_temp_file() {
+    if (!temp_file_) return;
+    if (file_.is_open()) file_.close();
+    std::error_code ec;
+    std::filesystem::remove(path_, ec);
+    path_.clear();
+    temp_file_ = false;
+}
+
+void OrderArchive::open_for_append(std::ios::openmode extra) {
+    if (file_.is_open()) file_.close();
+    file_.clear();
+    file_.open(path_, std::ios::in | std::ios::out | std::ios::binary | extra);
+    dirty_ = false;
+}
+
+OrderArchive::Scan::Scan(const OrderArchive& archive, KeyRange range,
+                         const std::vector<std::string>& symbols, bool newest_first)
+    : archive_(&archive), range_(std::move(range)), symbols_(symbols), newest_first_(newest_first) {
+    std::vector<uint64_t> symbol_hashes;
+    symbol_hashes.reserve(symbols_.size());
+    for (const auto& s : symbols_) symbol_hashes.push_back(key_hash(kSymbolTag, s));
+
+    const auto& pages = archive.pages_;
+    for (uint32_t p = 0; p < pages.size(); ++p) {
+        const Page& page = pages[p];
+        if (page.count == 0) continue;
+        if (range_.above && !(*range_.above < page.max_key)) continue;
+        if (range_.below && !(page.min_key < *range_.below)) continue;
+        if (!symbol_hashes.empty() &&
+            std::none_of(symbol_hashes.begin(), symbol_hashes.end(),
+                         [&](uint64_t h) { return page.filter.may_contain(h); })) {
+            continue;
+        }
+        pending_.push_back(p);
+    }
+    // The page whose span reaches furthest towards the front of the walk opens first.
+    std::sort(pending_.begin(), pending_.end(), [&](uint32_t a, uint32_t b) {
+        return newest_first_ ? pages[a].max_key < pages[b].max_key : pages[b].min_key < pages[a].min_key;
+    });
+    fill();
+}
+
+void OrderArchive::Scan::next() {
+    auto cmp = [this](const Item& a, const Item& b) { return before(b.rec->key, a.rec->key); };
+    std::pop_heap(heap_.begin(), heap_.end(), cmp);
+    heap_.pop_back();
+    fill();
+}
+
+void OrderArchive::Scan::fill() {
+    auto cmp = [this](const Item& a, const Item& b) { return before(b.rec->key, a.rec->key); };
+    while (!pending_.empty()) {
+        const Page& page = archive_->pages_[pending_.back()];
+        const Key& bound = newest_first_ ? page.max_key : page.min_key;
+        if (!heap_.empty() && before(heap_.front().rec->key, bound)) break;
+        auto data = archive_->load_page(pending_.back());
+        pending_.pop_back();
+        for (const auto& r : *data) {
+            if (!range_.contains(r.key) || !archive_->live(r)) continue;
+            if (!symbols_.empty() &&
+                std::find(symbols_.begin(), symbols_.end(), r.order.symbol) == symbols_.end()) {
+                continue;
+            }
+            heap_.push_back(Item{&r, data});
+            std::push_heap(heap_.begin(), heap_.end(), cmp);
+        }
+    }
+}
+
+} // namespace broker_sim
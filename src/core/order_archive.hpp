@@ -0,0 +1,278 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <limits>
+#include <fstream>
+#include <optional>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+#include "matching_engine.hpp"
+
+namespace broker_sim {
+
+/**
+ * JSON encoding of an Order shared by checkpoints and the order archive.
+ * Unset optional prices are written as 0 and read back as unset.
+ */
+inline nlohmann::json order_to_json(const Order& o) {
+    nlohmann::json j{
+        {"id", o.id},
+        {"client_order_id", o.client_order_id},
+        {"symbol", o.symbol},
+        {"side", o.side == OrderSide::BUY ? "BUY" : "SELL"},
+        {"type", static_cast<int>(o.type)},
+        {"tif", static_cast<int>(o.tif)},
+        {"status", static_cast<int>(o.status)},
+        {"qty", o.qty.value_or(0.0)},
+        {"filled_qty", o.filled_qty},
+        {"limit_price", o.limit_price.value_or(0.0)},
+        {"stop_price", o.stop_price.value_or(0.0)},
+        {"trail_price", o.trail_price.value_or(0.0)},
+        {"trail_percent", o.trail_percent.value_or(0.0)},
+        {"stop_triggered", o.stop_triggered},
+        {"is_maker", o.is_maker},
+        {"created_at_ns", o.created_at_ns},
+        {"submitted_at_ns", o.submitted_at_ns},
+        {"updated_at_ns", o.updated_at_ns},
+        {"filled_at_ns", o.filled_at_ns},
+        {"canceled_at_ns", o.canceled_at_ns},
+        {"expired_at_ns", o.expired_at_ns},
+        {"last_fill_price", o.last_fill_price},
+        {"last_fill_fee", o.last_fill_fee},
+        {"cumulative_fees", o.cumulative_fees}
+    };
+    if (o.hwm) j["hwm"] = *o.hwm;
+    if (o.expire_at) {
+        j["expire_at_ns"] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            o.expire_at->time_since_epoch()).count();
+    }
+    if (!o.rejection_reason.empty()) j["rejection_reason"] = o.rejection_reason;
+    return j;
+}
+
+inline Order order_from_json(const nlohmann::json& o) {
+    Order ord;
+    ord.id = o.value("id", "");
+    ord.client_order_id = o.value("client_order_id", "");
+    ord.symbol = o.value("symbol", "");
+    ord.side = o.value("side", "BUY") == "BUY" ? OrderSide::BUY : OrderSide::SELL;
+    ord.type = static_cast<OrderType>(o.value("type", 0));
+    ord.tif = static_cast<TimeInForce>(o.value("tif", 0));
+    ord.status = static_cast<OrderStatus>(o.value("status", 0));
+    ord.qty = o.value("qty", 0.0);
+    ord.filled_qty = o.value("filled_qty", 0.0);
+    double lp = o.value("limit_price", 0.0);
+    if (lp > 0.0) ord.limit_price = lp;
+    double sp = o.value("stop_price", 0.0);
+    if (sp > 0.0) ord.stop_price = sp;
+    double tp = o.value("trail_price", 0.0);
+    if (tp > 0.0) ord.trail_price = tp;
+    double tpct = o.value("trail_percent", 0.0);
+    if (tpct > 0.0) ord.trail_percent = tpct;
+    if (o.contains("hwm")) ord.hwm = o.value("hwm", 0.0);
+    if (o.contains("expire_at_ns")) {
+        ord.expire_at = Timestamp{} + std::chrono::nanoseconds(o.value("expire_at_ns", int64_t{0}));
+    }
+    ord.stop_triggered = o.value("stop_triggered", false);
+    ord.is_maker = o.value("is_maker", false);
+    ord.created_at_ns = o.value("created_at_ns", int64_t{0});
+    ord.submitted_at_ns = o.value("submitted_at_ns", int64_t{0});
+    ord.updated_at_ns = o.value("updated_at_ns", int64_t{0});
+    ord.filled_at_ns = o.value("filled_at_ns", int64_t{0});
+    ord.canceled_at_ns = o.value("canceled_at_ns", int64_t{0});
+    ord.expired_at_ns = o.value("expired_at_ns", int64_t{0});
+    ord.last_fill_price = o.value("last_fill_price", 0.0);
+    ord.last_fill_fee = o.value("last_fill_fee", 0.0);
+    ord.cumulative_fees = o.value("cumulative_fees", 0.0);
+    ord.rejection_reason = o.value("rejection_reason", "");
+    return ord;
+}
+
+/**
+ * Cold tier for terminal orders.
+ *
+ * Records are appended as JSON lines to a file. Without an attached file they
+ * start in an in-memory segment that spills to a temporary file once it
+ * reaches kSpillBytes, so the log never grows in memory past that. Nothing
+ * per-order stays resident either: the log is cut into
+ * pages of kPageRecords records, and each page keeps only its byte range, its
+ * (submitted_at_ns, seq) key span and a Bloom filter over the ids, client ids
+ * and symbols it holds. Every kSegmentPages pages share a wider filter so a
+ * lookup for an id that was never archived (every new order) rejects whole
+ * segments at once. Pages are decoded on demand into a small LRU cache.
+ *
+ * A later record for the same seq supersedes the earlier one; the few seqs
+ * that were rewritten or removed are tracked in a side map.
+ */
+class OrderArchive {
+public:
+    using Key = std::pair<int64_t, uint64_t>;  // (submitted_at_ns, seq)
+
+    static constexpr uint32_t kPageRecords = 512;
+    static constexpr uint32_t kSegmentPages = 16;
+    static constexpr size_t kCachedPages = 8;
+    static constexpr size_t kSpillBytes = size_t{4} << 20;
+
+    /**
+     * Exclusive bounds on the keys a scan returns.
+     */
+    struct KeyRange {
+        std::optional<Key> above;
+        std::optional<Key> below;
+        bool contains(const Key& k) const {
+            return (!above || *above < k) && (!below || k < *below);
+        }
+    };
+
+    /**
+     * Archive position taken by mark(); truncate() rolls back to it. Carries
+     * the (small) rewritten/removed side map so later removals are undone too.
+     * A default Mark is the empty archive.
+     */
+    struct Mark {
+        uint64_t ordinal{0};
+        uint64_t end_offset{0};
+        uint64_t max_seq{0};
+        size_t live{0};
+        std::unordered_map<uint64_t, uint64_t> moved;
+    };
+
+private:
+    struct Record {
+        Key key;
+        uint64_t ordinal{0};    // Position in the log
+        Order order;
+    };
+    using PageData = std::vector<Record>;
+
+public:
+    /**
+     * Lazily merged walk over the live records in key order. Pages are decoded
+     * only once their key span can reach the front of the walk. Invalidated by
+     * any mutation of the archive.
+     */
+    class Scan {
+    public:
+        bool done() const { return heap_.empty(); }
+        const Key& key() const { return heap_.front().rec->key; }
+        const Order& order() const { return heap_.front().rec->order; }
+        void next();
+
+    private:
+        friend class OrderArchive;
+        struct Item {
+            const Record* rec;
+            std::shared_ptr<const PageData> page;
+        };
+
+        Scan(const OrderArchive& archive, KeyRange range,
+             const std::vector<std::string>& symbols, bool newest_first);
+        bool before(const Key& a, const Key& b) const { return newest_first_ ? b < a : a < b; }
+        void fill();
+
+        const OrderArchive* archive_;
+        KeyRange range_;
+        std::vector<std::string> symbols_;
+        bool newest_first_;
+        std::vector<uint32_t> pending_;   // Page numbers, next to open at the back
+        std::vector<Item> heap_;
+    };
+
+    OrderArchive() = default;
+    ~OrderArchive();
+    OrderArchive(const OrderArchive&) = delete;
+    OrderArchive& operator=(const OrderArchive&) = delete;
+
+    /**
+     * Back the archive with a file. With load_existing the page summaries are
+     * rebuilt from the file's records, otherwise the file is truncated.
+     */
+    bool attach_file(const std::string& path, bool load_existing);
+
+    void append(const Order& order, uint64_t seq);
+
+    /**
+     * Drop an order from the archive (the record stays in the log).
+     */
+    bool remove(const std::string& order_id);
+
+    std::optional<Order> get(const std::string& order_id) const;
+    std::optional<Order> get_by_client_id(const std::string& client_order_id) const;
+    std::optional<Key> key_of(const std::string& order_id) const;
+
+    /**
+     * Walk live records within range, optionally restricted to symbols (empty =
+     * all).
+     */
+    Scan scan(const KeyRange& range, const std::vector<std::string>& symbols, bool newest_first) const;
+
+    Mark mark() const;
+
+    /**
+     * Drop every record appended after mark (from the file as well) and undo
+     * later removals. A mark from another archive, or ahead of this one, is
+     * ignored.
+     */
+    void truncate(const Mark& mark);
+
+    void clear();
+    size_t size() const { return live_; }
+    uint64_t bytes() const { return end_offset_; }
+    uint64_t max_seq() const { return max_seq_; }
+    size_t page_count() const { return pages_.size(); }
+    /** True once the log lives in a file, attached or spilled. */
+    bool on_disk() const { return !path_.empty(); }
+
+private:
+    static constexpr uint64_t kRemoved = ~uint64_t{0};
+
+    struct Bloom {
+        std::vector<uint64_t> words;
+        explicit Bloom(size_t bits = 0) : words(bits / 64, 0) {}
+        void add(uint64_t h);
+        bool may_contain(uint64_t h) const;
+    };
+
+    struct Page {
+        uint64_t offset{0};
+        uint64_t bytes{0};
+        uint64_t first_ordinal{0};
+        uint32_t count{0};
+        Key min_key{std::numeric_limits<int64_t>::max(), 0};
+        Key max_key{std::numeric_limits<int64_t>::min(), 0};
+        Bloom filter;
+    };
+
+    struct Hit {
+        std::shared_ptr<const PageData> page;
+        const Record* rec;
+    };
+
+    bool live(const Record& r) const;
+    std::optional<Hit> find_latest(uint64_t hash, bool by_client_id, const std::string& value) const;
+    uint64_t index_record(const Order& order, uint64_t seq, uint64_t offset, uint64_t length);
+    std::shared_ptr<const PageData> load_page(uint32_t page) const;
+    std::optional<std::string> read_range(uint64_t offset, uint64_t length) const;
+    void open_for_append(std::ios::openmode extra);
+    void spill_to_temp_file();
+    void drop_temp_file();
+
+    std::string path_;
+    mutable std::fstream file_;
+    mutable bool dirty_{false};
+    bool temp_file_{false};         // path_ was made by spill_to_temp_file
+    bool spill_failed_{false};
+    std::string segment_;           // Used until a file is attached or spilled to
+    uint64_t end_offset_{0};
+    uint64_t max_seq_{0};
+    uint64_t next_ordinal_{0};
+    size_t live_{0};
+    std::vector<Page> pages_;
+    std::vector<Bloom> segments_;   // One per kSegmentPages pages
+    std::unordered_map<uint64_t, uint64_t> moved_;   // seq -> ordinal of its live record, or kRemoved
+    mutable std::vector<std::pair<uint32_t, std::shared_ptr<const PageData>>> cache_;   // Most recent first
+};
+
+} // namespace broker_sim
@@ -0,0 +1,306 @@
+#include "order_store.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace broker_sim {
+
+namespace {
+
+using Key = OrderArchive::Key;
+using KeyRange = OrderArchive::KeyRange;
+
+struct Range {
+    OrderStore::Index::const_iterator lo;
+    OrderStore::Index::const_iterator hi;
+    bool empty() const { return lo == hi; }
+};
+
+KeyRange key_range(const OrderQuery& query) {
+    constexpr uint64_t kMaxSeq = std::numeric_limits<uint64_t>::max();
+    KeyRange range;
+    if (query.after_ns) range.above = Key{*query.after_ns, kMaxSeq};
+    if (query.until_ns) range.below = Key{*query.until_ns, 0};
+    if (query.cursor) {
+        Key c{query.cursor->submitted_at_ns, query.cursor->seq};
+        if (query.newest_first) {
+            if (!range.below || c < *range.below) range.below = c;
+        } else {
+            if (!range.above || *range.above < c) range.above = c;
+        }
+    }
+    return range;
+}
+
+Range bounded_range(const OrderStore::Index& index, const KeyRange& range) {
+    auto lo = range.above ? index.upper_bound(*range.above) : index.begin();
+    auto hi = range.below ? index.lower_bound(*range.below) : index.end();
+    if (lo == index.end() || (hi != index.end() && !(*lo < *hi))) hi = lo;
+    return Range{lo, hi};
+}
+
+} // namespace
+
+void OrderStore::upsert(const Order& order) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    upsert_locked(order);
+}
+
+bool OrderStore::update(const std::string& order_id, const std::function<void(Order&)>& fn) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = by_id_.find(order_id);
+    if (it != by_id_.end()) {
+        Slot& slot = hot_.at(it->second);
+        Order before = slot.order;
+        fn(slot.order);
+        if (!is_terminal_order_status(slot.order.status) &&
+            slot.order.submitted_at_ns == before.submitted_at_ns &&
+            slot.order.symbol == before.symbol &&
+            slot.order.client_order_id == before.client_order_id) {
+            return true;  // Index keys unchanged
+        }
+        Order after = slot.order;
+        slot.order = std::move(before);
+        upsert_locked(after);
+        return true;
+    }
+    auto cold = archive_.get(order_id);
+    if (!cold) return false;
+    fn(*cold);
+    upsert_locked(*cold);
+    return true;
+}
+
+std::optional<Order> OrderStore::get(const std::string& order_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = by_id_.find(order_id);
+    if (it != by_id_.end()) return hot_.at(it->second).order;
+    return archive_.get(order_id);
+}
+
+std::optional<Order> OrderStore::get_by_client_id(const std::string& client_order_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = by_client_id_.find(client_order_id);
+    if (it != by_client_id_.end()) return hot_.at(it->second).order;
+    return archive_.get_by_client_id(client_order_id);
+}
+
+std::optional<OrderCursor> OrderStore::visit(const OrderQuery& query, const Visitor& fn) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const KeyRange bounds = key_range(query);
+
+    static const Index kEmpty;
+    Range hot{kEmpty.end(), kEmpty.end()};
+    if (query.status != OrderStatusFilter::CLOSED) {
+        const Index* index = &by_time_;
+        if (query.symbols.size() == 1) {
+            auto it = by_symbol_.find(query.symbols.front());
+            index = it != by_symbol_.end() ? &it->second : &kEmpty;
+        }
+        hot = bounded_range(*index, bounds);
+    }
+    std::optional<OrderArchive::Scan> cold;
+    if (query.status != OrderStatusFilter::OPEN) {
+        cold.emplace(archive_.scan(bounds, query.symbols, query.newest_first));
+    }
+
+    auto hot_matches = [&](const Order& order) {
+        return query.symbols.size() <= 1 ||
+               std::find(query.symbols.begin(), query.symbols.end(), order.symbol) != query.symbols.end();
+    };
+    auto any_left = [&]() { return !hot.empty() || (cold && !cold->done()); };
+
+    size_t count = 0;
+    while (any_left()) {
+        bool take_cold = hot.empty();
+        if (!take_cold && cold && !cold->done()) {
+            const Key& h = query.newest_first ? *std::prev(hot.hi) : *hot.lo;
+            take_cold = query.newest_first ? h < cold->key() : cold->key() < h;
+        }
+        Key key;
+        bool keep_going;
+        if (take_cold) {
+            key = cold->key();
+            keep_going = fn(cold->order());
+            cold->next();
+        } else {
+            if (query.newest_first) {
+                --hot.hi;
+                key = *hot.hi;
+            } else {
+                key = *hot.lo;
+                ++hot.lo;
+            }
+            const Order& order = hot_.at(key.second).order;
+            if (!hot_matches(order)) continue;
+            keep_going = fn(order);
+        }
+        ++count;
+        if (!keep_going || (query.limit > 0 && count >= query.limit)) {
+            if (!any_left()) return std::nullopt;
+            return OrderCursor{key.first, key.second};
+        }
+    }
+    return std::nullopt;
+}
+
+OrderPage OrderStore::list(const OrderQuery& query) const {
+    OrderPage page;
+    if (query.limit > 0) page.orders.reserve(std::min<size_t>(query.limit, 1024));
+    page.next = visit(query, [&](const Order& o) {
+        page.orders.push_back(o);
+        return true;
+    });
+    return page;
+}
+
+std::vector<std::string> OrderStore::open_order_ids(const std::string& symbol) const {
+    std::vector<std::string> out;
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Index* index = &by_time_;
+    if (!symbol.empty()) {
+        auto it = by_symbol_.find(symbol);
+        if (it == by_symbol_.end()) return out;
+        index = &it->second;
+    }
+    out.reserve(index->size());
+    for (const auto& key : *index) {
+        out.push_back(hot_.at(key.second).order.id);
+    }
+    return out;
+}
+
+bool OrderStore::attach_archive(const std::string& path, bool load_existing) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool ok = archive_.attach_file(path, load_existing);
+    next_seq_ = std::max(next_seq_, archive_.max_seq() + 1);
+    return ok;
+}
+
+std::unordered_map<std::string, Order> OrderStore::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unordered_map<std::string, Order> out;
+    out.reserve(hot_.size() + archive_.size());
+    for (const auto& kv : hot_) {
+        out.emplace(kv.second.order.id, kv.second.order);
+    }
+    for (auto scan = archive_.scan({}, {}, false); !scan.done(); scan.next()) {
+        out.emplace(scan.order().id, scan.order());
+    }
+    return out;
+}
+
+std::unordered_map<std::string, Order> OrderStore::open_snapshot(OrderArchive::Mark* archive) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unordered_map<std::string, Order> out;
+    out.reserve(hot_.size());
+    for (const auto& kv : hot_) {
+        out.emplace(kv.second.order.id, kv.second.order);
+    }
+    if (archive) *archive = archive_.mark();
+    return out;
+}
+
+void OrderStore::restore(const std::unordered_map<std::string, Order>& orders) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    restore_locked(orders);
+}
+
+void OrderStore::restore(const std::unordered_map<std::string, Order>& orders,
+                         const OrderArchive::Mark& archive) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    archive_.truncate(archive);
+    restore_locked(orders);
+}
+
+void OrderStore::restore_locked(const std::unordered_map<std::string, Order>& orders) {
+    std::vector<const Order*> sorted;
+    sorted.reserve(orders.size());
+    for (const auto& kv : orders) sorted.push_back(&kv.second);
+    std::sort(sorted.begin(), sorted.end(), [](const Order* a, const Order* b) {
+        if (a->submitted_at_ns != b->submitted_at_ns) return a->submitted_at_ns < b->submitted_at_ns;
+        return a->id < b->id;
+    });
+
+    hot_.clear();
+    by_id_.clear();
+    by_client_id_.clear();
+    by_symbol_.clear();
+    by_time_.clear();
+    for (const auto* o : sorted) upsert_locked(*o);
+}
+
+void OrderStore::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hot_.clear();
+    by_id_.clear();
+    by_client_id_.clear();
+    by_symbol_.clear();
+    by_time_.clear();
+    archive_.clear();
+    next_seq_ = 1;
+}
+
+size_t OrderStore::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hot_.size() + archive_.size();
+}
+
+size_t OrderStore::open_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hot_.size();
+}
+
+size_t OrderStore::archived_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return archive_.size();
+}
+
+void OrderStore::upsert_locked(const Order& order) {
+    bool terminal = is_terminal_order_status(order.status);
+    uint64_t seq = 0;
+    auto hot_it = by_id_.find(order.id);
+    if (hot_it != by_id_.end()) {
+        seq = hot_it->second;
+        erase_hot_locked(order.id);
+    } else if (auto key = archive_.key_of(order.id)) {
+        seq = key->second;
+        if (!terminal) archive_.remove(order.id);
+    } else {
+        seq = next_seq_++;
+    }
+
+    if (terminal) {
+        archive_.append(order, seq);
+    } else {
+        insert_hot_locked(order, seq);
+    }
+}
+
+void OrderStore::insert_hot_locked(const Order& order, uint64_t seq) {
+    Key key{order.submitted_at_ns, seq};
+    hot_[seq] = Slot{order, key};
+    by_id_[order.id] = seq;
+    if (!order.client_order_id.empty()) by_client_id_[order.client_order_id] = seq;
+    by_symbol_[order.symbol].insert(key);
+    by_time_.insert(key);
+}
+
+void OrderStore::erase_hot_locked(const std::string& order_id) {
+    auto id_it = by_id_.find(order_id);
+    if (id_it == by_id_.end()) return;
+    uint64_t seq = id_it->second;
+    auto slot_it = hot_.find(seq);
+    const Slot& slot = slot_it->second;
+    auto cit = by_client_id_.find(slot.order.client_order_id);
+    if (cit != by_client_id_.end() && cit->second == seq) by_client_id_.erase(cit);
+    auto sit = by_symbol_.find(slot.order.symbol);
+    if (sit != by_symbol_.end()) {
+        sit->second.erase(slot.key);
+        if (sit->second.empty()) by_symbol_.erase(sit);
+    }
+    by_time_.erase(slot.key);
+    hot_.erase(slot_it);
+    by_id_.erase(id_it);
+}
+
+} // namespace broker_sim
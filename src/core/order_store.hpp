@@ -0,0 +1,145 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <optional>
+#include <functional>
+#include <mutex>
+#include "matching_engine.hpp"
+#include "order_archive.hpp"
+
+namespace broker_sim {
+
+/**
+ * True for statuses that can no longer change (filled, canceled, expired, rejected).
+ */
+inline bool is_terminal_order_status(OrderStatus status) {
+    return status == OrderStatus::FILLED ||
+           status == OrderStatus::CANCELED ||
+           status == OrderStatus::EXPIRED ||
+           status == OrderStatus::REJECTED;
+}
+
+enum class OrderStatusFilter { OPEN, CLOSED, ALL };
+
+/**
+ * Position in submission-time order; used to resume a listing.
+ */
+struct OrderCursor {
+    int64_t submitted_at_ns{0};
+    uint64_t seq{0};
+};
+
+struct OrderQuery {
+    OrderStatusFilter status{OrderStatusFilter::ALL};
+    std::vector<std::string> symbols;     // Empty = all symbols
+    std::optional<int64_t> after_ns;      // Exclusive lower bound on submitted_at_ns
+    std::optional<int64_t> until_ns;      // Exclusive upper bound on submitted_at_ns
+    std::optional<OrderCursor> cursor;    // Continue strictly past this position
+    bool newest_first{true};
+    size_t limit{0};                      // 0 = unlimited
+};
+
+struct OrderPage {
+    std::vector<Order> orders;
+    std::optional<OrderCursor> next;      // Set when more results may follow
+};
+
+/**
+ * Per-session order store.
+ *
+ * Open orders live in a compact hot table with secondary indexes (id,
+ * client_order_id, symbol, submission time). Orders that reach a terminal status
+ * move to an append-only OrderArchive, so hot-state memory is bounded by the
+ * open-order count while closed orders remain queryable. Both tiers share one
+ * submission sequence, so listings merge them in order; the archive decodes
+ * only the pages whose key span can reach the orders returned.
+ */
+class OrderStore {
+public:
+    using Index = std::set<OrderArchive::Key>;
+    using Visitor = std::function<bool(const Order&)>;
+
+    /**
+     * Insert a new order or overwrite an existing one with the same id.
+     */
+    void upsert(const Order& order);
+
+    /**
+     * Mutate an order in place, keeping indexes consistent. Returns false if unknown.
+     */
+    bool update(const std::string& order_id, const std::function<void(Order&)>& fn);
+
+    std::optional<Order> get(const std::string& order_id) const;
+    std::optional<Order> get_by_client_id(const std::string& client_order_id) const;
+
+    /**
+     * Visit matching orders in query order. Open orders are visited in place;
+     * archived ones are decoded one at a time. The visitor returns false to stop
+     * early and must not call back into the store.
+     */
+    std::optional<OrderCursor> visit(const OrderQuery& query, const Visitor& fn) const;
+
+    OrderPage list(const OrderQuery& query) const;
+    std::vector<std::string> open_order_ids(const std::string& symbol = "") const;
+
+    /**
+     * Persist archived orders to a file instead of memory. With load_existing the
+     * archive is reopened (crash recovery), otherwise it starts empty.
+     */
+    bool attach_archive(const std::string& path, bool load_existing);
+
+    /**
+     * Full copy keyed by id, including archived orders (legacy callers).
+     */
+    std::unordered_map<std::string, Order> snapshot() const;
+
+    /**
+     * Copy of the hot tier only (checkpoints). With archive set, also records
+     * the archive position under the same lock, for restore() after a seek.
+     */
+    std::unordered_map<std::string, Order> open_snapshot(OrderArchive::Mark* archive = nullptr) const;
+
+    /**
+     * Replace the hot tier from a checkpoint. Terminal orders in the input are
+     * archived; the existing archive is kept.
+     */
+    void restore(const std::unordered_map<std::string, Order>& orders);
+
+    /**
+     * Replace the hot tier and roll the archive back to the position taken
+     * with it, so orders closed after that point are gone from both tiers.
+     */
+    void restore(const std::unordered_map<std::string, Order>& orders, const OrderArchive::Mark& archive);
+    void clear();
+
+    size_t size() const;
+    size_t open_count() const;
+    size_t archived_count() const;
+
+private:
+    using Key = OrderArchive::Key;
+
+    struct Slot {
+        Order order;
+        Key key;
+    };
+
+    void restore_locked(const std::unordered_map<std::string, Order>& orders);
+    void upsert_locked(const Order& order);
+    void insert_hot_locked(const Order& order, uint64_t seq);
+    void erase_hot_locked(const std::string& order_id);
+
+    mutable std::mutex mutex_;
+    uint64_t next_seq_{1};
+    std::unordered_map<uint64_t, Slot> hot_;
+    std::unordered_map<std::string, uint64_t> by_id_;
+    std::unordered_map<std::string, uint64_t> by_client_id_;
+    std::unordered_map<std::string, Index> by_symbol_;
+    Index by_time_;
+    OrderArchive archive_;
+};
+
+} // namespace broker_sim
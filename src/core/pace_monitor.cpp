@@ -0,0 +1,63 @@
+#include "pace_monitor.hpp"
+
+#include <algorithm>
+
+namespace broker_sim {
+
+PaceReport PaceMonitor::observe(const PaceObservation& now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PaceReport report;
+    report.lag_ns = now.lag_ns;
+    report.feeder_lead_ns = now.feeder_lead_ns;
+    report.queue_depth = now.queue_depth;
+
+    const PaceObservation* ref = samples_.empty() ? nullptr : &samples_.front();
+    for (auto it = samples_.rbegin(); it != samples_.rend(); ++it) {
+        if (now.steady_ns - it->steady_ns >= kWindowNs) {
+            ref = &*it;
+            break;
+        }
+    }
+    if (ref && now.steady_ns > ref->steady_ns) {
+        const double wall = static_cast<double>(now.steady_ns - ref->steady_ns);
+        report.window_ns = now.steady_ns - ref->steady_ns;
+        // A jump or seek moves the clock back; report no progress rather than a negative rate.
+        report.achieved_speed = static_cast<double>(std::max<int64_t>(0, now.sim_ns - ref->sim_ns)) / wall;
+        if (now.events_processed >= ref->events_processed) {
+            report.events_per_sec = static_cast<double>(now.events_processed - ref->events_processed) * 1e9 / wall;
+        }
+        report.lag_growth_ns = now.lag_ns - ref->lag_ns;
+        report.falling_behind = report.lag_growth_ns * 20 > report.window_ns;
+    }
+
+    if (samples_.empty() || now.steady_ns - samples_.back().steady_ns >= kSampleSpacingNs) {
+        samples_.push_back(now);
+        if (samples_.size() > kHistory) samples_.pop_front();
+    }
+    report.queue_depth_history.reserve(samples_.size());
+    for (const auto& s : samples_) {
+        report.queue_depth_history.emplace_back(s.unix_ms, s.queue_depth);
+    }
+    return report;
+}
+
+nlohmann::json PaceReport::to_json() const {
+    nlohmann::json history = nlohmann::json::array();
+    for (const auto& [unix_ms, depth] : queue_depth_history) {
+        history.push_back({unix_ms, depth});
+    }
+    return {
+        {"target_speed", target_speed},
+        {"achieved_speed", achieved_speed},
+        {"events_per_sec", events_per_sec},
+        {"window_ns", window_ns},
+        {"lag_ns", lag_ns},
+        {"lag_growth_ns", lag_growth_ns},
+        {"falling_behind", falling_behind},
+        {"feeder_lead_ns", feeder_lead_ns},
+        {"queue_depth", queue_depth},
+        {"queue_depth_history", std::move(history)}
+    };
+}
+
+} // namespace broker_sim
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace broker_sim {
+
+/** One reading of a session's clock and queue, taken by PaceMonitor::observe. */
+struct PaceObservation {
+    int64_t steady_ns{0};        // steady clock, for rates
+    int64_t unix_ms{0};          // wall clock, for the reported history
+    int64_t sim_ns{0};           // session simulated time
+    uint64_t events_processed{0};
+    int64_t lag_ns{0};           // TimeEngine::schedule_lag_ns()
+    int64_t feeder_lead_ns{0};   // newest enqueued event minus simulated time
+    size_t queue_depth{0};
+};
+
+struct PaceReport {
+    double target_speed{0.0};    // TimeEngine speed factor, 0 = as fast as possible
+    double achieved_speed{0.0};  // simulated ns per wall ns over window_ns
+    double events_per_sec{0.0};
+    int64_t window_ns{0};        // 0 until a second observation exists
+    int64_t lag_ns{0};
+    int64_t lag_growth_ns{0};    // lag change over window_ns
+    bool falling_behind{false};  // lag grew by more than 5% of the window
+    int64_t feeder_lead_ns{0};
+    size_t queue_depth{0};
+    std::vector<std::pair<int64_t, size_t>> queue_depth_history;  // (unix_ms, depth), oldest first
+
+    nlohmann::json to_json() const;
+};
+
+/**
+ * Rolling pace statistics for one session.
+ *
+ * Nothing samples in the background: stats requests and the status heartbeat
+ * call observe(), which keeps roughly one sample per second for the last two
+ * minutes and compares the current reading with the sample ~5s back (or the
+ * oldest one when queried less often).
+ */
+class PaceMonitor {
+public:
+    static constexpr int64_t kSampleSpacingNs = 900'000'000;  // heartbeat ticks land ~1s apart
+    static constexpr int64_t kWindowNs = 5'000'000'000;
+    static constexpr size_t kHistory = 120;
+
+    PaceReport observe(const PaceObservation& now);
+
+private:
+    std::mutex mutex_;
+    std::deque<PaceObservation> samples_;
+};
+
+} // namespace broker_sim
@@ -5,31 +5,41 @@ namespace broker_sim {
 
 void PerformanceTracker::record(Timestamp ts, double equity) {
     std::lock_guard<std::mutex> lock(mutex_);
-    if (!series_.empty() && series_.back().timestamp == ts) {
-        series_.back().equity = equity;
+    auto& series = series_.mut();
+    if (!series.empty() && series.back().timestamp == ts) {
+        series.back().equity = equity;
         return;
     }
-    series_.push_back({ts, equity});
+    series.push_back({ts, equity});
 }
 
 std::vector<EquityPoint> PerformanceTracker::points(size_t limit) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    if (limit == 0 || series_.size() <= limit) return series_;
-    return std::vector<EquityPoint>(series_.end() - limit, series_.end());
+    const auto& series = *series_;
+    if (limit == 0 || series.size() <= limit) return series;
+    return std::vector<EquityPoint>(series.end() - limit, series.end());
+}
+
+std::shared_ptr<PerformanceTracker> PerformanceTracker::fork() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto copy = std::make_shared<PerformanceTracker>();
+    copy->series_ = series_;
+    return copy;
 }
 
 PerformanceMetrics PerformanceTracker::metrics() const {
     std::lock_guard<std::mutex> lock(mutex_);
     PerformanceMetrics out;
-    if (series_.size() < 2) return out;
+    const auto& series = *series_;
+    if (series.size() < 2) return out;
 
-    double start = series_.front().equity;
-    double end = series_.back().equity;
+    double start = series.front().equity;
+    double end = series.back().equity;
     if (start != 0.0) out.total_return = (end - start) / start;
 
-    double peak = series_.front().equity;
+    double peak = series.front().equity;
     double max_dd = 0.0;
-    for (const auto& p : series_) {
+    for (const auto& p : series) {
         if (p.equity > peak) peak = p.equity;
         double dd = peak > 0.0 ? (peak - p.equity) / peak : 0.0;
         if (dd > max_dd) max_dd = dd;
@@ -37,10 +47,10 @@ PerformanceMetrics PerformanceTracker::metrics() const {
     out.max_drawdown = max_dd;
 
     std::vector<double> rets;
-    rets.reserve(series_.size() - 1);
-    for (size_t i = 1; i < series_.size(); ++i) {
-        double prev = series_[i - 1].equity;
-        double cur = series_[i].equity;
+    rets.reserve(series.size() - 1);
+    for (size_t i = 1; i < series.size(); ++i) {
+        double prev = series[i - 1].equity;
+        double cur = series[i].equity;
         if (prev != 0.0) rets.push_back((cur - prev) / prev);
     }
     if (rets.size() >= 2) {
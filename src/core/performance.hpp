@@ -3,6 +3,8 @@
 #include <vector>
 #include <chrono>
 #include <mutex>
+#include <memory>
+#include "cow.hpp"
 
 namespace broker_sim {
 
@@ -24,10 +26,12 @@ public:
     void record(Timestamp ts, double equity);
     std::vector<EquityPoint> points(size_t limit = 0) const;
     PerformanceMetrics metrics() const;
+    /** Copy for a session fork; the equity history is shared copy-on-write. */
+    std::shared_ptr<PerformanceTracker> fork() const;
 
 private:
     mutable std::mutex mutex_;
-    std::vector<EquityPoint> series_;
+    Cow<std::vector<EquityPoint>> series_;
 };
 
 } // namespace broker_sim
@@ -1,18 +1,76 @@
 #include "session_manager.hpp"
+#include "alloc_tracking.hpp"
 #include <spdlog/spdlog.h>
 #include <spdlog/fmt/fmt.h>
 #include "data_source_stub.hpp"
 #include "checkpoint.hpp"
+#include "strategy_loader.hpp"
 #include "../ws/status_ws_controller.hpp"
 #include <algorithm>
 #include <cctype>
 #include <cmath>
+#include <limits>
 #include <sstream>
+#include <stdexcept>
 
 namespace broker_sim {
 
 namespace {
 
+/**
+ * Deferred WAL/event-log writes for a batch order call on this thread. The
+ * caller holds the session's step_mutex until the group is flushed, so the
+ * batch lands in the WAL as one contiguous run between market events.
+ */
+struct OrderGroup {
+    OrderGroup(const Session* owner, bool write_wal) : session(owner), has_wal(write_wal) {}
+
+    const Session* session;
+    bool has_wal;
+    std::string wal;    // Serialized on append so the batch never copies json trees
+    std::string log;
+};
+
+thread_local OrderGroup* tls_order_group = nullptr;
+
+bool has_wal(Session& session) {
+    std::lock_guard<std::mutex> lock(session.wal_mutex);
+    return session.wal != nullptr;
+}
+
+Event make_market_event(const MarketEvent& ev, uint64_t sequence) {
+    if (ev.type == MarketEventType::QUOTE) {
+        return Event{ev.timestamp, sequence, EventType::QUOTE, ev.quote.symbol,
+                     QuoteData{ev.quote.bid_price, ev.quote.bid_size, ev.quote.ask_price, ev.quote.ask_size,
+                               ev.quote.bid_exchange, ev.quote.ask_exchange, ev.quote.tape}};
+    }
+    return Event{ev.timestamp, sequence, EventType::TRADE, ev.trade.symbol,
+                 TradeData{ev.trade.price, ev.trade.size, ev.trade.exchange, ev.trade.conditions, ev.trade.tape}};
+}
+
+Event make_unified_event(const UnifiedMarketEvent& ev, uint64_t sequence) {
+    if (ev.type == UnifiedEventType::QUOTE) {
+        return Event{ev.timestamp, sequence, EventType::QUOTE, ev.quote.symbol,
+                     QuoteData{ev.quote.bid_price, ev.quote.bid_size, ev.quote.ask_price, ev.quote.ask_size,
+                               ev.quote.bid_exchange, ev.quote.ask_exchange, ev.quote.tape}};
+    }
+    if (ev.type == UnifiedEventType::TRADE) {
+        return Event{ev.timestamp, sequence, EventType::TRADE, ev.trade.symbol,
+                     TradeData{ev.trade.price, ev.trade.size, ev.trade.exchange, ev.trade.conditions, ev.trade.tape}};
+    }
+    return Event{ev.timestamp, sequence, EventType::BAR, ev.bar.symbol,
+                 BarData{ev.bar.open, ev.bar.high, ev.bar.low, ev.bar.close, ev.bar.volume, ev.bar.vwap,
+                         ev.bar.trade_count}};
+}
+
+constexpr char kSweepMemberFailed = 2;
+
+// Finished control commands stay pollable until this many newer ones exist.
+constexpr size_t kMaxRetainedCommands = 1024;
+
+// Daily bars searched for a prior close: covers weekends plus holiday runs.
+constexpr int kPriorCloseLookbackDays = 14;
+
 void advance_session_clock_to_window_end(const std::shared_ptr<Session>& session,
                                          Timestamp window_end) {
     if (!session || session->time_engine->is_paused()) {
@@ -190,15 +248,31 @@ std::chrono::milliseconds compute_iteration_sleep(std::chrono::steady_clock::tim
                     std::chrono::duration_cast<std::chrono::milliseconds>(target - elapsed));
 }
 
-std::optional<double> resolve_decision_fill_price(const std::shared_ptr<DataSource>& data_source,
-                                                  const std::shared_ptr<Session>& session,
-                                                  const Order& order,
-                                                  Timestamp decision_time) {
+void log_decision_fill_choice(const Order& order, const char* source,
+                              Timestamp decision_time, Timestamp source_ts, double chosen_price) {
+    auto ts_ns = [](Timestamp ts) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(ts.time_since_epoch()).count();
+    };
+    spdlog::info(
+        "Decision-time fill source={} order={} symbol={} side={} decision_ns={} source_ns={} price={}",
+        source,
+        order.id,
+        order.symbol,
+        order.side == OrderSide::BUY ? "BUY" : "SELL",
+        ts_ns(decision_time),
+        ts_ns(source_ts),
+        chosen_price);
+}
+
+// Market-data half of the decision-time fill: quotes, trades and bars around
+// decision_time. Only touches the data source, so it runs before the step lock.
+std::optional<double> lookup_decision_fill_price(const std::shared_ptr<DataSource>& data_source,
+                                                 const Order& order,
+                                                 Timestamp decision_time) {
     if (!data_source) {
         return std::nullopt;
     }
 
-    const auto decision_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(decision_time.time_since_epoch()).count();
     const auto forward_end = decision_time + std::chrono::seconds(90);
     const auto short_forward_end = decision_time + std::chrono::seconds(5);
     const auto quote_lookback_start = decision_time - std::chrono::seconds(15);
@@ -206,20 +280,8 @@ std::optional<double> resolve_decision_fill_price(const std::shared_ptr<DataSour
     const auto minute_lookback_start = decision_time - std::chrono::minutes(2);
     const auto inclusive_decision_end = decision_time + std::chrono::milliseconds(1);
 
-    auto ts_ns = [](Timestamp ts) {
-        return std::chrono::duration_cast<std::chrono::nanoseconds>(ts.time_since_epoch()).count();
-    };
-
     auto log_fill_choice = [&](const char* source, Timestamp source_ts, double chosen_price) {
-        spdlog::info(
-            "Decision-time fill source={} order={} symbol={} side={} decision_ns={} source_ns={} price={}",
-            source,
-            order.id,
-            order.symbol,
-            order.side == OrderSide::BUY ? "BUY" : "SELL",
-            decision_ns,
-            ts_ns(source_ts),
-            chosen_price);
+        log_decision_fill_choice(order, source, decision_time, source_ts, chosen_price);
     };
 
     auto quote_fill_price = [&](const QuoteRecord& q) -> std::optional<double> {
@@ -290,6 +352,25 @@ std::optional<double> resolve_decision_fill_price(const std::shared_ptr<DataSour
         }
     }
 
+    return std::nullopt;
+}
+
+// Session half of the decision-time fill: falls back to the engine NBBO and the
+// position mark when the market-data lookup found nothing. Runs under the step.
+std::optional<double> resolve_decision_fill_price(const std::shared_ptr<Session>& session,
+                                                  const Order& order,
+                                                  Timestamp decision_time,
+                                                  std::optional<double> looked_up) {
+    if (looked_up) {
+        return looked_up;
+    }
+
+    const auto decision_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(decision_time.time_since_epoch()).count();
+    const auto forward_end = decision_time + std::chrono::seconds(90);
+    auto log_fill_choice = [&](const char* source, Timestamp source_ts, double chosen_price) {
+        log_decision_fill_choice(order, source, decision_time, source_ts, chosen_price);
+    };
+
     auto nbbo = session->matching_engine->get_nbbo(order.symbol);
     if (nbbo && nbbo->timestamp > 0) {
         auto nbbo_ts = Timestamp{} + std::chrono::nanoseconds(nbbo->timestamp);
@@ -341,9 +422,64 @@ std::optional<double> resolve_decision_fill_price(const std::shared_ptr<DataSour
 }  // namespace
 
 
+/**
+ * StrategyContext bound to one session; routes orders through the same
+ * SessionManager paths as the HTTP controllers, minus the session lookup.
+ */
+class SessionStrategyContext : public StrategyContext {
+public:
+    SessionStrategyContext(SessionManager& mgr, const std::shared_ptr<Session>& session)
+        : mgr_(mgr), session_(session), session_id_(session->id) {}
+
+    const std::string& session_id() const override { return session_id_; }
+
+    Timestamp now() const override {
+        auto session = session_.lock();
+        return session ? session->time_engine->current_time() : Timestamp{};
+    }
+
+    std::string submit_order(Order order) override {
+        auto session = session_.lock();
+        if (!session) return {};
+        auto lookups = mgr_.lookup_order_data(session, order);
+        return mgr_.submit_order_impl(session, std::move(order), lookups);
+    }
+
+    bool cancel_order(const std::string& order_id) override {
+        auto session = session_.lock();
+        if (!session) return false;
+        return mgr_.cancel_order_impl(session, order_id);
+    }
+
+    std::optional<Order> get_order(const std::string& order_id) const override {
+        auto session = session_.lock();
+        if (!session) return std::nullopt;
+        return session->orders.get(order_id);
+    }
+
+    AccountState account() const override {
+        auto session = session_.lock();
+        return session ? session->account_manager->state() : AccountState{};
+    }
+
+    double position_qty(const std::string& symbol) const override {
+        auto session = session_.lock();
+        if (!session) return 0.0;
+        auto positions = session->account_manager->positions();
+        auto it = positions.find(symbol);
+        return it != positions.end() ? it->second.qty : 0.0;
+    }
+
+private:
+    SessionManager& mgr_;
+    std::weak_ptr<Session> session_;
+    std::string session_id_;
+};
+
 Session::Session(const std::string& session_id, const SessionConfig& cfg)
     : id(session_id)
     , config(cfg)
+    , window_start(cfg.start_time)
     , time_engine(std::make_shared<TimeEngine>())
     , event_queue(std::make_shared<EventQueue>(cfg.queue_capacity, cfg.overflow_policy))
     , matching_engine(std::make_shared<MatchingEngine>())
@@ -359,6 +495,11 @@ Session::Session(const std::string& session_id, const SessionConfig& cfg)
     time_engine->set_time(cfg.start_time);
     time_engine->set_speed(cfg.speed_factor);
     perf->record(cfg.start_time, cfg.initial_capital);
+    auto& metrics = MetricsRegistry::instance();
+    event_latency = metrics.histogram("broker_session_event_seconds",
+                                      "Wall time to apply one market event", {{"session", session_id}});
+    queue_wait = metrics.histogram("broker_session_queue_wait_seconds",
+                                   "Time events spend in the session queue", {{"session", session_id}});
 }
 
 Session::~Session() {
@@ -375,9 +516,15 @@ void Session::stop() {
     if (polling_thread && polling_thread->joinable()) {
         polling_thread->join();
     }
+    join_loop();
+}
+
+void Session::join_loop() {
     if (worker_thread && worker_thread->joinable()) {
         worker_thread->join();
     }
+    std::unique_lock<std::mutex> lock(loop_mutex);
+    loop_cv.wait(lock, [this] { return !loop_active; });
 }
 
 SessionManager::SessionManager(std::shared_ptr<DataSource> data_source,
@@ -398,18 +545,40 @@ SessionManager::SessionManager(std::shared_ptr<DataSource> data_source,
 }
 
 SessionManager::~SessionManager() {
+    // Let a running control command finish; queued ones are dropped.
+    control_pool_.reset();
     stop_shared_feeder();
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::shared_ptr<SweepGroup>> sweeps;
+    {
+        std::lock_guard<InstrumentedMutex> lock(mutex_);
+        for (auto& kv : sweeps_) sweeps.push_back(kv.second);
+    }
+    for (auto& group : sweeps) {
+        group->should_stop.store(true);
+        if (group->driver && group->driver->joinable()) group->driver->join();
+    }
+    std::lock_guard<InstrumentedMutex> lock(mutex_);
     for (auto& kv : sessions_) {
         kv.second->stop();
     }
 }
 
+SweepGroup::~SweepGroup() {
+    should_stop.store(true);
+    if (driver && driver->joinable()) {
+        if (driver->get_id() == std::this_thread::get_id()) {
+            driver->detach();
+        } else {
+            driver->join();
+        }
+    }
+}
+
 std::shared_ptr<Session> SessionManager::create_session(const SessionConfig& config,
                                                         std::optional<std::string> session_id) {
     std::string id = session_id.value_or(generate_uuid());
     {
-        std::lock_guard<std::mutex> lock(mutex_);
+        std::lock_guard<InstrumentedMutex> lock(mutex_);
         auto it = sessions_.find(id);
         if (it != sessions_.end()) {
             return it->second;
@@ -418,19 +587,31 @@ std::shared_ptr<Session> SessionManager::create_session(const SessionConfig& con
     auto session = std::make_shared<Session>(id, config);
 
     // Apply execution configuration to matching engine
-    session->matching_engine->set_config(exec_cfg_);
+    session->matching_engine->set_config(exec_cfg_for(*session));
+    session->tracer.set_sample_every(static_cast<uint32_t>(std::max(0, exec_cfg_for(*session).trace_sample_every)));
+
+    if (!config.strategy_library.empty()) {
+        session->strategy = load_strategy_library(config.strategy_library, config.strategy_params);
+        session->strategy_ctx = std::make_unique<SessionStrategyContext>(*this, session);
+        session->strategy_attached.store(session->strategy != nullptr, std::memory_order_release);
+    }
 
     {
-        std::lock_guard<std::mutex> lock(mutex_);
+        std::lock_guard<InstrumentedMutex> lock(mutex_);
         sessions_[id] = session;
     }
+    attach_session_storage(session, true);
+    return session;
+}
 
+void SessionManager::attach_session_storage(const std::shared_ptr<Session>& session, bool recover) {
+    const std::string& id = session->id;
     try {
         std::string wal_dir = exec_cfg_.wal_directory.empty() ? "logs" : exec_cfg_.wal_directory;
         std::filesystem::create_directories(wal_dir);
 
         {
-            std::lock_guard<std::mutex> l(log_mutex_);
+            std::lock_guard<InstrumentedMutex> l(log_mutex_);
             session_logs_[id] = std::ofstream(wal_dir + "/session_" + id + ".events.jsonl",
                                               std::ios::out | std::ios::trunc);
         }
@@ -439,32 +620,336 @@ std::shared_ptr<Session> SessionManager::create_session(const SessionConfig& con
             std::lock_guard<std::mutex> lock(session->wal_mutex);
             session->wal = std::make_unique<WalLogger>(wal_path(wal_dir, id));
         }
+        if (exec_cfg_.enable_wal) {
+            bool recovering = recover && std::filesystem::exists(checkpoint_path(wal_dir, id));
+            session->orders.attach_archive(order_archive_path(wal_dir, id), recovering);
+        }
 
         // Attempt recovery from prior checkpoint
-        if (restore_session(session)) {
+        if (recover && restore_session(session)) {
             spdlog::info("Recovered session {} from checkpoint and WAL", id);
         }
     } catch (const std::exception& e) {
         spdlog::warn("Failed to init event log for session {}: {}", id, e.what());
     }
+}
 
-    return session;
+std::shared_ptr<Session> SessionManager::fork_session(const std::string& parent_id,
+                                                      std::optional<std::string> session_id) {
+    auto parent = get_session(parent_id);
+    if (!parent) {
+        throw std::invalid_argument("session not found");
+    }
+    const SessionStatus parent_status = parent->status;
+    if (parent_status != SessionStatus::RUNNING && parent_status != SessionStatus::PAUSED) {
+        throw std::invalid_argument("only running or paused sessions can be forked");
+    }
+    std::string id = session_id.value_or(generate_uuid());
+    if (get_session(id)) {
+        throw std::invalid_argument("session id already exists");
+    }
+
+    std::shared_ptr<SessionSnapshot> snap;
+    {
+        // Whole-event snapshot: the parent loop cannot be mid-event here.
+        std::lock_guard<std::mutex> step(parent->step_mutex);
+        snap = capture_snapshot(*parent);
+    }
+    snap->archive_mark = {};  // the parent's closed orders stay with the parent
+    SessionConfig cfg = parent->config;
+    if (snap->cursor_ns > 0) {
+        cfg.start_time = Timestamp{} + std::chrono::nanoseconds(snap->cursor_ns);
+    }
+    auto child = std::make_shared<Session>(id, cfg);
+    child->forked_from = parent->id;
+    restore_snapshot(*child, *snap);
+    child->time_engine->set_speed(parent->time_engine->speed());
+    child->tracer.set_sample_every(parent->tracer.sample_every());
+
+    // Strategy state is opaque; the branch gets a fresh instance of the same library.
+    if (!child->config.strategy_library.empty()) {
+        child->strategy = load_strategy_library(child->config.strategy_library, child->config.strategy_params);
+        child->strategy_ctx = std::make_unique<SessionStrategyContext>(*this, child);
+        child->strategy_attached.store(child->strategy != nullptr, std::memory_order_release);
+    }
+    {
+        std::lock_guard<InstrumentedMutex> lock(mutex_);
+        if (!sessions_.emplace(id, child).second) {
+            throw std::invalid_argument("session id already exists");
+        }
+    }
+    {
+        std::lock_guard<InstrumentedMutex> lock(stream_mutex_);
+        auto it = stream_symbol_counts_.find(parent->id);
+        if (it != stream_symbol_counts_.end()) {
+            stream_symbol_counts_[id] = it->second;
+            publish_stream_subscriptions_locked(*child, it->second);
+        }
+    }
+    attach_session_storage(child, false);
+    nlohmann::json w{{"event","session_forked"},{"session_id",id},{"parent_id",parent->id},
+                     {"ts_ns", child->last_event_ns.load(std::memory_order_acquire)}};
+    append_wal(child, w);
+    spdlog::info("Session {} forked from {} at cursor_ns={} (skip {})",
+                 id, parent->id, child->last_event_ns.load(), child->resume_skip_events.load());
+
+    start_session(id);
+    if (parent_status == SessionStatus::PAUSED) {
+        pause_session(id);
+    }
+    return child;
+}
+
+bool SessionManager::skip_replayed_event(Session& session, Timestamp ts) {
+    if (session.resume_skip_events.load(std::memory_order_relaxed) == 0) return false;
+    if (ts != session.config.start_time) {
+        if (ts > session.config.start_time) session.resume_skip_events.store(0, std::memory_order_relaxed);
+        return false;
+    }
+    session.resume_skip_events.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+std::shared_ptr<SessionSnapshot> SessionManager::capture_snapshot(Session& session) {
+    auto snap = std::make_shared<SessionSnapshot>();
+    snap->sim_time = session.time_engine->current_time();
+    snap->cursor_ns = session.last_event_ns.load(std::memory_order_acquire);
+    snap->events_at_cursor = session.events_at_last_ts;
+    snap->events_processed = session.events_processed.load(std::memory_order_relaxed);
+    snap->cash = session.cash;
+    snap->equity = session.equity;
+    snap->margin_call_active = session.margin_call_active.load();
+    snap->matching_engine = session.matching_engine->fork();
+    snap->account_manager = session.account_manager->fork();
+    snap->perf = session.perf->fork();
+    snap->open_orders = session.orders.open_snapshot(&snap->archive_mark);
+    snap->symbol_state = session.symbol_state.snapshot();
+    snap->prior_close_day_ns = session.prior_close_day_ns;
+    snap->ssr_triggered_today = session.ssr_triggered_today;
+    return snap;
+}
+
+void SessionManager::restore_snapshot(Session& session, const SessionSnapshot& snap) {
+    // Fork again so the snapshot stays reusable for later seeks.
+    session.matching_engine = snap.matching_engine->fork();
+    session.matching_engine->set_config(exec_cfg_for(session));
+    session.account_manager = snap.account_manager->fork();
+    session.perf = snap.perf->fork();
+    session.orders.restore(snap.open_orders, snap.archive_mark);
+    session.cash = snap.cash;
+    session.equity = snap.equity;
+    session.margin_call_active.store(snap.margin_call_active);
+    session.time_engine->set_time(snap.sim_time);
+    session.last_event_ns.store(snap.cursor_ns, std::memory_order_release);
+    session.last_enqueued_ns.store(0, std::memory_order_relaxed);
+    session.events_at_last_ts = snap.events_at_cursor;
+    session.events_processed.store(snap.events_processed, std::memory_order_relaxed);
+    session.resume_skip_events.store(snap.cursor_ns > 0 ? snap.events_at_cursor : 0);
+    session.symbol_state.restore(snap.symbol_state);
+    // Band windows are not snapshotted; the next trade per symbol reseeds them.
+    session.luld.reset();
+    // The next event republishes that day's closes without a day roll.
+    session.prior_close_roll_ns = 0;
+    session.prior_close_day_ns = snap.prior_close_day_ns;
+    session.ssr_triggered_today = snap.ssr_triggered_today;
+}
+
+void SessionManager::maybe_snapshot(Session& session, Timestamp next_event_time) {
+    const auto& exec = exec_cfg_for(session);
+    if (exec.seek_snapshot_interval_seconds <= 0) return;
+    const int64_t next_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        next_event_time.time_since_epoch()).count();
+    if (next_ns < session.next_snapshot_ns) return;
+    if (session.snapshot_interval_ns == 0) {
+        session.snapshot_interval_ns = int64_t{exec.seek_snapshot_interval_seconds} * 1'000'000'000;
+    }
+    session.next_snapshot_ns = next_ns + session.snapshot_interval_ns;
+
+    auto snap = capture_snapshot(session);
+    const int64_t key = snap->cursor_ns > 0
+        ? snap->cursor_ns
+        : std::chrono::duration_cast<std::chrono::nanoseconds>(snap->sim_time.time_since_epoch()).count();
+    std::lock_guard<std::mutex> lock(session.snapshot_mutex);
+    session.snapshots[key] = std::move(snap);
+    if (exec.seek_snapshot_limit > 0 &&
+        session.snapshots.size() > static_cast<size_t>(exec.seek_snapshot_limit)) {
+        // Keep coverage of the whole run: drop every other snapshot (never the
+        // first) and space future ones twice as far apart.
+        bool drop = false;
+        for (auto it = session.snapshots.begin(); it != session.snapshots.end(); drop = !drop) {
+            it = drop ? session.snapshots.erase(it) : std::next(it);
+        }
+        session.snapshot_interval_ns *= 2;
+    }
+}
+
+void SessionManager::roll_prior_closes(Session& session, Timestamp now) {
+    const auto to_ns = [](Timestamp ts) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(ts.time_since_epoch()).count();
+    };
+    const int64_t today = to_ns(ExecutionConfig::et_date(now));
+    session.prior_close_roll_ns = to_ns(ExecutionConfig::next_et_midnight(now));
+
+    if (today != session.prior_close_day_ns) {
+        // Rule 201: a restriction lasts the rest of its trigger day and the
+        // whole next trading day, so only yesterday's triggers carry over.
+        if (session.prior_close_day_ns != 0) {
+            auto& carried = session.ssr_triggered_today;
+            std::sort(carried.begin(), carried.end());
+            for (const auto& [id, state] : session.symbol_state.snapshot()) {
+                if (state.ssr && !std::binary_search(carried.begin(), carried.end(), id)) {
+                    session.symbol_state.at(id)->ssr.store(false, std::memory_order_relaxed);
+                }
+            }
+        }
+        session.ssr_triggered_today.clear();
+        session.prior_close_day_ns = today;
+    }
+    publish_prior_closes(session);
+}
+
+void SessionManager::publish_prior_closes(Session& session) {
+    // Each symbol's most recent close in the lookback before today; symbols
+    // without one keep whatever close they already had.
+    const int64_t today = session.prior_close_day_ns;
+    const int64_t oldest = today - int64_t{24 * 3600} * kPriorCloseLookbackDays * 1'000'000'000;
+    for (const auto& [id, bars] : session.daily_closes) {
+        auto it = std::lower_bound(bars.begin(), bars.end(), std::make_pair(today, 0.0));
+        if (it == bars.begin() || std::prev(it)->first < oldest) continue;
+        if (auto* state = session.symbol_state.at(id)) {
+            state->prior_close.store(std::prev(it)->second, std::memory_order_relaxed);
+        }
+    }
+}
+
+DailyCloses SessionManager::load_daily_closes(const std::vector<std::string>& symbols,
+                                              Timestamp from, Timestamp to) const {
+    DailyCloses closes;
+    if (!data_source_ || symbols.empty()) return closes;
+    // One daily-bar query for every symbol over the whole window.
+    try {
+        data_source_->stream_aggregate_bars(symbols, from, to, 1, "day", [&](const BarRecord& bar) {
+            if (bar.close <= 0.0) return;
+            closes[SymbolTable::instance().intern(bar.symbol)].emplace_back(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(bar.timestamp.time_since_epoch()).count(),
+                bar.close);
+        });
+    } catch (const std::exception& e) {
+        spdlog::warn("Prior close load failed: {}", e.what());
+    }
+    for (auto& [id, bars] : closes) std::sort(bars.begin(), bars.end());
+    return closes;
+}
+
+void SessionManager::request_daily_closes(const std::shared_ptr<Session>& session) {
+    session->prior_close_subs_version = session->stream_subscriptions.version();
+    if (!exec_cfg_for(*session).enable_short_sale_restrictions || !data_source_) return;
+    std::vector<std::string> symbols;
+    for (auto& symbol : get_stream_symbols(session)) {
+        if (session->daily_closes_symbols.insert(symbol).second) symbols.push_back(std::move(symbol));
+    }
+    if (symbols.empty()) return;
+    const Timestamp from =
+        ExecutionConfig::et_date(session->window_start) - std::chrono::hours(24 * kPriorCloseLookbackDays);
+    const Timestamp to = session->config.end_time;
+    auto load = [this, session, symbols = std::move(symbols), from, to]() {
+        auto closes = load_daily_closes(symbols, from, to);
+        spdlog::info("Session {} loaded daily closes for {} of {} symbols",
+                     session->id, closes.size(), symbols.size());
+        std::vector<std::function<void()>> waiters;
+        {
+            std::lock_guard<std::mutex> lock(session->daily_closes_mutex);
+            for (auto& [id, bars] : closes) session->daily_closes_pending[id] = std::move(bars);
+            session->daily_closes_ready.store(true, std::memory_order_release);
+            if (--session->daily_closes_inflight == 0) {
+                waiters.swap(session->daily_closes_waiters);
+                session->daily_closes_cv.notify_all();
+            }
+        }
+        for (auto& wakeup : waiters) wakeup();
+    };
+    {
+        std::lock_guard<std::mutex> lock(session->daily_closes_mutex);
+        ++session->daily_closes_inflight;
+    }
+    // Off the caller: the query may wait behind a feed holding the data
+    // source. The worker merges the bars on the first event after they land.
+    control_pool().submit([load = std::move(load)]() {
+        load();
+        return false;
+    });
+}
+
+void SessionManager::wait_for_daily_closes(Session& session) {
+    std::unique_lock<std::mutex> lock(session.daily_closes_mutex);
+    session.daily_closes_cv.wait(lock, [&] { return session.daily_closes_inflight == 0; });
+}
+
+bool SessionManager::notify_when_daily_closes_loaded(Session& session, std::function<void()> wakeup) {
+    std::lock_guard<std::mutex> lock(session.daily_closes_mutex);
+    if (session.daily_closes_inflight == 0) return false;
+    session.daily_closes_waiters.push_back(std::move(wakeup));
+    return true;
+}
+
+void SessionManager::merge_daily_closes(Session& session) {
+    DailyCloses pending;
+    {
+        std::lock_guard<std::mutex> lock(session.daily_closes_mutex);
+        pending.swap(session.daily_closes_pending);
+        session.daily_closes_ready.store(false, std::memory_order_relaxed);
+    }
+    for (auto& [id, bars] : pending) session.daily_closes[id] = std::move(bars);
+    if (session.prior_close_day_ns != 0) publish_prior_closes(session);
+}
+
+void SessionManager::quiesce_session(const std::shared_ptr<Session>& session) {
+    session->should_stop.store(true);
+    session->time_engine->stop();
+    if (session->event_queue) session->event_queue->stop();
+    for (auto& t : session->feed_threads) {
+        if (t && t->joinable()) t->join();
+    }
+    session->feed_threads.clear();
+    if (session->polling_thread && session->polling_thread->joinable()) {
+        session->polling_thread->join();
+    }
+    session->polling_thread.reset();
+    session->join_loop();
+    session->worker_thread.reset();
 }
 
 std::shared_ptr<Session> SessionManager::get_session(const std::string& session_id) const {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<InstrumentedMutex> lock(mutex_);
     auto it = sessions_.find(session_id);
     return it != sessions_.end() ? it->second : nullptr;
 }
 
 std::vector<std::shared_ptr<Session>> SessionManager::list_sessions() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<InstrumentedMutex> lock(mutex_);
     std::vector<std::shared_ptr<Session>> out;
     out.reserve(sessions_.size());
     for (auto& kv : sessions_) out.push_back(kv.second);
     return out;
 }
 
+PaceReport SessionManager::pace_report(Session& session) const {
+    PaceObservation obs;
+    obs.steady_ns = trace_now_ns();
+    obs.unix_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    obs.sim_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        session.time_engine->current_time().time_since_epoch()).count();
+    obs.events_processed = session.events_processed.load(std::memory_order_relaxed);
+    obs.lag_ns = session.time_engine->schedule_lag_ns();
+    const int64_t last_fed = session.last_enqueued_ns.load(std::memory_order_relaxed);
+    obs.feeder_lead_ns = last_fed > 0 ? std::max<int64_t>(0, last_fed - obs.sim_ns) : 0;
+    obs.queue_depth = session.event_queue ? session.event_queue->size() : 0;
+    PaceReport report = session.pace.observe(obs);
+    report.target_speed = session.time_engine->speed();
+    return report;
+}
+
 void SessionManager::start_session(const std::string& session_id) {
     auto session = get_session(session_id);
     if (!session) return;
@@ -482,7 +967,7 @@ void SessionManager::start_session(const std::string& session_id) {
 
         // Allow news feeders to restart on session restart.
         {
-            std::lock_guard<std::mutex> lock(stream_mutex_);
+            std::lock_guard<InstrumentedMutex> lock(stream_mutex_);
             news_feeder_started_tokens_.erase(session->id);
         }
     }
@@ -497,7 +982,7 @@ void SessionManager::start_session(const std::string& session_id) {
     // Resume pre-existing news subscriptions if they were set before start/restart.
     std::vector<std::string> news_tokens;
     {
-        std::lock_guard<std::mutex> lock(stream_mutex_);
+        std::lock_guard<InstrumentedMutex> lock(stream_mutex_);
         auto it = stream_news_symbol_counts_.find(session->id);
         if (it != stream_news_symbol_counts_.end()) {
             for (const auto& kv : it->second) {
@@ -508,14 +993,37 @@ void SessionManager::start_session(const std::string& session_id) {
     for (const auto& token : news_tokens) {
         start_news_feed_for_symbol(session, token);
     }
-    if (exec_cfg_.enable_shared_feed) {
+    // Queued before any feed holds the data source; the loop waits for it
+    // before its first event, so the first day's closes are in place.
+    request_daily_closes(session);
+    start_session_feed(session);
+}
+
+void SessionManager::start_session_feed(const std::shared_ptr<Session>& session) {
+    bool preload_in_loop = false;
+    if (session->config.batch_mode) {
+        // Batch backtest: stream the whole window into the queue without the
+        // polling feeder's wall-clock pacing; the loop ends when the queue closes.
+        // An unbounded queue is fed by the loop task itself, one window each
+        // time it drains. A bounded one is filled from a feed thread that
+        // waits for the loop to make room, so no event is dropped; the loop
+        // parks off the pool while that thread is behind.
+        if (session->config.queue_capacity == 0) {
+            preload_in_loop = true;
+        } else {
+            // The stream holds the data source until the loop drains it, so
+            // the daily-bar load the loop waits on has to go first.
+            session->feed_threads.push_back(std::make_unique<std::thread>([this, session]() {
+                wait_for_daily_closes(*session);
+                preload_events(session, true);
+            }));
+        }
+    } else if (exec_cfg_.enable_shared_feed) {
         start_shared_feeder();
     } else {
         start_polling_feeder(session);
     }
-    session->worker_thread = std::make_unique<std::thread>(
-        [this, session]() { run_session_loop(session); }
-    );
+    launch_session_loop(session, preload_in_loop);
 }
 
 void SessionManager::pause_session(const std::string& session_id) {
@@ -524,10 +1032,7 @@ void SessionManager::pause_session(const std::string& session_id) {
         session->time_engine->pause();
         session->status = SessionStatus::PAUSED;
         nlohmann::json w{{"event","session_paused"},{"session_id",session_id}};
-        std::lock_guard<std::mutex> lock(session->wal_mutex);
-        if (session->wal) {
-            session->wal->append(w);
-        }
+        append_wal(session, w);
     }
 }
 
@@ -537,10 +1042,7 @@ void SessionManager::resume_session(const std::string& session_id) {
         session->time_engine->resume();
         session->status = SessionStatus::RUNNING;
         nlohmann::json w{{"event","session_resumed"},{"session_id",session_id}};
-        std::lock_guard<std::mutex> lock(session->wal_mutex);
-        if (session->wal) {
-            session->wal->append(w);
-        }
+        append_wal(session, w);
     }
 }
 
@@ -548,23 +1050,21 @@ void SessionManager::stop_session(const std::string& session_id) {
     auto session = get_session(session_id);
     if (session) {
         session->stop();
+        stop_strategy(session);
         session->status = SessionStatus::STOPPED;
         {
-            std::lock_guard<std::mutex> lock(stream_mutex_);
+            std::lock_guard<InstrumentedMutex> lock(stream_mutex_);
             news_feeder_started_tokens_.erase(session_id);
         }
         save_session_checkpoint(session_id);
 
         nlohmann::json w{{"event","session_stopped"},{"session_id",session_id}};
-        std::lock_guard<std::mutex> lock(session->wal_mutex);
-        if (session->wal) {
-            session->wal->append(w);
-        }
+        append_wal(session, w);
     }
     if (exec_cfg_.enable_shared_feed) {
         bool any_running = false;
         {
-            std::lock_guard<std::mutex> lock(mutex_);
+            std::lock_guard<InstrumentedMutex> lock(mutex_);
             for (const auto& kv : sessions_) {
                 if (kv.second->status == SessionStatus::RUNNING) {
                     any_running = true;
@@ -585,7 +1085,7 @@ void SessionManager::destroy_session(const std::string& session_id) {
     }
 
     {
-        std::lock_guard<std::mutex> lock(mutex_);
+        std::lock_guard<InstrumentedMutex> lock(mutex_);
         auto it = sessions_.find(session_id);
         if (it != sessions_.end()) {
             session = it->second;
@@ -595,8 +1095,13 @@ void SessionManager::destroy_session(const std::string& session_id) {
     if (session) {
         session->stop();
     }
+    auto& metrics = MetricsRegistry::instance();
+    metrics.remove("broker_session_event_seconds", {{"session", session_id}});
+    metrics.remove("broker_session_queue_wait_seconds", {{"session", session_id}});
+    metrics.remove("broker_session_queue_size", {{"session", session_id}});
+    metrics.remove("broker_session_events_processed", {{"session", session_id}});
     {
-        std::lock_guard<std::mutex> lock(stream_mutex_);
+        std::lock_guard<InstrumentedMutex> lock(stream_mutex_);
         stream_symbol_counts_.erase(session_id);
         stream_news_symbol_counts_.erase(session_id);
         news_feeder_started_tokens_.erase(session_id);
@@ -604,7 +1109,7 @@ void SessionManager::destroy_session(const std::string& session_id) {
     if (exec_cfg_.enable_shared_feed) {
         bool any_running = false;
         {
-            std::lock_guard<std::mutex> lock(mutex_);
+            std::lock_guard<InstrumentedMutex> lock(mutex_);
             for (const auto& kv : sessions_) {
                 if (kv.second->status == SessionStatus::RUNNING) {
                     any_running = true;
@@ -619,7 +1124,92 @@ void SessionManager::destroy_session(const std::string& session_id) {
 std::string SessionManager::submit_order(const std::string& session_id, Order order) {
     auto session = get_session(session_id);
     if (!session) return {};
+    auto lookups = lookup_order_data(session, order);
+    // Same step as a market event, so fork never snapshots half an order.
+    std::lock_guard<std::mutex> step(session->step_mutex);
+    return submit_order_impl(session, std::move(order), lookups);
+}
+
+std::vector<std::string> SessionManager::submit_orders(const std::string& session_id, std::vector<Order> orders) {
+    std::vector<std::string> ids;
+    ids.reserve(orders.size());
+    auto session = get_session(session_id);
+    if (!session) {
+        ids.resize(orders.size());
+        return ids;
+    }
+    std::vector<OrderLookups> lookups;
+    lookups.reserve(orders.size());
+    for (auto& order : orders) {
+        lookups.push_back(lookup_order_data(session, order));
+    }
+    // One step for the whole batch: the worker cannot apply (or WAL) a market
+    // event between two of these orders or before their grouped WAL write.
+    std::lock_guard<std::mutex> step(session->step_mutex);
+    OrderGroup group(session.get(), has_wal(*session));
+    tls_order_group = &group;
+    try {
+        for (size_t i = 0; i < orders.size(); ++i) {
+            ids.push_back(submit_order_impl(session, std::move(orders[i]), lookups[i]));
+        }
+    } catch (...) {
+        tls_order_group = nullptr;
+        flush_order_group(session, group.wal, group.log);
+        throw;
+    }
+    tls_order_group = nullptr;
+    flush_order_group(session, group.wal, group.log);
+    return ids;
+}
+
+std::vector<bool> SessionManager::cancel_orders(const std::string& session_id,
+                                                const std::vector<std::string>& order_ids) {
+    std::vector<bool> results(order_ids.size(), false);
+    auto session = get_session(session_id);
+    if (!session) return results;
+    std::lock_guard<std::mutex> step(session->step_mutex);
+    OrderGroup group(session.get(), has_wal(*session));
+    tls_order_group = &group;
+    try {
+        for (size_t i = 0; i < order_ids.size(); ++i) {
+            results[i] = cancel_order_impl(session, order_ids[i]);
+        }
+    } catch (...) {
+        tls_order_group = nullptr;
+        flush_order_group(session, group.wal, group.log);
+        throw;
+    }
+    tls_order_group = nullptr;
+    flush_order_group(session, group.wal, group.log);
+    return results;
+}
 
+SessionManager::OrderLookups SessionManager::lookup_order_data(const std::shared_ptr<Session>& session,
+                                                               Order& order) {
+    OrderLookups lookups;
+    // The decision-fill log names the order, so give it its id up front.
+    if (order.id.empty()) order.id = generate_uuid();
+    const int64_t order_clock_ns = order.decision_time_ns > 0
+        ? order.decision_time_ns
+        : std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::system_clock::now().time_since_epoch()).count();
+    const auto order_clock_ts = Timestamp{} + std::chrono::nanoseconds(order_clock_ns);
+    // The position may still move before the step; submit_order_impl re-checks
+    // and only queries inline if the order has become an opening short since.
+    if (exec_cfg_for(*session).allow_shorting && exec_cfg_.enable_short_locate_checks &&
+        is_opening_short_sale(session, order)) {
+        lookups.short_locate_ok = passes_short_locate_check(exec_cfg_, api_data_source_, order, order_clock_ts);
+    }
+    if (order.decision_time_ns > 0 && order.type == OrderType::MARKET &&
+        order.qty.has_value() && order.qty.value() > 0.0) {
+        lookups.decision_price = lookup_decision_fill_price(api_data_source_, order, order_clock_ts);
+    }
+    return lookups;
+}
+
+std::string SessionManager::submit_order_impl(std::shared_ptr<Session> session, Order order,
+                                              const OrderLookups& lookups) {
+    const std::string& session_id = session->id;
     const auto current_session_time = session->time_engine->current_time();
     const bool has_session_window = session->config.end_time > session->config.start_time;
     const auto decision_time = Timestamp{} + std::chrono::nanoseconds(order.decision_time_ns);
@@ -710,14 +1300,16 @@ std::string SessionManager::submit_order(const std::string& session_id, Order or
         }
     } else { // SELL
         const bool opening_short_sale = is_opening_short_sale(session, order);
-        if (!exec_cfg_.allow_shorting) {
+        if (!exec_cfg_for(*session).allow_shorting) {
             if (opening_short_sale) {
                 spdlog::warn("Order rejected: shorting disabled order={} qty={}", order.id, order.qty.value_or(0.0));
                 return {};
             }
         } else {
             if (opening_short_sale &&
-                !passes_short_locate_check(exec_cfg_, api_data_source_, order, order_clock_ts)) {
+                !(lookups.short_locate_ok
+                      ? *lookups.short_locate_ok
+                      : passes_short_locate_check(exec_cfg_, api_data_source_, order, order_clock_ts))) {
                 return {};
             }
             if (order.qty && order.limit_price) {
@@ -740,19 +1332,13 @@ std::string SessionManager::submit_order(const std::string& session_id, Order or
         order.is_maker = !marketable;
     }
 
-    // Circuit breaker check - reject orders for halted symbols
-    if (exec_cfg_.enable_circuit_breakers) {
-        std::lock_guard<std::mutex> lock(session->halt_mutex);
-        // Check for expired halts first
-        auto now_ts = std::chrono::system_clock::now();
-        auto end_it = session->halt_end_times.find(order.symbol);
-        if (end_it != session->halt_end_times.end() && now_ts >= end_it->second) {
-            // Halt has expired, remove it
-            session->halted_symbols.erase(order.symbol);
-            session->halt_end_times.erase(end_it);
-        }
-        // Check if symbol is currently halted
-        if (session->halted_symbols.find(order.symbol) != session->halted_symbols.end()) {
+    // Circuit breaker check - reject orders for halted symbols. A timed halt
+    // lapses once simulated time reaches its end.
+    const SymbolId symbol_id = SymbolTable::instance().find(order.symbol);
+    if (exec_cfg_for(*session).enable_circuit_breakers) {
+        const int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            session->time_engine->current_time().time_since_epoch()).count();
+        if (session->symbol_state.is_halted(symbol_id, now_ns)) {
             spdlog::warn("Order rejected: {} is halted (circuit breaker active)", order.symbol);
             return {};
         }
@@ -760,12 +1346,11 @@ std::string SessionManager::submit_order(const std::string& session_id, Order or
 
     // Short Sale Restriction (SSR) check - SEC Rule 201 Alternative Uptick Rule
     // When SSR is active, short sales must be at or above the current national best bid
-    if (exec_cfg_.enable_short_sale_restrictions && order.side == OrderSide::SELL) {
+    if (exec_cfg_for(*session).enable_short_sale_restrictions && order.side == OrderSide::SELL) {
         bool is_short_sale = is_opening_short_sale(session, order);
 
         if (is_short_sale) {
-            std::lock_guard<std::mutex> lock(session->ssr_mutex);
-            if (session->ssr_symbols.find(order.symbol) != session->ssr_symbols.end()) {
+            if (session->symbol_state.ssr_active(symbol_id)) {
                 // SSR is active for this symbol - enforce uptick rule
                 if (nbbo && nbbo->bid_price > 0.0) {
                     // For market orders, we can't guarantee the price, so reject
@@ -792,7 +1377,9 @@ std::string SessionManager::submit_order(const std::string& session_id, Order or
         && order.qty.value() > 0.0;
 
     if (use_decision_fill) {
-        auto decision_price = resolve_decision_fill_price(api_data_source_, session, order, order_clock_ts);
+        auto decision_price = api_data_source_
+            ? resolve_decision_fill_price(session, order, order_clock_ts, lookups.decision_price)
+            : std::nullopt;
         if (decision_price && *decision_price > 0.0) {
             fill = Fill{order.id, order.qty.value(), *decision_price, order_clock_ns, false};
             spdlog::debug("Decision-time fill for order {} at {}", order.id, *decision_price);
@@ -818,13 +1405,7 @@ std::string SessionManager::submit_order(const std::string& session_id, Order or
     }
 
     upsert_order(session, order);
-    {
-        std::lock_guard<std::mutex> lock(session->orders_mutex);
-        auto it = session->orders.find(order.id);
-        if (it != session->orders.end()) {
-            it->second.updated_at_ns = order_clock_ns;
-        }
-    }
+    session->orders.update(order.id, [&](Order& o) { o.updated_at_ns = order_clock_ns; });
     {
         Event ev;
         ev.timestamp = order_clock_ts;
@@ -839,28 +1420,15 @@ std::string SessionManager::submit_order(const std::string& session_id, Order or
                             order.filled_qty, 0.0, "new",
                             order.side == OrderSide::BUY ? "buy" : "sell",
                             pos_qty};
-        std::vector<EventCallback> callbacks_copy;
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            callbacks_copy = event_callbacks_;
-        }
-        for (auto& cb : callbacks_copy) {
-            if (cb) cb(session->id, ev);
-        }
-    }
-    {
-        std::lock_guard<std::mutex> l(log_mutex_);
-        auto it = session_logs_.find(session_id);
-        if (it != session_logs_.end() && it->second.good()) {
-            it->second << fmt::format(R"({{"event":"order_submitted","id":"{}","symbol":"{}","side":"{}","type":{},"qty":{},"limit":{},"stop":{}}})",
-                                       order.id, order.symbol, (order.side == OrderSide::BUY ? "BUY" : "SELL"),
-                                       static_cast<int>(order.type),
-                                       order.qty.value_or(0.0),
-                                       order.limit_price.value_or(0.0),
-                                       order.stop_price.value_or(0.0))
-                       << "\n";
-        }
+        emit_order_event(*session, ev);
     }
+    append_event_log(session_id,
+        fmt::format(R"({{"event":"order_submitted","id":"{}","symbol":"{}","side":"{}","type":{},"qty":{},"limit":{},"stop":{}}})",
+                    order.id, order.symbol, (order.side == OrderSide::BUY ? "BUY" : "SELL"),
+                    static_cast<int>(order.type),
+                    order.qty.value_or(0.0),
+                    order.limit_price.value_or(0.0),
+                    order.stop_price.value_or(0.0)));
     {
         nlohmann::json w{
             {"ts_ns", session->last_event_ns.load(std::memory_order_acquire)},
@@ -874,10 +1442,7 @@ std::string SessionManager::submit_order(const std::string& session_id, Order or
             {"limit", order.limit_price.value_or(0.0)},
             {"stop", order.stop_price.value_or(0.0)}
         };
-        std::lock_guard<std::mutex> lock(session->wal_mutex);
-        if (session->wal) {
-            session->wal->append(w);
-        }
+        append_wal(session, w);
     }
     if (fill && fill->fill_qty > 0.0) process_fill(session, *fill);
 
@@ -903,14 +1468,7 @@ std::string SessionManager::submit_order(const std::string& session_id, Order or
                                 order.filled_qty, 0.0, "canceled",
                                 order.side == OrderSide::BUY ? "buy" : "sell",
                                 pos_qty};
-            std::vector<EventCallback> callbacks_copy;
-            {
-                std::lock_guard<std::mutex> lock(mutex_);
-                callbacks_copy = event_callbacks_;
-            }
-            for (auto& cb : callbacks_copy) {
-                if (cb) cb(session->id, ev);
-            }
+            emit_order_event(*session, ev);
         }
     }
     return order.id;
@@ -919,26 +1477,26 @@ std::string SessionManager::submit_order(const std::string& session_id, Order or
 bool SessionManager::cancel_order(const std::string& session_id, const std::string& order_id) {
     auto session = get_session(session_id);
     if (!session) return false;
+    std::lock_guard<std::mutex> step(session->step_mutex);
+    return cancel_order_impl(session, order_id);
+}
+
+bool SessionManager::cancel_order_impl(std::shared_ptr<Session> session, const std::string& order_id) {
+    const std::string& session_id = session->id;
     bool canceled = session->matching_engine->cancel_order(order_id);
     std::optional<Order> order_opt;
     if (canceled) {
-        std::lock_guard<std::mutex> lock(session->orders_mutex);
-        auto it = session->orders.find(order_id);
-        if (it != session->orders.end()) {
-            it->second.status = OrderStatus::CANCELED;
-            int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                std::chrono::system_clock::now().time_since_epoch()).count();
-            it->second.updated_at_ns = now_ns;
-            it->second.canceled_at_ns = now_ns;
-            order_opt = it->second;
-        }
+        int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        session->orders.update(order_id, [&](Order& o) {
+            o.status = OrderStatus::CANCELED;
+            o.updated_at_ns = now_ns;
+            o.canceled_at_ns = now_ns;
+            order_opt = o;
+        });
     }
     if (canceled) {
-        std::lock_guard<std::mutex> l(log_mutex_);
-        auto it = session_logs_.find(session_id);
-        if (it != session_logs_.end() && it->second.good()) {
-            it->second << R"({"event":"order_canceled","id":")" << order_id << "\"}\n";
-        }
+        append_event_log(session_id, R"({"event":"order_canceled","id":")" + order_id + "\"}");
     }
     if (canceled) {
         nlohmann::json w{
@@ -946,10 +1504,7 @@ bool SessionManager::cancel_order(const std::string& session_id, const std::stri
             {"event","order_canceled"},
             {"id", order_id}
         };
-        std::lock_guard<std::mutex> lock(session->wal_mutex);
-        if (session->wal) {
-            session->wal->append(w);
-        }
+        append_wal(session, w);
     }
     if (canceled) {
         Event ev;
@@ -970,14 +1525,7 @@ bool SessionManager::cancel_order(const std::string& session_id, const std::stri
                             qty, filled_qty, 0.0, "canceled",
                             side,
                             pos_qty};
-        std::vector<EventCallback> callbacks_copy;
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            callbacks_copy = event_callbacks_;
-        }
-        for (auto& cb : callbacks_copy) {
-            if (cb) cb(session_id, ev);
-        }
+        emit_order_event(*session, ev);
     }
     return canceled;
 }
@@ -985,73 +1533,317 @@ bool SessionManager::cancel_order(const std::string& session_id, const std::stri
 std::unordered_map<std::string, Order> SessionManager::get_orders(const std::string& session_id) const {
     auto session = get_session(session_id);
     if (!session) return {};
-    std::lock_guard<std::mutex> lock(session->orders_mutex);
-    return session->orders;
+    return session->orders.snapshot();
+}
+
+std::optional<Order> SessionManager::get_order(const std::string& session_id,
+                                               const std::string& order_id) const {
+    auto session = get_session(session_id);
+    if (!session) return std::nullopt;
+    return session->orders.get(order_id);
+}
+
+std::optional<Order> SessionManager::get_order_by_client_id(const std::string& session_id,
+                                                            const std::string& client_order_id) const {
+    auto session = get_session(session_id);
+    if (!session) return std::nullopt;
+    return session->orders.get_by_client_id(client_order_id);
+}
+
+OrderPage SessionManager::list_orders(const std::string& session_id, const OrderQuery& query) const {
+    auto session = get_session(session_id);
+    if (!session) return {};
+    return session->orders.list(query);
+}
+
+void SessionManager::add_event_callback(EventCallback cb) {
+    event_callbacks_.add(std::move(cb));
+}
+
+void SessionManager::add_market_data_callback(EventCallback cb) {
+    market_data_callbacks_.add(std::move(cb));
+}
+
+void SessionManager::add_order_callback(EventCallback cb) {
+    order_callbacks_.add(std::move(cb));
+}
+
+void SessionManager::emit_market_event(Session& session, const Event& ev) const {
+    event_callbacks_.dispatch(session.id, ev);
+    market_data_callbacks_.dispatch(session.id, ev);
+}
+
+void SessionManager::emit_order_event(Session& session, const Event& ev) const {
+    event_callbacks_.dispatch(session.id, ev);
+    order_callbacks_.dispatch(session.id, ev);
+}
+
+bool SessionManager::attach_strategy(const std::string& session_id, std::shared_ptr<Strategy> strategy) {
+    auto session = get_session(session_id);
+    if (!session) return false;
+    std::lock_guard<std::recursive_mutex> lock(session->strategy_mutex);
+    session->strategy = std::move(strategy);
+    session->strategy_ctx = std::make_unique<SessionStrategyContext>(*this, session);
+    session->strategy_started = false;
+    session->strategy_attached.store(session->strategy != nullptr, std::memory_order_release);
+    return true;
+}
+
+void SessionManager::start_strategy(const std::shared_ptr<Session>& session) {
+    std::lock_guard<std::recursive_mutex> lock(session->strategy_mutex);
+    if (!session->strategy || session->strategy_started) return;
+    session->strategy_started = true;
+    session->strategy->on_start(*session->strategy_ctx);
+}
+
+void SessionManager::stop_strategy(const std::shared_ptr<Session>& session) {
+    std::lock_guard<std::recursive_mutex> lock(session->strategy_mutex);
+    if (!session->strategy || !session->strategy_started) return;
+    session->strategy_started = false;
+    session->strategy->on_stop(*session->strategy_ctx);
+}
+
+void SessionManager::dispatch_strategy_event(const std::shared_ptr<Session>& session, const Event& ev) {
+    if (!session->strategy_attached.load(std::memory_order_acquire)) return;
+    std::lock_guard<std::recursive_mutex> lock(session->strategy_mutex);
+    if (!session->strategy) return;
+    auto& strategy = *session->strategy;
+    auto& ctx = *session->strategy_ctx;
+    switch (ev.event_type) {
+        case EventType::QUOTE:
+            strategy.on_quote(ctx, ev.symbol, ev.timestamp, std::get<QuoteData>(ev.data));
+            break;
+        case EventType::TRADE:
+            strategy.on_trade(ctx, ev.symbol, ev.timestamp, std::get<TradeData>(ev.data));
+            break;
+        case EventType::BAR:
+            strategy.on_bar(ctx, ev.symbol, ev.timestamp, std::get<BarData>(ev.data));
+            break;
+        case EventType::ORDER_FILL:
+            strategy.on_fill(ctx, ev.symbol, ev.timestamp, std::get<OrderData>(ev.data));
+            break;
+        default:
+            break;
+    }
+}
+
+void SessionManager::run_session_loop(std::shared_ptr<Session> session) {
+    wait_for_daily_closes(*session);
+    SessionLoopState state;
+    while (run_session_slice(session, state, std::numeric_limits<size_t>::max(), true)) {
+    }
+}
+
+void SessionManager::launch_session_loop(std::shared_ptr<Session> session, bool preload_first) {
+    if (!session->config.batch_mode) {
+        session->worker_thread = std::make_unique<std::thread>(
+            [this, session]() { run_session_loop(session); }
+        );
+        return;
+    }
+    // Batch sessions never wait on the wall clock, so they run as cooperative
+    // slices on the shared pool instead of owning a thread.
+    {
+        std::lock_guard<std::mutex> lock(session->loop_mutex);
+        session->loop_active = true;
+    }
+    auto state = std::make_shared<SessionLoopState>();
+    state->preload = preload_first;
+    state->preload_cursor = session->config.start_time;
+    const size_t slice = exec_cfg_.scheduler_slice_events > 0
+        ? static_cast<size_t>(exec_cfg_.scheduler_slice_events)
+        : 1024;
+    // Start once the prior closes are in, without holding a pool worker.
+    if (notify_when_daily_closes_loaded(*session, [this, session, state, slice]() {
+            submit_session_slices(session, state, slice);
+        })) {
+        return;
+    }
+    submit_session_slices(std::move(session), std::move(state), slice);
+}
+
+void SessionManager::submit_session_slices(std::shared_ptr<Session> session,
+                                           std::shared_ptr<SessionLoopState> state,
+                                           size_t slice) {
+    scheduler().submit([this, session, state, slice]() {
+        bool more = run_session_slice(session, *state, slice, false);
+        if (more && state->parked) {
+            state->parked = false;
+            // Off the pool until the producer pushes or closes the queue. The
+            // wakeup holds the session weakly so an armed queue does not own it.
+            std::weak_ptr<Session> weak = session;
+            if (session->event_queue->notify_when_ready([this, weak, state, slice]() {
+                    if (auto s = weak.lock()) submit_session_slices(std::move(s), state, slice);
+                })) {
+                return false;
+            }
+        }
+        if (!more) {
+            std::lock_guard<std::mutex> lock(session->loop_mutex);
+            session->loop_active = false;
+            session->loop_cv.notify_all();
+        }
+        return more;
+    });
+}
+
+SessionScheduler& SessionManager::scheduler() {
+    std::call_once(scheduler_once_, [this]() {
+        scheduler_ = std::make_unique<SessionScheduler>(
+            static_cast<size_t>(std::max(0, exec_cfg_.scheduler_threads)));
+    });
+    return *scheduler_;
+}
+
+SessionScheduler& SessionManager::control_pool() {
+    std::call_once(control_once_, [this]() {
+        control_pool_ = std::make_unique<SessionScheduler>(
+            static_cast<size_t>(std::max(1, exec_cfg_.control_threads)));
+    });
+    return *control_pool_;
+}
+
+SessionManager::LoopEvent SessionManager::apply_loop_event(const std::shared_ptr<Session>& session,
+                                                           const Event& ev,
+                                                           SessionLoopState& state) {
+    if (ev.timestamp >= session->config.end_time) {
+        session->time_engine->set_time(session->config.end_time);
+        spdlog::info(
+            "Session {} loop: reached end_time boundary; dropping remaining queued events",
+            session->id);
+        return LoopEvent::END;
+    }
+    const auto& exec = exec_cfg_for(*session);
+    auto current_ts = session->time_engine->current_time();
+    if (exec.get_market_session(current_ts) == ExecutionConfig::MarketSession::CLOSED) {
+        auto next_open = exec.next_market_open_after(current_ts);
+        if (next_open > current_ts && next_open <= ev.timestamp) {
+            session->time_engine->set_time(std::min(next_open, session->config.end_time));
+        }
+    }
+    if (exec.get_market_session(ev.timestamp) == ExecutionConfig::MarketSession::CLOSED) {
+        auto next_open_event = exec.next_market_open_after(ev.timestamp);
+        if (next_open_event > ev.timestamp) {
+            session->time_engine->set_time(std::min(next_open_event, session->config.end_time));
+        }
+        return LoopEvent::SKIPPED;
+    }
+    const bool batch_mode = session->config.batch_mode;
+    if (batch_mode) {
+        session->time_engine->step_to(ev.timestamp);
+    } else if (!session->time_engine->wait_for_next_event(ev.timestamp)) {
+        spdlog::info("Session {} loop: wait_for_next_event returned false", session->id);
+        return LoopEvent::END;
+    }
+    trace_stamp(TraceStage::RELEASE);
+    {
+        std::lock_guard<std::mutex> step(session->step_mutex);
+        // In the step, so an order or cancel from another thread is either
+        // wholly in the snapshot or wholly after it.
+        maybe_snapshot(*session, ev.timestamp);
+        const auto started = std::chrono::steady_clock::now();
+        process_event(session, ev, true);
+        session->event_latency->record_since(started);
+    }
+    state.processed++;
+    const uint64_t checkpoint_every = session->config.batch_checkpoint_events;
+    if (batch_mode && checkpoint_every > 0 && state.processed % checkpoint_every == 0) {
+        session->time_engine->publish_time();
+    }
+    if (state.processed == 1 || state.processed % 10000 == 0) {
+        spdlog::info("Session {} processed {} events", session->id, state.processed);
+    }
+    return LoopEvent::PROCESSED;
 }
 
-void SessionManager::add_event_callback(EventCallback cb) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    event_callbacks_.push_back(std::move(cb));
+void SessionManager::finish_session_loop(const std::shared_ptr<Session>& session, SessionLoopState& state) {
+    spdlog::info("Session {} loop ended, processed {} events", session->id, state.processed);
+    if (session->config.batch_mode) {
+        session->time_engine->publish_time();
+    }
+    if (!session->should_stop.load()) {
+        if (session->time_engine->current_time() < session->config.end_time) {
+            session->time_engine->set_time(session->config.end_time);
+        }
+        expire_pending_orders_at(session, session->config.end_time);
+        stop_strategy(session);
+        session->status = SessionStatus::COMPLETED;
+        session->completed_at = std::chrono::system_clock::now();
+    }
+    session->time_engine->stop();
 }
 
-void SessionManager::run_session_loop(std::shared_ptr<Session> session) {
-    spdlog::info("Session {} loop starting, queue_size={}", session->id, session->event_queue->size());
+bool SessionManager::run_session_slice(const std::shared_ptr<Session>& session,
+                                       SessionLoopState& state,
+                                       size_t max_events,
+                                       bool blocking) {
+    const auto slice_start = std::chrono::steady_clock::now();
+    bool more = true;
     try {
-        size_t processed = 0;
-        while (!session->should_stop.load()) {
-            auto ev_opt = session->event_queue->wait_and_pop();
-            if (!ev_opt) {
-                spdlog::info("Session {} loop: wait_and_pop returned empty", session->id);
-                break;
-            }
-            const Event& ev = *ev_opt;
-            if (ev.timestamp >= session->config.end_time) {
-                session->time_engine->set_time(session->config.end_time);
-                spdlog::info(
-                    "Session {} loop: reached end_time boundary; dropping remaining queued events",
-                    session->id);
+        if (!state.started) {
+            state.started = true;
+            spdlog::info("Session {} loop starting, queue_size={}", session->id, session->event_queue->size());
+            start_strategy(session);
+        }
+        bool done = false;
+        for (size_t budget = max_events; budget > 0; --budget) {
+            if (session->should_stop.load()) {
+                done = true;
                 break;
             }
-            auto current_ts = session->time_engine->current_time();
-            if (exec_cfg_.get_market_session(current_ts) == ExecutionConfig::MarketSession::CLOSED) {
-                auto next_open = exec_cfg_.next_market_open_after(current_ts);
-                if (next_open > current_ts && next_open <= ev.timestamp) {
-                    session->time_engine->set_time(std::min(next_open, session->config.end_time));
+            AllocStageScope alloc_stage(AllocStage::DEQUEUE);
+            std::optional<Event> ev_opt;
+            if (blocking) {
+                ev_opt = session->event_queue->wait_and_pop();
+            } else {
+                // Check closure before popping so an event pushed just before
+                // stop() is never mistaken for end of stream.
+                const bool closed = session->event_queue->stopped();
+                ev_opt = session->event_queue->pop();
+                if (!ev_opt && state.preload) {
+                    preload_next_window(session, state);
+                    continue;
                 }
-            }
-            if (exec_cfg_.get_market_session(ev.timestamp) == ExecutionConfig::MarketSession::CLOSED) {
-                auto next_open_event = exec_cfg_.next_market_open_after(ev.timestamp);
-                if (next_open_event > ev.timestamp) {
-                    session->time_engine->set_time(std::min(next_open_event, session->config.end_time));
+                if (!ev_opt && !closed) {
+                    state.parked = true;
+                    break;
                 }
-                continue;
             }
-            if (!session->time_engine->wait_for_next_event(ev.timestamp)) {
-                spdlog::info("Session {} loop: wait_for_next_event returned false", session->id);
+            if (!ev_opt) {
+                spdlog::info("Session {} loop: wait_and_pop returned empty", session->id);
+                done = true;
                 break;
             }
-            process_event(session, ev, true);
-            processed++;
-            if (processed == 1 || processed % 10000 == 0) {
-                spdlog::info("Session {} processed {} events", session->id, processed);
+            const int64_t popped_ns = trace_now_ns();
+            if (ev_opt->enqueued_ns > 0) {
+                session->queue_wait->record(static_cast<uint64_t>(std::max<int64_t>(0, popped_ns - ev_opt->enqueued_ns)));
             }
-        }
-        spdlog::info("Session {} loop ended, processed {} events", session->id, processed);
-        if (!session->should_stop.load()) {
-            if (session->time_engine->current_time() < session->config.end_time) {
-                session->time_engine->set_time(session->config.end_time);
+            std::optional<TraceSpan> span;
+            if (ev_opt->decoded_ns > 0) span = TraceSpan::from_event(*ev_opt, popped_ns);
+            LoopEvent result;
+            {
+                ActiveSpanScope scope(span ? &*span : nullptr);
+                result = apply_loop_event(session, *ev_opt, state);
+            }
+            if (span && result == LoopEvent::PROCESSED) session->tracer.record(*span);
+            if (result == LoopEvent::END) {
+                done = true;
+                break;
             }
-            expire_pending_orders_at(session, session->config.end_time);
-            session->status = SessionStatus::COMPLETED;
-            session->completed_at = std::chrono::system_clock::now();
-        } else {
         }
-        session->time_engine->stop();
+        if (done) {
+            more = false;
+            finish_session_loop(session, state);
+        }
     } catch (const std::exception& e) {
+        more = false;
         session->status = SessionStatus::ERROR;
         session->time_engine->stop();
         spdlog::error("Session {} error: {}", session->id, e.what());
     }
+    session->run_wall_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - slice_start).count(), std::memory_order_relaxed);
+    return more;
 }
 
 void SessionManager::expire_pending_orders_at(std::shared_ptr<Session> session, Timestamp timestamp) {
@@ -1098,14 +1890,7 @@ void SessionManager::expire_pending_orders_at(std::shared_ptr<Session> session,
                             order.side == OrderSide::BUY ? "buy" : "sell",
                             pos_qty};
 
-        std::vector<EventCallback> callbacks_copy;
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            callbacks_copy = event_callbacks_;
-        }
-        for (auto& cb : callbacks_copy) {
-            if (cb) cb(session->id, ev);
-        }
+        emit_order_event(*session, ev);
     }
 }
 
@@ -1113,14 +1898,27 @@ void SessionManager::process_event(std::shared_ptr<Session> session, const Event
     // Track event processing for periodic checkpointing
     session->events_processed.fetch_add(1, std::memory_order_relaxed);
 
+    AllocStageScope alloc_stage(AllocStage::EVENT_LOG);
     append_event_log(session->id,
         fmt::format(R"({{"ts_ns":{},"seq":{},"symbol":"{}","type":{}}})",
                     std::chrono::duration_cast<std::chrono::nanoseconds>(ev.timestamp.time_since_epoch()).count(),
                     ev.sequence,
                     ev.symbol,
                     static_cast<int>(ev.event_type)));
-    session->last_event_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(ev.timestamp.time_since_epoch()).count(),
-                                 std::memory_order_release);
+    const int64_t event_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(ev.timestamp.time_since_epoch()).count();
+    if (ev.event_type != EventType::NEWS) {
+        session->events_at_last_ts = event_ns == session->last_event_ns.load(std::memory_order_relaxed)
+            ? session->events_at_last_ts + 1
+            : 1;
+    }
+    session->last_event_ns.store(event_ns, std::memory_order_release);
+    // Prior closes are published from memory, so replays roll the day too.
+    if (session->daily_closes_ready.load(std::memory_order_acquire)) merge_daily_closes(*session);
+    if (event_ns >= session->prior_close_roll_ns) roll_prior_closes(*session, ev.timestamp);
+    if (session->stream_subscriptions.version() != session->prior_close_subs_version) {
+        request_daily_closes(session);
+    }
+    alloc_stage.set(AllocStage::WAL);
     {
         nlohmann::json w{
             {"ts_ns", std::chrono::duration_cast<std::chrono::nanoseconds>(ev.timestamp.time_since_epoch()).count()},
@@ -1151,11 +1949,11 @@ void SessionManager::process_event(std::shared_ptr<Session> session, const Event
             w["close"] = b.close;
             w["volume"] = b.volume;
         }
-        std::lock_guard<std::mutex> lock(session->wal_mutex);
-        if (session->wal) {
-            session->wal->append(w);
-        }
+        append_wal(session, w);
+        trace_stamp(TraceStage::WAL);
     }
+    alloc_stage.set(AllocStage::MATCH);
+    LuldBandEngine::Action luld_action = LuldBandEngine::Action::NONE;
     if (ev.event_type == EventType::QUOTE) {
         const auto& q = std::get<QuoteData>(ev.data);
         NBBO nbbo{ev.symbol, q.bid_price, q.bid_size, q.ask_price, q.ask_size,
@@ -1181,14 +1979,7 @@ void SessionManager::process_event(std::shared_ptr<Session> session, const Event
                                 o.qty.value_or(0.0), o.filled_qty, 0.0, "expired",
                                 o.side == OrderSide::BUY ? "buy" : "sell",
                                 pos_qty};
-            std::vector<EventCallback> callbacks_copy;
-            {
-                std::lock_guard<std::mutex> lock(mutex_);
-                callbacks_copy = event_callbacks_;
-            }
-            for (auto& cb : callbacks_copy) {
-                if (cb) cb(session->id, oe);
-            }
+            emit_order_event(*session, oe);
         }
         // Mark to market using mid-price.
         session->account_manager->mark_to_market(ev.symbol, nbbo.mid_price());
@@ -1196,19 +1987,44 @@ void SessionManager::process_event(std::shared_ptr<Session> session, const Event
     } else if (ev.event_type == EventType::TRADE) {
         const auto& t = std::get<TradeData>(ev.data);
         session->account_manager->mark_to_market(ev.symbol, t.price);
+        const auto& exec = exec_cfg_for(*session);
+
+        // LULD: roll the 5-minute reference and publish bands for order checks
+        if (exec.enable_circuit_breakers) {
+            const SymbolId symbol_id = SymbolTable::instance().intern(ev.symbol);
+            if (!session->luld) {
+                LuldBandEngine::Params params;
+                params.tier1_pct = exec.luld_tier1_pct;
+                params.tier2_pct = exec.luld_tier2_pct;
+                if (exec.luld_halt_duration_sec > 0) {
+                    params.pause_ns = int64_t{exec.luld_halt_duration_sec} * 1'000'000'000;
+                }
+                params.tier1 = SymbolTable::instance().intern(exec.luld_tier1_symbols);
+                session->luld = std::make_unique<LuldBandEngine>(std::move(params));
+            }
+            const auto luld = session->luld->on_trade(symbol_id, event_ns, t.price);
+            if (luld.bands_changed) {
+                if (auto* state = session->symbol_state.at(symbol_id)) {
+                    state->luld_reference.store(luld.bands.reference, std::memory_order_relaxed);
+                    state->luld_upper.store(luld.bands.upper, std::memory_order_relaxed);
+                    state->luld_lower.store(luld.bands.lower, std::memory_order_relaxed);
+                }
+            }
+            luld_action = luld.action;
+        }
 
         // SSR check: If stock drops 10%+ from prior close, trigger SSR
-        if (exec_cfg_.enable_short_sale_restrictions) {
-            std::lock_guard<std::mutex> lock(session->ssr_mutex);
-            auto prior_it = session->prior_close.find(ev.symbol);
-            if (prior_it != session->prior_close.end() && prior_it->second > 0.0) {
-                double drop_pct = (prior_it->second - t.price) / prior_it->second * 100.0;
-                if (drop_pct >= exec_cfg_.ssr_threshold_pct) {
-                    if (session->ssr_symbols.find(ev.symbol) == session->ssr_symbols.end()) {
-                        session->ssr_symbols.insert(ev.symbol);
-                        spdlog::info("SSR triggered for {} (down {:.2f}% from prior close)",
-                                     ev.symbol, drop_pct);
-                    }
+        if (exec.enable_short_sale_restrictions) {
+            const SymbolId symbol_id = SymbolTable::instance().find(ev.symbol);
+            const auto* state = session->symbol_state.find(symbol_id);
+            const double prior_close = state ? state->prior_close.load(std::memory_order_relaxed) : 0.0;
+            if (prior_close > 0.0 && !state->ssr.load(std::memory_order_relaxed)) {
+                double drop_pct = (prior_close - t.price) / prior_close * 100.0;
+                if (drop_pct >= exec.ssr_threshold_pct) {
+                    session->symbol_state.at(symbol_id)->ssr.store(true, std::memory_order_relaxed);
+                    session->ssr_triggered_today.push_back(symbol_id);
+                    spdlog::info("SSR triggered for {} (down {:.2f}% from prior close)",
+                                 ev.symbol, drop_pct);
                 }
             }
         }
@@ -1218,34 +2034,11 @@ void SessionManager::process_event(std::shared_ptr<Session> session, const Event
             session->account_manager->mark_to_market(ev.symbol, b.close);
             enforce_margin(session);
         }
-    } else if (ev.event_type == EventType::HALT) {
-        // Trading halt - add symbol to halted set
-        const auto& h = std::get<HaltData>(ev.data);
-        if (h.is_halted) {
-            std::lock_guard<std::mutex> lock(session->halt_mutex);
-            session->halted_symbols.insert(ev.symbol);
-            // Set halt end time if duration is configured
-            if (exec_cfg_.luld_halt_duration_sec > 0) {
-                auto halt_end = ev.timestamp + std::chrono::seconds(exec_cfg_.luld_halt_duration_sec);
-                session->halt_end_times[ev.symbol] = halt_end;
-            }
-            spdlog::info("Trading halted for {} (reason: {})", ev.symbol, h.reason);
-        } else {
-            // Resume trading
-            std::lock_guard<std::mutex> lock(session->halt_mutex);
-            session->halted_symbols.erase(ev.symbol);
-            session->halt_end_times.erase(ev.symbol);
-            spdlog::info("Trading resumed for {}", ev.symbol);
-        }
-    } else if (ev.event_type == EventType::RESUME) {
-        // Trading resume
-        std::lock_guard<std::mutex> lock(session->halt_mutex);
-        session->halted_symbols.erase(ev.symbol);
-        session->halt_end_times.erase(ev.symbol);
-        spdlog::info("Trading resumed for {}", ev.symbol);
+    } else if (ev.event_type == EventType::HALT || ev.event_type == EventType::RESUME) {
+        apply_trading_halt(*session, ev);
     } else if (ev.event_type == EventType::DIVIDEND) {
         // Apply dividend automatically if enabled
-        if (exec_cfg_.enable_auto_corporate_actions) {
+        if (exec_cfg_for(*session).enable_auto_corporate_actions) {
             const auto& d = std::get<DividendData>(ev.data);
             session->account_manager->apply_dividend(ev.symbol, d.amount_per_share);
             session->cash = session->account_manager->state().cash;
@@ -1254,15 +2047,12 @@ void SessionManager::process_event(std::shared_ptr<Session> session, const Event
                 {"symbol", ev.symbol},
                 {"amount_per_share", d.amount_per_share}
             };
-            std::lock_guard<std::mutex> lock(session->wal_mutex);
-            if (session->wal) {
-                session->wal->append(w);
-            }
+            append_wal(session, w);
             spdlog::info("Applied dividend for {}: ${:.4f}/share", ev.symbol, d.amount_per_share);
         }
     } else if (ev.event_type == EventType::SPLIT) {
         // Apply stock split automatically if enabled
-        if (exec_cfg_.enable_auto_corporate_actions) {
+        if (exec_cfg_for(*session).enable_auto_corporate_actions) {
             const auto& s = std::get<SplitData>(ev.data);
             double ratio = s.ratio();
             session->account_manager->apply_split(ev.symbol, ratio);
@@ -1272,34 +2062,65 @@ void SessionManager::process_event(std::shared_ptr<Session> session, const Event
                 {"symbol", ev.symbol},
                 {"ratio", ratio}
             };
-            std::lock_guard<std::mutex> lock(session->wal_mutex);
-            if (session->wal) {
-                session->wal->append(w);
-            }
+            append_wal(session, w);
             spdlog::info("Applied split for {}: {}:{} (ratio {:.4f})",
                          ev.symbol, s.from_factor, s.to_factor, ratio);
         }
     }
+    trace_stamp(TraceStage::MATCH);
     session->equity = session->account_manager->state().equity;
     if (session->perf) {
         session->perf->record(ev.timestamp, session->equity);
     }
 
     if (emit_callbacks) {
-        std::vector<EventCallback> callbacks_copy;
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            callbacks_copy = event_callbacks_;
-        }
-        for (auto& cb : callbacks_copy) {
-            if (cb) cb(session->id, ev);
+        alloc_stage.set(AllocStage::CALLBACKS);
+        emit_market_event(*session, ev);
+        alloc_stage.set(AllocStage::STRATEGY);
+        dispatch_strategy_event(session, ev);
+    }
+    trace_stamp(TraceStage::CALLBACKS);
+
+    if (luld_action != LuldBandEngine::Action::NONE) {
+        // The pause (or reopening) follows the trade that caused it, applied
+        // here on live and replay paths alike. It is derived, not fed, so it
+        // stays out of the event cursor: a fork or seek re-derives it from the
+        // trade rather than re-streaming it.
+        const bool halt = luld_action == LuldBandEngine::Action::HALT;
+        Event derived{ev.timestamp, ev.sequence, halt ? EventType::HALT : EventType::RESUME, ev.symbol,
+                      HaltData{"LUDP", halt ? "LUDP" : "", halt}};
+        apply_trading_halt(*session, derived);
+        if (emit_callbacks) {
+            alloc_stage.set(AllocStage::CALLBACKS);
+            emit_market_event(*session, derived);
+            alloc_stage.set(AllocStage::STRATEGY);
+            dispatch_strategy_event(session, derived);
         }
     }
 
     // Periodic checkpointing
+    alloc_stage.set(AllocStage::CHECKPOINT);
     maybe_checkpoint(session);
 }
 
+void SessionManager::apply_trading_halt(Session& session, const Event& ev) {
+    auto* state = session.symbol_state.at(SymbolTable::instance().intern(ev.symbol));
+    const auto* h = std::get_if<HaltData>(&ev.data);
+    if (ev.event_type == EventType::HALT && h && h->is_halted) {
+        // Timed halt if a duration is configured, otherwise until resumed
+        int64_t until = SymbolStateTable::kHaltedIndefinitely;
+        if (exec_cfg_for(session).luld_halt_duration_sec > 0) {
+            auto halt_end = ev.timestamp + std::chrono::seconds(exec_cfg_for(session).luld_halt_duration_sec);
+            until = std::chrono::duration_cast<std::chrono::nanoseconds>(halt_end.time_since_epoch()).count();
+        }
+        if (state) state->halted_until_ns.store(until, std::memory_order_relaxed);
+        spdlog::info("Trading halted for {} (reason: {})", ev.symbol, h->reason);
+    } else {
+        if (state) state->halted_until_ns.store(0, std::memory_order_relaxed);
+        spdlog::info("Trading resumed for {}", ev.symbol);
+    }
+}
+
 void SessionManager::process_fill(std::shared_ptr<Session> session, const Fill& fill) {
     auto order_opt = find_order(session, fill.order_id);
     if (!order_opt) {
@@ -1350,7 +2171,7 @@ void SessionManager::process_fill(std::shared_ptr<Session> session, const Fill&
     double fees = 0.0;
     if (applied_fill.fill_qty > 0.0 && applied_fill.fill_price > 0.0) {
         bool is_sell = order.side == OrderSide::SELL;
-        fees = fee_cfg_.calculate_fees(applied_fill.fill_qty, applied_fill.fill_price, is_sell, order.is_maker);
+        fees = fee_cfg_for(*session).calculate_fees(applied_fill.fill_qty, applied_fill.fill_price, is_sell, order.is_maker);
     }
 
     order.last_fill_price = applied_fill.fill_price;
@@ -1380,10 +2201,7 @@ void SessionManager::process_fill(std::shared_ptr<Session> session, const Fill&
             {"price", applied_fill.fill_price},
             {"fee", fees}
         };
-        std::lock_guard<std::mutex> lock(session->wal_mutex);
-        if (session->wal) {
-            session->wal->append(w);
-        }
+        append_wal(session, w);
     }
     append_event_log(session->id,
         fmt::format(R"({{"event":"fill","order_id":"{}","symbol":"{}","side":"{}","qty":{},"price":{},"fee":{},"ts":{}}})",
@@ -1410,14 +2228,8 @@ void SessionManager::process_fill(std::shared_ptr<Session> session, const Fill&
                         order.side == OrderSide::BUY ? "buy" : "sell",
                         pos_qty,
                         fees};
-    std::vector<EventCallback> callbacks_copy;
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        callbacks_copy = event_callbacks_;
-    }
-    for (auto& cb : callbacks_copy) {
-        if (cb) cb(session->id, ev);
-    }
+    emit_order_event(*session, ev);
+    dispatch_strategy_event(session, ev);
 }
 
 bool SessionManager::apply_dividend(const std::string& session_id, const std::string& symbol, double amount_per_share) {
@@ -1432,10 +2244,7 @@ bool SessionManager::apply_dividend(const std::string& session_id, const std::st
             {"symbol", symbol},
             {"amount_per_share", amount_per_share}
         };
-        std::lock_guard<std::mutex> lock(session->wal_mutex);
-        if (session->wal) {
-            session->wal->append(w);
-        }
+        append_wal(session, w);
     }
     append_event_log(session_id,
         fmt::format(R"({{"event":"dividend","symbol":"{}","amount_per_share":{}}})",
@@ -1455,10 +2264,7 @@ bool SessionManager::apply_split(const std::string& session_id, const std::strin
             {"symbol", symbol},
             {"ratio", split_ratio}
         };
-        std::lock_guard<std::mutex> lock(session->wal_mutex);
-        if (session->wal) {
-            session->wal->append(w);
-        }
+        append_wal(session, w);
     }
     append_event_log(session_id,
         fmt::format(R"({{"event":"split","symbol":"{}","ratio":{}}})",
@@ -1466,7 +2272,7 @@ bool SessionManager::apply_split(const std::string& session_id, const std::strin
     return true;
 }
 
-void SessionManager::preload_events(std::shared_ptr<Session> session) {
+void SessionManager::preload_events(std::shared_ptr<Session> session, bool wait_for_space) {
     if (!data_source_) return;
     auto symbols = session->config.symbols;
     auto start = session->config.start_time;
@@ -1477,19 +2283,21 @@ void SessionManager::preload_events(std::shared_ptr<Session> session) {
         // initial window to avoid preloading the entire session and overwhelming the
         // event queue. The polling feeder will load subsequent windows.
         int window_secs = exec_cfg_.poll_interval_seconds > 0 ? exec_cfg_.poll_interval_seconds : 300;
-        Timestamp window_end = std::min(start + std::chrono::seconds(window_secs), end);
+        Timestamp window_end = session->config.batch_mode
+            ? end
+            : std::min(start + std::chrono::seconds(window_secs), end);
 
         spdlog::info("Using merged trade/quote/1s bar stream (session {}), initial window {}s", session->id, window_secs);
         data_source_->stream_events_with_bars(
             symbols, start, window_end,
-            [this, session](const UnifiedMarketEvent& ev) {
-                enqueue_unified_event(session, ev);
+            [this, session, wait_for_space](const UnifiedMarketEvent& ev) {
+                enqueue_unified_event(session, ev, wait_for_space);
             }
         );
     } else {
         // Default: stream trades and quotes
-        data_source_->stream_events(symbols, start, end, [this, session](const MarketEvent& ev) {
-            enqueue_event(session, ev);
+        data_source_->stream_events(symbols, start, end, [this, session, wait_for_space](const MarketEvent& ev) {
+            enqueue_event(session, ev, wait_for_space);
         });
     }
 
@@ -1499,6 +2307,37 @@ void SessionManager::preload_events(std::shared_ptr<Session> session) {
     }
 }
 
+void SessionManager::preload_next_window(const std::shared_ptr<Session>& session, SessionLoopState& state) {
+    // Same windows as the polling feeder, so one slice never holds more than
+    // a window of the session's data and never streams the whole range.
+    const Timestamp end = session->config.end_time;
+    if (data_source_ && state.preload_cursor < end) {
+        const int window_secs = exec_cfg_.poll_interval_seconds > 0 ? exec_cfg_.poll_interval_seconds : 300;
+        const Timestamp from = state.preload_cursor;
+        Timestamp to = exec_cfg_for(*session).next_time_boundary_after(from, from + std::chrono::seconds(window_secs));
+        if (to <= from) to = from + std::chrono::seconds(window_secs);
+        to = std::min(to, end);
+        const auto& symbols = session->config.symbols;
+        if (session->config.live_bar_aggr_source == "1s") {
+            data_source_->stream_events_with_bars(symbols, from, to, [&](const UnifiedMarketEvent& ev) {
+                if (ev.timestamp < from || ev.timestamp >= to) return;
+                enqueue_unified_event(session, ev);
+            });
+        } else {
+            data_source_->stream_events(symbols, from, to, [&](const MarketEvent& ev) {
+                if (ev.timestamp < from || ev.timestamp >= to) return;
+                enqueue_event(session, ev);
+            });
+        }
+        state.preload_cursor = to;
+    }
+    if (!data_source_ || state.preload_cursor >= end) {
+        state.preload = false;
+        session->event_queue->stop();
+        spdlog::info("Session {} preload complete; event queue closed", session->id);
+    }
+}
+
 void SessionManager::start_polling_feeder(std::shared_ptr<Session> session) {
     if (!data_source_) return;
     auto start = session->config.start_time;
@@ -1514,6 +2353,11 @@ void SessionManager::start_polling_feeder(std::shared_ptr<Session> session) {
         [this, session, start, end, base_window_secs]() {
             Timestamp cursor = start;
             double logged_speed = -1.0;
+            // Row filter; re-reads the published set only after it changes
+            StreamSubscriptions::Reader subscriptions(session->stream_subscriptions);
+            // Paced by the wall clock, not the loop, so hold off while the
+            // loop waits on the prior closes rather than overrun its queue.
+            wait_for_daily_closes(*session);
             
             while (!session->should_stop.load() && cursor < end) {
                 const auto loop_started_at = std::chrono::steady_clock::now();
@@ -1536,8 +2380,11 @@ void SessionManager::start_polling_feeder(std::shared_ptr<Session> session) {
                     exec_cfg_.next_time_boundary_after(cursor, cursor + window),
                     end);
 
-                // Get currently subscribed symbols (dynamic, not captured at start)
-                auto symbols = get_stream_symbols(session);
+                // Get currently subscribed symbols (dynamic, not captured at start).
+                // Holding the immutable set keeps the list valid for the window.
+                const auto subscribed = subscriptions.current();
+                const std::vector<std::string>& symbols =
+                    subscribed ? subscribed->symbols : session->config.symbols;
                 
                 if (symbols.empty()) {
                     if (session->time_engine->is_paused()) {
@@ -1579,13 +2426,13 @@ void SessionManager::start_polling_feeder(std::shared_ptr<Session> session) {
                 if (is_minute_bar_source(session->config.live_bar_aggr_source)) {
                     data_source_->stream_aggregate_bars(
                         symbols, cursor, window_end, 1, "minute",
-                        [this, session, cursor, window_end, &emitted_in_window](const BarRecord& bar) {
+                        [this, session, cursor, window_end, &emitted_in_window, &subscriptions](const BarRecord& bar) {
                             if (bar.timestamp < cursor || bar.timestamp >= window_end) return;
                             if (bar.timestamp < session->config.start_time ||
                                 bar.timestamp >= session->config.end_time) {
                                 return;
                             }
-                            if (!is_stream_symbol_subscribed(session->id, bar.symbol)) {
+                            if (!subscriptions.allows(bar.symbol)) {
                                 spdlog::trace("[PollingFeeder] session={} dropping bar for unsubscribed symbol={}",
                                               session->id, bar.symbol);
                                 return;
@@ -1601,7 +2448,7 @@ void SessionManager::start_polling_feeder(std::shared_ptr<Session> session) {
                 } else if (is_second_bar_source(session->config.live_bar_aggr_source)) {
                     data_source_->stream_events_with_bars(
                         symbols, cursor, window_end,
-                        [this, session, cursor, window_end, &emitted_in_window](const UnifiedMarketEvent& ev) {
+                        [this, session, cursor, window_end, &emitted_in_window, &subscriptions](const UnifiedMarketEvent& ev) {
                             if (ev.timestamp < cursor || ev.timestamp >= window_end) return;
                             if (ev.timestamp < session->config.start_time ||
                                 ev.timestamp >= session->config.end_time) {
@@ -1612,7 +2459,7 @@ void SessionManager::start_polling_feeder(std::shared_ptr<Session> session) {
                                 (ev.type == UnifiedEventType::TRADE) ? ev.trade.symbol :
                                 ev.bar.symbol;
                             
-                            if (!is_stream_symbol_subscribed(session->id, symbol)) {
+                            if (!subscriptions.allows(symbol)) {
                                 spdlog::trace("[PollingFeeder] session={} dropping event for unsubscribed symbol={}",
                                               session->id, symbol);
                                 return;
@@ -1623,7 +2470,7 @@ void SessionManager::start_polling_feeder(std::shared_ptr<Session> session) {
                     );
                 } else {
                     data_source_->stream_events(symbols, cursor, window_end, 
-                        [this, session, cursor, window_end, &emitted_in_window](const MarketEvent& ev) {
+                        [this, session, cursor, window_end, &emitted_in_window, &subscriptions](const MarketEvent& ev) {
                             if (ev.timestamp < cursor || ev.timestamp >= window_end) return;
                             if (ev.timestamp < session->config.start_time ||
                                 ev.timestamp >= session->config.end_time) {
@@ -1632,7 +2479,7 @@ void SessionManager::start_polling_feeder(std::shared_ptr<Session> session) {
                             const std::string& symbol = 
                                 (ev.type == MarketEventType::QUOTE) ? ev.quote.symbol : ev.trade.symbol;
                             
-                            if (!is_stream_symbol_subscribed(session->id, symbol)) {
+                            if (!subscriptions.allows(symbol)) {
                                 spdlog::trace("[PollingFeeder] session={} dropping event for unsubscribed symbol={}",
                                               session->id, symbol);
                                 return;
@@ -1659,13 +2506,60 @@ void SessionManager::start_polling_feeder(std::shared_ptr<Session> session) {
 }
 
 void SessionManager::append_event_log(const std::string& session_id, const std::string& payload) {
-    std::lock_guard<std::mutex> l(log_mutex_);
+    if (tls_order_group && tls_order_group->session->id == session_id) {
+        tls_order_group->log.append(payload);
+        tls_order_group->log.push_back('\n');
+        return;
+    }
+    std::lock_guard<InstrumentedMutex> l(log_mutex_);
     auto it = session_logs_.find(session_id);
     if (it != session_logs_.end() && it->second.good()) {
         it->second << payload << "\n";
     }
 }
 
+void SessionManager::append_wal(const std::shared_ptr<Session>& session, const nlohmann::json& entry) {
+    if (tls_order_group && tls_order_group->session == session.get()) {
+        if (tls_order_group->has_wal) {
+            tls_order_group->wal += entry.dump();
+            tls_order_group->wal.push_back('\n');
+        }
+        return;
+    }
+    static const auto wal_append = MetricsRegistry::instance().histogram(
+        "broker_wal_append_seconds", "WAL append (write and flush) wall time, single or group commit");
+    std::lock_guard<std::mutex> lock(session->wal_mutex);
+    if (session->wal) {
+        const auto started = std::chrono::steady_clock::now();
+        session->wal->append(entry);
+        wal_append->record_since(started);
+    }
+}
+
+void SessionManager::flush_order_group(const std::shared_ptr<Session>& session,
+                                       std::string& wal_lines,
+                                       std::string& log_lines) {
+    if (!wal_lines.empty()) {
+        static const auto wal_append = MetricsRegistry::instance().histogram(
+            "broker_wal_append_seconds", "WAL append (write and flush) wall time, single or group commit");
+        std::lock_guard<std::mutex> lock(session->wal_mutex);
+        if (session->wal) {
+            const auto started = std::chrono::steady_clock::now();
+            session->wal->append_batch(wal_lines);
+            wal_append->record_since(started);
+        }
+        wal_lines.clear();
+    }
+    if (!log_lines.empty()) {
+        std::lock_guard<InstrumentedMutex> l(log_mutex_);
+        auto it = session_logs_.find(session->id);
+        if (it != session_logs_.end() && it->second.good()) {
+            it->second << log_lines;
+        }
+        log_lines.clear();
+    }
+}
+
 void SessionManager::stop_feeds(std::shared_ptr<Session> session) {
     (void)session;
     // DataSource streaming API is currently blocking without cancel; threads will exit when stream ends.
@@ -1684,7 +2578,7 @@ void SessionManager::start_shared_feeder() {
             const auto loop_started_at = std::chrono::steady_clock::now();
             std::vector<std::shared_ptr<Session>> running_sessions;
             {
-                std::lock_guard<std::mutex> lock(mutex_);
+                std::lock_guard<InstrumentedMutex> lock(mutex_);
                 for (const auto& kv : sessions_) {
                     if (kv.second->status == SessionStatus::RUNNING) {
                         running_sessions.push_back(kv.second);
@@ -1893,34 +2787,37 @@ void SessionManager::stop_shared_feeder() {
     shared_feed_thread_.reset();
 }
 
-bool SessionManager::enqueue_event(std::shared_ptr<Session> session, const MarketEvent& ev) {
-    bool ok = false;
-    if (ev.type == MarketEventType::QUOTE) {
-        ok = session->event_queue->push(ev.timestamp, EventType::QUOTE, ev.quote.symbol,
-            QuoteData{ev.quote.bid_price, ev.quote.bid_size, ev.quote.ask_price, ev.quote.ask_size,
-                      ev.quote.bid_exchange, ev.quote.ask_exchange, ev.quote.tape});
-    } else {
-        ok = session->event_queue->push(ev.timestamp, EventType::TRADE, ev.trade.symbol,
-            TradeData{ev.trade.price, ev.trade.size, ev.trade.exchange, ev.trade.conditions, ev.trade.tape});
-    }
+bool SessionManager::enqueue_event(std::shared_ptr<Session> session, const MarketEvent& ev,
+                                   bool wait_for_space) {
+    if (skip_replayed_event(*session, ev.timestamp)) return true;
+    AllocStageScope alloc_stage(AllocStage::ENQUEUE);
+    const int64_t decoded_ns = session->tracer.should_sample() ? trace_now_ns() : 0;
+    Event decoded = make_market_event(ev, 0);
+    session->last_enqueued_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        decoded.timestamp.time_since_epoch()).count(), std::memory_order_relaxed);
+    bool ok = wait_for_space
+        ? session->event_queue->push_wait(decoded.timestamp, decoded.event_type, decoded.symbol,
+                                          std::move(decoded.data), decoded_ns)
+        : session->event_queue->push(decoded.timestamp, decoded.event_type, decoded.symbol,
+                                     std::move(decoded.data), decoded_ns);
     session->events_enqueued.fetch_add(1, std::memory_order_relaxed);
     if (!ok) session->events_dropped.fetch_add(1, std::memory_order_relaxed);
     return ok;
 }
 
-bool SessionManager::enqueue_unified_event(std::shared_ptr<Session> session, const UnifiedMarketEvent& ev) {
-    bool ok = false;
-    if (ev.type == UnifiedEventType::QUOTE) {
-        ok = session->event_queue->push(ev.timestamp, EventType::QUOTE, ev.quote.symbol,
-            QuoteData{ev.quote.bid_price, ev.quote.bid_size, ev.quote.ask_price, ev.quote.ask_size,
-                      ev.quote.bid_exchange, ev.quote.ask_exchange, ev.quote.tape});
-    } else if (ev.type == UnifiedEventType::TRADE) {
-        ok = session->event_queue->push(ev.timestamp, EventType::TRADE, ev.trade.symbol,
-            TradeData{ev.trade.price, ev.trade.size, ev.trade.exchange, ev.trade.conditions, ev.trade.tape});
-    } else {
-        BarData bd{ev.bar.open, ev.bar.high, ev.bar.low, ev.bar.close, ev.bar.volume, ev.bar.vwap, ev.bar.trade_count};
-        ok = session->event_queue->push(ev.timestamp, EventType::BAR, ev.bar.symbol, bd);
-    }
+bool SessionManager::enqueue_unified_event(std::shared_ptr<Session> session, const UnifiedMarketEvent& ev,
+                                           bool wait_for_space) {
+    if (skip_replayed_event(*session, ev.timestamp)) return true;
+    AllocStageScope alloc_stage(AllocStage::ENQUEUE);
+    const int64_t decoded_ns = session->tracer.should_sample() ? trace_now_ns() : 0;
+    Event decoded = make_unified_event(ev, 0);
+    session->last_enqueued_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        decoded.timestamp.time_since_epoch()).count(), std::memory_order_relaxed);
+    bool ok = wait_for_space
+        ? session->event_queue->push_wait(decoded.timestamp, decoded.event_type, decoded.symbol,
+                                          std::move(decoded.data), decoded_ns)
+        : session->event_queue->push(decoded.timestamp, decoded.event_type, decoded.symbol,
+                                     std::move(decoded.data), decoded_ns);
     session->events_enqueued.fetch_add(1, std::memory_order_relaxed);
     if (!ok) session->events_dropped.fetch_add(1, std::memory_order_relaxed);
     return ok;
@@ -1928,6 +2825,8 @@ bool SessionManager::enqueue_unified_event(std::shared_ptr<Session> session, con
 
 bool SessionManager::enqueue_news_event(std::shared_ptr<Session> session, const CompanyNewsRecord& news) {
     if (!session || !session->event_queue) return false;
+    AllocStageScope alloc_stage(AllocStage::ENQUEUE);
+    const int64_t decoded_ns = session->tracer.should_sample() ? trace_now_ns() : 0;
 
     std::string symbol = news.symbol;
     if (symbol.empty()) symbol = news.related;
@@ -1944,7 +2843,7 @@ bool SessionManager::enqueue_news_event(std::shared_ptr<Session> session, const
     payload.id = news.id;
     payload.raw_json = news.raw_json;
 
-    bool ok = session->event_queue->push(news.datetime, EventType::NEWS, symbol, std::move(payload));
+    bool ok = session->event_queue->push(news.datetime, EventType::NEWS, symbol, std::move(payload), decoded_ns);
     session->events_enqueued.fetch_add(1, std::memory_order_relaxed);
     if (!ok) session->events_dropped.fetch_add(1, std::memory_order_relaxed);
     return ok;
@@ -1958,7 +2857,7 @@ void SessionManager::start_news_feed_for_symbol(std::shared_ptr<Session> session
     if (token.empty()) return;
 
     {
-        std::lock_guard<std::mutex> lock(stream_mutex_);
+        std::lock_guard<InstrumentedMutex> lock(stream_mutex_);
         auto& started_tokens = news_feeder_started_tokens_[session->id];
         if (started_tokens.find(token) != started_tokens.end()) {
             return;
@@ -2075,7 +2974,7 @@ void SessionManager::start_news_feed_for_symbol(std::shared_ptr<Session> session
 }
 
 void SessionManager::enforce_margin(std::shared_ptr<Session> session) {
-    if (!exec_cfg_.enable_margin_call_checks) return;
+    if (!exec_cfg_for(*session).enable_margin_call_checks) return;
     auto st = session->account_manager->state();
     if (st.maintenance_margin <= 0.0) {
         session->margin_call_active.store(false, std::memory_order_release);
@@ -2086,7 +2985,7 @@ void SessionManager::enforce_margin(std::shared_ptr<Session> session) {
         return;
     }
     if (session->margin_call_active.exchange(true)) return;
-    if (!exec_cfg_.enable_forced_liquidation) return;
+    if (!exec_cfg_for(*session).enable_forced_liquidation) return;
 
     auto positions = session->account_manager->positions();
     for (const auto& kv : positions) {
@@ -2124,14 +3023,7 @@ void SessionManager::enforce_margin(std::shared_ptr<Session> session) {
         ev.data = OrderData{order.id, order.client_order_id, order.qty.value_or(0.0), 0.0, 0.0, "liquidation_new",
                             order.side == OrderSide::BUY ? "buy" : "sell",
                             pos_qty};
-        std::vector<EventCallback> callbacks_copy;
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            callbacks_copy = event_callbacks_;
-        }
-        for (auto& cb : callbacks_copy) {
-            if (cb) cb(session->id, ev);
-        }
+        emit_order_event(*session, ev);
 
         Fill fill{order.id, order.qty.value_or(0.0), price, nbbo->timestamp, false};
         process_fill(session, fill);
@@ -2144,15 +3036,11 @@ void SessionManager::enforce_margin(std::shared_ptr<Session> session) {
 }
 
 std::optional<Order> SessionManager::find_order(std::shared_ptr<Session> session, const std::string& order_id) {
-    std::lock_guard<std::mutex> lock(session->orders_mutex);
-    auto it = session->orders.find(order_id);
-    if (it != session->orders.end()) return it->second;
-    return std::nullopt;
+    return session->orders.get(order_id);
 }
 
 void SessionManager::upsert_order(std::shared_ptr<Session> session, const Order& order) {
-    std::lock_guard<std::mutex> lock(session->orders_mutex);
-    session->orders[order.id] = order;
+    session->orders.upsert(order);
 }
 
 std::string SessionManager::generate_uuid() {
@@ -2183,49 +3071,34 @@ void SessionManager::jump_to(const std::string& session_id, Timestamp ts) {
     if (session) {
         bool was_running = session->status == SessionStatus::RUNNING;
         bool was_paused = session->status == SessionStatus::PAUSED;
-        session->should_stop.store(true);
-        session->time_engine->stop();
-        if (session->event_queue) session->event_queue->stop();
-        for (auto& t : session->feed_threads) {
-            if (t && t->joinable()) t->join();
-        }
-        session->feed_threads.clear();
-        if (session->polling_thread && session->polling_thread->joinable()) {
-            session->polling_thread->join();
-        }
-        session->polling_thread.reset();
-        if (session->worker_thread && session->worker_thread->joinable()) {
-            session->worker_thread->join();
-        }
-        session->worker_thread.reset();
+        quiesce_session(session);
         session->event_queue = std::make_shared<EventQueue>(session->config.queue_capacity,
                                                             session->config.overflow_policy);
         session->matching_engine = std::make_shared<MatchingEngine>();
+        session->matching_engine->set_config(exec_cfg_for(*session));
         session->account_manager = std::make_shared<AccountManager>(session->config.initial_capital);
         session->perf = std::make_shared<PerformanceTracker>();
-        {
-            std::lock_guard<std::mutex> lock(session->orders_mutex);
-            session->orders.clear();
-        }
+        session->orders.clear();
         session->last_event_ns.store(0, std::memory_order_release);
+        session->last_enqueued_ns.store(0, std::memory_order_relaxed);
         session->cash = session->config.initial_capital;
         session->equity = session->config.initial_capital;
         session->perf->record(ts, session->equity);
         session->time_engine->set_time(ts);
         session->config.start_time = ts;
+        session->resume_skip_events.store(0);
+        {
+            std::lock_guard<std::mutex> lock(session->snapshot_mutex);
+            session->snapshots.clear();
+        }
+        session->next_snapshot_ns = 0;
+        session->snapshot_interval_ns = 0;
         session->should_stop.store(false);
 
         if (was_running || was_paused) {
             session->status = SessionStatus::RUNNING;
             session->time_engine->start();
-            if (exec_cfg_.poll_interval_seconds > 0) {
-                start_polling_feeder(session);
-            } else {
-                preload_events(session);
-            }
-            session->worker_thread = std::make_unique<std::thread>(
-                [this, session]() { run_session_loop(session); }
-            );
+            start_session_feed(session);
             if (was_paused) {
                 session->time_engine->pause();
                 session->status = SessionStatus::PAUSED;
@@ -2241,50 +3114,218 @@ void SessionManager::fast_forward(const std::string& session_id, Timestamp ts) {
     bool was_running = session->status == SessionStatus::RUNNING;
     bool was_paused = session->status == SessionStatus::PAUSED;
 
-    session->should_stop.store(true);
-    session->time_engine->stop();
-    if (session->event_queue) session->event_queue->stop();
-    for (auto& t : session->feed_threads) {
-        if (t && t->joinable()) t->join();
+    quiesce_session(session);
+
+    // The queue holds at most a window of what lies ahead; replay the whole
+    // gap from the data source instead, then feed on from its last event.
+    if (session->event_queue) {
+        session->event_queue->reset();
+        session->event_queue->clear();
     }
-    session->feed_threads.clear();
-    if (session->polling_thread && session->polling_thread->joinable()) {
-        session->polling_thread->join();
+    session->should_stop.store(false);
+    {
+        std::lock_guard<std::mutex> step(session->step_mutex);
+        session->resume_skip_events.store(session->events_at_last_ts);
+        replay_through(session, ts);
     }
-    session->polling_thread.reset();
-    if (session->worker_thread && session->worker_thread->joinable()) {
-        session->worker_thread->join();
+    session->time_engine->set_time(ts);
+
+    if (was_running || was_paused) {
+        session->status = SessionStatus::RUNNING;
+        session->time_engine->start();
+        start_session_feed(session);
+        if (was_paused) {
+            session->time_engine->pause();
+            session->status = SessionStatus::PAUSED;
+        }
     }
-    session->worker_thread.reset();
+}
 
-    if (session->event_queue) session->event_queue->reset();
-    session->should_stop.store(false);
+uint64_t SessionManager::replay_through(const std::shared_ptr<Session>& session, Timestamp ts) {
+    // Replay (cursor, ts] straight from the data source.
+    const Timestamp replay_from = session->last_event_ns.load(std::memory_order_acquire) > 0
+        ? Timestamp{} + std::chrono::nanoseconds(session->last_event_ns.load(std::memory_order_acquire))
+        : session->time_engine->current_time();
+    session->config.start_time = replay_from;
+    uint64_t replayed = 0;
+    uint64_t sequence = 0;
+    auto apply = [&](Event ev) {
+        if (ev.timestamp < replay_from || ev.timestamp > ts) return;
+        if (skip_replayed_event(*session, ev.timestamp)) return;
+        maybe_snapshot(*session, ev.timestamp);
+        session->time_engine->set_time(ev.timestamp);
+        process_event(session, ev, false);
+        ++replayed;
+    };
+    if (data_source_ && replay_from <= ts) {
+        auto symbols = get_stream_symbols(session);
+        const Timestamp replay_end = std::min(ts + std::chrono::nanoseconds(1), session->config.end_time);
+        if (session->config.live_bar_aggr_source == "1s") {
+            data_source_->stream_events_with_bars(symbols, replay_from, replay_end,
+                [&](const UnifiedMarketEvent& uev) {
+                    apply(make_unified_event(uev, sequence++));
+                });
+        } else {
+            data_source_->stream_events(symbols, replay_from, replay_end, [&](const MarketEvent& mev) {
+                apply(make_market_event(mev, sequence++));
+            });
+        }
+    }
 
-    while (true) {
-        auto next = session->event_queue->peek();
-        if (!next) break;
-        if (next->timestamp > ts) break;
-        auto ev_opt = session->event_queue->pop();
-        if (!ev_opt) break;
-        session->time_engine->set_time(ev_opt->timestamp);
-        process_event(session, *ev_opt, false);
+    // The live feed resumes after the last replayed event.
+    const int64_t cursor_ns = session->last_event_ns.load(std::memory_order_acquire);
+    if (cursor_ns > 0) {
+        session->config.start_time = Timestamp{} + std::chrono::nanoseconds(cursor_ns);
+        session->resume_skip_events.store(session->events_at_last_ts);
     }
-    session->time_engine->set_time(ts);
+    return replayed;
+}
+
+std::optional<SeekResult> SessionManager::seek_to(const std::string& session_id, Timestamp ts) {
+    auto session = get_session(session_id);
+    if (!session) return std::nullopt;
+
+    const bool was_running = session->status == SessionStatus::RUNNING;
+    const bool was_paused = session->status == SessionStatus::PAUSED;
+    quiesce_session(session);
+
+    const int64_t target_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(ts.time_since_epoch()).count();
+    std::shared_ptr<const SessionSnapshot> snap;
+    {
+        std::lock_guard<std::mutex> lock(session->snapshot_mutex);
+        auto it = session->snapshots.upper_bound(target_ns);
+        if (it != session->snapshots.begin()) snap = std::prev(it)->second;
+        // Later snapshots describe a future this seek discards.
+        session->snapshots.erase(it, session->snapshots.end());
+    }
+    SeekResult result;
+    if (!snap) {
+        // Before the first snapshot: replay from the start of the session
+        // window, restoring its opening state like any other snapshot.
+        auto initial = std::make_shared<SessionSnapshot>();
+        initial->sim_time = session->window_start;
+        initial->cash = session->config.initial_capital;
+        initial->equity = session->config.initial_capital;
+        initial->matching_engine = std::make_shared<MatchingEngine>();
+        initial->account_manager = std::make_shared<AccountManager>(session->config.initial_capital);
+        initial->perf = std::make_shared<PerformanceTracker>();
+        initial->perf->record(session->window_start, session->config.initial_capital);
+        snap = std::move(initial);
+    }
+    {
+        // One step, like fork: an order or cancel never lands between the
+        // restored state and the replay built on it.
+        std::lock_guard<std::mutex> step(session->step_mutex);
+        restore_snapshot(*session, *snap);
+        result.snapshot_time = snap->cursor_ns > 0
+            ? Timestamp{} + std::chrono::nanoseconds(snap->cursor_ns)
+            : snap->sim_time;
+        session->next_snapshot_ns = 0;
+        result.replayed_events = replay_through(session, ts);
+        session->time_engine->set_time(ts);
+        session->perf->record(ts, session->account_manager->state().equity);
+    }
+    spdlog::info("Session {} seek: restored snapshot at {} ns, replayed {} events",
+                 session->id,
+                 std::chrono::duration_cast<std::chrono::nanoseconds>(result.snapshot_time.time_since_epoch()).count(),
+                 result.replayed_events);
 
+    if (session->event_queue) {
+        session->event_queue->reset();
+        session->event_queue->clear();
+    }
+    session->should_stop.store(false);
     if (was_running || was_paused) {
         session->status = SessionStatus::RUNNING;
         session->time_engine->start();
-        if (exec_cfg_.poll_interval_seconds > 0) {
-            start_polling_feeder(session);
-        }
-        session->worker_thread = std::make_unique<std::thread>(
-            [this, session]() { run_session_loop(session); }
-        );
+        start_session_feed(session);
         if (was_paused) {
             session->time_engine->pause();
             session->status = SessionStatus::PAUSED;
         }
+    } else {
+        session->status = SessionStatus::STOPPED;
+    }
+    return result;
+}
+
+std::shared_ptr<ControlCommand> SessionManager::post_command(const std::string& session_id,
+                                                             const std::string& type,
+                                                             std::function<nlohmann::json()> run) {
+    auto session = get_session(session_id);
+    if (!session) return nullptr;
+
+    auto cmd = std::make_shared<ControlCommand>();
+    cmd->id = "cmd_" + generate_uuid();
+    cmd->session_id = session_id;
+    cmd->type = type;
+    cmd->submitted_at = std::chrono::system_clock::now();
+    cmd->run = std::move(run);
+    {
+        std::lock_guard<InstrumentedMutex> lock(command_mutex_);
+        commands_[cmd->id] = cmd;
+        command_order_.push_back(cmd->id);
+        while (command_order_.size() > kMaxRetainedCommands) {
+            commands_.erase(command_order_.front());
+            command_order_.pop_front();
+        }
+    }
+
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(session->mailbox_mutex);
+        session->mailbox.push_back(cmd);
+        if (!session->mailbox_active) {
+            session->mailbox_active = true;
+            schedule = true;
+        }
+    }
+    if (schedule) {
+        control_pool().submit([this, session]() { return drain_mailbox(session); });
+    }
+    return cmd;
+}
+
+std::shared_ptr<ControlCommand> SessionManager::get_command(const std::string& command_id) const {
+    std::lock_guard<InstrumentedMutex> lock(command_mutex_);
+    auto it = commands_.find(command_id);
+    return it != commands_.end() ? it->second : nullptr;
+}
+
+bool SessionManager::drain_mailbox(const std::shared_ptr<Session>& session) {
+    std::shared_ptr<ControlCommand> cmd;
+    {
+        std::lock_guard<std::mutex> lock(session->mailbox_mutex);
+        if (session->mailbox.empty()) {
+            session->mailbox_active = false;
+            return false;
+        }
+        cmd = std::move(session->mailbox.front());
+        session->mailbox.pop_front();
+    }
+
+    cmd->status.store(CommandStatus::RUNNING, std::memory_order_release);
+    CommandStatus outcome = CommandStatus::DONE;
+    try {
+        cmd->result = cmd->run();
+    } catch (const std::exception& e) {
+        cmd->error = e.what();
+        outcome = CommandStatus::FAILED;
+        spdlog::warn("Session {} command {} ({}) failed: {}",
+                     cmd->session_id, cmd->id, cmd->type, e.what());
+    }
+    cmd->run = nullptr;
+    cmd->completed_at = std::chrono::system_clock::now();
+    cmd->status.store(outcome, std::memory_order_release);
+    StatusWsController::broadcast_command_status(*cmd);
+
+    // One command per slice so a busy mailbox does not starve other sessions.
+    std::lock_guard<std::mutex> lock(session->mailbox_mutex);
+    if (session->mailbox.empty()) {
+        session->mailbox_active = false;
+        return false;
     }
+    return true;
 }
 
 std::optional<int64_t> SessionManager::watermark_ns(const std::string& session_id) const {
@@ -2293,6 +3334,169 @@ std::optional<int64_t> SessionManager::watermark_ns(const std::string& session_i
     return session->last_event_ns.load(std::memory_order_acquire);
 }
 
+std::shared_ptr<SweepGroup> SessionManager::create_sweep(const SessionConfig& base,
+                                                        const std::vector<SweepVariant>& variants) {
+    if (variants.empty()) {
+        throw std::invalid_argument("sweep requires at least one variant");
+    }
+    auto group = std::make_shared<SweepGroup>();
+    group->id = "sweep_" + generate_uuid();
+    try {
+        for (const auto& variant : variants) {
+            SessionConfig cfg = base;
+            cfg.batch_mode = true;
+            if (variant.execution) cfg.execution = variant.execution;
+            if (variant.fees) cfg.fees = variant.fees;
+            if (variant.strategy_params) cfg.strategy_params = *variant.strategy_params;
+            group->sessions.push_back(create_session(cfg));
+            group->labels.push_back(variant.label.empty()
+                ? "variant_" + std::to_string(group->labels.size())
+                : variant.label);
+        }
+    } catch (...) {
+        for (const auto& session : group->sessions) {
+            destroy_session(session->id);
+        }
+        throw;
+    }
+    {
+        std::lock_guard<InstrumentedMutex> lock(mutex_);
+        sweeps_[group->id] = group;
+    }
+    spdlog::info("Sweep {} starting with {} sessions", group->id, group->sessions.size());
+    group->driver = std::make_unique<std::thread>(
+        [this, group, base]() { run_sweep(group, base); });
+    return group;
+}
+
+std::shared_ptr<SweepGroup> SessionManager::get_sweep(const std::string& sweep_id) const {
+    std::lock_guard<InstrumentedMutex> lock(mutex_);
+    auto it = sweeps_.find(sweep_id);
+    return it != sweeps_.end() ? it->second : nullptr;
+}
+
+void SessionManager::run_sweep(std::shared_ptr<SweepGroup> group, SessionConfig base) {
+    const size_t members = group->sessions.size();
+    std::vector<SessionLoopState> states(members);
+    std::vector<char> ended(members, 0);
+    for (size_t i = 0; i < members; ++i) {
+        auto& session = group->sessions[i];
+        session->status = SessionStatus::RUNNING;
+        session->started_at = std::chrono::system_clock::now();
+        session->time_engine->start();
+        session->should_stop.store(false);
+        states[i].started = true;
+        start_strategy(session);
+        request_daily_closes(session);
+    }
+    // This thread is every member's worker and is about to hold the data
+    // source for the whole pass, so the loads must land first.
+    for (auto& session : group->sessions) wait_for_daily_closes(*session);
+
+    const size_t chunk_size = exec_cfg_.scheduler_slice_events > 0
+        ? static_cast<size_t>(exec_cfg_.scheduler_slice_events)
+        : 1024;
+    std::vector<Event> chunk;
+    chunk.reserve(chunk_size);
+    uint64_t sequence = 0;
+    bool all_ended = false;
+    auto flush = [&]() {
+        if (chunk.empty() || all_ended) return;
+        std::stable_sort(chunk.begin(), chunk.end(), [](const Event& a, const Event& b) {
+            return a.timestamp < b.timestamp;
+        });
+        dispatch_sweep_chunk(*group, states, ended, chunk);
+        chunk.clear();
+        all_ended = std::all_of(ended.begin(), ended.end(), [](char e) { return e != 0; });
+    };
+
+    try {
+        if (data_source_) {
+            data_source_->stream_events(base.symbols, base.start_time, base.end_time,
+                [&](const MarketEvent& ev) {
+                    if (all_ended || group->should_stop.load(std::memory_order_relaxed)) return;
+                    chunk.push_back(make_market_event(ev, sequence++));
+                    group->events_read.fetch_add(1, std::memory_order_relaxed);
+                    if (chunk.size() >= chunk_size) flush();
+                });
+        }
+        flush();
+    } catch (const std::exception& e) {
+        spdlog::error("Sweep {} data pass failed: {}", group->id, e.what());
+    }
+
+    for (size_t i = 0; i < members; ++i) {
+        auto& session = group->sessions[i];
+        if (ended[i] == kSweepMemberFailed) continue;
+        if (group->should_stop.load()) {
+            session->status = SessionStatus::STOPPED;
+            session->time_engine->stop();
+            continue;
+        }
+        try {
+            finish_session_loop(session, states[i]);
+        } catch (const std::exception& e) {
+            session->status = SessionStatus::ERROR;
+            spdlog::error("Session {} error: {}", session->id, e.what());
+        }
+    }
+    group->done.store(true);
+    spdlog::info("Sweep {} finished: {} events read once for {} sessions",
+                 group->id, group->events_read.load(), members);
+}
+
+void SessionManager::dispatch_sweep_chunk(SweepGroup& group,
+                                          std::vector<SessionLoopState>& states,
+                                          std::vector<char>& ended,
+                                          const std::vector<Event>& chunk) {
+    std::mutex done_mutex;
+    std::condition_variable done_cv;
+    size_t remaining = 0;
+    for (char e : ended) {
+        if (e == 0) ++remaining;
+    }
+    if (remaining == 0) return;
+
+    // Every member consumes this chunk before the next one is decoded.
+    for (size_t i = 0; i < group.sessions.size(); ++i) {
+        if (ended[i]) continue;
+        auto session = group.sessions[i];
+        {
+            std::lock_guard<std::mutex> lock(session->loop_mutex);
+            session->loop_active = true;
+        }
+        scheduler().submit([&, i, session]() {
+            const auto slice_start = std::chrono::steady_clock::now();
+            try {
+                for (const auto& ev : chunk) {
+                    if (session->should_stop.load() ||
+                        apply_loop_event(session, ev, states[i]) == LoopEvent::END) {
+                        ended[i] = 1;
+                        break;
+                    }
+                }
+            } catch (const std::exception& e) {
+                ended[i] = kSweepMemberFailed;
+                session->status = SessionStatus::ERROR;
+                session->time_engine->stop();
+                spdlog::error("Session {} error: {}", session->id, e.what());
+            }
+            session->run_wall_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - slice_start).count(), std::memory_order_relaxed);
+            {
+                std::lock_guard<std::mutex> lock(session->loop_mutex);
+                session->loop_active = false;
+                session->loop_cv.notify_all();
+            }
+            std::lock_guard<std::mutex> lock(done_mutex);
+            if (--remaining == 0) done_cv.notify_one();
+            return false;
+        });
+    }
+    std::unique_lock<std::mutex> lock(done_mutex);
+    done_cv.wait(lock, [&] { return remaining == 0; });
+}
+
 void SessionManager::save_session_checkpoint(const std::string& session_id) {
     auto session = get_session(session_id);
     if (!session) return;
@@ -2303,10 +3507,8 @@ void SessionManager::save_session_checkpoint(const std::string& session_id) {
     ck.session_id = session->id;
     ck.account = session->account_manager->state();
     ck.positions = session->account_manager->positions();
-    {
-        std::lock_guard<std::mutex> lock(session->orders_mutex);
-        ck.orders = session->orders;
-    }
+    // Terminal orders live in the session's order archive, not the checkpoint.
+    ck.orders = session->orders.open_snapshot();
     ck.last_event_ns = session->last_event_ns.load(std::memory_order_acquire);
     ck.events_processed = session->events_processed.load(std::memory_order_acquire);
 
@@ -2345,10 +3547,7 @@ bool SessionManager::restore_session(std::shared_ptr<Session> session) {
     session->account_manager->restore_positions(ck->positions);
 
     // Restore orders
-    {
-        std::lock_guard<std::mutex> lock(session->orders_mutex);
-        session->orders = ck->orders;
-    }
+    session->orders.restore(ck->orders);
 
     // Restore NBBO cache to matching engine
     for (const auto& kv : ck->nbbo_cache) {
@@ -2432,11 +3631,7 @@ void SessionManager::replay_wal_entries(std::shared_ptr<Session> session, int64_
             std::string order_id = entry.data.value("id", "");
             if (!order_id.empty()) {
                 session->matching_engine->cancel_order(order_id);
-                std::lock_guard<std::mutex> lock(session->orders_mutex);
-                auto it = session->orders.find(order_id);
-                if (it != session->orders.end()) {
-                    it->second.status = OrderStatus::CANCELED;
-                }
+                session->orders.update(order_id, [](Order& o) { o.status = OrderStatus::CANCELED; });
             }
         } else if (entry.event_type == "market_event") {
             // Replay market event for NBBO update
@@ -2507,7 +3702,7 @@ void SessionManager::update_stream_subscriptions(const std::string& session_id,
     std::vector<std::string> new_symbols;
     
     {
-        std::lock_guard<std::mutex> lock(stream_mutex_);
+        std::lock_guard<InstrumentedMutex> lock(stream_mutex_);
         auto& symbol_counts = stream_symbol_counts_[session_id];
         
         for (const auto& symbol : symbols) {
@@ -2531,6 +3726,7 @@ void SessionManager::update_stream_subscriptions(const std::string& session_id,
                 }
             }
         }
+        publish_stream_subscriptions_locked(*session, symbol_counts);
     }
     
     // Load data for new subscriptions
@@ -2558,57 +3754,43 @@ void SessionManager::update_stream_subscriptions(const std::string& session_id,
     }
 }
 
+void SessionManager::publish_stream_subscriptions_locked(Session& session,
+                                                         const std::unordered_map<std::string, int>& counts) {
+    std::vector<std::string> symbols;
+    symbols.reserve(counts.size());
+    for (const auto& [symbol, count] : counts) {
+        if (count > 0) symbols.push_back(symbol);
+    }
+    session.stream_subscriptions.publish(std::move(symbols));
+}
+
 std::vector<std::string> SessionManager::get_stream_symbols(std::shared_ptr<Session> session) const {
     if (!session) {
         spdlog::warn("[StreamSub] get_stream_symbols called with null session");
         return {};
     }
-    
-    std::lock_guard<std::mutex> lock(stream_mutex_);
-    auto it = stream_symbol_counts_.find(session->id);
-    
-    if (it == stream_symbol_counts_.end() || it->second.empty()) {
+    auto subscribed = session->stream_subscriptions.load();
+    if (!subscribed) {
         // Fallback: return session config symbols for backward compatibility
         spdlog::debug("[StreamSub] session={} no active subscriptions, falling back to config symbols (count={})",
                       session->id, session->config.symbols.size());
         return session->config.symbols;
     }
-    
-    std::vector<std::string> result;
-    result.reserve(it->second.size());
-    for (const auto& kv : it->second) {
-        if (kv.second > 0) {
-            result.push_back(kv.first);
-        }
-    }
-    
-    spdlog::debug("[StreamSub] session={} returning {} subscribed symbols", 
-                  session->id, result.size());
-    return result;
+    return subscribed->symbols;
 }
 
 bool SessionManager::is_stream_symbol_subscribed(const std::string& session_id, 
                                                   const std::string& symbol) const {
-    std::lock_guard<std::mutex> lock(stream_mutex_);
-    auto session_it = stream_symbol_counts_.find(session_id);
-    
-    if (session_it == stream_symbol_counts_.end() || session_it->second.empty()) {
-        // No subscriptions for this session - fallback behavior (stream everything)
-        spdlog::trace("[StreamSub] session={} symbol={} no subscriptions, allowing (fallback)", 
-                      session_id, symbol);
-        return true;
-    }
-    
-    auto symbol_it = session_it->second.find(symbol);
-    bool subscribed = (symbol_it != session_it->second.end() && symbol_it->second > 0);
-    
-    spdlog::trace("[StreamSub] session={} symbol={} subscribed={}", 
-                  session_id, symbol, subscribed);
-    return subscribed;
+    auto session = get_session(session_id);
+    if (!session) return false;
+    auto subscribed = session->stream_subscriptions.load();
+    // No subscriptions for this session - fallback behavior (stream everything)
+    return !subscribed || subscribed->contains(symbol);
 }
 
 void SessionManager::clear_stream_subscriptions(const std::string& session_id) {
-    std::lock_guard<std::mutex> lock(stream_mutex_);
+    auto session = get_session(session_id);
+    std::lock_guard<InstrumentedMutex> lock(stream_mutex_);
     auto it = stream_symbol_counts_.find(session_id);
     if (it != stream_symbol_counts_.end()) {
         size_t count = it->second.size();
@@ -2616,6 +3798,7 @@ void SessionManager::clear_stream_subscriptions(const std::string& session_id) {
         spdlog::info("[StreamSub] session={} cleared {} symbol subscriptions", 
                      session_id, count);
     }
+    if (session) session->stream_subscriptions.publish({});
 }
 
 void SessionManager::update_news_subscriptions(const std::string& session_id,
@@ -2630,7 +3813,7 @@ void SessionManager::update_news_subscriptions(const std::string& session_id,
     std::vector<std::string> new_tokens;
 
     {
-        std::lock_guard<std::mutex> lock(stream_mutex_);
+        std::lock_guard<InstrumentedMutex> lock(stream_mutex_);
         auto& token_counts = stream_news_symbol_counts_[session_id];
 
         for (const auto& raw_symbol : symbols) {
@@ -2681,7 +3864,7 @@ bool SessionManager::is_news_symbol_subscribed(const std::string& session_id,
     const auto token = normalize_news_token(symbol);
     if (token.empty()) return false;
 
-    std::lock_guard<std::mutex> lock(stream_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(stream_mutex_);
     auto session_it = stream_news_symbol_counts_.find(session_id);
     if (session_it == stream_news_symbol_counts_.end() || session_it->second.empty()) {
         return false;
@@ -2699,7 +3882,7 @@ bool SessionManager::is_news_symbol_subscribed(const std::string& session_id,
 }
 
 void SessionManager::clear_news_subscriptions(const std::string& session_id) {
-    std::lock_guard<std::mutex> lock(stream_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(stream_mutex_);
 
     auto count_it = stream_news_symbol_counts_.find(session_id);
     if (count_it != stream_news_symbol_counts_.end()) {
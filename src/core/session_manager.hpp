@@ -8,12 +8,15 @@
 #include <atomic>
 #include <optional>
 #include <mutex>
+#include <condition_variable>
 #include <unordered_map>
 #include <unordered_set>
+#include <map>
 #include <functional>
 #include <random>
 #include <fstream>
 #include <filesystem>
+#include <deque>
 
 #include "time_engine.hpp"
 #include "event_queue.hpp"
@@ -23,6 +26,17 @@
 #include "data_source.hpp"
 #include "config.hpp"
 #include "wal_logger.hpp"
+#include "order_store.hpp"
+#include "strategy.hpp"
+#include "session_scheduler.hpp"
+#include "metrics.hpp"
+#include "instrumented_mutex.hpp"
+#include "callback_list.hpp"
+#include "stream_subscriptions.hpp"
+#include "symbol_state.hpp"
+#include "luld_bands.hpp"
+#include "tracing.hpp"
+#include "pace_monitor.hpp"
 
 namespace broker_sim {
 
@@ -36,13 +50,82 @@ struct SessionConfig {
     std::string overflow_policy{"block"};
     std::string live_bar_aggr_source{"trades"};  // "trades", "1s", or "minute"
     int64_t live_aggr_bar_stream_freq_ms{500};  // milliseconds
+    std::string strategy_library;  // optional in-process strategy (.so path)
+    std::string strategy_params;   // raw JSON handed to the strategy factory
+    bool batch_mode{false};        // step time inline at max speed; ignores pause
+    uint64_t batch_checkpoint_events{0};  // batch mode: publish time every N events (0 = end only)
+    std::optional<ExecutionConfig> execution;  // per-session override of the manager's config
+    std::optional<FeeConfig> fees;             // per-session override of the manager's config
 };
 
 enum class SessionStatus { CREATED, RUNNING, PAUSED, STOPPED, COMPLETED, ERROR };
 
+/**
+ * Session state at an event boundary. Engine, account and equity history are
+ * copy-on-write forks, so holding a snapshot costs little until the live
+ * session diverges. Used for forks and seek_to.
+ */
+struct SessionSnapshot {
+    Timestamp sim_time;
+    int64_t cursor_ns{0};          // last applied event (0 = none yet)
+    uint64_t events_at_cursor{0};  // events applied at cursor_ns
+    uint64_t events_processed{0};
+    double cash{0.0};
+    double equity{0.0};
+    bool margin_call_active{false};
+    std::shared_ptr<MatchingEngine> matching_engine;
+    std::shared_ptr<AccountManager> account_manager;
+    std::shared_ptr<PerformanceTracker> perf;
+    std::unordered_map<std::string, Order> open_orders;
+    OrderArchive::Mark archive_mark;   // closed orders archived up to here
+    std::vector<std::pair<SymbolId, SymbolRegulatoryState>> symbol_state;
+    int64_t prior_close_day_ns{0};     // trading date SSR state belongs to
+    std::vector<SymbolId> ssr_triggered_today;
+};
+
+// Daily bars per symbol as (bar start ns, close), oldest first.
+using DailyCloses = std::unordered_map<SymbolId, std::vector<std::pair<int64_t, double>>>;
+
+struct SeekResult {
+    Timestamp snapshot_time;
+    uint64_t replayed_events{0};
+};
+
+enum class CommandStatus { QUEUED, RUNNING, DONE, FAILED };
+
+inline const char* command_status_name(CommandStatus status) {
+    switch (status) {
+        case CommandStatus::QUEUED: return "queued";
+        case CommandStatus::RUNNING: return "running";
+        case CommandStatus::DONE: return "done";
+        case CommandStatus::FAILED: return "failed";
+    }
+    return "unknown";
+}
+
+/**
+ * A control operation posted to a session's mailbox. result, error and
+ * completed_at are written before status becomes DONE/FAILED and are only
+ * read after observing that.
+ */
+struct ControlCommand {
+    std::string id;
+    std::string session_id;
+    std::string type;  // "jump", "seek", "fast_forward", "stop"
+    Timestamp submitted_at;
+    std::atomic<CommandStatus> status{CommandStatus::QUEUED};
+    std::optional<Timestamp> completed_at;
+    nlohmann::json result;
+    std::string error;
+    std::function<nlohmann::json()> run;
+};
+
+using EventCallback = std::function<void(const std::string& session_id, const Event& ev)>;
+
 struct Session {
     std::string id;
     SessionConfig config;
+    Timestamp window_start;  // config.start_time at creation; fork/seek move config.start_time
     std::shared_ptr<TimeEngine> time_engine;
     std::shared_ptr<EventQueue> event_queue;
     std::shared_ptr<MatchingEngine> matching_engine;
@@ -57,41 +140,120 @@ struct Session {
     std::atomic<int64_t> last_event_ns{0};
     std::atomic<bool> margin_call_active{false};
     std::atomic<uint64_t> events_enqueued{0};
+    std::atomic<int64_t> last_enqueued_ns{0};  // simulated time of the newest fed market event
     std::atomic<uint64_t> events_dropped{0};
     std::atomic<uint64_t> events_processed{0};
     std::atomic<uint64_t> last_checkpoint_events{0};
+    std::atomic<int64_t> run_wall_ns{0};  // wall-clock time spent in the session loop
+    // Registry series labelled with this session; removed by destroy_session
+    std::shared_ptr<Histogram> event_latency;  // process_event wall time per market event
+    std::shared_ptr<Histogram> queue_wait;     // enqueue to pop, including any pacing lead
+    SessionTracer tracer;                      // sampled per-stage pipeline spans
+    PaceMonitor pace;                          // achieved speed / lag history, see pace_report()
+    StreamSubscriptions stream_subscriptions;  // published from stream_symbol_counts_ for feeder filtering
+    // Event cursor: events applied at last_event_ns (a fork resumes after them)
+    uint64_t events_at_last_ts{0};
+    // Forked/seeked sessions re-stream from config.start_time; this many events
+    // at exactly that timestamp were already applied and are dropped
+    std::string forked_from;
+    std::atomic<uint64_t> resume_skip_events{0};
+    // Seek snapshots keyed by cursor_ns; written by the loop thread
+    std::map<int64_t, std::shared_ptr<const SessionSnapshot>> snapshots;
+    std::mutex snapshot_mutex;
+    int64_t next_snapshot_ns{0};
+    int64_t snapshot_interval_ns{0};  // 0 until the first snapshot; doubles when thinned
+    // Held while one market event, order or cancel is applied so a fork sees
+    // whole steps
+    std::mutex step_mutex;
     std::vector<std::unique_ptr<std::thread>> feed_threads;
     std::unique_ptr<std::thread> polling_thread;
-    std::unordered_map<std::string, Order> orders;
-    std::mutex orders_mutex;
+    OrderStore orders;
     std::unique_ptr<WalLogger> wal;
     std::mutex wal_mutex;
     std::unique_ptr<std::thread> worker_thread;
+    // Batch sessions run on the SessionScheduler instead of worker_thread
+    std::mutex loop_mutex;
+    std::condition_variable loop_cv;
+    bool loop_active{false};
     std::atomic<bool> should_stop{false};
 
-    // Circuit breaker / halt tracking
-    std::unordered_set<std::string> halted_symbols;
-    std::unordered_map<std::string, Timestamp> halt_end_times;
-    std::mutex halt_mutex;
+    // Control mailbox: jump/seek/fast_forward/stop run here one at a time, off
+    // the caller's thread; mailbox_active while a drain task is queued/running
+    std::deque<std::shared_ptr<ControlCommand>> mailbox;
+    std::mutex mailbox_mutex;
+    bool mailbox_active{false};
 
-    // Short Sale Restriction (SSR) tracking - SEC Rule 201
-    std::unordered_set<std::string> ssr_symbols;  // Symbols under SSR
-    std::unordered_map<std::string, double> prior_close;  // Prior day close prices
-    std::mutex ssr_mutex;
+    // In-process strategy (optional). strategy/strategy_ctx are read and
+    // replaced only under strategy_mutex, which also serializes callbacks;
+    // strategy_attached lets the per-event dispatch skip the lock when unset.
+    std::shared_ptr<Strategy> strategy;
+    std::unique_ptr<StrategyContext> strategy_ctx;
+    std::recursive_mutex strategy_mutex;
+    std::atomic<bool> strategy_attached{false};
+    bool strategy_started{false};
 
-    // LULD reference prices (for circuit breaker calculation)
-    std::unordered_map<std::string, double> luld_reference_price;
-    std::unordered_map<std::string, double> luld_upper_band;
-    std::unordered_map<std::string, double> luld_lower_band;
+    // Halts, Short Sale Restriction (SEC Rule 201) and LULD bands per symbol.
+    // Written by the session worker; submit_order reads it without locking.
+    SymbolStateTable symbol_state;
+    // Trade-driven LULD bands; created on the first trade, dropped on restore.
+    std::unique_ptr<LuldBandEngine> luld;
+
+    // Prior closes for SSR. The window's daily bars are loaded on the control
+    // pool: start_session's load is awaited before the loop's first event, and
+    // symbols subscribed later merge when their load lands. At each ET
+    // midnight the worker publishes every symbol's last close before the new
+    // day from memory, replays included. Session worker only, apart from the
+    // hand-off fields under daily_closes_mutex.
+    int64_t prior_close_roll_ns{0};          // next ET midnight; 0 = roll on next event
+    int64_t prior_close_day_ns{0};           // trading date the published closes belong to
+    std::vector<SymbolId> ssr_triggered_today;
+    DailyCloses daily_closes;
+    std::unordered_set<std::string> daily_closes_symbols;  // loaded or in flight
+    uint64_t prior_close_subs_version{0};
+    std::mutex daily_closes_mutex;
+    DailyCloses daily_closes_pending;        // control pool loads, merged by the worker
+    std::atomic<bool> daily_closes_ready{false};
+    int daily_closes_inflight{0};
+    std::condition_variable daily_closes_cv;  // signalled when inflight drops to 0
+    std::vector<std::function<void()>> daily_closes_waiters;  // run then, off the lock
 
     Session(const std::string& session_id, const SessionConfig& cfg);
     ~Session();
     void stop();
+    /** Wait for the session loop (dedicated thread or scheduler task) to exit. */
+    void join_loop();
+};
+
+/**
+ * One member of a parameter sweep: overrides applied on top of the sweep's
+ * base SessionConfig.
+ */
+struct SweepVariant {
+    std::string label;
+    std::optional<ExecutionConfig> execution;
+    std::optional<FeeConfig> fees;
+    std::optional<std::string> strategy_params;
+};
+
+/**
+ * Sessions that share one market data pass. A single driver thread reads and
+ * decodes the stream once and feeds each chunk to every member in lockstep.
+ */
+struct SweepGroup {
+    std::string id;
+    std::vector<std::string> labels;
+    std::vector<std::shared_ptr<Session>> sessions;
+    std::atomic<bool> should_stop{false};
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> events_read{0};
+    std::unique_ptr<std::thread> driver;
+
+    ~SweepGroup();
 };
 
 class SessionManager {
 public:
-    using EventCallback = std::function<void(const std::string&, const Event&)>;
+    using EventCallback = broker_sim::EventCallback;
 
     explicit SessionManager(std::shared_ptr<DataSource> data_source = nullptr,
                             ExecutionConfig exec_cfg = {},
@@ -103,18 +265,87 @@ public:
                                             std::optional<std::string> session_id = std::nullopt);
     std::shared_ptr<Session> get_session(const std::string& session_id) const;
     std::vector<std::shared_ptr<Session>> list_sessions() const;
+
+    /** Take a pace sample (clock, schedule lag, feeder lead, queue depth) and report the trend. */
+    PaceReport pace_report(Session& session) const;
     void start_session(const std::string& session_id);
     void pause_session(const std::string& session_id);
     void resume_session(const std::string& session_id);
     void stop_session(const std::string& session_id);
     void destroy_session(const std::string& session_id);
+
+    /**
+     * Branch a running or paused session at its current simulated time. The new
+     * session shares account, positions, pending orders, NBBO cache and equity
+     * history with the parent copy-on-write, so the fork copies only what either
+     * side later changes. It re-streams market data from the parent's event
+     * cursor and starts in the parent's status. Throws std::invalid_argument.
+     */
+    std::shared_ptr<Session> fork_session(const std::string& parent_id,
+                                          std::optional<std::string> session_id = std::nullopt);
     std::string submit_order(const std::string& session_id, Order order);
     bool cancel_order(const std::string& session_id, const std::string& order_id);
+
+    /**
+     * Submit/cancel many orders as one step of the session: the session lock is
+     * taken once, no market event is applied mid-batch, and the batch's WAL and
+     * event-log records are written as one group before the lock is released.
+     * Results are positional; an empty id or false means rejected.
+     */
+    std::vector<std::string> submit_orders(const std::string& session_id, std::vector<Order> orders);
+    std::vector<bool> cancel_orders(const std::string& session_id, const std::vector<std::string>& order_ids);
     std::unordered_map<std::string, Order> get_orders(const std::string& session_id) const;
+    std::optional<Order> get_order(const std::string& session_id, const std::string& order_id) const;
+    std::optional<Order> get_order_by_client_id(const std::string& session_id,
+                                                const std::string& client_order_id) const;
+
+    /**
+     * Indexed order listing (newest-first by default); only matching orders are touched.
+     */
+    OrderPage list_orders(const std::string& session_id, const OrderQuery& query) const;
+    /**
+     * Callbacks run on the session's thread for every market and order event
+     * of every session. Dispatch takes no lock and does not allocate;
+     * registration copies the list, so it belongs in setup code.
+     */
     void add_event_callback(EventCallback cb);
+
+    /** Like add_event_callback, but only market data or only order lifecycle events. */
+    void add_market_data_callback(EventCallback cb);
+    void add_order_callback(EventCallback cb);
+
+    /**
+     * Attach an in-process strategy to a session. It is driven synchronously
+     * from the session loop and trades through submit_order/cancel_order.
+     * May be called at any time: the swap and every callback are serialized
+     * by strategy_mutex, so a strategy attached mid-run (replacing any earlier
+     * one) sees events from the next one on. on_start runs when the loop
+     * starts, so a strategy attached after that does not get it.
+     */
+    bool attach_strategy(const std::string& session_id, std::shared_ptr<Strategy> strategy);
     void set_speed(const std::string& session_id, double speed);
     void jump_to(const std::string& session_id, Timestamp ts);
+
+    /**
+     * Move a session to ts keeping its history: restore the nearest snapshot at
+     * or before ts and replay only the gap without callbacks. Running/paused
+     * sessions continue from ts; others are left STOPPED at ts. Unlike jump_to,
+     * which restarts from a clean account at ts.
+     */
+    std::optional<SeekResult> seek_to(const std::string& session_id, Timestamp ts);
     void fast_forward(const std::string& session_id, Timestamp ts);
+
+    /**
+     * Queue a control operation on the session's mailbox and return at once.
+     * Commands for one session run in submission order on the control pool, so
+     * the caller never waits for feeder or loop threads to join. `run` returns
+     * the command's result; a throw marks it FAILED. Completion is broadcast on
+     * the status WebSocket. Returns nullptr if the session does not exist.
+     */
+    std::shared_ptr<ControlCommand> post_command(const std::string& session_id,
+                                                 const std::string& type,
+                                                 std::function<nlohmann::json()> run);
+    std::shared_ptr<ControlCommand> get_command(const std::string& command_id) const;
     std::optional<int64_t> watermark_ns(const std::string& session_id) const;
     std::shared_ptr<DataSource> data_source() const { return data_source_; }
     std::shared_ptr<DataSource> api_data_source() const { return api_data_source_; }
@@ -140,7 +371,9 @@ public:
     std::vector<std::string> get_stream_symbols(std::shared_ptr<Session> session) const;
 
     /**
-     * Check if a symbol is subscribed for streaming in a session.
+     * Check if a symbol is subscribed for streaming in a session (true when
+     * nothing is subscribed). Feeders filter rows with a
+     * StreamSubscriptions::Reader on the session instead.
      */
     bool is_stream_symbol_subscribed(const std::string& session_id, const std::string& symbol) const;
 
@@ -169,6 +402,15 @@ public:
      */
     void clear_news_subscriptions(const std::string& session_id);
 
+    /**
+     * Create one batch-mode session per variant and start a driver that reads
+     * the base config's symbols/window from the DataSource once and dispatches
+     * it to all members. Throws if variants is empty.
+     */
+    std::shared_ptr<SweepGroup> create_sweep(const SessionConfig& base,
+                                             const std::vector<SweepVariant>& variants);
+    std::shared_ptr<SweepGroup> get_sweep(const std::string& sweep_id) const;
+
     /**
      * Save checkpoint for a session (for crash recovery).
      */
@@ -180,22 +422,110 @@ public:
     bool restore_session(std::shared_ptr<Session> session);
 
 private:
+    friend class SessionStrategyContext;
+
+    /**
+     * Progress of one session loop run, so the loop can be driven to completion
+     * on a dedicated thread or in slices on the SessionScheduler.
+     */
+    struct SessionLoopState {
+        size_t processed{0};
+        bool started{false};
+        bool preload{false};         // slices feed the queue a window at a time as it drains
+        Timestamp preload_cursor{};  // start of the next window to preload
+        bool parked{false};          // queue ran dry while still open; wait for a push
+    };
+
+    enum class LoopEvent { PROCESSED, SKIPPED, END };
+
     void run_session_loop(std::shared_ptr<Session> session);
+    LoopEvent apply_loop_event(const std::shared_ptr<Session>& session, const Event& ev, SessionLoopState& state);
+    void finish_session_loop(const std::shared_ptr<Session>& session, SessionLoopState& state);
+    void run_sweep(std::shared_ptr<SweepGroup> group, SessionConfig base);
+    void dispatch_sweep_chunk(SweepGroup& group,
+                              std::vector<SessionLoopState>& states,
+                              std::vector<char>& ended,
+                              const std::vector<Event>& chunk);
+    // Start the session's feed (batch, shared or polling) and its loop from config.start_time
+    void start_session_feed(const std::shared_ptr<Session>& session);
+    void launch_session_loop(std::shared_ptr<Session> session, bool preload_first = false);
+    void submit_session_slices(std::shared_ptr<Session> session,
+                               std::shared_ptr<SessionLoopState> state,
+                               size_t slice);
+    void preload_next_window(const std::shared_ptr<Session>& session, SessionLoopState& state);
+    bool run_session_slice(const std::shared_ptr<Session>& session,
+                           SessionLoopState& state,
+                           size_t max_events,
+                           bool blocking);
+    SessionScheduler& scheduler();
+    SessionScheduler& control_pool();
+    bool drain_mailbox(const std::shared_ptr<Session>& session);
+    const ExecutionConfig& exec_cfg_for(const Session& session) const {
+        return session.config.execution ? *session.config.execution : exec_cfg_;
+    }
+    const FeeConfig& fee_cfg_for(const Session& session) const {
+        return session.config.fees ? *session.config.fees : fee_cfg_;
+    }
+    void attach_session_storage(const std::shared_ptr<Session>& session, bool recover);
+    bool skip_replayed_event(Session& session, Timestamp ts);
+    std::shared_ptr<SessionSnapshot> capture_snapshot(Session& session);
+    void restore_snapshot(Session& session, const SessionSnapshot& snap);
+    void maybe_snapshot(Session& session, Timestamp next_event_time);
+    // Apply the data source's events from the cursor through ts without callbacks; caller holds step_mutex
+    uint64_t replay_through(const std::shared_ptr<Session>& session, Timestamp ts);
+    void roll_prior_closes(Session& session, Timestamp now);
+    void publish_prior_closes(Session& session);
+    // Load the window's daily bars for symbols not loaded yet, on the control pool
+    void request_daily_closes(const std::shared_ptr<Session>& session);
+    // Block until no load is in flight; the worker still merges on its next event
+    void wait_for_daily_closes(Session& session);
+    // Arm a one-shot callback for when no load is in flight; false (unarmed) if none is
+    bool notify_when_daily_closes_loaded(Session& session, std::function<void()> wakeup);
+    void merge_daily_closes(Session& session);
+    DailyCloses load_daily_closes(const std::vector<std::string>& symbols, Timestamp from, Timestamp to) const;
+    void quiesce_session(const std::shared_ptr<Session>& session);
     void process_event(std::shared_ptr<Session> session, const Event& event, bool emit_callbacks);
     void process_fill(std::shared_ptr<Session> session, const Fill& fill);
+    void apply_trading_halt(Session& session, const Event& ev);  // HALT/RESUME symbol state
+    // Catch-all callbacks, then the typed market data or order list
+    void emit_market_event(Session& session, const Event& ev) const;
+    void emit_order_event(Session& session, const Event& ev) const;
+    // Caller holds stream_mutex_, which keeps publications in count order
+    void publish_stream_subscriptions_locked(Session& session, const std::unordered_map<std::string, int>& counts);
     void expire_pending_orders_at(std::shared_ptr<Session> session, Timestamp timestamp);
     void stop_feeds(std::shared_ptr<Session> session);
-    void preload_events(std::shared_ptr<Session> session);
+    // wait_for_space: block on a full bounded queue instead of dropping; only
+    // from a producer thread with the session loop consuming concurrently.
+    void preload_events(std::shared_ptr<Session> session, bool wait_for_space = false);
     void start_polling_feeder(std::shared_ptr<Session> session);
     void start_shared_feeder();
     void stop_shared_feeder();
-    bool enqueue_event(std::shared_ptr<Session> session, const MarketEvent& ev);
-    bool enqueue_unified_event(std::shared_ptr<Session> session, const UnifiedMarketEvent& ev);
+    bool enqueue_event(std::shared_ptr<Session> session, const MarketEvent& ev, bool wait_for_space = false);
+    bool enqueue_unified_event(std::shared_ptr<Session> session, const UnifiedMarketEvent& ev,
+                               bool wait_for_space = false);
     bool enqueue_news_event(std::shared_ptr<Session> session, const CompanyNewsRecord& news);
     void start_news_feed_for_symbol(std::shared_ptr<Session> session, const std::string& symbol_token);
+    /**
+     * Data-source answers an order needs, fetched before the step lock so a
+     * slow ClickHouse query never holds up the session worker.
+     */
+    struct OrderLookups {
+        std::optional<bool> short_locate_ok;   // unset: not an opening short when looked up
+        std::optional<double> decision_price;  // market-data decision-time fill price
+    };
+    OrderLookups lookup_order_data(const std::shared_ptr<Session>& session, Order& order);
+    std::string submit_order_impl(std::shared_ptr<Session> session, Order order, const OrderLookups& lookups);
+    bool cancel_order_impl(std::shared_ptr<Session> session, const std::string& order_id);
     std::optional<Order> find_order(std::shared_ptr<Session> session, const std::string& order_id);
     void upsert_order(std::shared_ptr<Session> session, const Order& order);
     void append_event_log(const std::string& session_id, const std::string& payload);
+    void append_wal(const std::shared_ptr<Session>& session, const nlohmann::json& entry);
+    void flush_order_group(const std::shared_ptr<Session>& session,
+                           std::string& wal_lines,
+                           std::string& log_lines);
+    void dispatch_strategy_event(const std::shared_ptr<Session>& session, const Event& ev);
+    void start_strategy(const std::shared_ptr<Session>& session);
+    void stop_strategy(const std::shared_ptr<Session>& session);
     void enforce_margin(std::shared_ptr<Session> session);
     void maybe_checkpoint(std::shared_ptr<Session> session);
     void replay_wal_entries(std::shared_ptr<Session> session, int64_t after_ns);
@@ -206,19 +536,36 @@ private:
     std::shared_ptr<DataSource> data_source_;      // For session streaming (stream_events)
     std::shared_ptr<DataSource> api_data_source_;  // For API queries (get_quotes, get_trades, etc.)
     std::unordered_map<std::string, std::shared_ptr<Session>> sessions_;
-    mutable std::mutex mutex_;
+    mutable InstrumentedMutex mutex_{"session_manager"};
     std::unordered_map<std::string, std::ofstream> session_logs_;
-    std::mutex log_mutex_;
-    std::vector<EventCallback> event_callbacks_;
+    InstrumentedMutex log_mutex_{"session_manager.log"};
+    CallbackList<EventCallback> event_callbacks_;
+    CallbackList<EventCallback> market_data_callbacks_;  // quotes, trades, bars, news, status
+    CallbackList<EventCallback> order_callbacks_;        // order lifecycle and fills
     std::unique_ptr<std::thread> shared_feed_thread_;
     std::atomic<bool> shared_feed_running_{false};
 
     // Subscription-based streaming tracking
     // Maps session_id -> symbol -> reference count
-    mutable std::mutex stream_mutex_;
+    mutable InstrumentedMutex stream_mutex_{"session_manager.stream"};
     std::unordered_map<std::string, std::unordered_map<std::string, int>> stream_symbol_counts_;
     std::unordered_map<std::string, std::unordered_map<std::string, int>> stream_news_symbol_counts_;
     std::unordered_map<std::string, std::unordered_set<std::string>> news_feeder_started_tokens_;
+
+    std::unordered_map<std::string, std::shared_ptr<SweepGroup>> sweeps_;
+
+    // Recent control commands by id, oldest first in command_order_
+    mutable InstrumentedMutex command_mutex_{"session_manager.command"};
+    std::unordered_map<std::string, std::shared_ptr<ControlCommand>> commands_;
+    std::deque<std::string> command_order_;
+
+    // Shared pool for batch session loops; declared last so it is torn down first.
+    std::once_flag scheduler_once_;
+    std::unique_ptr<SessionScheduler> scheduler_;
+    // Runs mailbox commands; separate from scheduler_ because a command joins
+    // the session loop it would otherwise share a worker with.
+    std::once_flag control_once_;
+    std::unique_ptr<SessionScheduler> control_pool_;
 };
 
 } // namespace broker_sim
@@ -0,0 +1,98 @@
+#include "session_scheduler.hpp"
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+namespace broker_sim {
+
+SessionScheduler::SessionScheduler(size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    threads_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        threads_.emplace_back([this, i]() { run(i); });
+    }
+    spdlog::info("SessionScheduler started with {} workers", threads);
+}
+
+SessionScheduler::~SessionScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        stopping_.store(true, std::memory_order_release);
+    }
+    idle_cv_.notify_all();
+    for (auto& t : threads_) {
+        if (t.joinable()) t.join();
+    }
+}
+
+void SessionScheduler::submit(Task task) {
+    size_t index = next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+    push(index, std::move(task));
+}
+
+void SessionScheduler::push(size_t index, Task task) {
+    // Count first so a concurrent take() never drives pending_ below zero.
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        pending_.fetch_add(1, std::memory_order_release);
+    }
+    {
+        std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+        workers_[index]->tasks.push_back(std::move(task));
+    }
+    idle_cv_.notify_one();
+}
+
+bool SessionScheduler::take(size_t index, Task& out) {
+    {
+        auto& own = *workers_[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            out = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            pending_.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+    for (size_t k = 1; k < workers_.size(); ++k) {
+        auto& victim = *workers_[(index + k) % workers_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            out = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            pending_.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+    return false;
+}
+
+void SessionScheduler::run(size_t index) {
+    while (!stopping_.load(std::memory_order_acquire)) {
+        Task task;
+        if (take(index, task)) {
+            bool again = false;
+            try {
+                again = task();
+            } catch (const std::exception& e) {
+                spdlog::error("SessionScheduler task failed: {}", e.what());
+            }
+            if (again) {
+                push(index, std::move(task));
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        idle_cv_.wait(lock, [this] {
+            return stopping_.load(std::memory_order_acquire) ||
+                   pending_.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+} // namespace broker_sim
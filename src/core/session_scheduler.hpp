@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace broker_sim {
+
+/**
+ * Fixed-size work-stealing pool for cooperative session loops.
+ *
+ * A task runs one slice of work and returns true to be requeued (at the back
+ * of the running worker's deque) or false when finished. Workers take from the
+ * front of their own deque and steal from the back of others when idle, so
+ * hundreds of sessions share core-count threads without oversubscription.
+ */
+class SessionScheduler {
+public:
+    using Task = std::function<bool()>;
+
+    /** @param threads worker count; 0 = std::thread::hardware_concurrency() */
+    explicit SessionScheduler(size_t threads = 0);
+    ~SessionScheduler();
+
+    SessionScheduler(const SessionScheduler&) = delete;
+    SessionScheduler& operator=(const SessionScheduler&) = delete;
+
+    void submit(Task task);
+    size_t thread_count() const { return workers_.size(); }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void run(size_t index);
+    void push(size_t index, Task task);
+    bool take(size_t index, Task& out);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+    std::mutex idle_mutex_;
+    std::condition_variable idle_cv_;
+    std::atomic<size_t> pending_{0};
+    std::atomic<size_t> next_worker_{0};
+    std::atomic<bool> stopping_{false};
+};
+
+} // namespace broker_sim
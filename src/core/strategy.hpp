@@ -0,0 +1,71 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include "event_queue.hpp"
+#include "matching_engine.hpp"
+#include "account_manager.hpp"
+
+namespace broker_sim {
+
+/**
+ * Handle a strategy uses to trade against its session. Calls go straight to
+ * SessionManager (same validation, fills and WAL as the HTTP order routes) with
+ * no serialization. Only valid for the duration of a Strategy callback.
+ */
+class StrategyContext {
+public:
+    virtual ~StrategyContext() = default;
+    virtual const std::string& session_id() const = 0;
+    virtual Timestamp now() const = 0;
+    /** Returns the new order id, or empty if the order was rejected. */
+    virtual std::string submit_order(Order order) = 0;
+    virtual bool cancel_order(const std::string& order_id) = 0;
+    virtual std::optional<Order> get_order(const std::string& order_id) const = 0;
+    virtual AccountState account() const = 0;
+    virtual double position_qty(const std::string& symbol) const = 0;
+};
+
+/**
+ * In-process strategy driven synchronously from the session loop thread.
+ * Callbacks may nest: an order submitted from on_quote can fill immediately
+ * and deliver on_fill before on_quote returns.
+ */
+class Strategy {
+public:
+    virtual ~Strategy() = default;
+    virtual void on_start(StrategyContext& ctx) { (void)ctx; }
+    virtual void on_quote(StrategyContext& ctx, const std::string& symbol, Timestamp ts, const QuoteData& q) {
+        (void)ctx; (void)symbol; (void)ts; (void)q;
+    }
+    virtual void on_trade(StrategyContext& ctx, const std::string& symbol, Timestamp ts, const TradeData& t) {
+        (void)ctx; (void)symbol; (void)ts; (void)t;
+    }
+    virtual void on_bar(StrategyContext& ctx, const std::string& symbol, Timestamp ts, const BarData& b) {
+        (void)ctx; (void)symbol; (void)ts; (void)b;
+    }
+    virtual void on_fill(StrategyContext& ctx, const std::string& symbol, Timestamp ts, const OrderData& fill) {
+        (void)ctx; (void)symbol; (void)ts; (void)fill;
+    }
+    virtual void on_stop(StrategyContext& ctx) { (void)ctx; }
+};
+
+/**
+ * Shared-library entry points. A strategy library built against the same
+ * broker_sim headers exports both symbols, e.g.:
+ *
+ *   extern "C" broker_sim::Strategy* broker_sim_create_strategy(const char* params) {
+ *       return new MyStrategy(params);
+ *   }
+ *   extern "C" void broker_sim_destroy_strategy(broker_sim::Strategy* s) { delete s; }
+ *
+ * `params` is the raw JSON string from the session config ("{}" if unset).
+ */
+using CreateStrategyFn = Strategy* (*)(const char* params);
+using DestroyStrategyFn = void (*)(Strategy* strategy);
+
+inline constexpr const char* kCreateStrategySymbol = "broker_sim_create_strategy";
+inline constexpr const char* kDestroyStrategySymbol = "broker_sim_destroy_strategy";
+
+} // namespace broker_sim
@@ -0,0 +1,33 @@
+#include "strategy_loader.hpp"
+#include <dlfcn.h>
+#include <stdexcept>
+#include <spdlog/spdlog.h>
+
+namespace broker_sim {
+
+std::shared_ptr<Strategy> load_strategy_library(const std::string& path, const std::string& params) {
+    void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        const char* err = dlerror();
+        throw std::runtime_error("failed to load strategy library " + path + ": " + (err ? err : "unknown error"));
+    }
+    auto create = reinterpret_cast<CreateStrategyFn>(dlsym(handle, kCreateStrategySymbol));
+    auto destroy = reinterpret_cast<DestroyStrategyFn>(dlsym(handle, kDestroyStrategySymbol));
+    if (!create || !destroy) {
+        dlclose(handle);
+        throw std::runtime_error("strategy library " + path + " does not export " +
+                                 kCreateStrategySymbol + "/" + kDestroyStrategySymbol);
+    }
+    Strategy* raw = create(params.empty() ? "{}" : params.c_str());
+    if (!raw) {
+        dlclose(handle);
+        throw std::runtime_error("strategy library " + path + " returned no strategy");
+    }
+    spdlog::info("Loaded strategy library {}", path);
+    return std::shared_ptr<Strategy>(raw, [handle, destroy](Strategy* s) {
+        destroy(s);
+        dlclose(handle);
+    });
+}
+
+} // namespace broker_sim
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include "strategy.hpp"
+
+namespace broker_sim {
+
+/**
+ * dlopen a strategy shared library and instantiate its strategy. The returned
+ * pointer keeps the library loaded until the strategy is destroyed.
+ * Throws std::runtime_error if the library or its entry points cannot be loaded.
+ */
+std::shared_ptr<Strategy> load_strategy_library(const std::string& path, const std::string& params);
+
+} // namespace broker_sim
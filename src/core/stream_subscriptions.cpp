@@ -0,0 +1,29 @@
+#include "stream_subscriptions.hpp"
+
+#include <algorithm>
+
+namespace broker_sim {
+
+void StreamSubscriptions::publish(std::vector<std::string> symbols) {
+    std::shared_ptr<const StreamSubscriptionSet> next;
+    if (!symbols.empty()) {
+        auto set = std::make_shared<StreamSubscriptionSet>();
+        std::sort(symbols.begin(), symbols.end());
+        symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+        auto& table = SymbolTable::instance();
+        const auto ids = table.intern(symbols);
+        set->index = table.index();
+        const SymbolId max_id = *std::max_element(ids.begin(), ids.end());
+        set->bits.assign(max_id / 64 + 1, 0);
+        for (SymbolId id : ids) {
+            set->bits[id / 64] |= uint64_t{1} << (id % 64);
+        }
+        set->symbols = std::move(symbols);
+        next = std::move(set);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    current_ = std::move(next);
+    version_.fetch_add(1, std::memory_order_release);
+}
+
+} // namespace broker_sim
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "symbol_table.hpp"
+
+namespace broker_sim {
+
+/** Immutable set of a session's streamed symbols: a bitset over SymbolTable ids. */
+struct StreamSubscriptionSet {
+    std::vector<std::string> symbols;                  // sorted, for data source queries
+    std::shared_ptr<const SymbolTable::Index> index;   // resolves row symbols to ids
+    std::vector<uint64_t> bits;
+
+    bool contains(SymbolId id) const {
+        return id / 64 < bits.size() && ((bits[id / 64] >> (id % 64)) & 1u) != 0;
+    }
+    bool contains(std::string_view symbol) const { return contains(index->find(symbol)); }
+};
+
+/**
+ * A session's published subscription set. SessionManager keeps the reference
+ * counts under stream_mutex_ and publishes a fresh set after every change;
+ * feeders read it through a Reader, which re-fetches only when the version
+ * moves. No set (null) means nothing is subscribed and every symbol passes.
+ */
+class StreamSubscriptions {
+public:
+    /** Replace the set; an empty list clears it. */
+    void publish(std::vector<std::string> symbols);
+
+    std::shared_ptr<const StreamSubscriptionSet> load() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return current_;
+    }
+
+    uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+    /**
+     * Per-thread view for row filtering: allows() is a version check, one
+     * hash lookup and a bit test, with no lock or allocation unless the set
+     * changed since the last call.
+     */
+    class Reader {
+    public:
+        explicit Reader(const StreamSubscriptions& source) : source_(&source) { refresh(); }
+
+        bool allows(std::string_view symbol) {
+            if (source_->version() != version_) refresh();
+            return !set_ || set_->contains(symbol);
+        }
+
+        /** The current set; null when nothing is subscribed. */
+        const std::shared_ptr<const StreamSubscriptionSet>& current() {
+            if (source_->version() != version_) refresh();
+            return set_;
+        }
+
+    private:
+        void refresh() {
+            version_ = source_->version();
+            set_ = source_->load();
+        }
+
+        const StreamSubscriptions* source_;
+        uint64_t version_{0};
+        std::shared_ptr<const StreamSubscriptionSet> set_;
+    };
+
+private:
+    mutable std::mutex mutex_;
+    std::shared_ptr<const StreamSubscriptionSet> current_;
+    std::atomic<uint64_t> version_{0};
+};
+
+} // namespace broker_sim
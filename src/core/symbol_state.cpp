@@ -0,0 +1,74 @@
+#include "symbol_state.hpp"
+
+namespace broker_sim {
+
+SymbolRegulatoryState SymbolStateTable::Entry::load() const {
+    SymbolRegulatoryState s;
+    s.halted_until_ns = halted_until_ns.load(std::memory_order_relaxed);
+    s.ssr = ssr.load(std::memory_order_relaxed);
+    s.prior_close = prior_close.load(std::memory_order_relaxed);
+    s.luld_reference = luld_reference.load(std::memory_order_relaxed);
+    s.luld_upper = luld_upper.load(std::memory_order_relaxed);
+    s.luld_lower = luld_lower.load(std::memory_order_relaxed);
+    return s;
+}
+
+void SymbolStateTable::Entry::store(const SymbolRegulatoryState& s) {
+    halted_until_ns.store(s.halted_until_ns, std::memory_order_relaxed);
+    ssr.store(s.ssr, std::memory_order_relaxed);
+    prior_close.store(s.prior_close, std::memory_order_relaxed);
+    luld_reference.store(s.luld_reference, std::memory_order_relaxed);
+    luld_upper.store(s.luld_upper, std::memory_order_relaxed);
+    luld_lower.store(s.luld_lower, std::memory_order_relaxed);
+}
+
+SymbolStateTable::~SymbolStateTable() {
+    for (auto& chunk : chunks_) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
+
+SymbolStateTable::Entry* SymbolStateTable::at(SymbolId id) {
+    if (id == kInvalidSymbolId || (id >> kChunkBits) >= kMaxChunks) return nullptr;
+    auto& slot = chunks_[id >> kChunkBits];
+    Entry* chunk = slot.load(std::memory_order_acquire);
+    if (!chunk) {
+        // Writers other than the session worker (restore, preload) may race here.
+        auto* fresh = new Entry[kChunkSize];
+        if (slot.compare_exchange_strong(chunk, fresh, std::memory_order_acq_rel)) {
+            chunk = fresh;
+        } else {
+            delete[] fresh;
+        }
+    }
+    return &chunk[id & (kChunkSize - 1)];
+}
+
+std::vector<std::pair<SymbolId, SymbolRegulatoryState>> SymbolStateTable::snapshot() const {
+    std::vector<std::pair<SymbolId, SymbolRegulatoryState>> out;
+    for (size_t c = 0; c < kMaxChunks; ++c) {
+        const Entry* chunk = chunks_[c].load(std::memory_order_acquire);
+        if (!chunk) continue;
+        for (size_t i = 0; i < kChunkSize; ++i) {
+            auto state = chunk[i].load();
+            if (!state.is_default()) {
+                out.emplace_back(static_cast<SymbolId>((c << kChunkBits) | i), state);
+            }
+        }
+    }
+    return out;
+}
+
+void SymbolStateTable::restore(const std::vector<std::pair<SymbolId, SymbolRegulatoryState>>& states) {
+    const SymbolRegulatoryState cleared;
+    for (auto& slot : chunks_) {
+        Entry* chunk = slot.load(std::memory_order_acquire);
+        if (!chunk) continue;
+        for (size_t i = 0; i < kChunkSize; ++i) chunk[i].store(cleared);
+    }
+    for (const auto& [id, state] : states) {
+        if (Entry* e = at(id)) e->store(state);
+    }
+}
+
+} // namespace broker_sim
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "symbol_table.hpp"
+
+namespace broker_sim {
+
+/** Plain copy of one symbol's regulatory state, for snapshots. */
+struct SymbolRegulatoryState {
+    int64_t halted_until_ns{0};   // 0 = trading; see SymbolStateTable::kHaltedIndefinitely
+    bool ssr{false};              // SEC Rule 201 short sale restriction active
+    double prior_close{0.0};      // previous session close, SSR trigger reference
+    double luld_reference{0.0};
+    double luld_upper{0.0};
+    double luld_lower{0.0};
+
+    bool is_default() const {
+        return halted_until_ns == 0 && !ssr && prior_close == 0.0 &&
+               luld_reference == 0.0 && luld_upper == 0.0 && luld_lower == 0.0;
+    }
+};
+
+/**
+ * A session's per-symbol regulatory state (halts, SSR, LULD), stored densely
+ * by SymbolTable id in fixed-size chunks so lookups are an index, not a hash.
+ *
+ * The session worker is the writer; order validation on other threads reads
+ * the same entries without locking. Fields are individually atomic, so a
+ * reader may see one field of a concurrent update before another, the same
+ * as it could see either side of the update under the old per-map mutexes.
+ * Chunks are allocated on first write and never move or shrink.
+ */
+class SymbolStateTable {
+public:
+    static constexpr int64_t kHaltedIndefinitely = std::numeric_limits<int64_t>::max();
+
+    struct Entry {
+        std::atomic<int64_t> halted_until_ns{0};
+        std::atomic<bool> ssr{false};
+        std::atomic<double> prior_close{0.0};
+        std::atomic<double> luld_reference{0.0};
+        std::atomic<double> luld_upper{0.0};
+        std::atomic<double> luld_lower{0.0};
+
+        SymbolRegulatoryState load() const;
+        void store(const SymbolRegulatoryState& state);
+    };
+
+    SymbolStateTable() = default;
+    ~SymbolStateTable();
+    SymbolStateTable(const SymbolStateTable&) = delete;
+    SymbolStateTable& operator=(const SymbolStateTable&) = delete;
+
+    /** Entry for reading; null if nothing was ever written for the symbol. */
+    const Entry* find(SymbolId id) const {
+        if (id == kInvalidSymbolId || (id >> kChunkBits) >= kMaxChunks) return nullptr;
+        const Entry* chunk = chunks_[id >> kChunkBits].load(std::memory_order_acquire);
+        return chunk ? &chunk[id & (kChunkSize - 1)] : nullptr;
+    }
+
+    /** Entry for writing, allocating its chunk on first use; null only for ids beyond capacity. */
+    Entry* at(SymbolId id);
+
+    /** Halted at simulated time now_ns (a timed halt lapses at its end time). */
+    bool is_halted(SymbolId id, int64_t now_ns) const {
+        const Entry* e = find(id);
+        if (!e) return false;
+        const int64_t until = e->halted_until_ns.load(std::memory_order_relaxed);
+        return until != 0 && now_ns < until;
+    }
+
+    bool ssr_active(SymbolId id) const {
+        const Entry* e = find(id);
+        return e && e->ssr.load(std::memory_order_relaxed);
+    }
+
+    /** Non-default entries, for session snapshots and forks. */
+    std::vector<std::pair<SymbolId, SymbolRegulatoryState>> snapshot() const;
+
+    /** Reset every entry, then apply a snapshot. */
+    void restore(const std::vector<std::pair<SymbolId, SymbolRegulatoryState>>& states);
+
+private:
+    static constexpr unsigned kChunkBits = 8;
+    static constexpr size_t kChunkSize = size_t{1} << kChunkBits;
+    static constexpr size_t kMaxChunks = 4096;  // ~1M symbols
+
+    std::array<std::atomic<Entry*>, kMaxChunks> chunks_{};
+};
+
+} // namespace broker_sim
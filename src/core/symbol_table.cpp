@@ -0,0 +1,93 @@
+#include "symbol_table.hpp"
+
+#include <stdexcept>
+
+namespace broker_sim {
+
+SymbolTable& SymbolTable::instance() {
+    static SymbolTable table;
+    return table;
+}
+
+SymbolTable::SymbolTable() {
+    slot_tables_.push_back(std::make_unique<const Slots>(kChunkSize * 2));
+    slots_.store(slot_tables_.back().get(), std::memory_order_release);
+}
+
+SymbolTable::~SymbolTable() {
+    for (auto& chunk : name_chunks_) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
+
+void SymbolTable::insert_slot(const Slots& slots, SymbolId id, size_t hash) {
+    size_t i = hash & slots.mask;
+    while (slots.ids[i].load(std::memory_order_relaxed) != 0) i = (i + 1) & slots.mask;
+    // Release: a reader that sees the id also sees its name.
+    slots.ids[i].store(id + 1, std::memory_order_release);
+}
+
+SymbolId SymbolTable::intern_locked(std::string_view symbol) {
+    if (SymbolId id = find(symbol); id != kInvalidSymbolId) return id;
+    const SymbolId id = count_.load(std::memory_order_relaxed);
+    if ((id >> kChunkBits) >= kMaxChunks) throw std::length_error("symbol table full");
+
+    auto& chunk_slot = name_chunks_[id >> kChunkBits];
+    std::string* chunk = chunk_slot.load(std::memory_order_relaxed);
+    if (!chunk) {
+        chunk = new std::string[kChunkSize];
+        chunk_slot.store(chunk, std::memory_order_release);
+    }
+    chunk[id & (kChunkSize - 1)] = std::string(symbol);
+
+    const Slots* slots = slots_.load(std::memory_order_relaxed);
+    if ((size_t{id} + 1) * 2 > slots->mask + 1) {
+        // Rebuild at twice the size before publishing; readers on the old
+        // table still find every symbol it held.
+        auto grown = std::make_unique<const Slots>((slots->mask + 1) * 2);
+        for (SymbolId old = 0; old < id; ++old) {
+            insert_slot(*grown, old, StringHash{}(name_ref(old)));
+        }
+        slots = grown.get();
+        slot_tables_.push_back(std::move(grown));
+        slots_.store(slots, std::memory_order_release);
+    }
+    insert_slot(*slots, id, StringHash{}(symbol));
+    count_.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+SymbolId SymbolTable::intern(std::string_view symbol) {
+    if (SymbolId id = find(symbol); id != kInvalidSymbolId) return id;
+    std::lock_guard<std::mutex> lock(mutex_);
+    return intern_locked(symbol);
+}
+
+std::vector<SymbolId> SymbolTable::intern(const std::vector<std::string>& symbols) {
+    std::vector<SymbolId> out;
+    out.reserve(symbols.size());
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& symbol : symbols) {
+        out.push_back(intern_locked(symbol));
+    }
+    return out;
+}
+
+std::shared_ptr<const SymbolTable::Index> SymbolTable::index() const {
+    return std::make_shared<const Index>(Index{this, count_.load(std::memory_order_acquire)});
+}
+
+SymbolId SymbolTable::find(std::string_view symbol) const {
+    const Slots* slots = slots_.load(std::memory_order_acquire);
+    for (size_t i = StringHash{}(symbol) & slots->mask;; i = (i + 1) & slots->mask) {
+        const SymbolId slot = slots->ids[i].load(std::memory_order_acquire);
+        if (slot == 0) return kInvalidSymbolId;
+        if (name_ref(slot - 1) == symbol) return slot - 1;
+    }
+}
+
+std::string SymbolTable::name(SymbolId id) const {
+    return id < count_.load(std::memory_order_acquire) ? name_ref(id) : std::string{};
+}
+
+} // namespace broker_sim
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace broker_sim {
+
+using SymbolId = uint32_t;
+constexpr SymbolId kInvalidSymbolId = UINT32_MAX;
+
+/**
+ * Process-wide interning of ticker symbols to dense ids (0, 1, 2, ...), so
+ * per-symbol state can live in flat arrays and bitsets indexed by id.
+ *
+ * Ids are never reused. Adding a symbol takes a mutex; nothing else does.
+ * Names live in fixed-size chunks that never move, and lookups probe an
+ * open-addressing table of ids published with release stores, so a new
+ * symbol extends what readers see instead of invalidating it. When the
+ * table fills past half it is rebuilt at twice the size and swapped in; the
+ * old one stays valid for readers still probing it.
+ */
+class SymbolTable {
+public:
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+    };
+
+    /** The table as of one point in time: symbols interned later are not found. */
+    struct Index {
+        const SymbolTable* table{nullptr};
+        SymbolId count{0};
+
+        SymbolId find(std::string_view symbol) const {
+            const SymbolId id = table->find(symbol);
+            return id < count ? id : kInvalidSymbolId;
+        }
+    };
+
+    static SymbolTable& instance();
+
+    ~SymbolTable();
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    /** Id for the symbol, adding it if new; throws std::length_error when full. */
+    SymbolId intern(std::string_view symbol);
+    std::vector<SymbolId> intern(const std::vector<std::string>& symbols);
+
+    /** Name to id map covering every symbol interned before the call. */
+    std::shared_ptr<const Index> index() const;
+
+    /** Id for the symbol, or kInvalidSymbolId if it was never interned. */
+    SymbolId find(std::string_view symbol) const;
+    std::string name(SymbolId id) const;
+    size_t size() const { return count_.load(std::memory_order_acquire); }
+
+private:
+    static constexpr unsigned kChunkBits = 8;
+    static constexpr size_t kChunkSize = size_t{1} << kChunkBits;
+    static constexpr size_t kMaxChunks = 4096;  // ~1M symbols
+
+    // Open-addressing table of id + 1 (0 = empty slot); the size is a power of two.
+    struct Slots {
+        explicit Slots(size_t n) : mask(n - 1), ids(std::make_unique<std::atomic<SymbolId>[]>(n)) {}
+        size_t mask;
+        std::unique_ptr<std::atomic<SymbolId>[]> ids;
+    };
+
+    SymbolTable();
+    SymbolId intern_locked(std::string_view symbol);
+    const std::string& name_ref(SymbolId id) const {
+        return name_chunks_[id >> kChunkBits].load(std::memory_order_acquire)[id & (kChunkSize - 1)];
+    }
+    static void insert_slot(const Slots& slots, SymbolId id, size_t hash);
+
+    mutable std::mutex mutex_;                                 // serializes writers
+    std::array<std::atomic<std::string*>, kMaxChunks> name_chunks_{};
+    std::atomic<const Slots*> slots_{nullptr};
+    std::vector<std::unique_ptr<const Slots>> slot_tables_;    // current last; older ones kept for readers
+    std::atomic<SymbolId> count_{0};
+};
+
+} // namespace broker_sim
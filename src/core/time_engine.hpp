@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <atomic>
 #include <functional>
@@ -38,13 +39,15 @@ public:
 
     void set_time(Timestamp ts) {
         int64_t ts_ns = std::chrono::duration_cast<Nanoseconds>(ts.time_since_epoch()).count();
-        spdlog::info("TimeEngine::set_time called with ts_ns={}", ts_ns);
+        spdlog::debug("TimeEngine::set_time called with ts_ns={}", ts_ns);
         current_time_ns_.store(ts_ns, std::memory_order_release);
+        rebase_schedule();
         notify_listeners(ts);
     }
 
     void set_speed(double factor) {
         speed_factor_.store(factor, std::memory_order_release);
+        rebase_schedule();
     }
 
     double speed() const {
@@ -54,6 +57,7 @@ public:
     void start() {
         is_running_.store(true, std::memory_order_release);
         is_paused_.store(false, std::memory_order_release);
+        rebase_schedule();
     }
 
     void pause() {
@@ -63,6 +67,7 @@ public:
 
     void resume() {
         is_paused_.store(false, std::memory_order_release);
+        rebase_schedule();
         pause_cv_.notify_all();
     }
 
@@ -74,6 +79,14 @@ public:
     bool is_running() const { return is_running_.load(std::memory_order_acquire); }
     bool is_paused() const { return is_paused_.load(std::memory_order_acquire); }
 
+    /**
+     * How late (wall ns) the most recently released event was against the
+     * ideal schedule anchored at the last start/resume/speed change/set_time.
+     * Pacing sleeps event-to-event, so processing time accumulates here
+     * instead of being caught up. Always 0 at max speed.
+     */
+    int64_t schedule_lag_ns() const { return schedule_lag_ns_.load(std::memory_order_relaxed); }
+
     // Wait until event_time, applying speed factor; returns false if stopped.
     bool wait_for_next_event(Timestamp event_time) {
         if (!is_running()) {
@@ -145,17 +158,52 @@ public:
             }
         }
 
+        if (speed > 0.0) {
+            const int64_t anchor_sim = anchor_sim_ns_.load(std::memory_order_relaxed);
+            const int64_t due_wall = anchor_wall_ns_.load(std::memory_order_relaxed) +
+                static_cast<int64_t>(static_cast<double>(event_ns - anchor_sim) / speed);
+            schedule_lag_ns_.store(std::max<int64_t>(0, steady_now_ns() - due_wall), std::memory_order_relaxed);
+        }
+
         // Advance time to event_time
         advance_to(event_ns);
         return true;
     }
 
+    /**
+     * Batch backtest stepping: move time forward with no pause wait, CAS or
+     * listener notification. Only valid with a single writer (the session loop).
+     */
+    void step_to(Timestamp event_time) {
+        int64_t event_ns = std::chrono::duration_cast<Nanoseconds>(event_time.time_since_epoch()).count();
+        if (event_ns > current_time_ns_.load(std::memory_order_relaxed)) {
+            current_time_ns_.store(event_ns, std::memory_order_release);
+        }
+    }
+
+    // Notify listeners of the current time (batch mode checkpoints).
+    void publish_time() {
+        notify_listeners(current_time());
+    }
+
     void add_listener(TimeListener listener) {
         std::lock_guard<std::mutex> lock(listeners_mutex_);
         listeners_.push_back(std::move(listener));
     }
 
 private:
+    static int64_t steady_now_ns() {
+        return std::chrono::duration_cast<Nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Restart the ideal schedule from the current simulated time.
+    void rebase_schedule() {
+        anchor_sim_ns_.store(current_time_ns_.load(std::memory_order_acquire), std::memory_order_relaxed);
+        anchor_wall_ns_.store(steady_now_ns(), std::memory_order_relaxed);
+        schedule_lag_ns_.store(0, std::memory_order_relaxed);
+    }
+
     void advance_to(int64_t ts_ns) {
         int64_t cur_ns = current_time_ns_.load(std::memory_order_acquire);
         while (ts_ns > cur_ns) {
@@ -176,6 +224,9 @@ private:
     std::atomic<double> speed_factor_{0.0}; // 0 = max speed
     std::atomic<bool> is_running_{false};
     std::atomic<bool> is_paused_{false};
+    std::atomic<int64_t> anchor_sim_ns_{0};    // simulated time the schedule starts from
+    std::atomic<int64_t> anchor_wall_ns_{0};   // steady clock when anchor_sim_ns_ was current
+    std::atomic<int64_t> schedule_lag_ns_{0};
 
     std::mutex pause_mutex_;
     std::condition_variable pause_cv_;
@@ -0,0 +1,112 @@
+#include "tracing.hpp"
+
+#include <algorithm>
+
+namespace broker_sim {
+
+namespace {
+
+constexpr int kFeederTid = 1;
+constexpr int kLoopTid = 2;
+
+double to_us(int64_t ns) { return static_cast<double>(ns) / 1000.0; }
+
+nlohmann::json span_args(const TraceSpan& span) {
+    return {
+        {"seq", span.sequence},
+        {"symbol", span.symbol},
+        {"type", static_cast<int>(span.event_type)},
+        {"sim_ns", span.sim_ns}
+    };
+}
+
+} // namespace
+
+void SessionTracer::record(const TraceSpan& span) {
+    for (size_t i = 0; i < kIntervals.size(); ++i) {
+        const int64_t from = span[kIntervals[i].from];
+        const int64_t to = span[kIntervals[i].to];
+        if (from > 0 && to >= from) {
+            intervals_[i].record(static_cast<uint64_t>(to - from));
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ring_.size() < kRingCapacity) {
+        ring_.push_back(span);
+    } else {
+        ring_[next_] = span;
+    }
+    next_ = (next_ + 1) % kRingCapacity;
+    recorded_++;
+}
+
+uint64_t SessionTracer::recorded() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return recorded_;
+}
+
+nlohmann::json SessionTracer::stage_summary() const {
+    nlohmann::json out = nlohmann::json::object();
+    for (size_t i = 0; i < kIntervals.size(); ++i) {
+        const Histogram& h = intervals_[i];
+        const uint64_t count = h.count();
+        out[kIntervals[i].name] = {
+            {"count", count},
+            {"mean_ns", count > 0 ? h.sum() / count : 0},
+            {"p50_ns", h.quantile(0.50)},
+            {"p99_ns", h.quantile(0.99)},
+            {"max_ns", h.quantile(1.0)}
+        };
+    }
+    return out;
+}
+
+nlohmann::json SessionTracer::chrome_trace(const std::string& session_id,
+                                           int64_t from_sim_ns,
+                                           int64_t to_sim_ns) const {
+    std::vector<TraceSpan> spans;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        spans.reserve(ring_.size());
+        for (const auto& span : ring_) {
+            if (span.sim_ns >= from_sim_ns && span.sim_ns <= to_sim_ns) spans.push_back(span);
+        }
+    }
+    std::sort(spans.begin(), spans.end(), [](const TraceSpan& a, const TraceSpan& b) {
+        return a[TraceStage::DEQUEUE] < b[TraceStage::DEQUEUE];
+    });
+
+    nlohmann::json events = nlohmann::json::array();
+    events.push_back({{"name", "process_name"}, {"ph", "M"}, {"pid", 1},
+                      {"args", {{"name", "session " + session_id}}}});
+    events.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", kFeederTid},
+                      {"args", {{"name", "feeder"}}}});
+    events.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", kLoopTid},
+                      {"args", {{"name", "session loop"}}}});
+
+    for (const auto& span : spans) {
+        const nlohmann::json args = span_args(span);
+        for (const auto& interval : kIntervals) {
+            const int64_t from = span[interval.from];
+            const int64_t to = span[interval.to];
+            if (from <= 0 || to < from) continue;
+            const std::string name = interval.name;
+            if (name == "total") continue;
+            if (name == "queue") {
+                // Sampled events overlap while queued, so draw the wait as an
+                // async slice keyed by sequence rather than on a thread lane.
+                events.push_back({{"name", name}, {"cat", "queue"}, {"ph", "b"}, {"id", span.sequence},
+                                  {"pid", 1}, {"ts", to_us(from)}, {"args", args}});
+                events.push_back({{"name", name}, {"cat", "queue"}, {"ph", "e"}, {"id", span.sequence},
+                                  {"pid", 1}, {"ts", to_us(to)}});
+                continue;
+            }
+            events.push_back({{"name", name}, {"cat", "pipeline"}, {"ph", "X"}, {"pid", 1},
+                              {"tid", name == "enqueue" ? kFeederTid : kLoopTid},
+                              {"ts", to_us(from)}, {"dur", to_us(to - from)}, {"args", args}});
+        }
+    }
+    return {{"traceEvents", std::move(events)}, {"displayTimeUnit", "ns"}};
+}
+
+} // namespace broker_sim
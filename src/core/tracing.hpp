@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "event_queue.hpp"
+#include "metrics.hpp"
+
+namespace broker_sim {
+
+/** Points in an event's trip through the replay pipeline, in pipeline order. */
+enum class TraceStage : size_t {
+    DECODE,     // feeder has the decoded provider row
+    ENQUEUE,    // pushed onto the session queue
+    DEQUEUE,    // popped by the session loop
+    RELEASE,    // pacing released it (batch: stepped to it)
+    WAL,        // market event appended to the WAL
+    MATCH,      // NBBO / fills / mark-to-market applied
+    WS_BEGIN,   // WebSocket fan-out started
+    WS_END,     // WebSocket fan-out finished
+    CALLBACKS,  // event callbacks and strategy dispatch returned
+    COUNT
+};
+
+inline int64_t trace_now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/** Stage timestamps (steady-clock ns, 0 = not reached) for one sampled event. */
+struct TraceSpan {
+    int64_t sim_ns{0};
+    uint64_t sequence{0};
+    EventType event_type{EventType::TRADE};
+    std::string symbol;
+    std::array<int64_t, static_cast<size_t>(TraceStage::COUNT)> at{};
+
+    /** Starts a span for a sampled event the session loop just popped. */
+    static TraceSpan from_event(const Event& ev, int64_t dequeued_ns) {
+        TraceSpan span;
+        span.sim_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(ev.timestamp.time_since_epoch()).count();
+        span.sequence = ev.sequence;
+        span.event_type = ev.event_type;
+        span.symbol = ev.symbol;
+        span.at[static_cast<size_t>(TraceStage::DECODE)] = ev.decoded_ns;
+        span.at[static_cast<size_t>(TraceStage::ENQUEUE)] = ev.enqueued_ns;
+        span.at[static_cast<size_t>(TraceStage::DEQUEUE)] = dequeued_ns;
+        return span;
+    }
+
+    void stamp(TraceStage stage) { at[static_cast<size_t>(stage)] = trace_now_ns(); }
+    int64_t operator[](TraceStage stage) const { return at[static_cast<size_t>(stage)]; }
+};
+
+/**
+ * Span of the event the current thread is processing, or null when the event
+ * was not sampled. Pipeline code calls trace_stamp() unconditionally; for
+ * unsampled events that is one thread-local load and a branch.
+ */
+inline thread_local TraceSpan* tls_active_span = nullptr;
+
+inline void trace_stamp(TraceStage stage) {
+    if (TraceSpan* span = tls_active_span) span->stamp(stage);
+}
+
+/** Installs a span as the thread's active span for the scope's lifetime. */
+class ActiveSpanScope {
+public:
+    explicit ActiveSpanScope(TraceSpan* span) { tls_active_span = span; }
+    ~ActiveSpanScope() { tls_active_span = nullptr; }
+    ActiveSpanScope(const ActiveSpanScope&) = delete;
+    ActiveSpanScope& operator=(const ActiveSpanScope&) = delete;
+};
+
+/**
+ * Per-session sampled pipeline tracer.
+ *
+ * The feeder asks should_sample() once per event; every Nth event carries a
+ * decode timestamp through the queue and the session loop stamps the rest of
+ * its stages. Completed spans feed per-stage histograms and a bounded ring of
+ * recent spans that can be exported as Chrome trace / Perfetto JSON.
+ */
+class SessionTracer {
+public:
+    static constexpr size_t kRingCapacity = 4096;
+
+    explicit SessionTracer(uint32_t sample_every = 0) : sample_every_(sample_every) {}
+
+    void set_sample_every(uint32_t n) { sample_every_.store(n, std::memory_order_relaxed); }
+    uint32_t sample_every() const { return sample_every_.load(std::memory_order_relaxed); }
+
+    bool should_sample() {
+        const uint32_t every = sample_every_.load(std::memory_order_relaxed);
+        return every > 0 && counter_.fetch_add(1, std::memory_order_relaxed) % every == 0;
+    }
+
+    void record(const TraceSpan& span);
+
+    /** Spans recorded since creation (the ring keeps the newest kRingCapacity). */
+    uint64_t recorded() const;
+
+    /** Per-stage count / mean / p50 / p99 / max in nanoseconds. */
+    nlohmann::json stage_summary() const;
+
+    /**
+     * Chrome trace JSON for retained spans whose simulated timestamp falls in
+     * [from_sim_ns, to_sim_ns]; load it in chrome://tracing or ui.perfetto.dev.
+     */
+    nlohmann::json chrome_trace(const std::string& session_id, int64_t from_sim_ns, int64_t to_sim_ns) const;
+
+    /** Stage-to-stage intervals that the histograms and trace slices report. */
+    struct Interval {
+        const char* name;
+        TraceStage from;
+        TraceStage to;
+    };
+    static constexpr std::array<Interval, 8> kIntervals{{
+        {"enqueue", TraceStage::DECODE, TraceStage::ENQUEUE},
+        {"queue", TraceStage::ENQUEUE, TraceStage::DEQUEUE},
+        {"pacing", TraceStage::DEQUEUE, TraceStage::RELEASE},
+        {"wal", TraceStage::RELEASE, TraceStage::WAL},
+        {"match", TraceStage::WAL, TraceStage::MATCH},
+        {"callbacks", TraceStage::MATCH, TraceStage::CALLBACKS},
+        {"ws_send", TraceStage::WS_BEGIN, TraceStage::WS_END},
+        {"total", TraceStage::DECODE, TraceStage::CALLBACKS},
+    }};
+
+private:
+    std::atomic<uint32_t> sample_every_;
+    std::atomic<uint64_t> counter_{0};
+    std::array<Histogram, kIntervals.size()> intervals_{};
+
+    mutable std::mutex mutex_;
+    std::vector<TraceSpan> ring_;
+    size_t next_{0};
+    uint64_t recorded_{0};
+};
+
+} // namespace broker_sim
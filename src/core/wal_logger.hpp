@@ -3,6 +3,7 @@
 #include <fstream>
 #include <mutex>
 #include <string>
+#include <vector>
 #include <nlohmann/json.hpp>
 #include <filesystem>
 
@@ -18,9 +19,26 @@ public:
     void append(const nlohmann::json& j) {
         std::lock_guard<std::mutex> lock(mu_);
         if (!stream_.is_open()) return;
-        stream_ << j.dump() << "\n";
+        std::string line = j.dump();
+        line += '\n';
+        stream_ << line;
         stream_.flush();
-        current_size_ += j.dump().size() + 1;
+        current_size_ += line.size();
+        if (current_size_ >= max_bytes_) {
+            rotate();
+        }
+    }
+
+    /**
+     * Append already serialized, newline-terminated entries with a single
+     * flush (group commit).
+     */
+    void append_batch(const std::string& buf) {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (!stream_.is_open()) return;
+        stream_ << buf;
+        stream_.flush();
+        current_size_ += buf.size();
         if (current_size_ >= max_bytes_) {
             rotate();
         }
@@ -71,6 +71,7 @@ int main(int argc, char* argv[]) {
     drogon::app().addListener(cfg.services.bind_address, cfg.services.polygon_port);
     drogon::app().addListener(cfg.services.bind_address, cfg.services.finnhub_port);
     drogon::app().addListener(cfg.services.bind_address, cfg.services.ws_port);
+    broker_sim::ControlServer::install_request_metrics();
     drogon::app().registerController(api_ctrl);
     drogon::app().registerController(alpaca_ctrl);
     drogon::app().registerController(polygon_ctrl);
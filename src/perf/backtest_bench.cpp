@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "../core/session_manager.hpp"
+#include "../core/data_source_stub.hpp"
+
+using namespace broker_sim;
+
+namespace {
+
+// Synthetic quotes spread evenly over one simulated second.
+class SyntheticQuoteSource : public StubDataSource {
+public:
+    explicit SyntheticQuoteSource(size_t events) : events_(events) {}
+
+    void stream_events(const std::vector<std::string>&,
+                       Timestamp start_time,
+                       Timestamp end_time,
+                       const std::function<void(const MarketEvent&)>& cb) override {
+        const int64_t step_ns = std::max<int64_t>(1, 1'000'000'000 / static_cast<int64_t>(events_));
+        for (size_t i = 0; i < events_; ++i) {
+            MarketEvent ev;
+            ev.timestamp = Timestamp{} + std::chrono::nanoseconds(1 + static_cast<int64_t>(i) * step_ns);
+            if (ev.timestamp < start_time || ev.timestamp >= end_time) continue;
+            ev.type = MarketEventType::QUOTE;
+            double mid = 100.0 + static_cast<double>(i % 100) * 0.01;
+            ev.quote = QuoteRecord{ev.timestamp, "AAPL", mid - 0.01, 100, mid + 0.01, 100, 1, 1, 1};
+            cb(ev);
+        }
+    }
+
+private:
+    size_t events_;
+};
+
+double per_sec(size_t n, std::chrono::steady_clock::duration d) {
+    double seconds = std::chrono::duration<double>(d).count();
+    return seconds > 0 ? static_cast<double>(n) / seconds : 0.0;
+}
+
+void bench_time_engine(size_t events) {
+    TimeEngine paced;
+    paced.set_speed(0.0);
+    paced.start();
+    paced.add_listener([](Timestamp) {});
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 1; i <= events; ++i) {
+        paced.wait_for_next_event(Timestamp{} + std::chrono::nanoseconds(static_cast<int64_t>(i)));
+    }
+    auto paced_elapsed = std::chrono::steady_clock::now() - start;
+
+    TimeEngine batch;
+    batch.add_listener([](Timestamp) {});
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 1; i <= events; ++i) {
+        batch.step_to(Timestamp{} + std::chrono::nanoseconds(static_cast<int64_t>(i)));
+    }
+    batch.publish_time();
+    auto batch_elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "time_engine events=" << events
+              << " wait_for_next_event_per_sec=" << static_cast<long long>(per_sec(events, paced_elapsed))
+              << " step_to_per_sec=" << static_cast<long long>(per_sec(events, batch_elapsed)) << "\n";
+}
+
+void bench_session(size_t events, bool batch_mode) {
+    SessionManager mgr(std::make_shared<SyntheticQuoteSource>(events));
+    SessionConfig cfg;
+    cfg.symbols = {"AAPL"};
+    cfg.start_time = Timestamp{};
+    cfg.end_time = Timestamp{} + std::chrono::seconds(1);
+    cfg.speed_factor = 0.0;
+    cfg.batch_mode = batch_mode;
+    auto session = mgr.create_session(cfg);
+
+    auto start = std::chrono::steady_clock::now();
+    mgr.start_session(session->id);
+    while (session->status == SessionStatus::RUNNING) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    size_t processed = session->events_processed.load();
+    std::cout << (batch_mode ? "session_batch" : "session_max_speed")
+              << " events=" << processed
+              << " elapsed_ms=" << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()
+              << " events_per_sec=" << static_cast<long long>(per_sec(processed, elapsed)) << "\n";
+    mgr.stop_session(session->id);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t events = 200000;
+    if (argc > 1) {
+        events = static_cast<size_t>(std::stoull(argv[1]));
+    }
+    spdlog::set_level(spdlog::level::warn);
+    bench_time_engine(events);
+    bench_session(events, false);
+    bench_session(events, true);
+    return 0;
+}
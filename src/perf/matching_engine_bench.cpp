@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../core/matching_engine.hpp"
+
+using namespace broker_sim;
+
+namespace {
+
+/**
+ * One parameterized case. `run(iters)` performs iters timed operations and
+ * returns the nanoseconds they took, leaving any untimed setup out.
+ */
+struct Benchmark {
+    std::string name;
+    std::function<int64_t(size_t iters)> run;
+};
+
+using Clock = std::chrono::steady_clock;
+
+int64_t since(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+// Keeps results observable so the optimizer cannot drop the timed calls.
+volatile size_t g_sink = 0;
+
+const int64_t kBaseNs = 1'704'205'800'000'000'000;  // 2024-01-02 14:30:00 UTC
+
+std::string symbol_name(size_t i) { return "S" + std::to_string(i); }
+
+NBBO quote(const std::string& symbol, double mid, int64_t ts_ns) {
+    return NBBO{symbol, mid - 0.01, 100, mid + 0.01, 100, ts_ns};
+}
+
+// Limit orders far from the market: they stay pending on every update.
+Order resting_limit(size_t i, const std::string& symbol) {
+    Order o;
+    o.id = "o" + std::to_string(i);
+    o.symbol = symbol;
+    o.side = i % 2 == 0 ? OrderSide::BUY : OrderSide::SELL;
+    o.type = OrderType::LIMIT;
+    o.tif = TimeInForce::GTC;
+    o.qty = 1.0;
+    o.limit_price = o.side == OrderSide::BUY ? 50.0 : 200.0;
+    return o;
+}
+
+void fill_book(MatchingEngine& engine, size_t pending, size_t symbols) {
+    for (size_t i = 0; i < pending; ++i) {
+        Order o = resting_limit(i, symbol_name(i % symbols));
+        engine.submit_order(o);
+    }
+}
+
+Benchmark update_nbbo_case(size_t pending, size_t symbols) {
+    return {"BM_UpdateNbbo/pending:" + std::to_string(pending) + "/symbols:" + std::to_string(symbols),
+            [pending, symbols](size_t iters) {
+                MatchingEngine engine;
+                fill_book(engine, pending, symbols);
+                std::vector<std::string> names;
+                for (size_t s = 0; s < symbols; ++s) names.push_back(symbol_name(s));
+                auto start = Clock::now();
+                for (size_t i = 0; i < iters; ++i) {
+                    double mid = 100.0 + static_cast<double>(i % 50) * 0.01;
+                    auto r = engine.update_nbbo(quote(names[i % symbols], mid, kBaseNs + static_cast<int64_t>(i)));
+                    g_sink = g_sink + r.fills.size();
+                }
+                return since(start);
+            }};
+}
+
+Order order_of_type(OrderType type, size_t i) {
+    Order o;
+    o.id = "n" + std::to_string(i);
+    o.symbol = "AAPL";
+    o.side = OrderSide::BUY;
+    o.type = type;
+    o.tif = TimeInForce::DAY;
+    o.qty = 1.0;
+    switch (type) {
+        case OrderType::MARKET: break;
+        case OrderType::LIMIT: o.limit_price = 99.0; break;
+        case OrderType::STOP: o.stop_price = 101.0; break;
+        case OrderType::STOP_LIMIT: o.stop_price = 101.0; o.limit_price = 101.5; break;
+        case OrderType::TRAILING_STOP: o.trail_percent = 1.0; break;
+    }
+    return o;
+}
+
+Benchmark submit_order_case(OrderType type, const std::string& label) {
+    return {"BM_SubmitOrder/type:" + label,
+            [type](size_t iters) {
+                // Resting types accumulate, so rebuild the engine every batch
+                // to keep the book size bounded and comparable across types.
+                constexpr size_t kBatch = 1000;
+                int64_t total = 0;
+                for (size_t done = 0; done < iters; ) {
+                    MatchingEngine engine;
+                    engine.update_nbbo(quote("AAPL", 100.0, kBaseNs));
+                    std::vector<Order> orders;
+                    size_t n = std::min(kBatch, iters - done);
+                    orders.reserve(n);
+                    for (size_t i = 0; i < n; ++i) orders.push_back(order_of_type(type, done + i));
+                    auto start = Clock::now();
+                    for (auto& o : orders) {
+                        auto fill = engine.submit_order(o);
+                        g_sink = g_sink + (fill ? 1 : 0);
+                    }
+                    total += since(start);
+                    done += n;
+                }
+                return total;
+            }};
+}
+
+Benchmark trailing_hwm_case(size_t pending) {
+    return {"BM_TrailingStopHwm/pending:" + std::to_string(pending),
+            [pending](size_t iters) {
+                MatchingEngine engine;
+                engine.update_nbbo(quote("AAPL", 100.0, kBaseNs));
+                for (size_t i = 0; i < pending; ++i) {
+                    Order o = order_of_type(OrderType::TRAILING_STOP, i);
+                    o.side = OrderSide::SELL;
+                    o.tif = TimeInForce::GTC;
+                    engine.submit_order(o);
+                }
+                // A rising market moves every sell stop's high-water mark without triggering it.
+                auto start = Clock::now();
+                for (size_t i = 0; i < iters; ++i) {
+                    double mid = 100.0 + static_cast<double>(i) * 0.0001;
+                    auto r = engine.update_nbbo(quote("AAPL", mid, kBaseNs + static_cast<int64_t>(i)));
+                    g_sink = g_sink + r.fills.size();
+                }
+                return since(start);
+            }};
+}
+
+void fill_expiring(MatchingEngine& engine, size_t pending, Timestamp expire_at) {
+    for (size_t i = 0; i < pending; ++i) {
+        Order o = resting_limit(i, symbol_name(i % 100));
+        o.tif = TimeInForce::DAY;
+        o.expire_at = expire_at;
+        engine.submit_order(o);
+    }
+}
+
+// Nothing due: the per-event scan every session pays.
+Benchmark expire_scan_case(size_t pending) {
+    return {"BM_ExpirePendingOrdersAt/pending:" + std::to_string(pending) + "/expiring:0",
+            [pending](size_t iters) {
+                const Timestamp base = Timestamp{} + std::chrono::nanoseconds(kBaseNs);
+                MatchingEngine engine;
+                fill_expiring(engine, pending, base + std::chrono::hours(8));
+                auto start = Clock::now();
+                for (size_t i = 0; i < iters; ++i) {
+                    auto expired = engine.expire_pending_orders_at(base + std::chrono::nanoseconds(i));
+                    g_sink = g_sink + expired.size();
+                }
+                return since(start);
+            }};
+}
+
+// Everything due: one call expires the whole book (refilled untimed).
+Benchmark expire_all_case(size_t pending) {
+    return {"BM_ExpirePendingOrdersAt/pending:" + std::to_string(pending) + "/expiring:all",
+            [pending](size_t iters) {
+                const Timestamp base = Timestamp{} + std::chrono::nanoseconds(kBaseNs);
+                int64_t total = 0;
+                for (size_t i = 0; i < iters; ++i) {
+                    MatchingEngine engine;
+                    fill_expiring(engine, pending, base);
+                    auto start = Clock::now();
+                    auto expired = engine.expire_pending_orders_at(base + std::chrono::seconds(1));
+                    total += since(start);
+                    g_sink = g_sink + expired.size();
+                }
+                return total;
+            }};
+}
+
+std::vector<Benchmark> all_benchmarks() {
+    std::vector<Benchmark> out;
+    for (size_t pending : {0, 100, 10000}) {
+        for (size_t symbols : {1, 100, 1000}) out.push_back(update_nbbo_case(pending, symbols));
+    }
+    out.push_back(submit_order_case(OrderType::MARKET, "market"));
+    out.push_back(submit_order_case(OrderType::LIMIT, "limit"));
+    out.push_back(submit_order_case(OrderType::STOP, "stop"));
+    out.push_back(submit_order_case(OrderType::STOP_LIMIT, "stop_limit"));
+    out.push_back(submit_order_case(OrderType::TRAILING_STOP, "trailing_stop"));
+    for (size_t pending : {1, 100, 10000}) out.push_back(trailing_hwm_case(pending));
+    for (size_t pending : {100, 10000}) {
+        out.push_back(expire_scan_case(pending));
+        out.push_back(expire_all_case(pending));
+    }
+    return out;
+}
+
+} // namespace
+
+/**
+ * Usage: matching_engine_bench [name_filter] [min_time_ms]
+ * Each case grows its iteration count until it runs for at least min_time_ms
+ * (default 200), then reports mean ns per operation.
+ */
+int main(int argc, char* argv[]) {
+    std::string filter = argc > 1 ? argv[1] : "";
+    double min_time_ms = argc > 2 ? std::stod(argv[2]) : 200.0;
+    spdlog::set_level(spdlog::level::warn);
+
+    std::cout << std::left << std::setw(56) << "Benchmark"
+              << std::right << std::setw(14) << "Time(ns/op)"
+              << std::setw(14) << "Iterations" << "\n";
+    for (const auto& bench : all_benchmarks()) {
+        if (!filter.empty() && bench.name.find(filter) == std::string::npos) continue;
+        size_t iters = 1;
+        int64_t elapsed = 0;
+        while (true) {
+            elapsed = bench.run(iters);
+            if (elapsed >= min_time_ms * 1e6 || iters >= 100'000'000) break;
+            // Aim past the target in one step once a timing is meaningful.
+            double scale = elapsed > 0 ? min_time_ms * 1e6 * 1.4 / static_cast<double>(elapsed) : 10.0;
+            iters = static_cast<size_t>(static_cast<double>(iters) * std::clamp(scale, 2.0, 10.0));
+        }
+        std::cout << std::left << std::setw(56) << bench.name
+                  << std::right << std::setw(14) << std::fixed << std::setprecision(1)
+                  << static_cast<double>(elapsed) / static_cast<double>(iters)
+                  << std::setw(14) << iters << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../core/session_manager.hpp"
+#include "../core/data_source_stub.hpp"
+#include "../core/alloc_tracking.hpp"
+
+using namespace broker_sim;
+
+// Process-wide allocation counters for bytes/allocs per replayed event. With
+// ENABLE_ALLOC_TRACKING the core library owns operator new and the totals come
+// from its per-stage counters instead.
+#ifndef BROKER_ALLOC_TRACKING
+namespace {
+std::atomic<uint64_t> g_alloc_bytes{0};
+std::atomic<uint64_t> g_alloc_count{0};
+
+void* counted_alloc(std::size_t size) {
+    g_alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+} // namespace
+
+void* operator new(std::size_t size) { return counted_alloc(size); }
+void* operator new[](std::size_t size) { return counted_alloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+#endif
+
+namespace {
+
+AllocCounts process_alloc_counts() {
+#ifdef BROKER_ALLOC_TRACKING
+    AllocCounts total;
+    for (size_t i = 0; i < static_cast<size_t>(AllocStage::COUNT); ++i) {
+        const AllocCounts stage = alloc_tracking::stage_counts(static_cast<AllocStage>(i));
+        total.allocations += stage.allocations;
+        total.bytes += stage.bytes;
+        total.frees += stage.frees;
+    }
+    return total;
+#else
+    return {g_alloc_count.load(), g_alloc_bytes.load(), 0};
+#endif
+}
+
+struct BenchOptions {
+    size_t events{200000};
+    size_t symbols{4};
+    double quote_ratio{0.8};   // fraction of events that are quotes; the rest are trades
+    size_t resting_orders{0};  // per symbol, priced away from the market so they never fill
+    bool wal{false};
+    size_t callbacks{1};       // event callbacks registered, like WS fan-out
+};
+
+std::string symbol_name(size_t i) { return "SYM" + std::to_string(i); }
+
+// Deterministic interleaved quotes/trades over one simulated minute.
+class SyntheticTickSource : public StubDataSource {
+public:
+    SyntheticTickSource(const BenchOptions& opts, Timestamp origin) : opts_(opts), origin_(origin) {}
+
+    void stream_events(const std::vector<std::string>&,
+                       Timestamp start_time,
+                       Timestamp end_time,
+                       const std::function<void(const MarketEvent&)>& cb) override {
+        const int64_t step_ns = std::max<int64_t>(1, 60'000'000'000 / static_cast<int64_t>(opts_.events));
+        const size_t quote_every = 1000;
+        const size_t quotes_per_1000 = static_cast<size_t>(opts_.quote_ratio * quote_every);
+        uint64_t lcg = 0x2545F4914F6CDD1DULL;
+        for (size_t i = 0; i < opts_.events; ++i) {
+            MarketEvent ev;
+            ev.timestamp = origin_ + std::chrono::nanoseconds(1 + static_cast<int64_t>(i) * step_ns);
+            if (ev.timestamp < start_time || ev.timestamp >= end_time) continue;
+            lcg = lcg * 6364136223846793005ULL + 1442695040888963407ULL;
+            const std::string symbol = symbol_name(i % opts_.symbols);
+            const double mid = 100.0 + static_cast<double>((lcg >> 33) % 200) * 0.01;
+            if (i % quote_every < quotes_per_1000) {
+                ev.type = MarketEventType::QUOTE;
+                ev.quote = QuoteRecord{ev.timestamp, symbol, mid - 0.01, 100, mid + 0.01, 100, 1, 1, 1};
+            } else {
+                ev.type = MarketEventType::TRADE;
+                ev.trade = TradeRecord{ev.timestamp, symbol, mid, 100, 1, "", 1};
+            }
+            cb(ev);
+        }
+    }
+
+private:
+    BenchOptions opts_;
+    Timestamp origin_;
+};
+
+bool parse_flag(const std::string& arg, const std::string& key, std::string& value) {
+    if (arg.rfind(key + "=", 0) != 0) return false;
+    value = arg.substr(key.size() + 1);
+    return true;
+}
+
+BenchOptions parse_options(int argc, char* argv[]) {
+    BenchOptions opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string v;
+        if (parse_flag(arg, "events", v)) opts.events = std::stoull(v);
+        else if (parse_flag(arg, "symbols", v)) opts.symbols = std::max<size_t>(1, std::stoull(v));
+        else if (parse_flag(arg, "quote_ratio", v)) opts.quote_ratio = std::clamp(std::stod(v), 0.0, 1.0);
+        else if (parse_flag(arg, "resting", v)) opts.resting_orders = std::stoull(v);
+        else if (parse_flag(arg, "wal", v)) opts.wal = v != "0";
+        else if (parse_flag(arg, "callbacks", v)) opts.callbacks = std::stoull(v);
+        else std::cerr << "ignoring unknown option " << arg << "\n";
+    }
+    return opts;
+}
+
+int64_t percentile(std::vector<int64_t>& samples, double p) {
+    if (samples.empty()) return 0;
+    size_t idx = static_cast<size_t>(p * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(idx), samples.end());
+    return samples[idx];
+}
+
+void run(const BenchOptions& opts) {
+    // 2024-01-02 14:30:00 UTC, inside regular trading hours.
+    const Timestamp origin = Timestamp{} + std::chrono::seconds(1704205800);
+    const auto wal_dir = std::filesystem::temp_directory_path() / "replay_bench_wal";
+    ExecutionConfig exec;
+    exec.enable_wal = opts.wal;
+    exec.wal_directory = wal_dir.string();
+    exec.checkpoint_interval_events = 0;
+    exec.seek_snapshot_interval_seconds = 0;
+    SessionManager mgr(std::make_shared<SyntheticTickSource>(opts, origin), exec);
+
+    // The first callback times consecutive market events; the rest stand in
+    // for WebSocket fan-out and only touch the event.
+    std::vector<int64_t> gaps;
+    gaps.reserve(opts.events);
+    int64_t last_ns = 0;
+    std::atomic<uint64_t> sink{0};
+    mgr.add_event_callback([&](const std::string&, const Event& ev) {
+        if (ev.event_type != EventType::QUOTE && ev.event_type != EventType::TRADE) return;
+        int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        if (last_ns != 0) gaps.push_back(now - last_ns);
+        last_ns = now;
+    });
+    for (size_t i = 1; i < opts.callbacks; ++i) {
+        mgr.add_event_callback([&](const std::string&, const Event& ev) {
+            sink.fetch_add(ev.symbol.size(), std::memory_order_relaxed);
+        });
+    }
+
+    SessionConfig cfg;
+    for (size_t i = 0; i < opts.symbols; ++i) cfg.symbols.push_back(symbol_name(i));
+    cfg.start_time = origin;
+    cfg.end_time = origin + std::chrono::minutes(1);
+    cfg.initial_capital = 1e9;
+    cfg.batch_mode = true;
+    auto session = mgr.create_session(cfg);
+
+    for (const auto& symbol : cfg.symbols) {
+        for (size_t i = 0; i < opts.resting_orders; ++i) {
+            Order order;
+            order.symbol = symbol;
+            order.side = i % 2 == 0 ? OrderSide::BUY : OrderSide::SELL;
+            order.type = OrderType::LIMIT;
+            order.tif = TimeInForce::GTC;
+            order.qty = 1.0;
+            order.limit_price = order.side == OrderSide::BUY ? 50.0 - 0.01 * i : 200.0 + 0.01 * i;
+            if (mgr.submit_order(session->id, order).empty()) {
+                std::cerr << "resting order rejected for " << symbol << "\n";
+            }
+        }
+    }
+
+    alloc_tracking::reset_stages();
+    const AllocCounts allocs_before = process_alloc_counts();
+    auto start = std::chrono::steady_clock::now();
+    mgr.start_session(session->id);
+    while (session->status == SessionStatus::RUNNING) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    const AllocCounts allocs_delta = process_alloc_counts() - allocs_before;
+    const uint64_t bytes = allocs_delta.bytes;
+    const uint64_t allocs = allocs_delta.allocations;
+
+    const size_t processed = session->events_processed.load();
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    const double per_event = processed > 0 ? 1.0 / static_cast<double>(processed) : 0.0;
+    std::cout << "replay events=" << processed
+              << " symbols=" << opts.symbols
+              << " quote_ratio=" << opts.quote_ratio
+              << " resting=" << opts.resting_orders * opts.symbols
+              << " wal=" << (opts.wal ? 1 : 0)
+              << " callbacks=" << opts.callbacks
+              << " elapsed_ms=" << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()
+              << " events_per_sec=" << static_cast<long long>(seconds > 0 ? processed / seconds : 0.0)
+              << " p50_ns=" << percentile(gaps, 0.50)
+              << " p99_ns=" << percentile(gaps, 0.99)
+              << " bytes_per_event=" << static_cast<long long>(static_cast<double>(bytes) * per_event)
+              << " allocs_per_event=" << static_cast<double>(allocs) * per_event << "\n";
+    if (alloc_tracking::enabled()) {
+        for (size_t i = 0; i < static_cast<size_t>(AllocStage::COUNT); ++i) {
+            const auto stage = static_cast<AllocStage>(i);
+            const AllocCounts counts = alloc_tracking::stage_counts(stage);
+            std::cout << "  stage=" << alloc_stage_name(stage)
+                      << " allocs_per_event=" << static_cast<double>(counts.allocations) * per_event
+                      << " bytes_per_event=" << static_cast<long long>(static_cast<double>(counts.bytes) * per_event)
+                      << "\n";
+        }
+    }
+
+    mgr.stop_session(session->id);
+    std::error_code ec;
+    std::filesystem::remove_all(wal_dir, ec);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    spdlog::set_level(spdlog::level::warn);
+    run(parse_options(argc, argv));
+    return 0;
+}
@@ -0,0 +1,546 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <drogon/drogon.h>
+#include "../core/session_manager.hpp"
+#include "../core/data_source_stub.hpp"
+#include "../control/alpaca_controller.hpp"
+#include "../control/polygon_controller.hpp"
+#include "../control/finnhub_controller.hpp"
+
+using namespace broker_sim;
+using json = nlohmann::json;
+
+/**
+ * REST latency load test, independent of ClickHouse.
+ *
+ * Forks a server process running the Alpaca, Polygon and Finnhub controllers
+ * on one localhost listener, backed by a synthetic in-memory data source and
+ * one session whose first simulated second has been replayed (so snapshots and
+ * latest quotes/trades have data). This process then replays a weighted
+ * request mix from closed-loop keep-alive connections, stepping through the
+ * given concurrency levels, and prints throughput and p50/p99/p999 per level.
+ *
+ * The mix is built in, or read from mix=<file>: one request per line,
+ *   <label> <weight> <METHOD> <path> [json body]
+ * with {session} and {symbol} substituted per request; '#' starts a comment.
+ * A successful POST /v2/orders is followed on the same connection by a
+ * DELETE of the order it created (labelled alpaca_cancel_order) so the book
+ * stays flat over the run.
+ *
+ * Usage: rest_load_bench [concurrency=1,4,16,64] [duration=5] [symbols=10]
+ *                        [rows=100] [mix=<file>] [by_route=0] [port=18500]
+ *                        [threads=4]
+ */
+
+namespace {
+
+struct LoadOptions {
+    std::vector<size_t> concurrency{1, 4, 16, 64};
+    int duration_s{5};        // per concurrency level
+    size_t symbols{10};
+    size_t rows{100};         // trades/quotes/bars/news returned per historical query
+    std::string mix_file;
+    bool by_route{false};
+    uint16_t port{18500};
+    size_t threads{4};        // server event loops
+};
+
+struct MixEntry {
+    std::string label;
+    double weight{1.0};
+    std::string method;
+    std::string path;
+    std::string body;
+};
+
+const std::string kSessionId = "rest_load";
+// 2024-01-02 14:30:00 UTC, inside regular trading hours.
+const int64_t kSimOriginNs = 1'704'205'800'000'000'000;
+const std::string kCancelLabel = "alpaca_cancel_order";
+
+std::string symbol_name(size_t i) { return "SYM" + std::to_string(i); }
+
+Timestamp sim_origin() { return Timestamp{} + std::chrono::nanoseconds(kSimOriginNs); }
+
+/**
+ * Answers historical queries with `rows` evenly spaced records inside the
+ * requested range and streams one quote and one trade per symbol, standing in
+ * for ClickHouse so the bench measures the controllers, not the database.
+ */
+class SyntheticRestSource : public StubDataSource {
+public:
+    explicit SyntheticRestSource(const LoadOptions& opts) : opts_(opts) {}
+
+    void stream_events(const std::vector<std::string>& symbols,
+                       Timestamp start_time,
+                       Timestamp end_time,
+                       const std::function<void(const MarketEvent&)>& cb) override {
+        int64_t offset = 1;
+        for (const auto& symbol : symbols) {
+            MarketEvent ev;
+            ev.timestamp = sim_origin() + std::chrono::microseconds(offset++);
+            if (ev.timestamp < start_time || ev.timestamp >= end_time) continue;
+            ev.type = MarketEventType::QUOTE;
+            ev.quote = QuoteRecord{ev.timestamp, symbol, 99.99, 100, 100.01, 100, 1, 1, 1};
+            cb(ev);
+            MarketEvent tr;
+            tr.timestamp = sim_origin() + std::chrono::microseconds(offset++);
+            tr.type = MarketEventType::TRADE;
+            tr.trade = TradeRecord{tr.timestamp, symbol, 100.0, 100, 1, "@", 1};
+            cb(tr);
+        }
+    }
+
+    std::vector<TradeRecord> get_trades(const std::string& symbol, Timestamp start_time,
+                                        Timestamp end_time, size_t limit) override {
+        std::vector<TradeRecord> out;
+        for (auto ts : spaced(start_time, end_time, limit)) {
+            out.push_back(TradeRecord{ts, symbol, price_at(ts), 100, 4, "@", 1});
+        }
+        return out;
+    }
+
+    std::vector<QuoteRecord> get_quotes(const std::string& symbol, Timestamp start_time,
+                                        Timestamp end_time, size_t limit) override {
+        std::vector<QuoteRecord> out;
+        for (auto ts : spaced(start_time, end_time, limit)) {
+            const double mid = price_at(ts);
+            out.push_back(QuoteRecord{ts, symbol, mid - 0.01, 200, mid + 0.01, 300, 11, 12, 1});
+        }
+        return out;
+    }
+
+    std::vector<BarRecord> get_bars(const std::string& symbol, Timestamp start_time,
+                                    Timestamp end_time, int, const std::string&,
+                                    size_t limit) override {
+        std::vector<BarRecord> out;
+        for (auto ts : spaced(start_time, end_time, limit)) {
+            const double c = price_at(ts);
+            out.push_back(BarRecord{ts, symbol, c - 0.05, c + 0.10, c - 0.10, c, 12000, c, 85});
+        }
+        return out;
+    }
+
+    std::vector<CompanyNewsRecord> get_company_news(const std::string& symbol, Timestamp start_time,
+                                                    Timestamp end_time, size_t limit) override {
+        std::vector<CompanyNewsRecord> out;
+        int64_t id = 1;
+        for (auto ts : spaced(start_time, end_time, limit)) {
+            CompanyNewsRecord n;
+            n.datetime = ts;
+            n.symbol = symbol;
+            n.headline = symbol + " headline " + std::to_string(id);
+            n.summary = "Synthetic summary text for load testing the news endpoint.";
+            n.source = "bench";
+            n.url = "https://example.com/news/" + std::to_string(id);
+            n.category = "company";
+            n.related = symbol;
+            n.id = id++;
+            out.push_back(std::move(n));
+        }
+        return out;
+    }
+
+    std::optional<CompanyProfileRecord> get_company_profile(const std::string& symbol) override {
+        CompanyProfileRecord p;
+        p.symbol = symbol;
+        p.name = symbol + " Inc";
+        p.exchange = "NASDAQ";
+        p.industry = "Technology";
+        p.ipo = sim_origin() - std::chrono::hours(24 * 3650);
+        p.market_capitalization = 1.5e6;
+        p.share_outstanding = 1.5e4;
+        p.country = "US";
+        p.currency = "USD";
+        return p;
+    }
+
+private:
+    std::vector<Timestamp> spaced(Timestamp start, Timestamp end, size_t limit) const {
+        std::vector<Timestamp> out;
+        const size_t n = limit == 0 ? opts_.rows : std::min(limit, opts_.rows);
+        if (end <= start || n == 0) return out;
+        const auto step = (end - start) / static_cast<int64_t>(n);
+        out.reserve(n);
+        for (size_t i = 0; i < n; ++i) out.push_back(start + step * static_cast<int64_t>(i));
+        return out;
+    }
+
+    static double price_at(Timestamp ts) {
+        return 100.0 + static_cast<double>(utils::ts_to_ns(ts) / 1'000'000'000 % 100) * 0.01;
+    }
+
+    LoadOptions opts_;
+};
+
+std::vector<MixEntry> default_mix() {
+    // Roughly what a polling strategy client sends: market data dominates,
+    // account/order reads next, order entry last.
+    return {
+        {"polygon_aggs", 10, "GET", "/v2/aggs/ticker/{symbol}/range/1/minute/2024-01-02/2024-01-02?session_id={session}&limit=100", ""},
+        {"polygon_trades", 8, "GET", "/v3/trades/{symbol}?session_id={session}&timestamp.gte=2024-01-02&timestamp.lt=2024-01-03&limit=100", ""},
+        {"polygon_quotes", 8, "GET", "/v3/quotes/{symbol}?session_id={session}&timestamp.gte=2024-01-02&timestamp.lt=2024-01-03&limit=100", ""},
+        {"polygon_last_quote", 10, "GET", "/v2/last/nbbo/{symbol}?session_id={session}", ""},
+        {"polygon_snapshot", 8, "GET", "/v2/snapshot/locale/us/markets/stocks/tickers/{symbol}?session_id={session}", ""},
+        {"polygon_snapshot_all", 2, "GET", "/v2/snapshot/locale/us/markets/stocks/tickers?session_id={session}", ""},
+        {"alpaca_bars", 6, "GET", "/v2/stocks/{symbol}/bars?session_id={session}&timeframe=1Min&start=2024-01-02&end=2024-01-03&limit=100", ""},
+        {"alpaca_latest_quote", 8, "GET", "/v2/stocks/{symbol}/quotes/latest?session_id={session}", ""},
+        {"alpaca_snapshot", 6, "GET", "/v2/stocks/{symbol}/snapshot?session_id={session}", ""},
+        {"alpaca_account", 8, "GET", "/v2/account?session_id={session}", ""},
+        {"alpaca_positions", 4, "GET", "/v2/positions?session_id={session}", ""},
+        {"alpaca_orders", 4, "GET", "/v2/orders?session_id={session}&status=open", ""},
+        {"alpaca_submit_order", 4, "POST", "/v2/orders?session_id={session}",
+         R"({"symbol":"{symbol}","qty":"1","side":"buy","type":"limit","limit_price":"50","time_in_force":"day"})"},
+        {"alpaca_clock", 2, "GET", "/v2/clock?session_id={session}", ""},
+        {"finnhub_company_news", 2, "GET", "/company-news?symbol={symbol}&from=2024-01-01&to=2024-01-02&session_id={session}", ""},
+        {"finnhub_profile", 2, "GET", "/stock/profile2?symbol={symbol}&session_id={session}", ""},
+    };
+}
+
+std::vector<MixEntry> load_mix(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("cannot open mix file " + path);
+    std::vector<MixEntry> out;
+    std::string line;
+    while (std::getline(in, line)) {
+        auto hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+        std::istringstream ss(line);
+        MixEntry e;
+        if (!(ss >> e.label >> e.weight >> e.method >> e.path)) continue;
+        std::getline(ss >> std::ws, e.body);
+        out.push_back(std::move(e));
+    }
+    if (out.empty()) throw std::runtime_error("mix file " + path + " has no requests");
+    return out;
+}
+
+std::string substitute(std::string s, const std::string& key, const std::string& value) {
+    for (size_t pos = s.find(key); pos != std::string::npos; pos = s.find(key, pos + value.size())) {
+        s.replace(pos, key.size(), value);
+    }
+    return s;
+}
+
+[[noreturn]] void run_server(const LoadOptions& opts, int ready_fd) {
+    spdlog::set_level(spdlog::level::warn);
+    Config cfg;
+    cfg.execution.enable_wal = false;
+    cfg.execution.checkpoint_interval_events = 0;
+    cfg.execution.seek_snapshot_interval_seconds = 0;
+    auto source = std::make_shared<SyntheticRestSource>(opts);
+    auto mgr = std::make_shared<SessionManager>(source, cfg.execution, cfg.fees, source);
+
+    // Controllers register their quote/trade caches as event callbacks, so
+    // they must exist before the warm-up replay.
+    auto alpaca = std::make_shared<AlpacaController>(mgr, cfg);
+    auto polygon = std::make_shared<PolygonController>(mgr, cfg);
+    auto finnhub = std::make_shared<FinnhubController>(mgr, source, cfg);
+
+    SessionConfig sc;
+    for (size_t i = 0; i < opts.symbols; ++i) sc.symbols.push_back(symbol_name(i));
+    sc.start_time = sim_origin();
+    sc.end_time = sc.start_time + std::chrono::seconds(1);
+    sc.initial_capital = 1e9;
+    sc.batch_mode = true;
+    auto session = mgr->create_session(sc, kSessionId);
+    mgr->start_session(kSessionId);
+    while (session->status == SessionStatus::RUNNING) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    drogon::app().setThreadNum(opts.threads);
+    drogon::app().addListener("127.0.0.1", opts.port);
+    drogon::app().registerController(alpaca);
+    drogon::app().registerController(polygon);
+    drogon::app().registerController(finnhub);
+    drogon::app().getLoop()->queueInLoop([ready_fd]() {
+        char ok = 1;
+        ssize_t written = write(ready_fd, &ok, 1);
+        (void)written;
+        close(ready_fd);
+    });
+    drogon::app().run();
+    std::_Exit(0);
+}
+
+/**
+ * Minimal blocking HTTP/1.1 keep-alive client. Drogon answers with
+ * Content-Length bodies, which is all this parses.
+ */
+class HttpConnection {
+public:
+    explicit HttpConnection(uint16_t port) : port_(port) {}
+    ~HttpConnection() { close_fd(); }
+
+    // Returns the status code, or 0 on a transport error (the socket is then reopened next call).
+    int request(const std::string& method, const std::string& path, const std::string& body,
+                std::string& response_body) {
+        if (fd_ < 0 && !connect_fd()) return 0;
+        std::string req = method + " " + path + " HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: keep-alive\r\n";
+        if (!body.empty()) {
+            req += "Content-Type: application/json\r\nContent-Length: " + std::to_string(body.size()) + "\r\n";
+        }
+        req += "\r\n" + body;
+        if (!send_all(req)) { close_fd(); return 0; }
+
+        size_t header_end;
+        while ((header_end = buf_.find("\r\n\r\n")) == std::string::npos) {
+            if (!fill()) { close_fd(); return 0; }
+        }
+        const std::string headers = buf_.substr(0, header_end);
+        int status = 0;
+        if (headers.size() > 12) status = std::atoi(headers.c_str() + 9);
+        size_t length = 0;
+        std::string lower = headers;
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+        auto cl = lower.find("content-length:");
+        if (cl != std::string::npos) length = std::strtoull(lower.c_str() + cl + 15, nullptr, 10);
+        const size_t total = header_end + 4 + length;
+        while (buf_.size() < total) {
+            if (!fill()) { close_fd(); return 0; }
+        }
+        response_body.assign(buf_, header_end + 4, length);
+        buf_.erase(0, total);
+        if (lower.find("connection: close") != std::string::npos) close_fd();
+        return status;
+    }
+
+private:
+    bool connect_fd() {
+        fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd_ < 0) return false;
+        int one = 1;
+        setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port_);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            close_fd();
+            return false;
+        }
+        return true;
+    }
+
+    void close_fd() {
+        if (fd_ >= 0) close(fd_);
+        fd_ = -1;
+        buf_.clear();
+    }
+
+    bool send_all(const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = send(fd_, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    bool fill() {
+        char chunk[16384];
+        ssize_t n = recv(fd_, chunk, sizeof(chunk), 0);
+        if (n <= 0) return false;
+        buf_.append(chunk, static_cast<size_t>(n));
+        return true;
+    }
+
+    uint16_t port_;
+    int fd_{-1};
+    std::string buf_;
+};
+
+struct RouteStats {
+    std::vector<int64_t> latencies_ns;
+    uint64_t errors{0};  // transport failures and non-2xx responses
+};
+
+using StatsByRoute = std::map<std::string, RouteStats>;
+
+// One closed-loop connection: pick a weighted request, send, wait, repeat until `stop`.
+void run_worker(const LoadOptions& opts, const std::vector<MixEntry>& mix, size_t worker,
+                const std::atomic<bool>& stop, StatsByRoute& stats) {
+    std::vector<double> cumulative;
+    double total = 0.0;
+    for (const auto& e : mix) cumulative.push_back(total += e.weight);
+    uint64_t lcg = 0x9E3779B97F4A7C15ULL ^ (worker * 0x2545F4914F6CDD1DULL);
+    HttpConnection conn(opts.port);
+    std::string response;
+    size_t seq = worker;
+
+    auto timed = [&](const std::string& label, const std::string& method,
+                     const std::string& path, const std::string& body) {
+        auto start = std::chrono::steady_clock::now();
+        int status = conn.request(method, path, body, response);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        auto& rs = stats[label];
+        rs.latencies_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        if (status < 200 || status >= 300) ++rs.errors;
+        return status;
+    };
+
+    while (!stop.load(std::memory_order_relaxed)) {
+        lcg = lcg * 6364136223846793005ULL + 1442695040888963407ULL;
+        const double pick = static_cast<double>(lcg >> 11) / static_cast<double>(1ULL << 53) * total;
+        const auto& e = mix[static_cast<size_t>(
+            std::upper_bound(cumulative.begin(), cumulative.end(), pick) - cumulative.begin()) % mix.size()];
+        const std::string symbol = symbol_name(seq++ % opts.symbols);
+        const std::string path = substitute(substitute(e.path, "{session}", kSessionId), "{symbol}", symbol);
+        const std::string body = substitute(e.body, "{symbol}", symbol);
+        int status = timed(e.label, e.method, path, body);
+
+        if (e.method == "POST" && e.path.rfind("/v2/orders?", 0) == 0 && status >= 200 && status < 300) {
+            auto parsed = json::parse(response, nullptr, false);
+            if (parsed.is_object() && parsed.contains("id")) {
+                timed(kCancelLabel, "DELETE",
+                      "/v2/orders/" + parsed["id"].get<std::string>() + "?session_id=" + kSessionId, "");
+            }
+        }
+    }
+}
+
+int64_t percentile(std::vector<int64_t>& v, double p) {
+    if (v.empty()) return 0;
+    size_t idx = static_cast<size_t>(p * static_cast<double>(v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(idx), v.end());
+    return v[idx];
+}
+
+void print_line(const std::string& prefix, std::vector<int64_t>& latencies, uint64_t errors, double secs) {
+    const size_t n = latencies.size();
+    std::cout << prefix
+              << " requests=" << n
+              << " errors=" << errors
+              << " req_per_sec=" << static_cast<long long>(static_cast<double>(n) / secs)
+              << " p50_us=" << percentile(latencies, 0.50) / 1000
+              << " p99_us=" << percentile(latencies, 0.99) / 1000
+              << " p999_us=" << percentile(latencies, 0.999) / 1000 << "\n";
+}
+
+void run_level(const LoadOptions& opts, const std::vector<MixEntry>& mix, size_t concurrency) {
+    std::atomic<bool> stop{false};
+    std::vector<StatsByRoute> per_worker(concurrency);
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < concurrency; ++i) {
+        workers.emplace_back(run_worker, std::cref(opts), std::cref(mix), i, std::cref(stop), std::ref(per_worker[i]));
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(opts.duration_s));
+    stop.store(true);
+    for (auto& t : workers) t.join();
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    StatsByRoute merged;
+    std::vector<int64_t> all;
+    uint64_t errors = 0;
+    for (auto& w : per_worker) {
+        for (auto& [label, rs] : w) {
+            auto& m = merged[label];
+            m.latencies_ns.insert(m.latencies_ns.end(), rs.latencies_ns.begin(), rs.latencies_ns.end());
+            m.errors += rs.errors;
+            all.insert(all.end(), rs.latencies_ns.begin(), rs.latencies_ns.end());
+            errors += rs.errors;
+        }
+    }
+    print_line("rest_load concurrency=" + std::to_string(concurrency), all, errors, secs);
+    if (opts.by_route) {
+        for (auto& [label, rs] : merged) {
+            print_line("  route=" + label, rs.latencies_ns, rs.errors, secs);
+        }
+    }
+    std::cout.flush();
+}
+
+bool parse_flag(const std::string& arg, const std::string& key, std::string& value) {
+    if (arg.rfind(key + "=", 0) != 0) return false;
+    value = arg.substr(key.size() + 1);
+    return true;
+}
+
+LoadOptions parse_options(int argc, char* argv[]) {
+    LoadOptions opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string v;
+        if (parse_flag(arg, "concurrency", v)) {
+            opts.concurrency.clear();
+            std::stringstream ss(v);
+            std::string item;
+            while (std::getline(ss, item, ',')) {
+                if (!item.empty()) opts.concurrency.push_back(std::max<size_t>(1, std::stoull(item)));
+            }
+        }
+        else if (parse_flag(arg, "duration", v)) opts.duration_s = std::max(1, std::stoi(v));
+        else if (parse_flag(arg, "symbols", v)) opts.symbols = std::max<size_t>(1, std::stoull(v));
+        else if (parse_flag(arg, "rows", v)) opts.rows = std::stoull(v);
+        else if (parse_flag(arg, "mix", v)) opts.mix_file = v;
+        else if (parse_flag(arg, "by_route", v)) opts.by_route = v != "0";
+        else if (parse_flag(arg, "port", v)) opts.port = static_cast<uint16_t>(std::stoi(v));
+        else if (parse_flag(arg, "threads", v)) opts.threads = std::max<size_t>(1, std::stoull(v));
+        else std::cerr << "ignoring unknown option " << arg << "\n";
+    }
+    return opts;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const LoadOptions opts = parse_options(argc, argv);
+    std::vector<MixEntry> mix;
+    try {
+        mix = opts.mix_file.empty() ? default_mix() : load_mix(opts.mix_file);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    // Fork before any threads exist in this process.
+    int fds[2];
+    if (pipe(fds) != 0) {
+        std::perror("pipe");
+        return 1;
+    }
+    pid_t server = fork();
+    if (server < 0) {
+        std::perror("fork");
+        return 1;
+    }
+    if (server == 0) {
+        close(fds[0]);
+        run_server(opts, fds[1]);
+    }
+    close(fds[1]);
+    char ready = 0;
+    if (read(fds[0], &ready, 1) != 1) {
+        std::cerr << "server failed to start\n";
+        waitpid(server, nullptr, 0);
+        return 1;
+    }
+    close(fds[0]);
+
+    for (size_t concurrency : opts.concurrency) run_level(opts, mix, concurrency);
+
+    kill(server, SIGTERM);
+    waitpid(server, nullptr, 0);
+    return 0;
+}
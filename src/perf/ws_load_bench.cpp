@@ -0,0 +1,443 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <drogon/drogon.h>
+#include <drogon/WebSocketClient.h>
+#include <trantor/net/EventLoopThreadPool.h>
+#include "../core/session_manager.hpp"
+#include "../core/data_source_stub.hpp"
+#include "../ws/ws_controller.hpp"
+
+using namespace broker_sim;
+using json = nlohmann::json;
+
+/**
+ * WebSocket fan-out load test.
+ *
+ * Forks a server process (SessionManager + WsController on localhost, fed by
+ * a synthetic source at a fixed event rate) and opens N Alpaca/Polygon/Finnhub
+ * clients against it from this process. The session runs at speed 1.0, so an
+ * event with simulated time ts is due at wall_start + (ts - sim_origin); each
+ * client compares that against its receive time for end-to-end latency. The
+ * TimeEngine paces event-to-event, so lag the server accumulates under load
+ * shows up in the latency figures, as it would for a real client.
+ *
+ * Usage: ws_load_bench [clients=50] [api=mix|alpaca|polygon|finnhub] [symbols=10]
+ *                      [subs=5] [rate=5000] [duration=10] [warmup=2] [port=18400]
+ *                      [threads=4]
+ */
+
+namespace {
+
+struct LoadOptions {
+    size_t clients{50};
+    std::string api{"mix"};
+    size_t symbols{10};
+    size_t subs{5};          // symbols per client
+    double rate{5000.0};     // market events per second across all symbols
+    int duration_s{10};
+    int warmup_s{2};
+    uint16_t port{18400};
+    size_t threads{4};       // client event loops
+};
+
+const std::string kSessionId = "ws_load";
+// 2024-01-02 14:30:00 UTC: a regular-hours weekday, so the feeder never skips a closed market.
+const int64_t kSimOriginNs = 1'704'205'800'000'000'000;
+
+int64_t wall_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string symbol_name(size_t i) { return "SYM" + std::to_string(i); }
+
+int64_t step_ns(const LoadOptions& opts) {
+    return std::max<int64_t>(1, static_cast<int64_t>(1e9 / opts.rate));
+}
+
+// Event k: symbol k % symbols; quote on even rounds through the universe, trade on odd.
+bool is_quote(size_t k, size_t symbols) { return (k / symbols) % 2 == 0; }
+
+class SyntheticRateSource : public StubDataSource {
+public:
+    explicit SyntheticRateSource(const LoadOptions& opts) : opts_(opts) {}
+
+    void stream_events(const std::vector<std::string>& symbols,
+                       Timestamp start_time,
+                       Timestamp end_time,
+                       const std::function<void(const MarketEvent&)>& cb) override {
+        const int64_t step = step_ns(opts_);
+        const int64_t from = utils::ts_to_ns(start_time) - kSimOriginNs;
+        const int64_t to = utils::ts_to_ns(end_time) - kSimOriginNs;
+        std::vector<char> wanted(opts_.symbols, 0);
+        for (const auto& s : symbols) {
+            for (size_t i = 0; i < opts_.symbols; ++i) {
+                if (s == symbol_name(i)) wanted[i] = 1;
+            }
+        }
+        for (int64_t k = std::max<int64_t>(0, (from + step - 1) / step); k * step < to; ++k) {
+            const size_t idx = static_cast<size_t>(k) % opts_.symbols;
+            if (!wanted[idx]) continue;
+            MarketEvent ev;
+            ev.timestamp = Timestamp{} + std::chrono::nanoseconds(kSimOriginNs + k * step);
+            const double mid = 100.0 + static_cast<double>(k % 100) * 0.01;
+            if (is_quote(static_cast<size_t>(k), opts_.symbols)) {
+                ev.type = MarketEventType::QUOTE;
+                ev.quote = QuoteRecord{ev.timestamp, symbol_name(idx), mid - 0.01, 100, mid + 0.01, 100, 1, 1, 1};
+            } else {
+                ev.type = MarketEventType::TRADE;
+                ev.trade = TradeRecord{ev.timestamp, symbol_name(idx), mid, 100, 1, "", 1};
+            }
+            cb(ev);
+        }
+    }
+
+private:
+    LoadOptions opts_;
+};
+
+[[noreturn]] void run_server(const LoadOptions& opts, int ready_fd) {
+    spdlog::set_level(spdlog::level::warn);
+    Config cfg;
+    cfg.execution.enable_wal = false;
+    cfg.execution.checkpoint_interval_events = 0;
+    cfg.execution.seek_snapshot_interval_seconds = 0;
+    auto mgr = std::make_shared<SessionManager>(std::make_shared<SyntheticRateSource>(opts),
+                                                cfg.execution, cfg.fees);
+    WsController::init(mgr, cfg);
+
+    SessionConfig sc;
+    for (size_t i = 0; i < opts.symbols; ++i) sc.symbols.push_back(symbol_name(i));
+    sc.start_time = Timestamp{} + std::chrono::nanoseconds(kSimOriginNs);
+    sc.end_time = sc.start_time + std::chrono::seconds(opts.warmup_s + opts.duration_s + 5);
+    sc.speed_factor = 1.0;
+    mgr->create_session(sc, kSessionId);
+
+    drogon::app().addListener("127.0.0.1", opts.port);
+    drogon::app().registerController(std::make_shared<WsController>());
+    drogon::app().getLoop()->queueInLoop([mgr, ready_fd]() {
+        int64_t wall_start = wall_ns();
+        mgr->start_session(kSessionId);
+        ssize_t written = write(ready_fd, &wall_start, sizeof(wall_start));
+        (void)written;
+        close(ready_fd);
+    });
+    drogon::app().run();
+    WsController::shutdown();
+    _exit(0);
+}
+
+/** Server process CPU time (user + system) in seconds, from /proc. */
+double process_cpu_seconds(pid_t pid) {
+    std::ifstream in("/proc/" + std::to_string(pid) + "/stat");
+    std::string line;
+    if (!std::getline(in, line)) return 0.0;
+    // Fields after the parenthesised command name; utime/stime are 14 and 15.
+    std::istringstream rest(line.substr(line.rfind(')') + 2));
+    std::string field;
+    unsigned long long utime = 0, stime = 0;
+    for (int i = 3; i <= 15 && rest >> field; ++i) {
+        if (i == 14) utime = std::stoull(field);
+        if (i == 15) stime = std::stoull(field);
+    }
+    return static_cast<double>(utime + stime) / static_cast<double>(sysconf(_SC_CLK_TCK));
+}
+
+double self_cpu_seconds() {
+    rusage ru{};
+    getrusage(RUSAGE_SELF, &ru);
+    auto tv = [](const timeval& t) { return static_cast<double>(t.tv_sec) + t.tv_usec / 1e6; };
+    return tv(ru.ru_utime) + tv(ru.ru_stime);
+}
+
+// "2024-01-02T14:30:00.123456789Z" -> epoch ns
+int64_t parse_iso_ns(const std::string& s) {
+    std::tm tm{};
+    if (strptime(s.c_str(), "%Y-%m-%dT%H:%M:%S", &tm) == nullptr) return 0;
+    int64_t ns = static_cast<int64_t>(timegm(&tm)) * 1'000'000'000;
+    auto dot = s.find('.');
+    if (dot != std::string::npos) {
+        int64_t frac = 0;
+        int digits = 0;
+        for (size_t i = dot + 1; i < s.size() && std::isdigit(static_cast<unsigned char>(s[i])) && digits < 9; ++i) {
+            frac = frac * 10 + (s[i] - '0');
+            ++digits;
+        }
+        while (digits++ < 9) frac *= 10;
+        ns += frac;
+    }
+    return ns;
+}
+
+struct ClientStats {
+    std::mutex mutex;
+    uint64_t received{0};    // market data items inside the measured window
+    uint64_t frames{0};
+    std::vector<int64_t> latencies_ns;
+};
+
+struct LoadClient {
+    WsApiType api;
+    std::vector<std::string> symbols;
+    drogon::WebSocketClientPtr ws;
+    std::shared_ptr<ClientStats> stats = std::make_shared<ClientStats>();
+};
+
+std::string subscribe_message(const LoadClient& c) {
+    switch (c.api) {
+        case WsApiType::ALPACA:
+            return json{{"action", "subscribe"}, {"trades", c.symbols}, {"quotes", c.symbols}}.dump();
+        case WsApiType::POLYGON: {
+            std::string params;
+            for (const auto& s : c.symbols) {
+                if (!params.empty()) params += ",";
+                params += "T." + s + ",Q." + s;
+            }
+            return json{{"action", "subscribe"}, {"params", params}}.dump();
+        }
+        default:
+            return {};  // Finnhub subscribes one symbol per message
+    }
+}
+
+std::string api_path(WsApiType api) {
+    switch (api) {
+        case WsApiType::ALPACA: return "/alpaca/ws";
+        case WsApiType::POLYGON: return "/polygon/ws";
+        default: return "/finnhub/ws";
+    }
+}
+
+/** Simulated timestamp of one market data item, or 0 for control/status messages. */
+int64_t item_sim_ns(WsApiType api, const json& item) {
+    if (!item.is_object()) return 0;
+    if (api == WsApiType::ALPACA) {
+        auto t = item.value("T", "");
+        if ((t == "t" || t == "q") && item.contains("t")) return parse_iso_ns(item["t"].get<std::string>());
+    } else if (api == WsApiType::POLYGON) {
+        auto ev = item.value("ev", "");
+        if ((ev == "T" || ev == "Q") && item.contains("t_ns")) return item["t_ns"].get<int64_t>();
+    } else if (item.contains("t") && item["t"].is_number()) {
+        return item["t"].get<int64_t>() * 1'000'000;  // Finnhub carries ms only
+    }
+    return 0;
+}
+
+void on_frame(const LoadClient& c, const std::string& frame,
+              int64_t wall_start, int64_t window_from, int64_t window_to) {
+    const int64_t recv = wall_ns();
+    json msg = json::parse(frame, nullptr, false);
+    if (msg.is_discarded()) return;
+    const json* items = &msg;
+    if (c.api == WsApiType::FINNHUB) {
+        if (msg.value("type", "") != "trade" || !msg.contains("data")) return;
+        items = &msg["data"];
+    }
+    if (!items->is_array()) return;
+
+    std::lock_guard<std::mutex> lock(c.stats->mutex);
+    ++c.stats->frames;
+    for (const auto& item : *items) {
+        int64_t sim = item_sim_ns(c.api, item);
+        if (sim < window_from || sim >= window_to) continue;
+        ++c.stats->received;
+        c.stats->latencies_ns.push_back(recv - (wall_start + (sim - kSimOriginNs)));
+    }
+}
+
+/** Items a client should see in [from, to) if nothing is dropped or conflated. */
+uint64_t expected_items(const LoadOptions& opts, const LoadClient& c, int64_t from, int64_t to) {
+    const int64_t step = step_ns(opts);
+    std::vector<char> wanted(opts.symbols, 0);
+    for (const auto& s : c.symbols) {
+        for (size_t i = 0; i < opts.symbols; ++i) {
+            if (s == symbol_name(i)) wanted[i] = 1;
+        }
+    }
+    uint64_t n = 0;
+    for (int64_t k = (from - kSimOriginNs + step - 1) / step; kSimOriginNs + k * step < to; ++k) {
+        size_t idx = static_cast<size_t>(k) % opts.symbols;
+        if (!wanted[idx]) continue;
+        if (c.api == WsApiType::FINNHUB && is_quote(static_cast<size_t>(k), opts.symbols)) continue;
+        ++n;
+    }
+    return n;
+}
+
+bool parse_flag(const std::string& arg, const std::string& key, std::string& value) {
+    if (arg.rfind(key + "=", 0) != 0) return false;
+    value = arg.substr(key.size() + 1);
+    return true;
+}
+
+LoadOptions parse_options(int argc, char* argv[]) {
+    LoadOptions opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string v;
+        if (parse_flag(arg, "clients", v)) opts.clients = std::stoull(v);
+        else if (parse_flag(arg, "api", v)) opts.api = v;
+        else if (parse_flag(arg, "symbols", v)) opts.symbols = std::max<size_t>(1, std::stoull(v));
+        else if (parse_flag(arg, "subs", v)) opts.subs = std::max<size_t>(1, std::stoull(v));
+        else if (parse_flag(arg, "rate", v)) opts.rate = std::max(1.0, std::stod(v));
+        else if (parse_flag(arg, "duration", v)) opts.duration_s = std::max(1, std::stoi(v));
+        else if (parse_flag(arg, "warmup", v)) opts.warmup_s = std::max(1, std::stoi(v));
+        else if (parse_flag(arg, "port", v)) opts.port = static_cast<uint16_t>(std::stoi(v));
+        else if (parse_flag(arg, "threads", v)) opts.threads = std::max<size_t>(1, std::stoull(v));
+        else std::cerr << "ignoring unknown option " << arg << "\n";
+    }
+    opts.subs = std::min(opts.subs, opts.symbols);
+    return opts;
+}
+
+WsApiType client_api(const LoadOptions& opts, size_t i) {
+    if (opts.api == "alpaca") return WsApiType::ALPACA;
+    if (opts.api == "polygon") return WsApiType::POLYGON;
+    if (opts.api == "finnhub") return WsApiType::FINNHUB;
+    static const WsApiType kMix[] = {WsApiType::ALPACA, WsApiType::POLYGON, WsApiType::FINNHUB};
+    return kMix[i % 3];
+}
+
+int64_t percentile(std::vector<int64_t>& v, double p) {
+    if (v.empty()) return 0;
+    size_t idx = static_cast<size_t>(p * static_cast<double>(v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(idx), v.end());
+    return v[idx];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const LoadOptions opts = parse_options(argc, argv);
+
+    // Fork before any threads exist in this process.
+    int fds[2];
+    if (pipe(fds) != 0) {
+        std::perror("pipe");
+        return 1;
+    }
+    pid_t server = fork();
+    if (server < 0) {
+        std::perror("fork");
+        return 1;
+    }
+    if (server == 0) {
+        close(fds[0]);
+        run_server(opts, fds[1]);
+    }
+    close(fds[1]);
+    int64_t wall_start = 0;
+    if (read(fds[0], &wall_start, sizeof(wall_start)) != static_cast<ssize_t>(sizeof(wall_start))) {
+        std::cerr << "server failed to start\n";
+        kill(server, SIGTERM);
+        waitpid(server, nullptr, 0);
+        return 1;
+    }
+    close(fds[0]);
+    spdlog::set_level(spdlog::level::warn);
+
+    const int64_t window_from = kSimOriginNs + int64_t{opts.warmup_s} * 1'000'000'000;
+    const int64_t window_to = window_from + int64_t{opts.duration_s} * 1'000'000'000;
+
+    trantor::EventLoopThreadPool loops(opts.threads, "ws-load");
+    loops.start();
+    std::atomic<size_t> connected{0};
+    std::vector<LoadClient> clients(opts.clients);
+    for (size_t i = 0; i < opts.clients; ++i) {
+        auto& c = clients[i];
+        c.api = client_api(opts, i);
+        for (size_t j = 0; j < opts.subs; ++j) c.symbols.push_back(symbol_name((i * opts.subs + j) % opts.symbols));
+        c.ws = drogon::WebSocketClient::newWebSocketClient(
+            "ws://127.0.0.1:" + std::to_string(opts.port), loops.getNextLoop());
+        c.ws->setMessageHandler([&c, wall_start, window_from, window_to](
+                                    std::string&& frame,
+                                    const drogon::WebSocketClientPtr&,
+                                    const drogon::WebSocketMessageType&) {
+            on_frame(c, frame, wall_start, window_from, window_to);
+        });
+        auto req = drogon::HttpRequest::newHttpRequest();
+        req->setPath(api_path(c.api));
+        req->setParameter("session_id", kSessionId);
+        if (c.api == WsApiType::FINNHUB) req->setParameter("token", "load");
+        c.ws->connectToServer(req, [&c, &connected](drogon::ReqResult result,
+                                                     const drogon::HttpResponsePtr&,
+                                                     const drogon::WebSocketClientPtr& ws) {
+            if (result != drogon::ReqResult::Ok) {
+                std::cerr << "client connect failed: result=" << static_cast<int>(result) << "\n";
+                return;
+            }
+            if (c.api == WsApiType::FINNHUB) {
+                for (const auto& s : c.symbols) {
+                    ws->getConnection()->send(json{{"type", "subscribe"}, {"symbol", s}}.dump());
+                }
+            } else {
+                ws->getConnection()->send(subscribe_message(c));
+            }
+            connected.fetch_add(1);
+        });
+    }
+
+    auto sleep_until_sim = [&](int64_t sim_ns) {
+        int64_t target = wall_start + (sim_ns - kSimOriginNs);
+        int64_t now = wall_ns();
+        if (target > now) std::this_thread::sleep_for(std::chrono::nanoseconds(target - now));
+    };
+    sleep_until_sim(window_from);
+    const double server_cpu_before = process_cpu_seconds(server);
+    const double client_cpu_before = self_cpu_seconds();
+    sleep_until_sim(window_to);
+    const double server_cpu = process_cpu_seconds(server) - server_cpu_before;
+    const double client_cpu = self_cpu_seconds() - client_cpu_before;
+    // Grace period for messages still in flight at the end of the window.
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    uint64_t received = 0, expected = 0, frames = 0;
+    std::vector<int64_t> latencies;
+    for (const auto& c : clients) {
+        expected += expected_items(opts, c, window_from, window_to);
+        std::lock_guard<std::mutex> lock(c.stats->mutex);
+        received += c.stats->received;
+        frames += c.stats->frames;
+        latencies.insert(latencies.end(), c.stats->latencies_ns.begin(), c.stats->latencies_ns.end());
+    }
+    kill(server, SIGTERM);
+    waitpid(server, nullptr, 0);
+
+    const double secs = static_cast<double>(opts.duration_s);
+    const uint64_t missing = expected > received ? expected - received : 0;
+    std::cout << "ws_load clients=" << opts.clients
+              << " connected=" << connected.load()
+              << " api=" << opts.api
+              << " symbols=" << opts.symbols
+              << " subs=" << opts.subs
+              << " rate=" << static_cast<long long>(opts.rate)
+              << " duration_s=" << opts.duration_s
+              << " delivered_msgs_per_sec=" << static_cast<long long>(static_cast<double>(received) / secs)
+              << " frames_per_sec=" << static_cast<long long>(static_cast<double>(frames) / secs)
+              << " expected=" << expected
+              << " received=" << received
+              << " dropped_or_conflated=" << missing
+              << " p50_us=" << percentile(latencies, 0.50) / 1000
+              << " p99_us=" << percentile(latencies, 0.99) / 1000
+              << " max_us=" << (latencies.empty() ? 0 : *std::max_element(latencies.begin(), latencies.end()) / 1000)
+              << " server_cpu_pct=" << static_cast<int>(server_cpu / secs * 100.0)
+              << " client_cpu_pct=" << static_cast<int>(client_cpu / secs * 100.0) << "\n";
+    std::cout.flush();
+    // Client sockets and loops are torn down by process exit.
+    std::_Exit(0);
+}
@@ -9,7 +9,7 @@ namespace broker_sim {
 
 // Static member initialization
 std::shared_ptr<SessionManager> StatusWsController::session_mgr_;
-std::mutex StatusWsController::conn_mutex_;
+InstrumentedMutex StatusWsController::conn_mutex_{"status_ws.conn"};
 std::set<drogon::WebSocketConnectionPtr> StatusWsController::connections_;
 std::atomic<bool> StatusWsController::worker_running_{false};
 std::unique_ptr<std::thread> StatusWsController::worker_;
@@ -44,7 +44,7 @@ void StatusWsController::handleNewConnection(const drogon::HttpRequestPtr& req,
         spdlog::info("Status WebSocket client connected from {}", req->getPeerAddr().toIp());
 
         {
-            std::lock_guard<std::mutex> lock(conn_mutex_);
+            std::lock_guard<InstrumentedMutex> lock(conn_mutex_);
             connections_.insert(conn);
         }
 
@@ -62,7 +62,7 @@ void StatusWsController::handleNewConnection(const drogon::HttpRequestPtr& req,
 }
 
 void StatusWsController::handleConnectionClosed(const drogon::WebSocketConnectionPtr& conn) {
-    std::lock_guard<std::mutex> lock(conn_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(conn_mutex_);
     connections_.erase(conn);
     spdlog::debug("Status WebSocket client disconnected, {} clients remaining", connections_.size());
 }
@@ -130,7 +130,8 @@ void StatusWsController::broadcast_session_status(const std::string& session_id,
                                                    const std::string& status,
                                                    int64_t current_time_ns,
                                                    uint64_t events_processed,
-                                                   double speed_factor) {
+                                                   double speed_factor,
+                                                   const nlohmann::json& pace) {
     nlohmann::json msg;
     msg["type"] = "session_status";
     msg["session_id"] = session_id;
@@ -138,35 +139,11 @@ void StatusWsController::broadcast_session_status(const std::string& session_id,
     msg["current_time_ns"] = current_time_ns;
     msg["events_processed"] = events_processed;
     msg["speed_factor"] = speed_factor;
+    if (!pace.is_null()) msg["pace"] = pace;
 
     std::string payload = msg.dump();
 
-    std::vector<drogon::WebSocketConnectionPtr> conns;
-    {
-        std::lock_guard<std::mutex> lock(conn_mutex_);
-        conns.assign(connections_.begin(), connections_.end());
-    }
-
-    std::vector<drogon::WebSocketConnectionPtr> stale;
-    for (const auto& conn : conns) {
-        if (!conn || !conn->connected()) {
-            stale.push_back(conn);
-            continue;
-        }
-        try {
-            conn->send(payload);
-        } catch (const std::exception& e) {
-            spdlog::warn("StatusWs: send failed, removing connection: {}", e.what());
-            stale.push_back(conn);
-        }
-    }
-
-    if (!stale.empty()) {
-        std::lock_guard<std::mutex> lock(conn_mutex_);
-        for (const auto& conn : stale) {
-            connections_.erase(conn);
-        }
-    }
+    send_to_all(payload);
 }
 
 void StatusWsController::broadcast_session_event(const std::string& event_type,
@@ -179,9 +156,27 @@ void StatusWsController::broadcast_session_event(const std::string& event_type,
 
     std::string payload = msg.dump();
 
+    send_to_all(payload);
+}
+
+void StatusWsController::broadcast_command_status(const ControlCommand& cmd) {
+    nlohmann::json msg;
+    msg["type"] = "session_command";
+    msg["command_id"] = cmd.id;
+    msg["session_id"] = cmd.session_id;
+    msg["command"] = cmd.type;
+    msg["status"] = command_status_name(cmd.status.load(std::memory_order_acquire));
+    if (!cmd.error.empty()) msg["error"] = cmd.error;
+    msg["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    send_to_all(msg.dump());
+}
+
+void StatusWsController::send_to_all(const std::string& payload) {
     std::vector<drogon::WebSocketConnectionPtr> conns;
     {
-        std::lock_guard<std::mutex> lock(conn_mutex_);
+        std::lock_guard<InstrumentedMutex> lock(conn_mutex_);
         conns.assign(connections_.begin(), connections_.end());
     }
 
@@ -200,7 +195,7 @@ void StatusWsController::broadcast_session_event(const std::string& event_type,
     }
 
     if (!stale.empty()) {
-        std::lock_guard<std::mutex> lock(conn_mutex_);
+        std::lock_guard<InstrumentedMutex> lock(conn_mutex_);
         for (const auto& conn : stale) {
             connections_.erase(conn);
         }
@@ -273,7 +268,8 @@ void StatusWsController::worker_loop() {
                     status_to_string(session->status),
                     send_ns,
                     session->events_processed.load(std::memory_order_relaxed),
-                    speed);
+                    speed,
+                    session_mgr_->pace_report(*session).to_json());
             }
         }
 
@@ -19,6 +19,7 @@ namespace broker_sim {
  * - Session status (running/paused/stopped)
  * - Events processed count
  * - Speed factor
+ * - Pace: achieved speed, schedule lag, feeder lead and queue depth
  *
  * No authentication required, no subscription needed - all connected clients
  * receive all session updates automatically.
@@ -35,13 +36,15 @@ public:
 
     /**
      * Broadcast session status update to all connected clients.
-     * Called by SessionManager during event processing.
+     * Called by SessionManager during event processing; the heartbeat also
+     * attaches the session's PaceReport as "pace".
      */
     static void broadcast_session_status(const std::string& session_id,
                                           const std::string& status,
                                           int64_t current_time_ns,
                                           uint64_t events_processed,
-                                          double speed_factor);
+                                          double speed_factor,
+                                          const nlohmann::json& pace = nullptr);
 
     /**
      * Broadcast that a session has been created/deleted/status changed.
@@ -49,6 +52,11 @@ public:
     static void broadcast_session_event(const std::string& event_type,
                                          const std::string& session_id);
 
+    /**
+     * Broadcast that a queued control command finished (done or failed).
+     */
+    static void broadcast_command_status(const ControlCommand& cmd);
+
     // Drogon WebSocket interface
     void handleNewConnection(const drogon::HttpRequestPtr& req,
                              const drogon::WebSocketConnectionPtr& conn) override;
@@ -63,13 +71,14 @@ public:
 
 private:
     static std::shared_ptr<SessionManager> session_mgr_;
-    static std::mutex conn_mutex_;
+    static InstrumentedMutex conn_mutex_;
     static std::set<drogon::WebSocketConnectionPtr> connections_;
     static std::atomic<bool> worker_running_;
     static std::unique_ptr<std::thread> worker_;
 
     // Send current state of all sessions to a newly connected client
     static void send_initial_state(const drogon::WebSocketConnectionPtr& conn);
+    static void send_to_all(const std::string& payload);
     static void start_worker();
     static void stop_worker();
     static void worker_loop();
@@ -1,4 +1,6 @@
 #include "ws_controller.hpp"
+#include "../core/metrics.hpp"
+#include "../core/tracing.hpp"
 #include <spdlog/spdlog.h>
 #include <algorithm>
 #include <cctype>
@@ -9,6 +11,28 @@ using json = nlohmann::json;
 namespace broker_sim {
 
 namespace {
+struct WsMetrics {
+    std::shared_ptr<Histogram> encode;
+    std::shared_ptr<Histogram> send;
+    std::shared_ptr<Counter> messages_sent;
+    std::shared_ptr<Gauge> outbox;
+    std::shared_ptr<Gauge> connections;
+};
+
+const WsMetrics& ws_metrics() {
+    static const WsMetrics metrics = [] {
+        auto& registry = MetricsRegistry::instance();
+        return WsMetrics{
+            registry.histogram("broker_ws_encode_seconds", "Formatting one event for one WebSocket connection"),
+            registry.histogram("broker_ws_send_seconds", "Handing one event message to a WebSocket connection"),
+            registry.counter("broker_ws_messages_sent_total", "Messages written to WebSocket connections"),
+            registry.gauge("broker_ws_outbox_messages", "Broadcast messages queued for the WebSocket worker"),
+            registry.gauge("broker_ws_connections", "Open WebSocket connections"),
+        };
+    }();
+    return metrics;
+}
+
 int64_t parse_timeframe(const std::string& tf) {
     if (tf.empty()) return 60;
     char unit = tf.back();
@@ -124,7 +148,7 @@ std::vector<std::string> extract_related_tokens(const NewsData& news, const std:
 // Static member definitions
 std::shared_ptr<SessionManager> WsController::session_mgr_;
 Config WsController::cfg_;
-std::mutex WsController::conn_mutex_;
+InstrumentedMutex WsController::conn_mutex_{"ws.conn"};
 std::unordered_map<drogon::WebSocketConnectionPtr, WsConnectionState> WsController::conn_states_;
 std::unordered_map<std::string, std::vector<drogon::WebSocketConnectionPtr>> WsController::session_conns_;
 std::mutex WsController::queue_mutex_;
@@ -256,8 +280,9 @@ void WsController::handleNewConnection(const drogon::HttpRequestPtr& req,
     }
 
     {
-        std::lock_guard<std::mutex> lock(conn_mutex_);
+        std::lock_guard<InstrumentedMutex> lock(conn_mutex_);
         conn_states_[conn] = state;
+        ws_metrics().connections->set(static_cast<int64_t>(conn_states_.size()));
         if (!session_id.empty()) {
             session_conns_[session_id].push_back(conn);
         }
@@ -290,7 +315,7 @@ void WsController::handleNewConnection(const drogon::HttpRequestPtr& req,
 }
 
 void WsController::handleConnectionClosed(const drogon::WebSocketConnectionPtr& conn) {
-    std::lock_guard<std::mutex> lock(conn_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(conn_mutex_);
 
     auto it = conn_states_.find(conn);
     if (it != conn_states_.end()) {
@@ -361,6 +386,7 @@ void WsController::handleConnectionClosed(const drogon::WebSocketConnectionPtr&
             }
         }
         conn_states_.erase(it);
+        ws_metrics().connections->set(static_cast<int64_t>(conn_states_.size()));
     }
     
     spdlog::debug("[WsController] Connection closed, remaining connections: {}", conn_states_.size());
@@ -381,7 +407,7 @@ void WsController::handleNewMessage(const drogon::WebSocketConnectionPtr& conn,
         return;
     }
 
-    std::lock_guard<std::mutex> lock(conn_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(conn_mutex_);
     auto it = conn_states_.find(conn);
     if (it == conn_states_.end()) {
         return;
@@ -1250,6 +1276,7 @@ void WsController::flush_pending_messages(const drogon::WebSocketConnectionPtr&
     }
 
     state.messages_sent += state.pending_msgs.size();
+    ws_metrics().messages_sent->add(state.pending_msgs.size());
     state.pending_msgs.clear();
     state.last_flush = now;
 }
@@ -1266,6 +1293,7 @@ void WsController::enqueue_event_message(const drogon::WebSocketConnectionPtr& c
         conn->send(msg);
         update_backpressure(conn, msg.size());
         state.messages_sent += 1;
+        ws_metrics().messages_sent->add();
         state.bytes_sent += msg.size();
         state.last_flush = std::chrono::steady_clock::now();
         return;
@@ -1280,7 +1308,8 @@ void WsController::enqueue_event_message(const drogon::WebSocketConnectionPtr& c
 // ============================================================================
 
 void WsController::broadcast_event(const std::string& session_id, const Event& event) {
-    std::lock_guard<std::mutex> lock(conn_mutex_);
+    trace_stamp(TraceStage::WS_BEGIN);
+    std::lock_guard<InstrumentedMutex> lock(conn_mutex_);
 
     auto it = session_conns_.find(session_id);
     if (it == session_conns_.end()) return;
@@ -1294,6 +1323,7 @@ void WsController::broadcast_event(const std::string& session_id, const Event& e
         auto& state = state_it->second;
         if (!state.authenticated) continue;
 
+        const auto encode_start = std::chrono::steady_clock::now();
         std::string msg;
 
         switch (event.event_type) {
@@ -1560,9 +1590,14 @@ void WsController::broadcast_event(const std::string& session_id, const Event& e
         }
 
         if (!msg.empty()) {
+            const auto send_start = std::chrono::steady_clock::now();
+            ws_metrics().encode->record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(send_start - encode_start).count()));
             enqueue_event_message(conn, state, std::move(msg), event.event_type == EventType::BAR);
+            ws_metrics().send->record_since(send_start);
         }
     }
+    trace_stamp(TraceStage::WS_END);
 }
 
 void WsController::broadcast(const std::string& session_id, const std::string& msg) {
@@ -1576,7 +1611,10 @@ void WsController::enqueue(const std::string& session_id, const std::string& msg
         if (cfg_.websocket.queue_size > 0 &&
             q.size() >= static_cast<size_t>(cfg_.websocket.queue_size)) {
             if (cfg_.websocket.overflow_policy == "drop_oldest") {
-                if (!q.empty()) q.pop_front();
+                if (!q.empty()) {
+                    q.pop_front();
+                    ws_metrics().outbox->add(-1);
+                }
             } else if (cfg_.websocket.overflow_policy == "block") {
                 queue_cv_.wait(lock, [&] {
                     return !worker_running_.load() ||
@@ -1590,12 +1628,13 @@ void WsController::enqueue(const std::string& session_id, const std::string& msg
             }
         }
         q.push_back(msg);
+        ws_metrics().outbox->add(1);
     }
     queue_cv_.notify_one();
 }
 
 void WsController::send_batch(const std::string& session_id, const std::vector<std::string>& msgs) {
-    std::lock_guard<std::mutex> lock(conn_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(conn_mutex_);
     auto it = session_conns_.find(session_id);
     if (it == session_conns_.end()) return;
 
@@ -1621,6 +1660,7 @@ void WsController::send_batch(const std::string& session_id, const std::vector<s
         // Update backpressure state
         update_backpressure(conn, batch_bytes);
         state.messages_sent += msgs.size();
+        ws_metrics().messages_sent->add(msgs.size());
         state.bytes_sent += batch_bytes;
     }
 }
@@ -1665,6 +1705,7 @@ void WsController::worker_loop() {
                 }
 
                 if (!msgs.empty()) {
+                    ws_metrics().outbox->add(-static_cast<int64_t>(msgs.size()));
                     to_send.emplace(kv.first, std::move(msgs));
                 }
             }
@@ -1678,7 +1719,7 @@ void WsController::worker_loop() {
         auto now = std::chrono::steady_clock::now();
         if (now >= next_bar_heartbeat) {
             int64_t fallback_ts_ns = utils::ts_to_ns(std::chrono::system_clock::now());
-            std::lock_guard<std::mutex> lock(conn_mutex_);
+            std::lock_guard<InstrumentedMutex> lock(conn_mutex_);
             for (auto& entry : conn_states_) {
                 const auto& conn = entry.first;
                 auto& state = entry.second;
@@ -1732,6 +1773,7 @@ void WsController::worker_loop() {
                         agg.last_emit_ts_ns = now_ts_ns;
                         update_backpressure(conn, bar_msg.size());
                         state.messages_sent += 1;
+                        ws_metrics().messages_sent->add();
                         state.bytes_sent += bar_msg.size();
                     }
                 }
@@ -1741,7 +1783,7 @@ void WsController::worker_loop() {
         }
 
         {
-            std::lock_guard<std::mutex> lock(conn_mutex_);
+            std::lock_guard<InstrumentedMutex> lock(conn_mutex_);
             for (auto it = conn_states_.begin(); it != conn_states_.end(); ++it) {
                 const auto& conn = it->first;
                 auto& state = it->second;
@@ -1790,7 +1832,7 @@ void WsController::update_backpressure(const drogon::WebSocketConnectionPtr& con
 }
 
 void WsController::on_message_drained(const drogon::WebSocketConnectionPtr& conn, size_t bytes) {
-    std::lock_guard<std::mutex> lock(conn_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(conn_mutex_);
     auto it = conn_states_.find(conn);
     if (it == conn_states_.end()) return;
 
@@ -1827,7 +1869,7 @@ bool WsController::should_drop_for_slow_consumer(const WsConnectionState& state)
 }
 
 size_t WsController::count_slow_connections(const std::string& session_id) {
-    std::lock_guard<std::mutex> lock(conn_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(conn_mutex_);
 
     auto it = session_conns_.find(session_id);
     if (it == session_conns_.end()) return 0;
@@ -1843,7 +1885,7 @@ size_t WsController::count_slow_connections(const std::string& session_id) {
 }
 
 void WsController::log_backpressure_stats() {
-    std::lock_guard<std::mutex> lock(conn_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(conn_mutex_);
 
     size_t total_connections = conn_states_.size();
     size_t slow_connections = 0;
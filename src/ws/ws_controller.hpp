@@ -176,7 +176,7 @@ private:
     static Config cfg_;
 
     // Connection management
-    static std::mutex conn_mutex_;
+    static InstrumentedMutex conn_mutex_;
     static std::unordered_map<drogon::WebSocketConnectionPtr, WsConnectionState> conn_states_;
 
     // Session to connections mapping
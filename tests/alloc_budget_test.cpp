@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "../src/core/session_manager.hpp"
+#include "../src/core/data_source_stub.hpp"
+#include "../src/core/alloc_tracking.hpp"
+
+using namespace broker_sim;
+
+namespace {
+
+// 2024-01-02 14:30:00 UTC, inside regular trading hours.
+const Timestamp kOrigin = Timestamp{} + std::chrono::seconds(1704205800);
+constexpr size_t kEvents = 20000;
+
+// Fixed interleaving of quotes and trades over four symbols.
+class SyntheticReplaySource : public StubDataSource {
+public:
+    void stream_events(const std::vector<std::string>&,
+                       Timestamp,
+                       Timestamp,
+                       const std::function<void(const MarketEvent&)>& cb) override {
+        for (size_t i = 0; i < kEvents; ++i) {
+            MarketEvent ev;
+            ev.timestamp = kOrigin + std::chrono::microseconds(1 + static_cast<int64_t>(i) * 1000);
+            const std::string symbol = "SYM" + std::to_string(i % 4);
+            const double mid = 100.0 + static_cast<double>(i % 50) * 0.01;
+            if (i % 5 == 4) {
+                ev.type = MarketEventType::TRADE;
+                ev.trade = TradeRecord{ev.timestamp, symbol, mid, 100, 1, "", 1};
+            } else {
+                ev.type = MarketEventType::QUOTE;
+                ev.quote = QuoteRecord{ev.timestamp, symbol, mid - 0.01, 100, mid + 0.01, 100, 1, 1, 1};
+            }
+            cb(ev);
+        }
+    }
+};
+
+struct StageBudget {
+    AllocStage stage;
+    double max_allocs_per_event;
+};
+
+// Measured allocations per event on the session hot path with WAL off, one
+// event callback and no strategy, plus headroom. Lower these when a change
+// removes allocations; a change that needs more should justify raising them.
+// The market-event WAL record is built as a json object even when the WAL is
+// disabled, which is most of today's total.
+constexpr std::array<StageBudget, 6> kBudgets{{
+    {AllocStage::ENQUEUE, 0.5},
+    {AllocStage::DEQUEUE, 0.5},
+    {AllocStage::EVENT_LOG, 1.5},
+    {AllocStage::WAL, 36.0},
+    {AllocStage::MATCH, 0.5},
+    {AllocStage::CALLBACKS, 0.5},
+}};
+constexpr double kTotalBudget = 38.0;
+
+} // namespace
+
+TEST(AllocBudgetTest, SessionHotPathStaysWithinAllocationBudget) {
+    if (!alloc_tracking::enabled()) {
+        GTEST_SKIP() << "configure with -DENABLE_ALLOC_TRACKING=ON to check allocation budgets";
+    }
+
+    ExecutionConfig exec;
+    exec.enable_wal = false;
+    exec.checkpoint_interval_events = 0;
+    exec.seek_snapshot_interval_seconds = 0;
+    SessionManager mgr(std::make_shared<SyntheticReplaySource>(), exec);
+    std::atomic<uint64_t> sink{0};
+    mgr.add_event_callback([&](const std::string&, const Event& ev) {
+        sink.fetch_add(ev.symbol.size(), std::memory_order_relaxed);
+    });
+
+    SessionConfig cfg;
+    cfg.symbols = {"SYM0", "SYM1", "SYM2", "SYM3"};
+    cfg.start_time = kOrigin;
+    cfg.end_time = kOrigin + std::chrono::minutes(1);
+    cfg.batch_mode = true;
+    auto session = mgr.create_session(cfg);
+
+    alloc_tracking::reset_stages();
+    mgr.start_session(session->id);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (session->status != SessionStatus::COMPLETED && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(session->status, SessionStatus::COMPLETED);
+    const uint64_t processed = session->events_processed.load();
+    ASSERT_EQ(processed, kEvents);
+
+    double total = 0.0;
+    for (const auto& budget : kBudgets) {
+        const double per_event =
+            static_cast<double>(alloc_tracking::stage_counts(budget.stage).allocations) / static_cast<double>(processed);
+        total += per_event;
+        EXPECT_LE(per_event, budget.max_allocs_per_event) << alloc_stage_name(budget.stage);
+        std::cout << "[ alloc    ] " << alloc_stage_name(budget.stage) << " " << per_event << "/event\n";
+    }
+    EXPECT_LE(total, kTotalBudget);
+    mgr.stop_session(session->id);
+}
+
+TEST(AllocBudgetTest, StageScopesChargeTheCurrentThread) {
+    if (!alloc_tracking::enabled()) {
+        GTEST_SKIP() << "configure with -DENABLE_ALLOC_TRACKING=ON to check allocation budgets";
+    }
+    alloc_tracking::reset_stages();
+    const AllocCounts before = alloc_tracking::thread_counts();
+    {
+        // Direct operator calls, which unlike new-expressions may not be elided.
+        AllocStageScope scope(AllocStage::STRATEGY);
+        void* owned = ::operator new(64);
+        scope.set(AllocStage::CHECKPOINT);
+        void* more = ::operator new(8);
+        ::operator delete(more);
+        ::operator delete(owned);
+    }
+    const AllocCounts delta = alloc_tracking::thread_counts() - before;
+    EXPECT_EQ(delta.allocations, 2u);
+    EXPECT_EQ(delta.frees, 2u);
+    EXPECT_EQ(alloc_tracking::stage_counts(AllocStage::STRATEGY).allocations, 1u);
+    EXPECT_EQ(alloc_tracking::stage_counts(AllocStage::STRATEGY).bytes, 64u);
+    // Both frees happen while CHECKPOINT is current.
+    EXPECT_EQ(alloc_tracking::stage_counts(AllocStage::CHECKPOINT).allocations, 1u);
+    EXPECT_EQ(alloc_tracking::stage_counts(AllocStage::CHECKPOINT).frees, 2u);
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include "../src/core/callback_list.hpp"
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+using namespace broker_sim;
+
+TEST(CallbackListTest, DispatchesInRegistrationOrder) {
+    CallbackList<std::function<void(int, std::string&)>> list;
+    std::string out;
+    list.dispatch(1, out);
+    EXPECT_TRUE(list.empty());
+
+    list.add([](int n, std::string& s) { s += "a" + std::to_string(n); });
+    list.add(nullptr);
+    list.add([](int n, std::string& s) { s += "b" + std::to_string(n); });
+    EXPECT_EQ(list.size(), 3u);
+    list.dispatch(7, out);
+    EXPECT_EQ(out, "a7b7");
+}
+
+TEST(CallbackListTest, CallbackAddedDuringDispatchRunsFromNextDispatch) {
+    CallbackList<std::function<void()>> list;
+    int late_calls = 0;
+    list.add([&] { list.add([&] { late_calls++; }); });
+    list.dispatch();
+    EXPECT_EQ(late_calls, 0);
+    list.dispatch();
+    EXPECT_EQ(late_calls, 1);
+}
+
+TEST(CallbackListTest, ConcurrentRegistrationIsSafeForDispatchers) {
+    CallbackList<std::function<void(std::atomic<int>&)>> list;
+    list.add([](std::atomic<int>& n) { n++; });
+    std::atomic<bool> stop{false};
+    std::atomic<int> calls{0};
+    std::thread dispatcher([&] {
+        while (!stop) list.dispatch(calls);
+    });
+    for (int i = 0; i < 100; ++i) {
+        list.add([](std::atomic<int>& n) { n++; });
+    }
+    stop = true;
+    dispatcher.join();
+    EXPECT_EQ(list.size(), 101u);
+    std::atomic<int> last{0};
+    list.dispatch(last);
+    EXPECT_EQ(last.load(), 101);
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include "../src/core/cpu_profiler.hpp"
+
+#include <chrono>
+#include <cmath>
+
+using namespace broker_sim;
+
+// Out of line and with external linkage so the profiler can name it (the test
+// binary is linked with ENABLE_EXPORTS).
+__attribute__((noinline)) double cpu_profiler_test_burn(std::chrono::milliseconds duration) {
+    const auto until = std::chrono::steady_clock::now() + duration;
+    volatile double acc = 0.0;
+    while (std::chrono::steady_clock::now() < until) {
+        for (int i = 1; i < 1000; ++i) acc = acc + std::sqrt(static_cast<double>(i));
+    }
+    return acc;
+}
+
+TEST(CpuProfilerTest, CapturesCollapsedStacksOfBusyThread) {
+    auto& profiler = CpuProfiler::instance();
+    ASSERT_TRUE(profiler.start(500, 10'000));
+    cpu_profiler_test_burn(std::chrono::milliseconds(300));
+    auto result = profiler.stop();
+
+    EXPECT_FALSE(profiler.running());
+    EXPECT_EQ(result.hz, 500);
+    ASSERT_GT(result.samples, 20u);
+    EXPECT_EQ(result.dropped, 0u);
+    EXPECT_NE(result.collapsed.find("cpu_profiler_test_burn"), std::string::npos) << result.collapsed;
+    // Handler and signal trampoline frames are cut off.
+    EXPECT_EQ(result.collapsed.find("on_sigprof"), std::string::npos);
+
+    // Every line is "frame;frame;... count" and the counts add up.
+    uint64_t total = 0;
+    size_t pos = 0;
+    while (pos < result.collapsed.size()) {
+        size_t eol = result.collapsed.find('\n', pos);
+        ASSERT_NE(eol, std::string::npos);
+        std::string line = result.collapsed.substr(pos, eol - pos);
+        size_t space = line.rfind(' ');
+        ASSERT_NE(space, std::string::npos) << line;
+        total += std::stoull(line.substr(space + 1));
+        pos = eol + 1;
+    }
+    EXPECT_EQ(total, result.samples);
+}
+
+TEST(CpuProfilerTest, RejectsConcurrentCaptureAndCountsDroppedSamples) {
+    auto& profiler = CpuProfiler::instance();
+    ASSERT_TRUE(profiler.start(1000, 5));
+    EXPECT_FALSE(profiler.start(1000, 5));
+    cpu_profiler_test_burn(std::chrono::milliseconds(100));
+    auto result = profiler.stop();
+    EXPECT_EQ(result.samples, 5u);
+    EXPECT_GT(result.dropped, 0u);
+
+    // Stopping again is harmless and the profiler can be re-armed.
+    EXPECT_EQ(profiler.stop().samples, 0u);
+    ASSERT_TRUE(profiler.start(100, 10));
+    profiler.stop();
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include "../src/core/instrumented_mutex.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace broker_sim;
+
+TEST(InstrumentedMutexTest, UncontendedLockRecordsZeroWaitAndHoldTime) {
+    InstrumentedMutex mutex("test.uncontended");
+    {
+        std::lock_guard<InstrumentedMutex> lock(mutex);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    EXPECT_EQ(mutex.wait_histogram().count(), 1u);
+    EXPECT_EQ(mutex.wait_histogram().sum(), 0u);
+    EXPECT_EQ(mutex.contended(), 0u);
+    ASSERT_EQ(mutex.hold_histogram().count(), 1u);
+    EXPECT_GE(mutex.hold_histogram().sum(), 2'000'000u);
+
+    ASSERT_TRUE(mutex.try_lock());
+    mutex.unlock();
+    EXPECT_EQ(mutex.wait_histogram().count(), 2u);
+    EXPECT_EQ(mutex.hold_histogram().count(), 2u);
+}
+
+TEST(InstrumentedMutexTest, BlockedAcquisitionRecordsWaitTime) {
+    InstrumentedMutex mutex("test.contended");
+    std::atomic<bool> held{false};
+    std::thread holder([&] {
+        std::lock_guard<InstrumentedMutex> lock(mutex);
+        held = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    });
+    while (!held) std::this_thread::yield();
+    EXPECT_FALSE(mutex.try_lock());
+    {
+        std::unique_lock<InstrumentedMutex> lock(mutex);
+    }
+    holder.join();
+
+    EXPECT_EQ(mutex.contended(), 1u);
+    EXPECT_EQ(mutex.wait_histogram().count(), 2u);
+    EXPECT_GE(mutex.wait_histogram().sum(), 5'000'000u);
+    EXPECT_GE(mutex.hold_histogram().quantile(1.0), 20'000'000u);
+}
+
+TEST(InstrumentedMutexTest, SameNameSharesSeriesExposedInPrometheus) {
+    InstrumentedMutex a("test.shared");
+    InstrumentedMutex b("test.shared");
+    a.lock();
+    a.unlock();
+    b.lock();
+    b.unlock();
+    EXPECT_EQ(a.wait_histogram().count(), 2u);
+    EXPECT_EQ(&a.hold_histogram(), &b.hold_histogram());
+
+    const std::string text = MetricsRegistry::instance().render_prometheus();
+    EXPECT_NE(text.find("broker_lock_wait_seconds_count{lock=\"test.shared\"} 2"), std::string::npos);
+    EXPECT_NE(text.find("broker_lock_hold_seconds_bucket{lock=\"test.shared\""), std::string::npos);
+    EXPECT_NE(text.find("broker_lock_contended_total{lock=\"test.shared\"} 0"), std::string::npos);
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "../src/core/luld_bands.hpp"
+
+using namespace broker_sim;
+
+namespace {
+
+constexpr int64_t kSec = 1'000'000'000;
+
+} // namespace
+
+TEST(LuldBandEngineTest, BandsWidenForLowPricedStocks) {
+    auto tier = LuldBandEngine::bands_for(100.0, 5.0);
+    EXPECT_DOUBLE_EQ(tier.upper, 105.0);
+    EXPECT_DOUBLE_EQ(tier.lower, 95.0);
+
+    auto mid = LuldBandEngine::bands_for(2.0, 5.0);   // $0.75-$3: 20%
+    EXPECT_DOUBLE_EQ(mid.upper, 2.4);
+    EXPECT_DOUBLE_EQ(mid.lower, 1.6);
+
+    auto penny = LuldBandEngine::bands_for(0.5, 5.0); // lesser of $0.15 or 75%
+    EXPECT_DOUBLE_EQ(penny.upper, 0.65);
+    EXPECT_DOUBLE_EQ(penny.lower, 0.35);
+}
+
+TEST(LuldBandEngineTest, ReferenceFollowsTheFiveMinuteMeanInOnePercentSteps) {
+    LuldBandEngine engine({});
+    auto r = engine.on_trade(0, 0, 100.0);
+    EXPECT_TRUE(r.bands_changed);
+    EXPECT_DOUBLE_EQ(r.bands.reference, 100.0);
+    EXPECT_DOUBLE_EQ(r.bands.upper, 110.0);   // Tier 2 default
+
+    // Mean 100.5 is within 1% of the reference: bands stay put.
+    r = engine.on_trade(0, 10 * kSec, 101.0);
+    EXPECT_FALSE(r.bands_changed);
+    EXPECT_DOUBLE_EQ(r.bands.reference, 100.0);
+
+    // Mean 101.33 moves the reference.
+    r = engine.on_trade(0, 200 * kSec, 103.0);
+    EXPECT_TRUE(r.bands_changed);
+    EXPECT_NEAR(r.bands.reference, 304.0 / 3.0, 1e-9);
+
+    // At 301s the print from second 0 has left the window: mean of 101, 103, 106.
+    r = engine.on_trade(0, 301 * kSec, 106.0);
+    EXPECT_TRUE(r.bands_changed);
+    EXPECT_NEAR(r.bands.reference, 310.0 / 3.0, 1e-9);
+
+    // After a quiet spell longer than the window the next print reseeds it.
+    r = engine.on_trade(0, 2'000 * kSec, 50.0);
+    EXPECT_TRUE(r.bands_changed);
+    EXPECT_DOUBLE_EQ(r.bands.reference, 50.0);
+}
+
+TEST(LuldBandEngineTest, UnresolvedLimitStatePausesThenReopensAtNextPrint) {
+    LuldBandEngine::Params params;
+    params.pause_ns = 300 * kSec;
+    LuldBandEngine engine(params);
+    for (int s = 1; s <= 50; ++s) {
+        EXPECT_EQ(engine.on_trade(7, s * kSec, 100.0).action, LuldBandEngine::Action::NONE);
+    }
+    // At the upper band: limit state, not yet a pause.
+    EXPECT_EQ(engine.on_trade(7, 55 * kSec, 110.0).action, LuldBandEngine::Action::NONE);
+    // A print back inside the bands clears it, so the clock restarts.
+    EXPECT_EQ(engine.on_trade(7, 60 * kSec, 100.0).action, LuldBandEngine::Action::NONE);
+    EXPECT_EQ(engine.on_trade(7, 61 * kSec, 111.0).action, LuldBandEngine::Action::NONE);
+    EXPECT_EQ(engine.on_trade(7, 75 * kSec, 111.0).action, LuldBandEngine::Action::NONE);
+    EXPECT_EQ(engine.on_trade(7, 76 * kSec, 111.0).action, LuldBandEngine::Action::HALT);
+
+    // Prints during the pause are ignored; the first one after it reopens.
+    EXPECT_EQ(engine.on_trade(7, 200 * kSec, 130.0).action, LuldBandEngine::Action::NONE);
+    auto r = engine.on_trade(7, 376 * kSec, 120.0);
+    EXPECT_EQ(r.action, LuldBandEngine::Action::RESUME);
+    EXPECT_DOUBLE_EQ(r.bands.reference, 120.0);
+    EXPECT_EQ(engine.on_trade(7, 377 * kSec, 121.0).action, LuldBandEngine::Action::NONE);
+}
+
+TEST(LuldBandEngineTest, TierOneSymbolsUseTheNarrowerBand) {
+    LuldBandEngine::Params params;
+    params.tier1 = {3};
+    LuldBandEngine engine(params);
+    EXPECT_DOUBLE_EQ(engine.on_trade(3, 0, 100.0).bands.upper, 105.0);
+    EXPECT_DOUBLE_EQ(engine.on_trade(4, 0, 100.0).bands.upper, 110.0);
+    EXPECT_EQ(engine.tracked_symbols(), 2u);
+    EXPECT_FALSE(engine.on_trade(kInvalidSymbolId, 0, 100.0).bands_changed);
+}
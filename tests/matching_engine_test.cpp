@@ -151,3 +151,29 @@ TEST(MatchingEngineTest, OrderExpiresOnTimestamp) {
     ASSERT_EQ(res.expired.size(), 1u);
     EXPECT_EQ(res.expired[0].id, "exp");
 }
+
+TEST(MatchingEngineTest, ForkSharesStateUntilEitherSideWrites) {
+    MatchingEngine eng;
+    eng.update_nbbo(make_nbbo("AAPL", 100.0, 100, 101.0, 100));
+    Order o;
+    o.id = "lim";
+    o.symbol = "AAPL";
+    o.side = OrderSide::BUY;
+    o.type = OrderType::LIMIT;
+    o.tif = TimeInForce::GTC;
+    o.qty = 10.0;
+    o.limit_price = 99.0;
+    ASSERT_FALSE(eng.submit_order(o).has_value());
+
+    auto branch = eng.fork();
+    ASSERT_TRUE(branch->get_order("lim").has_value());
+    EXPECT_DOUBLE_EQ(branch->get_nbbo("AAPL")->ask_price, 101.0);
+
+    EXPECT_TRUE(branch->cancel_order("lim"));
+    EXPECT_FALSE(branch->get_order("lim").has_value());
+    EXPECT_TRUE(eng.get_order("lim").has_value());
+
+    auto result = eng.update_nbbo(make_nbbo("AAPL", 98.0, 100, 98.5, 100, 2));
+    ASSERT_EQ(result.fills.size(), 1u);
+    EXPECT_DOUBLE_EQ(branch->get_nbbo("AAPL")->ask_price, 101.0);
+}
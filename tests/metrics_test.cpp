@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/core/metrics.hpp"
+
+using namespace broker_sim;
+
+TEST(MetricsTest, HistogramBucketsCoverValuesWithinQuarterWidth) {
+    for (uint64_t v : {0ull, 1ull, 3ull, 4ull, 5ull, 7ull, 8ull, 1000ull, 123456789ull, ~0ull}) {
+        size_t idx = Histogram::bucket_index(v);
+        ASSERT_LT(idx, Histogram::kBuckets);
+        EXPECT_GE(Histogram::bucket_upper(idx), v);
+        if (idx > 0) {
+            EXPECT_LT(Histogram::bucket_upper(idx - 1), v);
+        }
+        EXPECT_LE(Histogram::bucket_upper(idx) - v, v / 4) << v;
+    }
+}
+
+TEST(MetricsTest, HistogramPowerOfTwoBoundsIncludeTheBoundValue) {
+    for (unsigned pow2 = 2; pow2 < 64; ++pow2) {
+        const uint64_t le = uint64_t{1} << pow2;
+        EXPECT_EQ(Histogram::bucket_upper(Histogram::bucket_index(le)), le) << pow2;
+    }
+    Histogram h;
+    h.record(1024);
+    h.record(1025);
+    EXPECT_EQ(h.count_at_or_below(1023), 0u);
+    EXPECT_EQ(h.count_at_or_below(1024), 1u);
+}
+
+TEST(MetricsTest, HistogramQuantilesAndConcurrentRecording) {
+    Histogram h;
+    EXPECT_EQ(h.quantile(0.5), 0u);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&h]() {
+            for (uint64_t i = 1; i <= 1000; ++i) h.record(i * 1000);  // 1us..1ms
+        });
+    }
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(h.count(), 4000u);
+    EXPECT_EQ(h.sum(), 4u * 1000u * 1001u / 2u * 1000u);
+    const uint64_t p50 = h.quantile(0.50);
+    EXPECT_GE(p50, 500'000u);
+    EXPECT_LE(p50, 625'000u);
+    EXPECT_GE(h.quantile(0.99), 990'000u);
+    EXPECT_EQ(h.count_at_or_below(1u << 20), 4000u);
+}
+
+TEST(MetricsTest, RegistryRendersPrometheusText) {
+    MetricsRegistry registry;
+    auto c = registry.counter("test_requests_total", "Requests", {{"route", "/a\"b"}});
+    c->add(3);
+    EXPECT_EQ(registry.counter("test_requests_total", "Requests", {{"route", "/a\"b"}}), c);
+    registry.gauge("test_depth", "Depth")->set(-2);
+    registry.histogram("test_latency_seconds", "Latency", {{"op", "x"}})->record(1000);
+
+    const std::string text = registry.render_prometheus();
+    EXPECT_NE(text.find("# TYPE test_requests_total counter\n"), std::string::npos);
+    EXPECT_NE(text.find("test_requests_total{route=\"/a\\\"b\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("test_depth -2\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE test_latency_seconds histogram\n"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_bucket{op=\"x\",le=\"2.56e-07\"} 0\n"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_bucket{op=\"x\",le=\"1.024e-06\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_bucket{op=\"x\",le=\"+Inf\"} 1\n"), std::string::npos);
+    EXPECT_NE(text.find("test_latency_seconds_count{op=\"x\"} 1\n"), std::string::npos);
+
+    registry.remove("test_latency_seconds", {{"op", "x"}});
+    EXPECT_EQ(registry.render_prometheus().find("test_latency_seconds"), std::string::npos);
+}
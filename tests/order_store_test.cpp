@@ -0,0 +1,314 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include "../src/core/order_store.hpp"
+
+using namespace broker_sim;
+
+static Order make_order(const std::string& id, const std::string& sym, int64_t ts,
+                        OrderStatus status = OrderStatus::ACCEPTED) {
+    Order o;
+    o.id = id;
+    o.client_order_id = "c_" + id;
+    o.symbol = sym;
+    o.side = OrderSide::BUY;
+    o.type = OrderType::LIMIT;
+    o.tif = TimeInForce::DAY;
+    o.qty = 1.0;
+    o.status = status;
+    o.submitted_at_ns = ts;
+    o.created_at_ns = ts;
+    return o;
+}
+
+static std::vector<std::string> ids(const OrderPage& page) {
+    std::vector<std::string> out;
+    for (const auto& o : page.orders) out.push_back(o.id);
+    return out;
+}
+
+TEST(OrderStoreTest, ListsNewestFirstWithStatusFilter) {
+    OrderStore store;
+    store.upsert(make_order("a", "AAPL", 100));
+    store.upsert(make_order("b", "MSFT", 200, OrderStatus::FILLED));
+    store.upsert(make_order("c", "AAPL", 300));
+
+    OrderQuery all;
+    EXPECT_EQ(ids(store.list(all)), (std::vector<std::string>{"c", "b", "a"}));
+
+    OrderQuery open;
+    open.status = OrderStatusFilter::OPEN;
+    EXPECT_EQ(ids(store.list(open)), (std::vector<std::string>{"c", "a"}));
+
+    OrderQuery closed;
+    closed.status = OrderStatusFilter::CLOSED;
+    EXPECT_EQ(ids(store.list(closed)), (std::vector<std::string>{"b"}));
+
+    OrderQuery asc;
+    asc.newest_first = false;
+    EXPECT_EQ(ids(store.list(asc)), (std::vector<std::string>{"a", "b", "c"}));
+}
+
+TEST(OrderStoreTest, StatusTransitionsMaintainOpenIndex) {
+    OrderStore store;
+    store.upsert(make_order("a", "AAPL", 100));
+    EXPECT_EQ(store.open_count(), 1u);
+
+    ASSERT_TRUE(store.update("a", [](Order& o) { o.status = OrderStatus::CANCELED; }));
+    EXPECT_EQ(store.open_count(), 0u);
+    EXPECT_TRUE(store.open_order_ids().empty());
+    EXPECT_FALSE(store.update("missing", [](Order&) {}));
+
+    auto filled = make_order("a", "AAPL", 100, OrderStatus::PARTIALLY_FILLED);
+    store.upsert(filled);
+    EXPECT_EQ(store.open_order_ids(), (std::vector<std::string>{"a"}));
+    EXPECT_EQ(store.size(), 1u);
+}
+
+TEST(OrderStoreTest, LooksUpByClientIdAndSymbol) {
+    OrderStore store;
+    store.upsert(make_order("a", "AAPL", 100));
+    store.upsert(make_order("b", "MSFT", 200));
+    store.upsert(make_order("c", "AAPL", 300, OrderStatus::FILLED));
+
+    auto by_client = store.get_by_client_id("c_b");
+    ASSERT_TRUE(by_client.has_value());
+    EXPECT_EQ(by_client->id, "b");
+    EXPECT_FALSE(store.get_by_client_id("nope").has_value());
+
+    OrderQuery q;
+    q.symbols = {"AAPL"};
+    EXPECT_EQ(ids(store.list(q)), (std::vector<std::string>{"c", "a"}));
+    q.status = OrderStatusFilter::OPEN;
+    EXPECT_EQ(ids(store.list(q)), (std::vector<std::string>{"a"}));
+    q.symbols = {"TSLA"};
+    EXPECT_TRUE(store.list(q).orders.empty());
+    EXPECT_EQ(store.open_order_ids("MSFT"), (std::vector<std::string>{"b"}));
+}
+
+TEST(OrderStoreTest, CursorPagesThroughResults) {
+    OrderStore store;
+    for (int i = 0; i < 5; ++i) {
+        store.upsert(make_order(std::to_string(i), "AAPL", 100 + i));
+    }
+
+    OrderQuery q;
+    q.limit = 2;
+    auto p1 = store.list(q);
+    EXPECT_EQ(ids(p1), (std::vector<std::string>{"4", "3"}));
+    ASSERT_TRUE(p1.next.has_value());
+
+    q.cursor = p1.next;
+    auto p2 = store.list(q);
+    EXPECT_EQ(ids(p2), (std::vector<std::string>{"2", "1"}));
+    ASSERT_TRUE(p2.next.has_value());
+
+    q.cursor = p2.next;
+    auto p3 = store.list(q);
+    EXPECT_EQ(ids(p3), (std::vector<std::string>{"0"}));
+    EXPECT_FALSE(p3.next.has_value());
+
+    OrderQuery window;
+    window.after_ns = 100;
+    window.until_ns = 104;
+    window.newest_first = false;
+    EXPECT_EQ(ids(store.list(window)), (std::vector<std::string>{"1", "2", "3"}));
+}
+
+TEST(OrderStoreTest, RestoreRebuildsHotTierAndArchivesTerminalOrders) {
+    OrderStore store;
+    store.upsert(make_order("old", "AAPL", 1));
+
+    std::unordered_map<std::string, Order> restored;
+    restored["x"] = make_order("x", "MSFT", 20);
+    restored["y"] = make_order("y", "MSFT", 10, OrderStatus::EXPIRED);
+    store.restore(restored);
+
+    EXPECT_FALSE(store.get("old").has_value());
+    EXPECT_EQ(store.size(), 2u);
+    EXPECT_EQ(store.open_count(), 1u);
+    EXPECT_EQ(ids(store.list(OrderQuery{})), (std::vector<std::string>{"x", "y"}));
+    EXPECT_EQ(store.snapshot().size(), 2u);
+    EXPECT_EQ(store.open_snapshot().size(), 1u);
+
+    store.clear();
+    EXPECT_EQ(store.size(), 0u);
+    EXPECT_TRUE(store.list(OrderQuery{}).orders.empty());
+}
+
+TEST(OrderStoreTest, TerminalOrdersMoveToArchiveAndStayQueryable) {
+    OrderStore store;
+    store.upsert(make_order("a", "AAPL", 100));
+    store.upsert(make_order("b", "AAPL", 200));
+    ASSERT_TRUE(store.update("a", [](Order& o) {
+        o.status = OrderStatus::FILLED;
+        o.filled_qty = 1.0;
+        o.rejection_reason = "n/a";
+    }));
+
+    EXPECT_EQ(store.open_count(), 1u);
+    EXPECT_EQ(store.archived_count(), 1u);
+    auto a = store.get("a");
+    ASSERT_TRUE(a.has_value());
+    EXPECT_EQ(a->status, OrderStatus::FILLED);
+    EXPECT_DOUBLE_EQ(a->filled_qty, 1.0);
+    EXPECT_EQ(a->rejection_reason, "n/a");
+    ASSERT_TRUE(store.get_by_client_id("c_a").has_value());
+
+    OrderQuery q;
+    q.symbols = {"AAPL"};
+    EXPECT_EQ(ids(store.list(q)), (std::vector<std::string>{"b", "a"}));
+    q.status = OrderStatusFilter::CLOSED;
+    EXPECT_EQ(ids(store.list(q)), (std::vector<std::string>{"a"}));
+
+    // Updating an archived order supersedes its record.
+    ASSERT_TRUE(store.update("a", [](Order& o) { o.cumulative_fees = 2.5; }));
+    EXPECT_DOUBLE_EQ(store.get("a")->cumulative_fees, 2.5);
+    EXPECT_EQ(store.archived_count(), 1u);
+}
+
+TEST(OrderStoreTest, FileArchiveSurvivesReattach) {
+    auto path = (std::filesystem::temp_directory_path() / "order_store_test.orders.jsonl").string();
+    {
+        OrderStore store;
+        ASSERT_TRUE(store.attach_archive(path, false));
+        store.upsert(make_order("a", "AAPL", 100, OrderStatus::CANCELED));
+        store.upsert(make_order("b", "MSFT", 200, OrderStatus::FILLED));
+        store.upsert(make_order("c", "MSFT", 300));
+        EXPECT_EQ(store.get("b")->status, OrderStatus::FILLED);
+    }
+    OrderStore reopened;
+    ASSERT_TRUE(reopened.attach_archive(path, true));
+    EXPECT_EQ(reopened.archived_count(), 2u);
+    EXPECT_EQ(reopened.open_count(), 0u);
+    OrderQuery q;
+    q.status = OrderStatusFilter::CLOSED;
+    EXPECT_EQ(ids(reopened.list(q)), (std::vector<std::string>{"b", "a"}));
+
+    reopened.upsert(make_order("d", "AAPL", 400, OrderStatus::EXPIRED));
+    EXPECT_EQ(ids(reopened.list(q)), (std::vector<std::string>{"d", "b", "a"}));
+    std::filesystem::remove(path);
+}
+
+TEST(OrderStoreTest, RestoreToArchiveMarkDropsLaterClosedOrders) {
+    auto path = (std::filesystem::temp_directory_path() / "order_store_mark_test.orders.jsonl").string();
+    std::filesystem::remove(path);
+    {
+        OrderStore store;
+        ASSERT_TRUE(store.attach_archive(path, false));
+        store.upsert(make_order("a", "AAPL", 100, OrderStatus::FILLED));
+        store.upsert(make_order("b", "AAPL", 200));
+        OrderArchive::Mark mark;
+        auto open = store.open_snapshot(&mark);
+        ASSERT_EQ(open.size(), 1u);
+
+        // After the mark: b closes and c comes and goes.
+        ASSERT_TRUE(store.update("b", [](Order& o) { o.status = OrderStatus::CANCELED; }));
+        store.upsert(make_order("c", "MSFT", 300, OrderStatus::FILLED));
+        ASSERT_TRUE(store.update("a", [](Order& o) { o.cumulative_fees = 1.0; }));
+        EXPECT_EQ(store.archived_count(), 3u);
+
+        store.restore(open, mark);
+        EXPECT_EQ(store.archived_count(), 1u);
+        EXPECT_EQ(store.open_count(), 1u);
+        EXPECT_FALSE(store.get("c").has_value());
+        EXPECT_EQ(store.get("b")->status, OrderStatus::ACCEPTED);
+        EXPECT_DOUBLE_EQ(store.get("a")->cumulative_fees, 0.0);
+        EXPECT_EQ(ids(store.list(OrderQuery{})), (std::vector<std::string>{"b", "a"}));
+
+        store.upsert(make_order("d", "MSFT", 400, OrderStatus::EXPIRED));
+        EXPECT_EQ(store.archived_count(), 2u);
+    }
+    // The file was cut back too, so a reattach sees the same history.
+    OrderStore reopened;
+    ASSERT_TRUE(reopened.attach_archive(path, true));
+    EXPECT_EQ(reopened.archived_count(), 2u);
+    EXPECT_EQ(ids(reopened.list(OrderQuery{})), (std::vector<std::string>{"d", "a"}));
+    EXPECT_DOUBLE_EQ(reopened.get("a")->cumulative_fees, 0.0);
+    std::filesystem::remove(path);
+}
+
+TEST(OrderStoreTest, ArchiveWithoutFileSpillsToTemporaryFile) {
+    OrderArchive archive;
+    uint64_t seq = 1;
+    auto append_next = [&]() {
+        archive.append(make_order("o" + std::to_string(seq), "AAPL", static_cast<int64_t>(seq),
+                                  OrderStatus::FILLED), seq);
+        ++seq;
+    };
+    while (seq <= 100) append_next();
+    const auto mark = archive.mark();
+    EXPECT_FALSE(archive.on_disk());
+    while (archive.bytes() < OrderArchive::kSpillBytes) append_next();
+    append_next();
+    EXPECT_TRUE(archive.on_disk());
+    EXPECT_EQ(archive.size(), seq - 1);
+    EXPECT_EQ(archive.get("o3")->status, OrderStatus::FILLED);
+    EXPECT_EQ(archive.get("o" + std::to_string(seq - 1))->submitted_at_ns, static_cast<int64_t>(seq - 1));
+
+    // Rolling back across the spill keeps the records before the mark.
+    archive.truncate(mark);
+    EXPECT_EQ(archive.size(), 100u);
+    EXPECT_TRUE(archive.get("o100").has_value());
+    EXPECT_FALSE(archive.get("o101").has_value());
+
+    archive.clear();
+    EXPECT_FALSE(archive.on_disk());
+}
+
+TEST(OrderStoreTest, ArchiveSpanningManyPagesStaysQueryable) {
+    OrderArchive archive;
+    const uint64_t n = OrderArchive::kPageRecords * 3 + 10;
+    for (uint64_t i = 1; i <= n; ++i) {
+        // Close out of submission order so page key spans overlap.
+        int64_t ts = static_cast<int64_t>(i * 10 + (i % 7) * 1000);
+        archive.append(make_order("o" + std::to_string(i), i % 2 ? "AAPL" : "MSFT", ts, OrderStatus::FILLED), i);
+    }
+    EXPECT_EQ(archive.size(), n);
+    EXPECT_EQ(archive.page_count(), 4u);
+
+    ASSERT_TRUE(archive.get("o7").has_value());
+    EXPECT_EQ(archive.get_by_client_id("c_o1000")->id, "o1000");
+    EXPECT_FALSE(archive.get("missing").has_value());
+
+    std::vector<uint64_t> seqs;
+    OrderArchive::Key prev{std::numeric_limits<int64_t>::max(), 0};
+    std::vector<std::string> msft = {"MSFT"};
+    for (auto scan = archive.scan({}, msft, true); !scan.done(); scan.next()) {
+        EXPECT_LT(scan.key(), prev);
+        EXPECT_EQ(scan.order().symbol, "MSFT");
+        prev = scan.key();
+        seqs.push_back(scan.key().second);
+    }
+    EXPECT_EQ(seqs.size(), n / 2);
+
+    // Rewriting and removing records keeps the live count exact.
+    auto o5 = *archive.get("o5");
+    o5.cumulative_fees = 1.5;
+    archive.append(o5, 5);
+    EXPECT_DOUBLE_EQ(archive.get("o5")->cumulative_fees, 1.5);
+    EXPECT_TRUE(archive.remove("o6"));
+    EXPECT_FALSE(archive.get("o6").has_value());
+    EXPECT_EQ(archive.size(), n - 1);
+    size_t visited = 0;
+    for (auto scan = archive.scan({}, {}, false); !scan.done(); scan.next()) ++visited;
+    EXPECT_EQ(visited, n - 1);
+}
+
+TEST(OrderStoreTest, PagesThroughArchiveAndHotTierInOrder) {
+    OrderStore store;
+    const int n = static_cast<int>(OrderArchive::kPageRecords) * 2 + 5;
+    for (int i = 1; i <= n; ++i) {
+        store.upsert(make_order("o" + std::to_string(i), "AAPL", i * 10,
+                                i % 3 ? OrderStatus::CANCELED : OrderStatus::ACCEPTED));
+    }
+    OrderQuery q;
+    q.limit = 100;
+    std::vector<std::string> seen;
+    do {
+        auto page = store.list(q);
+        for (const auto& o : page.orders) seen.push_back(o.id);
+        q.cursor = page.next;
+    } while (q.cursor);
+    ASSERT_EQ(seen.size(), static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i) EXPECT_EQ(seen[i], "o" + std::to_string(n - i));
+}
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "../src/core/pace_monitor.hpp"
+
+using namespace broker_sim;
+
+namespace {
+
+constexpr int64_t kSec = 1'000'000'000;
+
+PaceObservation at(int64_t wall_s, int64_t sim_s, uint64_t events, int64_t lag_ns, size_t depth) {
+    PaceObservation obs;
+    obs.steady_ns = wall_s * kSec;
+    obs.unix_ms = wall_s * 1000;
+    obs.sim_ns = sim_s * kSec;
+    obs.events_processed = events;
+    obs.lag_ns = lag_ns;
+    obs.queue_depth = depth;
+    return obs;
+}
+
+} // namespace
+
+TEST(PaceMonitorTest, FirstObservationHasNoRate) {
+    PaceMonitor monitor;
+    auto report = monitor.observe(at(100, 0, 0, 0, 7));
+    EXPECT_EQ(report.window_ns, 0);
+    EXPECT_EQ(report.achieved_speed, 0.0);
+    EXPECT_EQ(report.queue_depth, 7u);
+    ASSERT_EQ(report.queue_depth_history.size(), 1u);
+    EXPECT_EQ(report.queue_depth_history[0], std::make_pair(int64_t{100'000}, size_t{7}));
+}
+
+TEST(PaceMonitorTest, ComparesAgainstSampleAboutFiveSecondsBack) {
+    PaceMonitor monitor;
+    // 1s ticks, 10x speed target but only 8 simulated seconds per wall second.
+    for (int64_t t = 0; t <= 10; ++t) {
+        monitor.observe(at(t, t * 8, static_cast<uint64_t>(t) * 1000, t * 200'000'000, static_cast<size_t>(t)));
+    }
+    auto report = monitor.observe(at(11, 88, 11'000, int64_t{11} * 200'000'000, 11));
+    EXPECT_EQ(report.window_ns, 5 * kSec);
+    EXPECT_DOUBLE_EQ(report.achieved_speed, 8.0);
+    EXPECT_DOUBLE_EQ(report.events_per_sec, 1000.0);
+    EXPECT_EQ(report.lag_growth_ns, 1'000'000'000);
+    EXPECT_TRUE(report.falling_behind);
+    EXPECT_EQ(report.queue_depth_history.size(), 12u);
+    EXPECT_EQ(report.queue_depth_history.back().second, 11u);
+
+    // Sub-second re-queries reuse the window without adding history.
+    auto again = monitor.observe(at(11, 88, 11'000, int64_t{11} * 200'000'000, 11));
+    EXPECT_EQ(again.queue_depth_history.size(), 12u);
+}
+
+TEST(PaceMonitorTest, BackwardJumpReportsNoProgressAndHistoryIsBounded) {
+    PaceMonitor monitor;
+    monitor.observe(at(0, 1000, 500, 0, 0));
+    auto report = monitor.observe(at(2, 10, 0, 0, 0));
+    EXPECT_EQ(report.achieved_speed, 0.0);
+    EXPECT_EQ(report.events_per_sec, 0.0);
+    EXPECT_FALSE(report.falling_behind);
+
+    for (int64_t t = 3; t < 3 + static_cast<int64_t>(PaceMonitor::kHistory) * 2; ++t) {
+        report = monitor.observe(at(t, t, 0, 0, 0));
+    }
+    EXPECT_EQ(report.queue_depth_history.size(), PaceMonitor::kHistory);
+}
@@ -1,6 +1,11 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <future>
+#include <map>
+#include <tuple>
 #include <chrono>
 #include "../src/core/session_manager.hpp"
 #include "../src/core/data_source_stub.hpp"
@@ -149,6 +154,21 @@ public:
         return {};
     }
 
+    void stream_aggregate_bars(const std::vector<std::string>& symbols,
+                               Timestamp start_time,
+                               Timestamp end_time,
+                               int,
+                               const std::string& timespan,
+                               const std::function<void(const BarRecord&)>& cb) override {
+        if (timespan != "day") return;
+        ++daily_bar_queries;
+        for (const auto& bar : daily_bars) {
+            if (bar.timestamp < start_time || bar.timestamp >= end_time) continue;
+            if (std::find(symbols.begin(), symbols.end(), bar.symbol) == symbols.end()) continue;
+            cb(bar);
+        }
+    }
+
     std::optional<PriceTargetRecord> get_price_targets(const std::string&) override {
         return std::nullopt;
     }
@@ -160,6 +180,9 @@ public:
         return {};
     }
 
+    std::vector<BarRecord> daily_bars;   // oldest first, as the daily table streams them
+    std::atomic<int> daily_bar_queries{0};
+
 private:
     std::vector<MarketEvent> events_;
 };
@@ -897,3 +920,1278 @@ TEST(SessionManagerTest, MarketImpactAdjustsFillPrice) {
     EXPECT_NEAR(fill_price, 100.05, 1e-6);
     mgr.stop_session(session->id);
 }
+
+namespace {
+
+class BuyOnFirstQuoteStrategy : public Strategy {
+public:
+    void on_start(StrategyContext&) override { ++starts; }
+    void on_quote(StrategyContext& ctx, const std::string& symbol, Timestamp, const QuoteData&) override {
+        ++quotes;
+        if (!order_id.empty()) return;
+        Order order;
+        order.symbol = symbol;
+        order.side = OrderSide::BUY;
+        order.type = OrderType::MARKET;
+        order.tif = TimeInForce::DAY;
+        order.qty = 5.0;
+        order_id = ctx.submit_order(order);
+    }
+    void on_fill(StrategyContext& ctx, const std::string&, Timestamp, const OrderData& fill) override {
+        filled_qty = fill.filled_qty;
+        position = ctx.position_qty("AAPL");
+    }
+    void on_stop(StrategyContext&) override { ++stops; }
+
+    std::atomic<int> starts{0};
+    std::atomic<int> stops{0};
+    std::atomic<int> quotes{0};
+    std::string order_id;
+    double filled_qty{0.0};
+    double position{0.0};
+};
+
+} // namespace
+
+TEST(SessionManagerTest, InProcessStrategyTradesWithoutHttp) {
+    std::vector<MarketEvent> events;
+    for (int i = 1; i <= 3; ++i) {
+        MarketEvent ev;
+        ev.timestamp = make_ts(i * 1'000'000);
+        ev.type = MarketEventType::QUOTE;
+        ev.quote = QuoteRecord{ev.timestamp, "AAPL", 100.0, 100, 101.0, 100, 1, 1, 1};
+        events.push_back(ev);
+    }
+
+    auto ds = std::make_shared<FakeDataSource>(events);
+    SessionManager mgr(ds);
+
+    SessionConfig cfg;
+    cfg.symbols = {"AAPL"};
+    cfg.start_time = make_ts(0);
+    cfg.end_time = make_ts(10'000'000);
+    cfg.speed_factor = 0.0;
+    auto session = mgr.create_session(cfg);
+
+    auto strategy = std::make_shared<BuyOnFirstQuoteStrategy>();
+    ASSERT_TRUE(mgr.attach_strategy(session->id, strategy));
+    EXPECT_FALSE(mgr.attach_strategy("missing", strategy));
+
+    mgr.start_session(session->id);
+    ASSERT_TRUE(wait_until([&] { return strategy->stops.load() == 1; }, std::chrono::seconds(2)));
+
+    EXPECT_EQ(strategy->starts.load(), 1);
+    EXPECT_EQ(strategy->quotes.load(), 3);
+    ASSERT_FALSE(strategy->order_id.empty());
+    EXPECT_DOUBLE_EQ(strategy->filled_qty, 5.0);
+    EXPECT_DOUBLE_EQ(strategy->position, 5.0);
+    auto order = mgr.get_order(session->id, strategy->order_id);
+    ASSERT_TRUE(order.has_value());
+    EXPECT_EQ(order->status, OrderStatus::FILLED);
+
+    mgr.stop_session(session->id);
+    EXPECT_EQ(strategy->stops.load(), 1);
+}
+
+TEST(SessionManagerTest, StrategyCanBeSwappedWhileTheSessionRuns) {
+    constexpr int kQuotes = 2000;
+    std::vector<MarketEvent> events;
+    for (int i = 1; i <= kQuotes; ++i) {
+        MarketEvent ev;
+        ev.timestamp = make_ts(i * 1'000);
+        ev.type = MarketEventType::QUOTE;
+        ev.quote = QuoteRecord{ev.timestamp, "AAPL", 100.0, 100, 101.0, 100, 1, 1, 1};
+        events.push_back(ev);
+    }
+
+    auto ds = std::make_shared<FakeDataSource>(events);
+    SessionManager mgr(ds);
+
+    SessionConfig cfg;
+    cfg.symbols = {"AAPL"};
+    cfg.start_time = make_ts(0);
+    cfg.end_time = make_ts(10'000'000);
+    cfg.speed_factor = 0.0;
+    auto session = mgr.create_session(cfg);
+
+    std::vector<std::shared_ptr<BuyOnFirstQuoteStrategy>> strategies;
+    for (int i = 0; i < 4; ++i) strategies.push_back(std::make_shared<BuyOnFirstQuoteStrategy>());
+    ASSERT_TRUE(mgr.attach_strategy(session->id, strategies[0]));
+    mgr.start_session(session->id);
+
+    // The worker dispatches every quote while attach/detach replaces the strategy.
+    for (int i = 0; session->status == SessionStatus::RUNNING && i < 10'000; ++i) {
+        mgr.attach_strategy(session->id, i % 5 == 4 ? nullptr : strategies[i % 4]);
+    }
+    mgr.stop_session(session->id);
+
+    int quotes = 0;
+    for (const auto& s : strategies) quotes += s->quotes.load();
+    EXPECT_LE(quotes, kQuotes);
+}
+
+TEST(SessionManagerTest, BatchModeRunsToCompletionWithoutPerEventTimeNotifications) {
+    constexpr int kQuotes = 50;
+    std::vector<MarketEvent> events;
+    for (int i = 1; i <= kQuotes; ++i) {
+        MarketEvent ev;
+        ev.timestamp = make_ts(i * 100'000);
+        ev.type = MarketEventType::QUOTE;
+        ev.quote = QuoteRecord{ev.timestamp, "AAPL", 100.0, 100, 101.0, 100, 1, 1, 1};
+        events.push_back(ev);
+    }
+
+    auto ds = std::make_shared<FakeDataSource>(events);
+    SessionManager mgr(ds);
+
+    SessionConfig cfg;
+    cfg.symbols = {"AAPL"};
+    cfg.start_time = make_ts(0);
+    cfg.end_time = make_ts(10'000'000);
+    cfg.batch_mode = true;
+    auto session = mgr.create_session(cfg);
+
+    std::atomic<int> notifications{0};
+    session->time_engine->add_listener([&](Timestamp) { ++notifications; });
+
+    Order order;
+    order.symbol = "AAPL";
+    order.side = OrderSide::BUY;
+    order.type = OrderType::MARKET;
+    order.tif = TimeInForce::DAY;
+    order.qty = 10.0;
+    auto order_id = mgr.submit_order(session->id, order);
+    ASSERT_FALSE(order_id.empty());
+
+    mgr.start_session(session->id);
+    ASSERT_TRUE(wait_until([&] { return session->status == SessionStatus::COMPLETED; },
+                           std::chrono::seconds(2)));
+
+    EXPECT_EQ(session->events_processed.load(), static_cast<uint64_t>(kQuotes));
+    EXPECT_EQ(session->time_engine->current_time(), cfg.end_time);
+    EXPECT_LT(notifications.load(), 5);
+    auto filled = mgr.get_order(session->id, order_id);
+    ASSERT_TRUE(filled.has_value());
+    EXPECT_EQ(filled->status, OrderStatus::FILLED);
+
+    mgr.stop_session(session->id);
+}
+
+TEST(SessionManagerTest, BoundedBatchSessionProcessesEveryEvent) {
+    constexpr int kQuotes = 500;
+    std::vector<MarketEvent> events;
+    for (int i = 1; i <= kQuotes; ++i) {
+        MarketEvent ev;
+        ev.timestamp = make_ts(i * 10'000);
+        ev.type = MarketEventType::QUOTE;
+        ev.quote = QuoteRecord{ev.timestamp, "AAPL", 100.0, 100, 101.0, 100, 1, 1, 1};
+        events.push_back(ev);
+    }
+
+    auto ds = std::make_shared<FakeDataSource>(events);
+    SessionManager mgr(ds);
+
+    SessionConfig cfg;
+    cfg.symbols = {"AAPL"};
+    cfg.start_time = make_ts(0);
+    cfg.end_time = make_ts(10'000'000);
+    cfg.batch_mode = true;
+    cfg.queue_capacity = 8;
+    auto session = mgr.create_session(cfg);
+
+    mgr.start_session(session->id);
+    ASSERT_TRUE(wait_until([&] { return session->status == SessionStatus::COMPLETED; },
+                           std::chrono::seconds(5)));
+
+    EXPECT_EQ(session->events_processed.load(), static_cast<uint64_t>(kQuotes));
+    EXPECT_EQ(session->events_dropped.load(), 0u);
+
+    mgr.stop_session(session->id);
+}
+
+TEST(SessionManagerTest, JumpInBoundedBatchSessionDropsNoEvents) {
+    constexpr int kQuotes = 500;
+    std::vector<MarketEvent> events;
+    for (int i = 1; i <= kQuotes; ++i) {
+        MarketEvent ev;
+        ev.timestamp = make_ts(i * 10'000);
+        ev.type = MarketEventType::QUOTE;
+        ev.quote = QuoteRecord{ev.timestamp, "AAPL", 100.0, 100, 101.0, 100, 1, 1, 1};
+        events.push_back(ev);
+    }
+
+    auto ds = std::make_shared<FakeDataSource>(events);
+    SessionManager mgr(ds);
+
+    SessionConfig cfg;
+    cfg.symbols = {"AAPL"};
+    cfg.start_time = make_ts(0);
+    cfg.end_time = make_ts(10'000'000);
+    cfg.batch_mode = true;
+    cfg.queue_capacity = 8;
+    auto session = mgr.create_session(cfg);
+
+    // A jump restarts the feed the way start_session picked it: a bounded
+    // batch queue is filled from a thread that waits for room, not in one
+    // burst that overflows it.
+    session->status = SessionStatus::RUNNING;
+    mgr.jump_to(session->id, make_ts(2'000'000));
+    ASSERT_TRUE(wait_until([&] { return session->status == SessionStatus::COMPLETED; },
+                           std::chrono::seconds(5)));
+
+    // The fake streams every event whatever the window, so all of them count.
+    EXPECT_EQ(session->events_processed.load(), static_cast<uint64_t>(kQuotes));
+    EXPECT_EQ(session->events_dropped.load(), 0u);
+
+    mgr.stop_session(session->id);
+}
+
+TEST(SessionManagerTest, UnboundedBatchSessionPreloadsOneWindowAtATime) {
+    // One quote every 10 s over an hour: twelve 300 s preload windows.
+    constexpr int kQuotes = 360;
+    std::vector<MarketEvent> events;
+    for (int i = 0; i < kQuotes; ++i) {
+        MarketEvent ev;
+        ev.timestamp = make_ts(static_cast<int64_t>(i) * 10'000'000'000);
+        ev.type = MarketEventType::QUOTE;
+        ev.quote = QuoteRecord{ev.timestamp, "AAPL", 100.0, 100, 101.0, 100, 1, 1, 1};
+        events.push_back(ev);
+    }
+
+    auto ds = std::make_shared<FakeDataSource>(events);
+    SessionManager mgr(ds);
+
+    SessionConfig cfg;
+    cfg.symbols = {"AAPL"};
+    cfg.start_time = make_ts(0);
+    cfg.end_time = make_ts(3'600'000'000'000);
+    cfg.batch_mode = true;
+    auto session = mgr.create_session(cfg);
+
+    mgr.start_session(session->id);
+    ASSERT_TRUE(wait_until([&] { return session->status == SessionStatus::COMPLETED; },
+                           std::chrono::seconds(5)));
+
+    // The fake source returns every event for any range; each must be fed once.
+    EXPECT_EQ(session->events_processed.load(), static_cast<uint64_t>(kQuotes));
+    EXPECT_EQ(session->time_engine->current_time(), cfg.end_time);
+
+    mgr.stop_session(session->id);
+}
+
+TEST(SessionManagerTest, SampledEventsRecordPipelineStageSpans) {
+    constexpr int kQuotes = 50;
+    std::vector<MarketEvent> events;
+    for (int i = 1; i <= kQuotes; ++i) {
+        MarketEvent ev;
+        ev.timestamp = make_ts(i * 100'000);
+        ev.type = MarketEventType::QUOTE;
+        ev.quote = QuoteRecord{ev.timestamp, "AAPL", 100.0, 100, 101.0, 100, 1, 1, 1};
+        events.push_back(ev);
+    }
+
+    auto ds = std::make_shared<FakeDataSource>(events);
+    SessionManager mgr(ds);
+
+    SessionConfig cfg;
+    cfg.symbols = {"AAPL"};
+    cfg.start_time = make_ts(0);
+    cfg.end_time = make_ts(10'000'000);
+    cfg.batch_mode = true;
+    auto session = mgr.create_session(cfg);
+    EXPECT_EQ(session->tracer.sample_every(), 0u);
+    session->tracer.set_sample_every(5);
+
+    mgr.start_session(session->id);
+    ASSERT_TRUE(wait_until([&] { return session->status == SessionStatus::COMPLETED; },
+                           std::chrono::seconds(2)));
+
+    EXPECT_EQ(session->tracer.recorded(), static_cast<uint64_t>(kQuotes / 5));
+    auto stages = session->tracer.stage_summary();
+    for (const char* stage : {"enqueue", "queue", "pacing", "wal", "match", "callbacks", "total"}) {
+        EXPECT_EQ(stages[stage]["count"].get<uint64_t>(), static_cast<uint64_t>(kQuotes / 5)) << stage;
+    }
+    EXPECT_EQ(stages["ws_send"]["count"].get<uint64_t>(), 0u);
+
+    // Only the first two sampled quotes (sim 100us and 600us) fall in the window.
+    auto trace = session->tracer.chrome_trace(session->id, 0, 1'000'000);
+    int match_slices = 0;
+    for (const auto& ev : trace["traceEvents"]) {
+        if (ev.value("name", "") == "match") {
+            ++match_slices;
+            EXPECT_EQ(ev["ph"], "X");
+            EXPECT_EQ(ev["args"]["symbol"], "AAPL");
+        }
+    }
+    EXPECT_EQ(match_slices, 2);
+
+    mgr.stop_session(session->id);
+}
+
+TEST(SessionManagerTest, BatchSessionsShareSchedulerPool) {
+    constexpr int kSessions = 32;
+    constexpr int kQuotes = 200;
+    std::vector<MarketEvent> events;
+    for (int i = 1; i <= kQuotes; ++i) {
+        MarketEvent ev;
+        ev.timestamp = make_ts(i * 10'000);
+        ev.type = MarketEventType::QUOTE;
+        ev.quote = QuoteRecord{ev.timestamp, "AAPL", 100.0, 100, 101.0, 100, 1, 1, 1};
+        events.push_back(ev);
+    }
+
+    ExecutionConfig exec;
+    exec.scheduler_threads = 2;
+    exec.scheduler_slice_events = 16;
+    SessionManager mgr(std::make_shared<FakeDataSource>(events), exec);
+
+    std::vector<std::shared_ptr<Session>> sessions;
+    for (int i = 0; i < kSessions; ++i) {
+        SessionConfig cfg;
+        cfg.symbols = {"AAPL"};
+        cfg.start_time = make_ts(0);
+        cfg.end_time = make_ts(10'000'000);
+        cfg.batch_mode = true;
+        sessions.push_back(mgr.create_session(cfg));
+    }
+    for (const auto& s : sessions) {
+        mgr.start_session(s->id);
+        EXPECT_EQ(s->worker_thread, nullptr);
+    }
+
+    ASSERT_TRUE(wait_until([&] {
+        for (const auto& s : sessions) {
+            if (s->status != SessionStatus::COMPLETED) return false;
+        }
+        return true;
+    }, std::chrono::seconds(5)));
+    for (const auto& s : sessions) {
+        EXPECT_EQ(s->events_processed.load(), static_cast<uint64_t>(kQuotes));
+    }
+
+    // Stopping a finished pooled session must not block.
+    mgr.stop_session(sessions.front()->id);
+}
+
+TEST(SessionManagerTest, SweepSharesOneDataPassAcrossVariants) {
+    constexpr int kQuotes = 300;
+    std::vector<MarketEvent> events;
+    for (int i = 1; i <= kQuotes; ++i) {
+        MarketEvent ev;
+        ev.timestamp = make_ts(i * 10'000);
+        ev.type = MarketEventType::QUOTE;
+        ev.quote = QuoteRecord{ev.timestamp, "AAPL", 100.0, 100, 101.0, 100, 1, 1, 1};
+        events.push_back(ev);
+    }
+
+    ExecutionConfig exec;
+    exec.scheduler_threads = 2;
+    exec.scheduler_slice_events = 64;
+    SessionManager mgr(std::make_shared<FakeDataSource>(events), exec);
+
+    SessionConfig base;
+    base.symbols = {"AAPL"};
+    base.start_time = make_ts(0);
+    base.end_time = make_ts(10'000'000);
+
+    std::vector<SweepVariant> variants(3);
+    variants[0].label = "no_commission";
+    variants[1].label = "commission";
+    variants[1].fees = FeeConfig{};
+    variants[1].fees->per_share_commission = 0.005;
+    variants[2].execution = exec;
+
+    auto group = mgr.create_sweep(base, variants);
+    ASSERT_EQ(group->sessions.size(), 3u);
+    EXPECT_EQ(mgr.get_sweep(group->id), group);
+    EXPECT_EQ(group->labels[2], "variant_2");
+
+    ASSERT_TRUE(wait_until([&] { return group->done.load(); }, std::chrono::seconds(5)));
+    EXPECT_EQ(group->events_read.load(), static_cast<uint64_t>(kQuotes));
+    for (const auto& s : group->sessions) {
+        EXPECT_TRUE(s->config.batch_mode);
+        EXPECT_EQ(s->status, SessionStatus::COMPLETED);
+        EXPECT_EQ(s->events_processed.load(), static_cast<uint64_t>(kQuotes));
+        EXPECT_EQ(s->worker_thread, nullptr);
+    }
+    ASSERT_TRUE(group->sessions[1]->config.fees.has_value());
+    EXPECT_DOUBLE_EQ(group->sessions[1]->config.fees->per_share_commission, 0.005);
+    EXPECT_FALSE(group->sessions[0]->config.fees.has_value());
+
+    EXPECT_THROW(mgr.create_sweep(base, {}), std::invalid_argument);
+}
+
+TEST(SessionManagerTest, ForkBranchesStateAtCurrentEvent) {
+    int64_t t1 = 1'000'000;
+    int64_t t2 = 51'000'000;
+    MarketEvent ev1;
+    ev1.timestamp = make_ts(t1);
+    ev1.type = MarketEventType::QUOTE;
+    ev1.quote = QuoteRecord{ev1.timestamp, "MSFT", 200.0, 100, 201.0, 100, 1, 1, 1};
+    MarketEvent ev2;
+    ev2.timestamp = make_ts(t2);
+    ev2.type = MarketEventType::QUOTE;
+    ev2.quote = QuoteRecord{ev2.timestamp, "MSFT", 202.0, 100, 203.0, 100, 1, 1, 1};
+
+    auto ds = std::make_shared<FakeDataSource>(std::vector<MarketEvent>{ev1, ev2});
+    SessionManager mgr(ds);
+
+    SessionConfig cfg;
+    cfg.symbols = {"MSFT"};
+    cfg.start_time = make_ts(0);
+    cfg.end_time = make_ts(100'000'000);
+    cfg.speed_factor = 1.0;
+    auto parent = mgr.create_session(cfg);
+
+    std::mutex mu;
+    std::condition_variable cv;
+    std::unordered_map<std::string, std::vector<int64_t>> quotes;
+    mgr.add_event_callback([&](const std::string& sid, const Event& e) {
+        if (e.event_type != EventType::QUOTE) return;
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            quotes[sid].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                e.timestamp.time_since_epoch()).count());
+            if (sid == parent->id && quotes[sid].size() == 1) {
+                mgr.pause_session(parent->id);
+            }
+        }
+        cv.notify_all();
+    });
+
+    EXPECT_THROW(mgr.fork_session(parent->id), std::invalid_argument);
+    mgr.start_session(parent->id);
+    {
+        std::unique_lock<std::mutex> lock(mu);
+        ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(2), [&] { return quotes[parent->id].size() == 1; }));
+    }
+
+    Order order;
+    order.symbol = "MSFT";
+    order.side = OrderSide::BUY;
+    order.type = OrderType::MARKET;
+    order.tif = TimeInForce::DAY;
+    order.qty = 10.0;
+    ASSERT_FALSE(mgr.submit_order(parent->id, order).empty());
+
+    auto child = mgr.fork_session(parent->id, std::string("branch"));
+    ASSERT_EQ(child->id, "branch");
+    EXPECT_EQ(child->forked_from, parent->id);
+    EXPECT_EQ(child->status, SessionStatus::PAUSED);
+    EXPECT_EQ(child->config.start_time, make_ts(t1));
+    EXPECT_EQ(child->time_engine->current_time(), parent->time_engine->current_time());
+    EXPECT_DOUBLE_EQ(child->account_manager->positions().at("MSFT").qty, 10.0);
+    EXPECT_TRUE(child->matching_engine->get_nbbo("MSFT").has_value());
+    EXPECT_THROW(mgr.fork_session(parent->id, std::string("branch")), std::invalid_argument);
+
+    // Trading on the branch leaves the parent untouched.
+    order.qty = 5.0;
+    ASSERT_FALSE(mgr.submit_order(child->id, order).empty());
+    EXPECT_DOUBLE_EQ(child->account_manager->positions().at("MSFT").qty, 15.0);
+    EXPECT_DOUBLE_EQ(parent->account_manager->positions().at("MSFT").qty, 10.0);
+
+    // The branch resumes after the parent's cursor: ev1 is not replayed.
+    mgr.resume_session(child->id);
+    {
+        std::unique_lock<std::mutex> lock(mu);
+        ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(2), [&] { return !quotes[child->id].empty(); }));
+        EXPECT_EQ(quotes[child->id].front(), t2);
+        EXPECT_EQ(quotes[parent->id].size(), 1u);
+    }
+
+    mgr.stop_session(child->id);
+    mgr.stop_session(parent->id);
+}
+
+TEST(SessionManagerTest, OrdersWaitForTheSessionStepLikeFork) {
+    MarketEvent ev;
+    ev.timestamp = make_ts(1'000'000);
+    ev.type = MarketEventType::QUOTE;
+    ev.quote = QuoteRecord{ev.timestamp, "MSFT", 200.0, 100, 201.0, 100, 1, 1, 1};
+    SessionManager mgr(std::make_shared<FakeDataSource>(std::vector<MarketEvent>{ev}));
+
+    SessionConfig cfg;
+    cfg.symbols = {"MSFT"};
+    cfg.start_time = make_ts(0);
+    cfg.end_time = make_ts(100'000'000);
+    auto session = mgr.create_session(cfg);
+
+    Order order;
+    order.symbol = "MSFT";
+    order.side = OrderSide::BUY;
+    order.type = OrderType::LIMIT;
+    order.tif = TimeInForce::GTC;
+    order.qty = 1.0;
+    order.limit_price = 100.0;
+
+    // While a step (a market event, or fork's snapshot) holds the lock, an
+    // order or cancel must not touch the book or the order store.
+    std::unique_lock<std::mutex> step(session->step_mutex);
+    auto submitted = std::async(std::launch::async, [&] { return mgr.submit_order(session->id, order); });
+    EXPECT_EQ(submitted.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+    EXPECT_EQ(session->orders.size(), 0u);
+    step.unlock();
+    const auto id = submitted.get();
+    ASSERT_FALSE(id.empty());
+    EXPECT_EQ(session->orders.open_count(), 1u);
+
+    step.lock();
+    auto canceled = std::async(std::launch::async, [&] { return mgr.cancel_order(session->id, id); });
+    EXPECT_EQ(canceled.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+    EXPECT_EQ(session->matching_engine->get_pending_orders().size(), 1u);
+    step.unlock();
+    EXPECT_TRUE(canceled.get());
+    EXPECT_EQ(session->orders.open_count(), 0u);
+}
+
+TEST(SessionManagerTest, OrderDataLookupsRunOutsideTheSessionStep) {
+    // Decision-time quotes come from the data source; the query must not hold
+    // the step, or a slow lookup would stall the session worker behind it.
+    class ProbeDataSource : public FakeDataSource {
+    public:
+        ProbeDataSource() : FakeDataSource({}) {}
+        std::vector<QuoteRecord> get_quotes(const std::string& symbol,
+                                            Timestamp from,
+                                            Timestamp,
+                                            size_t) override {
+            ++queries;
+            if (session && session->step_mutex.try_lock()) {
+                ++unlocked_queries;
+                session->step_mutex.unlock();
+            }
+            return {QuoteRecord{from, symbol, 100.0, 100, 100.5, 100, 1, 1, 1}};
+        }
+        std::shared_ptr<Session> session;
+        std::atomic<int> queries{0};
+        std::atomic<int> unlocked_queries{0};
+    };
+    auto ds = std::make_shared<ProbeDataSource>();
+    SessionManager mgr(ds);
+
+    SessionConfig cfg;
+    cfg.symbols = {"AAPL"};
+    cfg.start_time = make_ts(0);
+    cfg.end_time = make_ts(10'000'000);
+    auto session = mgr.create_session(cfg);
+    session->status = SessionStatus::RUNNING;
+    ds->session = session;
+
+    Order order;
+    order.symbol = "AAPL";
+    order.side = OrderSide::BUY;
+    order.type = OrderType::MARKET;
+    order.tif = TimeInForce::DAY;
+    order.qty = 1.0;
+    order.decision_time_ns = 1'000'000;
+
+    ASSERT_FALSE(mgr.submit_order(session->id, order).empty());
+    const auto ids = mgr.submit_orders(session->id, {order, order});
+    ASSERT_EQ(ids.size(), 2u);
+    EXPECT_FALSE(ids[0].empty());
+    EXPECT_FALSE(ids[1].empty());
+    EXPECT_EQ(ds->queries.load(), 3);
+    EXPECT_EQ(ds->unlocked_queries.load(), 3);
+    for (const auto& [id, o] : mgr.get_orders(session->id)) {
+        EXPECT_EQ(o.status, OrderStatus::FILLED) << id;
+        EXPECT_DOUBLE_EQ(o.last_fill_price, 100.5) << id;
+    }
+}
+
+TEST(SessionManagerTest, SeekRestoresNearestSnapshotAndReplaysGap) {
+    constexpr int64_t kSecond = 1'000'000'000;
+    std::vector<MarketEvent> events;
+    for (int i = 1; i <= 20; ++i) {
+        MarketEvent ev;
+        ev.timestamp = make_ts(i * kSecond);
+        ev.type = MarketEventType::QUOTE;
+        ev.quote = QuoteRecord{ev.timestamp, "AAPL", 100.0 + i, 100, 101.0 + i, 100, 1, 1, 1};
+        events.push_back(ev);
+    }
+
+    ExecutionConfig exec;
+    exec.seek_snapshot_interval_seconds = 5;
+    SessionManager mgr(std::make_shared<FakeDataSource>(events), exec);
+
+    SessionConfig cfg;
+    cfg.symbols = {"AAPL"};
+    cfg.start_time = make_ts(0);
+    cfg.end_time = make_ts(30 * kSecond);
+    cfg.batch_mode = true;
+    auto session = mgr.create_session(cfg);
+
+    Order order;
+    order.symbol = "AAPL";
+    order.side = OrderSide::BUY;
+    order.type = OrderType::MARKET;
+    order.tif = TimeInForce::DAY;
+    order.qty = 10.0;
+    ASSERT_FALSE(mgr.submit_order(session->id, order).empty());
+
+    mgr.start_session(session->id);
+    ASSERT_TRUE(wait_until([&] { return session->status == SessionStatus::COMPLETED; },
+                           std::chrono::seconds(5)));
+    {
+        std::lock_guard<std::mutex> lock(session->snapshot_mutex);
+        EXPECT_GE(session->snapshots.size(), 4u);
+    }
+
+    // Snapshot at the 10s cursor; only the 11s and 12s quotes are replayed.
+    auto back = mgr.seek_to(session->id, make_ts(12 * kSecond));
+    ASSERT_TRUE(back.has_value());
+    EXPECT_EQ(back->snapshot_time, make_ts(10 * kSecond));
+    EXPECT_EQ(back->replayed_events, 2u);
+    EXPECT_EQ(session->status, SessionStatus::STOPPED);
+    EXPECT_EQ(session->time_engine->current_time(), make_ts(12 * kSecond));
+    EXPECT_EQ(session->last_event_ns.load(), 12 * kSecond);
+    EXPECT_EQ(session->events_processed.load(), 12u);
+    EXPECT_DOUBLE_EQ(session->account_manager->positions().at("AAPL").qty, 10.0);
+    const double equity_at_12 = session->account_manager->state().equity;
+
+    // Scrub to the start and back: the state at 12s is reproduced.
+    auto early = mgr.seek_to(session->id, make_ts(3 * kSecond));
+    ASSERT_TRUE(early.has_value());
+    EXPECT_EQ(early->replayed_events, 3u);
+    EXPECT_EQ(session->events_processed.load(), 3u);
+
+    auto again = mgr.seek_to(session->id, make_ts(12 * kSecond));
+    ASSERT_TRUE(again.has_value());
+    EXPECT_EQ(session->events_processed.load(), 12u);
+    EXPECT_DOUBLE_EQ(session->account_manager->state().equity, equity_at_12);
+    EXPECT_DOUBLE_EQ(session->account_manager->positions().at("AAPL").qty, 10.0);
+
+    EXPECT_FALSE(mgr.seek_to("missing", make_ts(0)).has_value());
+}
+
+TEST(SessionManagerTest, SeekReplaysUnderTheStepAndResumesTheSessionFeed) {
+    constexpr int kQuotes = 500;
+    std::vector<MarketEvent> events;
+    for (int i = 1; i <= kQuotes; ++i) {
+        MarketEvent ev;
+        ev.timestamp = make_ts(i * 10'000);
+        ev.type = MarketEventType::QUOTE;
+        ev.quote = QuoteRecord{ev.timestamp, "AAPL", 100.0, 100, 101.0, 100, 1, 1, 1};
+        events.push_back(ev);
+    }
+    // Records whether the seek's replay stream runs inside the session step.
+    class ProbeDataSource : public FakeDataSource {
+    public:
+        using FakeDataSource::FakeDataSource;
+        void stream_events(const std::vector<std::string>& symbols,
+                           Timestamp from,
+                           Timestamp to,
+                           const std::function<void(const MarketEvent&)>& cb) override {
+            if (session && probe.exchange(false)) {
+                step_held = !session->step_mutex.try_lock();
+                if (!step_held) session->step_mutex.unlock();
+            }
+            FakeDataSource::stream_events(symbols, from, to, cb);
+        }
+        std::shared_ptr<Session> session;
+        std::atomic<bool> probe{false};
+        std::atomic<bool> step_held{false};
+    };
+    auto ds = std::make_shared<ProbeDataSource>(events);
+    ExecutionConfig exec;
+    exec.seek_snapshot_interval_seconds = 0;
+    SessionManager mgr(ds, exec);
+
+    SessionConfig cfg;
+    cfg.symbols = {"AAPL"};
+    cfg.start_time = make_ts(0);
+    cfg.end_time = make_ts(10'000'000);
+    cfg.batch_mode = true;
+    cfg.queue_capacity = 8;
+    auto session = mgr.create_session(cfg);
+    ds->session = session;
+
+    session->status = SessionStatus::RUNNING;
+    ds->probe = true;
+    auto result = mgr.seek_to(session->id, make_ts(1'000'000));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->replayed_events, 100u);
+    EXPECT_TRUE(ds->step_held.load());
+
+    // The bounded batch feed picks up after the replayed events without
+    // overflowing the queue. The fake restreams its whole list from the
+    // cursor; only the cursor's own event is skipped as already replayed.
+    ASSERT_TRUE(wait_until([&] { return session->status == SessionStatus::COMPLETED; },
+                           std::chrono::seconds(5)));
+    EXPECT_EQ(session->events_dropped.load(), 0u);
+    EXPECT_EQ(session->events_processed.load(), static_cast<uint64_t>(100 + kQuotes - 1));
+
+    mgr.stop_session(session->id);
+}
+
+TEST(SessionManagerTest, SeekBeforeFirstSnapshotRebuildsFromWindowStart) {
+    constexpr int64_t kSecond = 1'000'000'000;
+    std::vector<MarketEvent> events;
+    for (int i = 1; i <= 20; ++i) {
+        MarketEvent ev;
+        ev.timestamp = make_ts(i * kSecond);
+        ev.type = MarketEventType::QUOTE;
+        ev.quote = QuoteRecord{ev.timestamp, "SEEKX", 100.0 + i, 100, 101.0 + i, 100, 1, 1, 1};
+        events.push_back(ev);
+    }
+
+    ExecutionConfig exec;
+    exec.seek_snapshot_interval_seconds = 5;
+    SessionManager mgr(std::make_shared<FakeDataSource>(events), exec);
+
+    SessionConfig cfg;
+    cfg.symbols = {"SEEKX"};
+    cfg.start_time = make_ts(0);
+    cfg.end_time = make_ts(30 * kSecond);
+    cfg.batch_mode = true;
+    auto session = mgr.create_session(cfg);
+
+    Order order;
+    order.symbol = "SEEKX";
+    order.side = OrderSide::BUY;
+    order.type = OrderType::MARKET;
+    order.tif = TimeInForce::DAY;
+    order.qty = 10.0;
+    ASSERT_FALSE(mgr.submit_order(session->id, order).empty());
+
+    mgr.start_session(session->id);
+    ASSERT_TRUE(wait_until([&] { return session->status == SessionStatus::COMPLETED; },
+                           std::chrono::seconds(5)));
+
+    // A seek moves config.start_time to its cursor.
+    ASSERT_TRUE(mgr.seek_to(session->id, make_ts(12 * kSecond)).has_value());
+    const SymbolId id = SymbolTable::instance().intern("SEEKX");
+    session->symbol_state.at(id)->ssr.store(true);
+
+    // Before the first snapshot (taken at the 1s quote): every later snapshot
+    // goes, and all state is back to the window's opening, SSR included.
+    auto before = mgr.seek_to(session->id, make_ts(kSecond / 2));
+    ASSERT_TRUE(before.has_value());
+    EXPECT_EQ(before->snapshot_time, make_ts(0));
+    EXPECT_EQ(before->replayed_events, 0u);
+    {
+        std::lock_guard<std::mutex> lock(session->snapshot_mutex);
+        EXPECT_TRUE(session->snapshots.empty());
+    }
+    EXPECT_FALSE(session->symbol_state.ssr_active(id));
+    EXPECT_EQ(session->events_processed.load(), 0u);
+    EXPECT_TRUE(session->account_manager->positions().empty());
+    EXPECT_EQ(session->orders.size(), 0u);
+
+    // With no snapshot left, the replay still starts at the window's start.
+    auto early = mgr.seek_to(session->id, make_ts(3 * kSecond));
+    ASSERT_TRUE(early.has_value());
+    EXPECT_EQ(early->snapshot_time, make_ts(0));
+    EXPECT_EQ(early->replayed_events, 3u);
+    EXPECT_EQ(session->events_processed.load(), 3u);
+}
+
+TEST(SessionManagerTest, ControlCommandsQueueOnSessionMailbox) {
+    SessionManager mgr(std::make_shared<FakeDataSource>(std::vector<MarketEvent>{}));
+    SessionConfig cfg;
+    cfg.symbols = {"AAPL"};
+    cfg.start_time = make_ts(0);
+    cfg.end_time = make_ts(10'000'000);
+    auto session = mgr.create_session(cfg);
+    mgr.start_session(session->id);
+
+    EXPECT_EQ(mgr.post_command("missing", "stop", [] { return nlohmann::json::object(); }), nullptr);
+
+    std::mutex gate_mutex;
+    std::condition_variable gate_cv;
+    bool released = false;
+    std::vector<int> order;
+    auto blocker = mgr.post_command(session->id, "jump", [&] {
+        std::unique_lock<std::mutex> lock(gate_mutex);
+        gate_cv.wait(lock, [&] { return released; });
+        order.push_back(1);
+        return nlohmann::json{{"step", 1}};
+    });
+    auto failing = mgr.post_command(session->id, "seek", [&]() -> nlohmann::json {
+        order.push_back(2);
+        throw std::runtime_error("boom");
+    });
+    auto stop = mgr.post_command(session->id, "stop", [&] {
+        order.push_back(3);
+        mgr.stop_session(session->id);
+        return nlohmann::json::object();
+    });
+    ASSERT_NE(blocker, nullptr);
+    ASSERT_NE(stop, nullptr);
+
+    // Posting returned while the first command is still blocked.
+    EXPECT_EQ(failing->status.load(), CommandStatus::QUEUED);
+    EXPECT_EQ(stop->status.load(), CommandStatus::QUEUED);
+    EXPECT_EQ(mgr.get_command(stop->id), stop);
+    EXPECT_NE(session->status, SessionStatus::STOPPED);
+
+    {
+        std::lock_guard<std::mutex> lock(gate_mutex);
+        released = true;
+    }
+    gate_cv.notify_all();
+
+    ASSERT_TRUE(wait_until([&] { return stop->status.load() == CommandStatus::DONE; },
+                           std::chrono::seconds(5)));
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(blocker->status.load(), CommandStatus::DONE);
+    EXPECT_EQ(blocker->result["step"], 1);
+    EXPECT_EQ(failing->status.load(), CommandStatus::FAILED);
+    EXPECT_EQ(failing->error, "boom");
+    EXPECT_TRUE(stop->completed_at.has_value());
+    EXPECT_EQ(session->status, SessionStatus::STOPPED);
+}
+
+TEST(SessionManagerTest, TypedSubscribersReceiveOnlyTheirKindOfEvent) {
+    MarketEvent ev;
+    ev.timestamp = make_ts(1'000'000);
+    ev.type = MarketEventType::QUOTE;
+    ev.quote = QuoteRecord{ev.timestamp, "AAPL", 100.0, 100, 101.0, 100, 1, 1, 1};
+    auto ds = std::make_shared<FakeDataSource>(std::vector<MarketEvent>{ev});
+    SessionManager mgr(ds);
+
+    SessionConfig cfg;
+    cfg.symbols = {"AAPL"};
+    cfg.start_time = make_ts(0);
+    cfg.end_time = make_ts(10'000'000);
+    cfg.speed_factor = 0.0;
+    auto first = mgr.create_session(cfg);
+    auto second = mgr.create_session(cfg);
+
+    std::mutex mu;
+    std::map<std::string, std::vector<EventType>> market_types;
+    std::map<std::string, std::vector<EventType>> order_types;
+    std::map<std::string, size_t> all_events;
+    auto record_into = [&](std::map<std::string, std::vector<EventType>>& out) {
+        return [&](const std::string& sid, const Event& e) {
+            std::lock_guard<std::mutex> lock(mu);
+            out[sid].push_back(e.event_type);
+        };
+    };
+    mgr.add_market_data_callback(record_into(market_types));
+    mgr.add_order_callback(record_into(order_types));
+    mgr.add_event_callback([&](const std::string& sid, const Event&) {
+        std::lock_guard<std::mutex> lock(mu);
+        all_events[sid]++;
+    });
+
+    Order order;
+    order.symbol = "AAPL";
+    order.side = OrderSide::BUY;
+    order.type = OrderType::MARKET;
+    order.tif = TimeInForce::DAY;
+    order.qty = 5.0;
+    ASSERT_FALSE(mgr.submit_order(first->id, order).empty());
+
+    mgr.start_session(first->id);
+    mgr.start_session(second->id);
+    ASSERT_TRUE(wait_until([&] {
+        std::lock_guard<std::mutex> lock(mu);
+        const auto& fills = order_types[first->id];
+        return std::find(fills.begin(), fills.end(), EventType::ORDER_FILL) != fills.end();
+    }, std::chrono::seconds(2)));
+    ASSERT_TRUE(wait_until([&] { return second->events_processed.load() == 1; }, std::chrono::seconds(2)));
+    mgr.stop_session(first->id);
+    mgr.stop_session(second->id);
+
+    std::lock_guard<std::mutex> lock(mu);
+    EXPECT_EQ(market_types[first->id], std::vector<EventType>{EventType::QUOTE});
+    EXPECT_EQ(market_types[second->id], std::vector<EventType>{EventType::QUOTE});
+    EXPECT_EQ(order_types[first->id], (std::vector<EventType>{EventType::ORDER_NEW, EventType::ORDER_FILL}));
+    EXPECT_TRUE(order_types[second->id].empty());
+    // Manager-wide callbacks see both kinds.
+    EXPECT_EQ(all_events[first->id], 3u);
+    EXPECT_EQ(all_events[second->id], 1u);
+}
+
+TEST(SessionManagerTest, StreamSubscriptionsAreRefCountedAndPublished) {
+    auto ds = std::make_shared<FakeDataSource>(std::vector<MarketEvent>{});
+    SessionManager mgr(ds);
+
+    SessionConfig cfg;
+    cfg.symbols = {"AAPL", "MSFT", "TSLA"};
+    cfg.start_time = make_ts(0);
+    cfg.end_time = make_ts(10'000'000'000);
+    cfg.speed_factor = 1.0;
+    auto session = mgr.create_session(cfg);
+
+    // Nothing subscribed: stream the configured symbols, allow every row.
+    EXPECT_EQ(mgr.get_stream_symbols(session), cfg.symbols);
+    EXPECT_TRUE(mgr.is_stream_symbol_subscribed(session->id, "NVDA"));
+
+    StreamSubscriptions::Reader reader(session->stream_subscriptions);
+    mgr.update_stream_subscriptions(session->id, {"MSFT", "AAPL"}, true);
+    mgr.update_stream_subscriptions(session->id, {"AAPL"}, true);
+    EXPECT_EQ(mgr.get_stream_symbols(session), (std::vector<std::string>{"AAPL", "MSFT"}));
+    EXPECT_TRUE(reader.allows("MSFT"));
+    EXPECT_FALSE(reader.allows("TSLA"));
+
+    mgr.start_session(session->id);
+    mgr.pause_session(session->id);
+    auto child = mgr.fork_session(session->id);
+    EXPECT_EQ(mgr.get_stream_symbols(child), (std::vector<std::string>{"AAPL", "MSFT"}));
+
+    mgr.update_stream_subscriptions(session->id, {"AAPL", "MSFT"}, false);
+    EXPECT_EQ(mgr.get_stream_symbols(session), std::vector<std::string>{"AAPL"});
+    EXPECT_FALSE(reader.allows("MSFT"));
+    EXPECT_FALSE(mgr.is_stream_symbol_subscribed(session->id, "MSFT"));
+    EXPECT_TRUE(mgr.is_stream_symbol_subscribed(child->id, "MSFT"));
+
+    mgr.clear_stream_subscriptions(session->id);
+    EXPECT_EQ(mgr.get_stream_symbols(session), cfg.symbols);
+    EXPECT_TRUE(reader.allows("TSLA"));
+    mgr.stop_session(child->id);
+    mgr.stop_session(session->id);
+}
+
+TEST(SessionManagerTest, HaltedSymbolRejectsOrdersUntilHaltLapses) {
+    auto ds = std::make_shared<FakeDataSource>(std::vector<MarketEvent>{});
+    SessionManager mgr(ds);
+
+    SessionConfig cfg;
+    cfg.symbols = {"HALTX"};
+    cfg.start_time = make_ts(0);
+    cfg.end_time = make_ts(10'000'000);
+    auto session = mgr.create_session(cfg);
+    session->matching_engine->update_nbbo(NBBO{"HALTX", 100.0, 1000, 100.5, 1000, 0});
+
+    Order order;
+    order.symbol = "HALTX";
+    order.side = OrderSide::BUY;
+    order.type = OrderType::LIMIT;
+    order.limit_price = 99.0;
+    order.tif = TimeInForce::DAY;
+    order.qty = 1.0;
+
+    const SymbolId id = SymbolTable::instance().intern("HALTX");
+    session->symbol_state.at(id)->halted_until_ns = 5'000'000;
+    EXPECT_TRUE(mgr.submit_order(session->id, order).empty());
+
+    // The halt ends in simulated time, not wall-clock time.
+    session->time_engine->set_time(make_ts(5'000'000));
+    EXPECT_FALSE(mgr.submit_order(session->id, order).empty());
+
+    session->symbol_state.at(id)->halted_until_ns = SymbolStateTable::kHaltedIndefinitely;
+    EXPECT_TRUE(mgr.submit_order(session->id, order).empty());
+}
+
+TEST(SessionManagerTest, TradeBelowPriorCloseThresholdActivatesShortSaleRestriction) {
+    MarketEvent quote;
+    quote.timestamp = make_ts(1'000'000);
+    quote.type = MarketEventType::QUOTE;
+    quote.quote = QuoteRecord{quote.timestamp, "SSRX", 85.0, 100, 85.5, 100, 1, 1, 1};
+    MarketEvent trade;
+    trade.timestamp = make_ts(2'000'000);
+    trade.type = MarketEventType::TRADE;
+    trade.trade = TradeRecord{trade.timestamp, "SSRX", 85.2, 100, 1, "", 1};
+    auto ds = std::make_shared<FakeDataSource>(std::vector<MarketEvent>{quote, trade});
+    SessionManager mgr(ds);
+
+    SessionConfig cfg;
+    cfg.symbols = {"SSRX"};
+    cfg.start_time = make_ts(0);
+    cfg.end_time = make_ts(10'000'000);
+    cfg.speed_factor = 0.0;
+    auto session = mgr.create_session(cfg);
+    const SymbolId id = SymbolTable::instance().intern("SSRX");
+    session->symbol_state.at(id)->prior_close = 100.0;
+
+    mgr.start_session(session->id);
+    ASSERT_TRUE(wait_until([&] { return session->symbol_state.ssr_active(id); }, std::chrono::seconds(2)));
+    ASSERT_TRUE(wait_until([&] { return session->events_processed.load() == 2; }, std::chrono::seconds(2)));
+
+    Order short_sell;
+    short_sell.symbol = "SSRX";
+    short_sell.side = OrderSide::SELL;
+    short_sell.type = OrderType::MARKET;
+    short_sell.tif = TimeInForce::DAY;
+    short_sell.qty = 10.0;
+    EXPECT_TRUE(mgr.submit_order(session->id, short_sell).empty());
+
+    short_sell.type = OrderType::LIMIT;
+    short_sell.limit_price = 84.0;  // below the national best bid
+    EXPECT_TRUE(mgr.submit_order(session->id, short_sell).empty());
+    short_sell.limit_price = 85.5;
+    EXPECT_FALSE(mgr.submit_order(session->id, short_sell).empty());
+
+    mgr.stop_session(session->id);
+}
+
+TEST(SessionManagerTest, PriorClosesPreloadPerTradingDayAndSsrCarriesOneDay) {
+    const auto utc = [](int year, int month, int day, int hour) {
+        std::tm tm{};
+        tm.tm_year = year - 1900;
+        tm.tm_mon = month - 1;
+        tm.tm_mday = day;
+        tm.tm_hour = hour;
+        return std::chrono::system_clock::from_time_t(timegm(&tm));
+    };
+    std::vector<MarketEvent> events;
+    auto add_trade = [&](Timestamp ts, const std::string& symbol, double price) {
+        MarketEvent trade;
+        trade.timestamp = ts;
+        trade.type = MarketEventType::TRADE;
+        trade.trade = TradeRecord{ts, symbol, price, 100, 1, "", 1};
+        events.push_back(trade);
+    };
+    add_trade(utc(2024, 3, 5, 15), "PCA", 89.0);                       // 11% under 100: SSR
+    add_trade(utc(2024, 3, 5, 15) + std::chrono::seconds(1), "PCB", 46.0);  // 8% under 50
+    add_trade(utc(2024, 3, 6, 15), "PCA", 79.0);                       // still restricted
+    add_trade(utc(2024, 3, 7, 15), "PCA", 79.0);                       // restriction lapsed
+    auto ds = std::make_shared<FakeDataSource>(events);
+    ds->daily_bars = {
+        BarRecord{utc(2024, 3, 1, 0), "PCB", 50, 50, 50, 50.0, 1, 50, 1},
+        BarRecord{utc(2024, 3, 4, 0), "PCA", 100, 100, 100, 100.0, 1, 100, 1},
+        BarRecord{utc(2024, 3, 5, 0), "PCA", 80, 80, 80, 80.0, 1, 80, 1},
+    };
+    SessionManager mgr(ds);
+
+    SessionConfig cfg;
+    cfg.symbols = {"PCA", "PCB"};
+    cfg.start_time = utc(2024, 3, 5, 14);
+    cfg.end_time = utc(2024, 3, 8, 0);
+    cfg.batch_mode = true;
+    auto session = mgr.create_session(cfg);
+
+    std::mutex mu;
+    std::vector<std::tuple<std::string, double, bool>> seen;  // symbol, prior close, ssr
+    mgr.add_event_callback([&](const std::string&, const Event& e) {
+        if (e.event_type != EventType::TRADE) return;
+        const auto* state = session->symbol_state.find(SymbolTable::instance().find(e.symbol));
+        std::lock_guard<std::mutex> lock(mu);
+        seen.emplace_back(e.symbol, state ? state->prior_close.load() : 0.0, state && state->ssr.load());
+    });
+
+    mgr.start_session(session->id);
+    ASSERT_TRUE(wait_until([&] { return session->status == SessionStatus::COMPLETED; },
+                           std::chrono::seconds(2)));
+
+    std::lock_guard<std::mutex> lock(mu);
+    ASSERT_EQ(seen.size(), 4u);
+    EXPECT_EQ(seen[0], std::make_tuple(std::string("PCA"), 100.0, true));
+    EXPECT_EQ(seen[1], std::make_tuple(std::string("PCB"), 50.0, false));
+    EXPECT_EQ(seen[2], std::make_tuple(std::string("PCA"), 80.0, true));
+    EXPECT_EQ(seen[3], std::make_tuple(std::string("PCA"), 80.0, false));
+    // One bulk query for the whole window, made before the loop started.
+    EXPECT_EQ(ds->daily_bar_queries.load(), 1);
+}
+
+TEST(SessionManagerTest, PriorCloseLoadRunsOffTheCallerAndGatesTheFirstEvent) {
+    const auto utc = [](int year, int month, int day, int hour) {
+        std::tm tm{};
+        tm.tm_year = year - 1900;
+        tm.tm_mon = month - 1;
+        tm.tm_mday = day;
+        tm.tm_hour = hour;
+        return std::chrono::system_clock::from_time_t(timegm(&tm));
+    };
+    // The daily-bar query blocks until the test releases it.
+    class GatedDataSource : public FakeDataSource {
+    public:
+        using FakeDataSource::FakeDataSource;
+        void stream_aggregate_bars(const std::vector<std::string>& symbols,
+                                   Timestamp start_time,
+                                   Timestamp end_time,
+                                   int multiplier,
+                                   const std::string& timespan,
+                                   const std::function<void(const BarRecord&)>& cb) override {
+            {
+                std::unique_lock<std::mutex> lock(mu);
+                cv.wait(lock, [&] { return released; });
+            }
+            FakeDataSource::stream_aggregate_bars(symbols, start_time, end_time, multiplier, timespan, cb);
+        }
+        void release() {
+            std::lock_guard<std::mutex> lock(mu);
+            released = true;
+            cv.notify_all();
+        }
+        std::mutex mu;
+        std::condition_variable cv;
+        bool released{false};
+    };
+    MarketEvent trade;
+    trade.timestamp = utc(2024, 3, 5, 15);
+    trade.type = MarketEventType::TRADE;
+    trade.trade = TradeRecord{trade.timestamp, "PCG", 89.0, 100, 1, "", 1};
+    auto ds = std::make_shared<GatedDataSource>(std::vector<MarketEvent>{trade});
+    ds->daily_bars = {BarRecord{utc(2024, 3, 4, 0), "PCG", 100, 100, 100, 100.0, 1, 100, 1}};
+    SessionManager mgr(ds);
+
+    SessionConfig cfg;
+    cfg.symbols = {"PCG"};
+    cfg.start_time = utc(2024, 3, 5, 14);
+    cfg.end_time = utc(2024, 3, 6, 0);
+    cfg.batch_mode = true;
+    auto session = mgr.create_session(cfg);
+    const SymbolId id = SymbolTable::instance().intern("PCG");
+
+    // start_session returns while the query is still blocked, and the loop
+    // holds its first event until the closes are in.
+    auto started = std::async(std::launch::async, [&] { mgr.start_session(session->id); });
+    ASSERT_EQ(started.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(session->events_processed.load(), 0u);
+
+    ds->release();
+    ASSERT_TRUE(wait_until([&] { return session->status == SessionStatus::COMPLETED; },
+                           std::chrono::seconds(2)));
+    EXPECT_EQ(session->events_processed.load(), 1u);
+    EXPECT_TRUE(session->symbol_state.ssr_active(id));
+    EXPECT_DOUBLE_EQ(session->symbol_state.find(id)->prior_close.load(), 100.0);
+}
+
+TEST(SessionManagerTest, SweepMembersLoadPriorCloses) {
+    const auto utc = [](int year, int month, int day, int hour) {
+        std::tm tm{};
+        tm.tm_year = year - 1900;
+        tm.tm_mon = month - 1;
+        tm.tm_mday = day;
+        tm.tm_hour = hour;
+        return std::chrono::system_clock::from_time_t(timegm(&tm));
+    };
+    MarketEvent trade;
+    trade.timestamp = utc(2024, 3, 5, 15);
+    trade.type = MarketEventType::TRADE;
+    trade.trade = TradeRecord{trade.timestamp, "PCS", 89.0, 100, 1, "", 1};  // 11% under 100
+    auto ds = std::make_shared<FakeDataSource>(std::vector<MarketEvent>{trade});
+    ds->daily_bars = {BarRecord{utc(2024, 3, 4, 0), "PCS", 100, 100, 100, 100.0, 1, 100, 1}};
+    SessionManager mgr(ds);
+
+    SessionConfig base;
+    base.symbols = {"PCS"};
+    base.start_time = utc(2024, 3, 5, 14);
+    base.end_time = utc(2024, 3, 6, 0);
+
+    auto group = mgr.create_sweep(base, std::vector<SweepVariant>(2));
+    ASSERT_TRUE(wait_until([&] { return group->done.load(); }, std::chrono::seconds(5)));
+    const SymbolId id = SymbolTable::instance().intern("PCS");
+    for (const auto& s : group->sessions) {
+        EXPECT_EQ(s->status, SessionStatus::COMPLETED);
+        EXPECT_TRUE(s->symbol_state.ssr_active(id));
+        ASSERT_NE(s->symbol_state.find(id), nullptr);
+        EXPECT_DOUBLE_EQ(s->symbol_state.find(id)->prior_close.load(), 100.0);
+    }
+}
+
+TEST(SessionManagerTest, SeeksCarrySsrAcrossTradingDays) {
+    const auto utc = [](int year, int month, int day, int hour) {
+        std::tm tm{};
+        tm.tm_year = year - 1900;
+        tm.tm_mon = month - 1;
+        tm.tm_mday = day;
+        tm.tm_hour = hour;
+        return std::chrono::system_clock::from_time_t(timegm(&tm));
+    };
+    std::vector<MarketEvent> events;
+    auto add_trade = [&](Timestamp ts, double price) {
+        MarketEvent trade;
+        trade.timestamp = ts;
+        trade.type = MarketEventType::TRADE;
+        trade.trade = TradeRecord{ts, "SSRD", price, 100, 1, "", 1};
+        events.push_back(trade);
+    };
+    add_trade(utc(2024, 3, 5, 15), 89.0);  // 11% under 100: SSR
+    add_trade(utc(2024, 3, 5, 16), 95.0);
+    add_trade(utc(2024, 3, 6, 15), 79.0);  // carried into the next day
+    add_trade(utc(2024, 3, 7, 15), 79.0);  // then lapsed
+    auto ds = std::make_shared<FakeDataSource>(events);
+    ds->daily_bars = {
+        BarRecord{utc(2024, 3, 4, 0), "SSRD", 100, 100, 100, 100.0, 1, 100, 1},
+        BarRecord{utc(2024, 3, 5, 0), "SSRD", 80, 80, 80, 80.0, 1, 80, 1},
+    };
+    ExecutionConfig exec;
+    exec.seek_snapshot_interval_seconds = 3600;
+    SessionManager mgr(ds, exec);
+
+    SessionConfig cfg;
+    cfg.symbols = {"SSRD"};
+    cfg.start_time = utc(2024, 3, 5, 14);
+    cfg.end_time = utc(2024, 3, 8, 0);
+    cfg.batch_mode = true;
+    auto session = mgr.create_session(cfg);
+    const SymbolId id = SymbolTable::instance().intern("SSRD");
+
+    mgr.start_session(session->id);
+    ASSERT_TRUE(wait_until([&] { return session->status == SessionStatus::COMPLETED; },
+                           std::chrono::seconds(2)));
+    EXPECT_FALSE(session->symbol_state.ssr_active(id));
+
+    // The snapshot taken before the 3/6 trade holds the 3/5 trigger, so the
+    // replayed day roll carries the restriction.
+    ASSERT_TRUE(mgr.seek_to(session->id, utc(2024, 3, 6, 16)).has_value());
+    EXPECT_TRUE(session->symbol_state.ssr_active(id));
+    EXPECT_DOUBLE_EQ(session->symbol_state.find(id)->prior_close.load(), 80.0);
+
+    // A replay crossing the next midnight lets it lapse, callbacks or not.
+    ASSERT_TRUE(mgr.seek_to(session->id, utc(2024, 3, 7, 16)).has_value());
+    EXPECT_FALSE(session->symbol_state.ssr_active(id));
+    EXPECT_EQ(ds->daily_bar_queries.load(), 1);
+}
+
+TEST(SessionManagerTest, TradesThroughLuldBandPauseAndReopenTheSymbol) {
+    constexpr int64_t kSec = 1'000'000'000;
+    std::vector<MarketEvent> events;
+    auto add_trade = [&](int64_t ts, double price) {
+        MarketEvent trade;
+        trade.timestamp = make_ts(ts);
+        trade.type = MarketEventType::TRADE;
+        trade.trade = TradeRecord{trade.timestamp, "LULDX", price, 100, 1, "", 1};
+        events.push_back(trade);
+    };
+    for (int s = 1; s <= 50; ++s) add_trade(s * kSec, 100.0);
+    add_trade(55 * kSec, 111.0);   // through the 110 upper band: limit state
+    add_trade(70 * kSec, 111.0);   // still there 15s later: pause
+    add_trade(400 * kSec, 100.0);  // first print after the pause reopens
+    auto ds = std::make_shared<FakeDataSource>(events);
+    ExecutionConfig exec;
+    exec.seek_snapshot_interval_seconds = 0;  // seeks replay from the start
+    SessionManager mgr(ds, exec);
+
+    SessionConfig cfg;
+    cfg.symbols = {"LULDX"};
+    cfg.start_time = make_ts(0);
+    cfg.end_time = make_ts(500 * kSec);
+    cfg.speed_factor = 1000.0;  // pauses are minutes of simulated time
+    auto session = mgr.create_session(cfg);
+    const SymbolId id = SymbolTable::instance().intern("LULDX");
+
+    std::mutex mu;
+    std::vector<std::pair<EventType, int64_t>> regulatory;  // type, halted_until_ns seen
+    mgr.add_event_callback([&](const std::string&, const Event& e) {
+        if (e.event_type != EventType::HALT && e.event_type != EventType::RESUME) return;
+        std::lock_guard<std::mutex> lock(mu);
+        regulatory.emplace_back(e.event_type, session->symbol_state.find(id)->halted_until_ns.load());
+    });
+
+    mgr.start_session(session->id);
+    ASSERT_TRUE(wait_until([&] {
+        std::lock_guard<std::mutex> lock(mu);
+        return regulatory.size() == 2;
+    }, std::chrono::seconds(5)));
+    ASSERT_TRUE(wait_until([&] { return session->status == SessionStatus::COMPLETED; },
+                           std::chrono::seconds(5)));
+    // Derived events stay out of the cursor a fork or seek resumes from.
+    EXPECT_EQ(session->events_processed.load(), events.size());
+    EXPECT_EQ(session->events_at_last_ts, 1u);
+
+    {
+        std::lock_guard<std::mutex> lock(mu);
+        ASSERT_EQ(regulatory.size(), 2u);
+        EXPECT_EQ(regulatory[0].first, EventType::HALT);
+        EXPECT_EQ(regulatory[0].second, 70 * kSec + 300 * kSec);
+        EXPECT_EQ(regulatory[1].first, EventType::RESUME);
+        EXPECT_EQ(regulatory[1].second, 0);
+    }
+    const auto state = session->symbol_state.find(id)->load();
+    EXPECT_DOUBLE_EQ(state.luld_reference, 100.0);
+    EXPECT_DOUBLE_EQ(state.luld_upper, 110.0);
+
+    // A replay without callbacks derives the same pause at the same point.
+    auto seek = mgr.seek_to(session->id, make_ts(70 * kSec));
+    ASSERT_TRUE(seek.has_value());
+    EXPECT_EQ(seek->replayed_events, 52u);
+    EXPECT_EQ(session->events_processed.load(), 52u);
+    EXPECT_EQ(session->events_at_last_ts, 1u);
+    EXPECT_EQ(session->symbol_state.find(id)->halted_until_ns.load(), 70 * kSec + 300 * kSec);
+
+    mgr.stop_session(session->id);
+}
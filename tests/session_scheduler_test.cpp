@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include "../src/core/session_scheduler.hpp"
+
+using namespace broker_sim;
+
+namespace {
+
+bool wait_for(const std::function<bool()>& predicate, std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (predicate()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return predicate();
+}
+
+} // namespace
+
+TEST(SessionSchedulerTest, RequeuedTasksRunToCompletion) {
+    SessionScheduler scheduler(2);
+    EXPECT_EQ(scheduler.thread_count(), 2u);
+
+    constexpr int kTasks = 50;
+    constexpr int kSlices = 20;
+    std::atomic<int> slices{0};
+    std::atomic<int> finished{0};
+    for (int i = 0; i < kTasks; ++i) {
+        auto remaining = std::make_shared<int>(kSlices);
+        scheduler.submit([&, remaining]() {
+            ++slices;
+            if (--*remaining > 0) return true;
+            ++finished;
+            return false;
+        });
+    }
+
+    ASSERT_TRUE(wait_for([&] { return finished.load() == kTasks; }, std::chrono::seconds(5)));
+    EXPECT_EQ(slices.load(), kTasks * kSlices);
+}
+
+TEST(SessionSchedulerTest, IdleWorkersStealFromBusyOnes) {
+    SessionScheduler scheduler(4);
+    std::atomic<bool> release{false};
+    std::atomic<int> done{0};
+
+    // Round-robin puts one blocker on each worker; the short tasks queued
+    // behind the blocked workers must be stolen by the free one.
+    for (int i = 0; i < 3; ++i) {
+        scheduler.submit([&]() {
+            while (!release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            return false;
+        });
+    }
+    for (int i = 0; i < 12; ++i) {
+        scheduler.submit([&]() { ++done; return false; });
+    }
+
+    EXPECT_TRUE(wait_for([&] { return done.load() == 12; }, std::chrono::seconds(2)));
+    release.store(true);
+}
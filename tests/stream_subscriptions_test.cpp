@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/core/stream_subscriptions.hpp"
+
+using namespace broker_sim;
+
+TEST(SymbolTableTest, InternsDenseStableIds) {
+    auto& table = SymbolTable::instance();
+    const SymbolId a = table.intern("SYMTAB_A");
+    const SymbolId b = table.intern("SYMTAB_B");
+    EXPECT_EQ(b, a + 1);
+    EXPECT_EQ(table.intern("SYMTAB_A"), a);
+    EXPECT_EQ(table.name(b), "SYMTAB_B");
+    EXPECT_EQ(table.find("SYMTAB_MISSING"), kInvalidSymbolId);
+
+    auto before = table.index();
+    const SymbolId c = table.intern("SYMTAB_C");
+    EXPECT_EQ(before->find("SYMTAB_C"), kInvalidSymbolId);  // snapshots never change
+    EXPECT_EQ(table.index()->find("SYMTAB_C"), c);
+    EXPECT_EQ(table.index()->find("SYMTAB_A"), a);
+}
+
+TEST(SymbolTableTest, LookupsSeeEveryPublishedSymbolWhileTheTableGrows) {
+    auto& table = SymbolTable::instance();
+    const SymbolId first = table.intern("SYMTAB_GROW_0");
+    std::atomic<bool> done{false};
+    std::atomic<int> misses{0};
+    std::thread reader([&] {
+        while (!done.load()) {
+            // Every symbol below the published count must resolve to its id.
+            const auto snapshot = table.index();
+            const SymbolId n = snapshot->count;
+            for (SymbolId id = first; id < n; id += 7) {
+                if (table.find(table.name(id)) != id) misses.fetch_add(1);
+            }
+        }
+    });
+    // Enough symbols to rebuild the slot table several times.
+    std::vector<SymbolId> ids;
+    for (int i = 1; i < 5000; ++i) {
+        ids.push_back(table.intern("SYMTAB_GROW_" + std::to_string(i)));
+    }
+    done = true;
+    reader.join();
+
+    EXPECT_EQ(misses.load(), 0);
+    for (int i = 1; i < 5000; ++i) {
+        EXPECT_EQ(table.find("SYMTAB_GROW_" + std::to_string(i)), ids[i - 1]);
+        EXPECT_EQ(ids[i - 1], first + static_cast<SymbolId>(i));
+    }
+}
+
+TEST(StreamSubscriptionsTest, ReaderAllowsEverythingUntilASetIsPublished) {
+    StreamSubscriptions subs;
+    StreamSubscriptions::Reader reader(subs);
+    EXPECT_TRUE(reader.allows("ANY"));
+    EXPECT_EQ(reader.current(), nullptr);
+
+    subs.publish({"MSFT", "AAPL", "MSFT"});
+    EXPECT_TRUE(reader.allows("AAPL"));
+    EXPECT_TRUE(reader.allows("MSFT"));
+    EXPECT_FALSE(reader.allows("TSLA"));
+    EXPECT_FALSE(reader.allows("NEVER_INTERNED_SYMBOL"));
+    ASSERT_NE(reader.current(), nullptr);
+    EXPECT_EQ(reader.current()->symbols, (std::vector<std::string>{"AAPL", "MSFT"}));
+
+    // A held set stays valid after the next publication replaces it.
+    auto held = reader.current();
+    subs.publish({"TSLA"});
+    EXPECT_FALSE(reader.allows("AAPL"));
+    EXPECT_TRUE(reader.allows("TSLA"));
+    EXPECT_TRUE(held->contains("AAPL"));
+
+    subs.publish({});
+    EXPECT_TRUE(reader.allows("AAPL"));
+    EXPECT_EQ(subs.load(), nullptr);
+}
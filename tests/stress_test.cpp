@@ -6,6 +6,7 @@
 #include <atomic>
 #include <vector>
 #include <random>
+#include <algorithm>
 #include "../src/core/session_manager.hpp"
 #include "../src/core/data_source_stub.hpp"
 
@@ -334,6 +335,82 @@ TEST(StressTest, HighVolumeOrderSubmission) {
     mgr.stop_session(session->id);
 }
 
+TEST(StressTest, BatchVsSingleOrderThroughput) {
+    constexpr int NUM_ORDERS = 2000;
+
+    auto ds = std::make_shared<StressTestDataSource>(10);
+    SessionManager mgr(ds);
+
+    SessionConfig cfg;
+    cfg.symbols = {"AAPL"};
+    cfg.start_time = Timestamp{} + std::chrono::nanoseconds(1'000'000);
+    cfg.end_time = cfg.start_time + std::chrono::hours(1);
+    cfg.speed_factor = 0.0;
+    cfg.initial_capital = 1000000.0;
+
+    auto single_session = mgr.create_session(cfg);
+    auto batch_session = mgr.create_session(cfg);
+    ASSERT_NE(single_session, nullptr);
+    ASSERT_NE(batch_session, nullptr);
+
+    // Resting limit orders far from the market so nothing fills.
+    auto make_orders = [&] {
+        std::vector<Order> orders;
+        orders.reserve(NUM_ORDERS);
+        for (int i = 0; i < NUM_ORDERS; ++i) {
+            Order order;
+            order.symbol = "AAPL";
+            order.side = OrderSide::BUY;
+            order.type = OrderType::LIMIT;
+            order.tif = TimeInForce::GTC;
+            order.qty = 1.0;
+            order.limit_price = 1.0;
+            orders.push_back(std::move(order));
+        }
+        return orders;
+    };
+
+    auto single_orders = make_orders();
+    std::vector<std::string> single_ids;
+    auto start = std::chrono::steady_clock::now();
+    for (auto& order : single_orders) {
+        single_ids.push_back(mgr.submit_order(single_session->id, order));
+    }
+    auto single_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    auto batch_ids = mgr.submit_orders(batch_session->id, make_orders());
+    auto batch_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    ASSERT_EQ(batch_ids.size(), static_cast<size_t>(NUM_ORDERS));
+    size_t accepted = 0;
+    for (const auto& id : batch_ids) {
+        if (!id.empty()) ++accepted;
+    }
+    EXPECT_EQ(accepted, static_cast<size_t>(std::count_if(single_ids.begin(), single_ids.end(),
+        [](const std::string& id) { return !id.empty(); })));
+    EXPECT_EQ(mgr.get_orders(batch_session->id).size(), accepted);
+
+    start = std::chrono::steady_clock::now();
+    auto canceled = mgr.cancel_orders(batch_session->id, batch_ids);
+    auto cancel_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    ASSERT_EQ(canceled.size(), batch_ids.size());
+    for (size_t i = 0; i < batch_ids.size(); ++i) {
+        if (!batch_ids[i].empty()) {
+            EXPECT_TRUE(canceled[i]) << "order " << batch_ids[i] << " should cancel";
+        }
+    }
+    EXPECT_TRUE(batch_session->orders.open_order_ids().empty());
+
+    auto rate = [](int n, long long us) { return us > 0 ? n * 1'000'000.0 / us : 0.0; };
+    std::cout << "Order throughput: single " << rate(NUM_ORDERS, single_us) << " orders/s, batch "
+              << rate(NUM_ORDERS, batch_us) << " orders/s, batch cancel "
+              << rate(NUM_ORDERS, cancel_us) << " orders/s" << std::endl;
+}
+
 TEST(StressTest, RapidSessionCreationDestruction) {
     constexpr int NUM_ITERATIONS = 20;
 
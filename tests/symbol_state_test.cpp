@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include "../src/core/symbol_state.hpp"
+
+using namespace broker_sim;
+
+TEST(SymbolStateTableTest, UnwrittenSymbolsReadAsDefault) {
+    SymbolStateTable table;
+    EXPECT_EQ(table.find(3), nullptr);
+    EXPECT_EQ(table.find(kInvalidSymbolId), nullptr);
+    EXPECT_FALSE(table.is_halted(3, 0));
+    EXPECT_FALSE(table.ssr_active(3));
+    EXPECT_EQ(table.at(kInvalidSymbolId), nullptr);
+    EXPECT_TRUE(table.snapshot().empty());
+}
+
+TEST(SymbolStateTableTest, TimedHaltsLapseAndIndefiniteHaltsDoNot) {
+    SymbolStateTable table;
+    table.at(1)->halted_until_ns = 1'000;
+    table.at(2)->halted_until_ns = SymbolStateTable::kHaltedIndefinitely;
+    EXPECT_TRUE(table.is_halted(1, 999));
+    EXPECT_FALSE(table.is_halted(1, 1'000));
+    EXPECT_TRUE(table.is_halted(2, 1'000'000'000'000));
+    table.at(2)->halted_until_ns = 0;
+    EXPECT_FALSE(table.is_halted(2, 0));
+    // Neighbours in the same chunk exist but stay default.
+    ASSERT_NE(table.find(0), nullptr);
+    EXPECT_TRUE(table.find(0)->load().is_default());
+}
+
+TEST(SymbolStateTableTest, SnapshotRestoreRoundTripsAcrossChunks) {
+    SymbolStateTable table;
+    table.at(5)->ssr = true;
+    table.at(5)->prior_close = 42.5;
+    table.at(70'000)->luld_upper = 105.0;
+    table.at(70'000)->luld_lower = 95.0;
+    auto snap = table.snapshot();
+    ASSERT_EQ(snap.size(), 2u);
+    EXPECT_EQ(snap[0].first, 5u);
+    EXPECT_EQ(snap[1].first, 70'000u);
+
+    table.at(5)->ssr = false;
+    table.at(9)->halted_until_ns = SymbolStateTable::kHaltedIndefinitely;
+
+    SymbolStateTable copy;
+    copy.restore(snap);
+    table.restore(snap);
+    for (auto* t : {&table, &copy}) {
+        EXPECT_TRUE(t->ssr_active(5));
+        EXPECT_DOUBLE_EQ(t->find(5)->prior_close.load(), 42.5);
+        EXPECT_DOUBLE_EQ(t->find(70'000)->luld_lower.load(), 95.0);
+        EXPECT_FALSE(t->is_halted(9, 0));
+    }
+}
@@ -23,3 +23,37 @@ TEST(TimeEngineTest, StopInterruptsWait) {
     ASSERT_EQ(status, std::future_status::ready);
     EXPECT_FALSE(future.get());
 }
+
+TEST(TimeEngineTest, StepToSkipsListenersUntilPublished) {
+    TimeEngine engine;
+    engine.set_time(Timestamp{} + std::chrono::seconds(10));
+    int notifications = 0;
+    engine.add_listener([&](Timestamp) { ++notifications; });
+
+    engine.step_to(Timestamp{} + std::chrono::seconds(20));
+    engine.step_to(Timestamp{} + std::chrono::seconds(15));  // never moves backwards
+    EXPECT_EQ(engine.current_time(), Timestamp{} + std::chrono::seconds(20));
+    EXPECT_EQ(notifications, 0);
+
+    engine.publish_time();
+    EXPECT_EQ(notifications, 1);
+}
+
+TEST(TimeEngineTest, ScheduleLagAccumulatesProcessingTimeUntilRebased) {
+    TimeEngine engine;
+    engine.set_time(Timestamp{} + std::chrono::seconds(0));
+    engine.set_speed(1000.0);
+    engine.start();
+
+    ASSERT_TRUE(engine.wait_for_next_event(Timestamp{} + std::chrono::milliseconds(10)));
+    EXPECT_LT(engine.schedule_lag_ns(), 5'000'000);
+
+    // Simulated processing far longer than the 10us slot the next event has.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_TRUE(engine.wait_for_next_event(Timestamp{} + std::chrono::milliseconds(20)));
+    EXPECT_GE(engine.schedule_lag_ns(), 19'000'000);
+
+    engine.set_speed(1000.0);
+    EXPECT_EQ(engine.schedule_lag_ns(), 0);
+    engine.stop();
+}
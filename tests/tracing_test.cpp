@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include "../src/core/tracing.hpp"
+
+using namespace broker_sim;
+
+namespace {
+
+TraceSpan make_span(uint64_t seq, int64_t sim_ns, int64_t base_ns) {
+    TraceSpan span;
+    span.sequence = seq;
+    span.sim_ns = sim_ns;
+    span.symbol = "AAPL";
+    // 100ns per stage, fan-out nested inside callbacks.
+    span.at[static_cast<size_t>(TraceStage::DECODE)] = base_ns;
+    span.at[static_cast<size_t>(TraceStage::ENQUEUE)] = base_ns + 100;
+    span.at[static_cast<size_t>(TraceStage::DEQUEUE)] = base_ns + 200;
+    span.at[static_cast<size_t>(TraceStage::RELEASE)] = base_ns + 300;
+    span.at[static_cast<size_t>(TraceStage::WAL)] = base_ns + 400;
+    span.at[static_cast<size_t>(TraceStage::MATCH)] = base_ns + 500;
+    span.at[static_cast<size_t>(TraceStage::WS_BEGIN)] = base_ns + 550;
+    span.at[static_cast<size_t>(TraceStage::WS_END)] = base_ns + 580;
+    span.at[static_cast<size_t>(TraceStage::CALLBACKS)] = base_ns + 600;
+    return span;
+}
+
+} // namespace
+
+TEST(TracingTest, SamplesEveryNthEvent) {
+    SessionTracer tracer;
+    EXPECT_FALSE(tracer.should_sample());
+    tracer.set_sample_every(3);
+    int sampled = 0;
+    for (int i = 0; i < 9; ++i) sampled += tracer.should_sample() ? 1 : 0;
+    EXPECT_EQ(sampled, 3);
+}
+
+TEST(TracingTest, StampOnlyTouchesActiveSpan) {
+    trace_stamp(TraceStage::MATCH);  // no active span: no-op
+    TraceSpan span;
+    {
+        ActiveSpanScope scope(&span);
+        trace_stamp(TraceStage::MATCH);
+    }
+    EXPECT_GT(span[TraceStage::MATCH], 0);
+    EXPECT_EQ(span[TraceStage::WAL], 0);
+    EXPECT_EQ(tls_active_span, nullptr);
+}
+
+TEST(TracingTest, AggregatesStagesAndExportsWindow) {
+    SessionTracer tracer(1);
+    for (uint64_t i = 0; i < SessionTracer::kRingCapacity + 10; ++i) {
+        tracer.record(make_span(i, static_cast<int64_t>(i) * 1000, 1'000'000 + static_cast<int64_t>(i) * 1000));
+    }
+    EXPECT_EQ(tracer.recorded(), SessionTracer::kRingCapacity + 10);
+
+    auto stages = tracer.stage_summary();
+    EXPECT_EQ(stages["match"]["count"].get<uint64_t>(), SessionTracer::kRingCapacity + 10);
+    EXPECT_EQ(stages["match"]["mean_ns"].get<uint64_t>(), 100u);
+    EXPECT_EQ(stages["ws_send"]["p50_ns"].get<uint64_t>(), 32u);  // 30ns rounded to its bucket
+    EXPECT_EQ(stages["total"]["mean_ns"].get<uint64_t>(), 600u);
+
+    // The oldest spans were overwritten, so a window over them is empty.
+    auto evicted = tracer.chrome_trace("s1", 0, 5'000);
+    size_t slices = 0;
+    for (const auto& ev : evicted["traceEvents"]) slices += ev["ph"] == "X" ? 1 : 0;
+    EXPECT_EQ(slices, 0u);
+
+    const int64_t last = static_cast<int64_t>(SessionTracer::kRingCapacity + 9) * 1000;
+    auto trace = tracer.chrome_trace("s1", last - 1000, last);
+    EXPECT_EQ(trace["displayTimeUnit"], "ns");
+    size_t x = 0, async_begin = 0;
+    for (const auto& ev : trace["traceEvents"]) {
+        if (ev["ph"] == "X") {
+            ++x;
+            EXPECT_EQ(ev["pid"], 1);
+            if (ev["name"] == "ws_send") {
+                EXPECT_DOUBLE_EQ(ev["dur"].get<double>(), 0.03);
+            }
+        } else if (ev["ph"] == "b") {
+            ++async_begin;
+        }
+    }
+    // Two spans: enqueue, pacing, wal, match, callbacks, ws_send each, plus one async queue wait.
+    EXPECT_EQ(x, 12u);
+    EXPECT_EQ(async_begin, 2u);
+}